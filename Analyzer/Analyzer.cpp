@@ -130,7 +130,7 @@ std::shared_ptr<Analyzer::Expr> LikelihoodExpr::deep_copy() const {
   return makeExpr<LikelihoodExpr>(arg->deep_copy(), likelihood);
 }
 std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
-  return makeExpr<AggExpr>(type_info, aggtype, arg == nullptr ? nullptr : arg->deep_copy(), is_distinct, error_rate);
+  return makeExpr<AggExpr>(type_info, aggtype, arg == nullptr ? nullptr : arg->deep_copy(), is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -1548,7 +1548,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_targetlist(
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
     const std::vector<std::shared_ptr<TargetEntry>>& tlist) const {
   return makeExpr<AggExpr>(
-      type_info, aggtype, arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr, is_distinct, error_rate);
+      type_info, aggtype, arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -1831,6 +1831,8 @@ bool AggExpr::operator==(const Expr& rhs) const {
   const AggExpr& rhs_ae = dynamic_cast<const AggExpr&>(rhs);
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct())
     return false;
+  if (!arg1 != !rhs_ae.get_arg1() || (arg1 && !(*arg1 == *rhs_ae.get_arg1())))
+    return false;
   if (arg.get() == rhs_ae.get_arg())
     return true;
   if (arg == nullptr || rhs_ae.get_arg() == nullptr)
@@ -2102,6 +2104,9 @@ void AggExpr::print() const {
     case kLAST_SAMPLE:
       agg = "LAST_SAMPLE";
       break;
+    case kAPPROX_PERCENTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
   }
   std::cout << "(" << agg;
   if (is_distinct)
@@ -82,6 +82,7 @@ const int MAPD_TEMP_TABLE_START_ID = 1073741824;  // 2^30, give room for over a
 const int MAPD_TEMP_DICT_START_ID = 1073741824;   // 2^30, give room for over a billion non-temp dictionaries
 
 const std::string Catalog::physicalTableNameTag_("_shard_#");
+const std::string Catalog::partitionTableNameTag_("_partition_#");
 std::map<std::string, std::shared_ptr<Catalog>> Catalog::mapd_cat_map_;
 
 thread_local bool Catalog::thread_holds_read_lock = false;
@@ -1429,6 +1430,18 @@ void Catalog::updateTableDescriptorSchema() {
       string queryString("ALTER TABLE mapd_tables ADD userid integer DEFAULT " + std::to_string(MAPD_ROOT_USER_ID));
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("partition_column_id")) == cols.end()) {
+      string queryString("ALTER TABLE mapd_tables ADD partition_column_id integer DEFAULT 0");
+      sqliteConnector_.query(queryString);
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("partition_upper_bound")) == cols.end()) {
+      string queryString("ALTER TABLE mapd_tables ADD partition_upper_bound BIGINT DEFAULT 0");
+      sqliteConnector_.query(queryString);
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("page_compression")) == cols.end()) {
+      string queryString("ALTER TABLE mapd_tables ADD page_compression integer DEFAULT 0");
+      sqliteConnector_.query(queryString);
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -1929,7 +1942,8 @@ void Catalog::buildMaps() {
 
   string tableQuery(
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, "
-      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid from mapd_tables");
+      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, partition_column_id, "
+      "partition_upper_bound, page_compression from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
   for (size_t r = 0; r < numRows; ++r) {
@@ -1950,6 +1964,9 @@ void Catalog::buildMaps() {
     td->nShards = sqliteConnector_.getData<int>(r, 13);
     td->keyMetainfo = sqliteConnector_.getData<string>(r, 14);
     td->userId = sqliteConnector_.getData<int>(r, 15);
+    td->partitionColumnId = sqliteConnector_.getData<int>(r, 16);
+    td->partitionUpperBound = sqliteConnector_.getData<int64_t>(r, 17);
+    td->pageCompression = static_cast<File_Namespace::PageCompression>(sqliteConnector_.getData<int>(r, 18));
     if (!td->isView) {
       td->fragmenter = nullptr;
     }
@@ -2057,6 +2074,7 @@ void Catalog::buildMaps() {
       physicalTableIt->second.push_back(physical_tb_id);
     }
   }
+  sortRangePartitions();
 }
 
 void Catalog::addTableToMap(TableDescriptor& td,
@@ -2191,6 +2209,10 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
     getAllColumnMetadataForTable(td, columnDescs, true, false, true);
     Chunk::translateColumnDescriptorsToChunkVec(columnDescs, chunkVec);
     ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId};
+    if (td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
+      // chunks created by the fragmenter from now on are written through the codec of the table
+      dataMgr_->setTablePageCompression(currentDB_.dbId, td->tableId, td->pageCompression);
+    }
     td->fragmenter = new InsertOrderFragmenter(chunkKeyPrefix,
                                                chunkVec,
                                                dataMgr_.get(),
@@ -2616,8 +2638,9 @@ void Catalog::createTable(TableDescriptor& td,
       sqliteConnector_.query_with_text_params(
           "INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, "
           "max_chunk_size, "
-          "frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo) VALUES (?, ?, ?, "
-          "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+          "frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, "
+          "partition_column_id, partition_upper_bound, page_compression) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+          "?, ?, ?, ?, ?, ?)",
 
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
@@ -2633,7 +2656,10 @@ void Catalog::createTable(TableDescriptor& td,
                                    std::to_string(td.shardedColumnId),
                                    std::to_string(td.shard),
                                    std::to_string(td.nShards),
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   std::to_string(td.partitionColumnId),
+                                   std::to_string(td.partitionUpperBound),
+                                   std::to_string(static_cast<int>(td.pageCompression))});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param("SELECT tableid FROM mapd_tables WHERE name = ?", td.tableName);
@@ -2996,6 +3022,56 @@ void Catalog::createShardedTable(TableDescriptor& td,
   }
 }
 
+void Catalog::createRangePartitionedTable(TableDescriptor& td,
+                                          const list<ColumnDescriptor>& cols,
+                                          const std::vector<Parser::SharedDictionaryDef>& shared_dict_defs,
+                                          const std::vector<std::pair<std::string, int64_t>>& partitions) {
+  if (td.partitionColumnId <= 0 || static_cast<size_t>(td.partitionColumnId) > cols.size()) {
+    std::string error_message{"Invalid partition column for table " + td.tableName + " of database " +
+                              currentDB_.dbName};
+    throw runtime_error(error_message);
+  }
+  CHECK(!partitions.empty());
+  CHECK_EQ(0, td.nShards);
+
+  cat_write_lock write_lock(this);
+
+  TableDescriptor tdl(td);
+  createTable(tdl, cols, shared_dict_defs, true);  // create logical table
+  int32_t logical_tb_id = tdl.tableId;
+
+  // every partition is a physical table of the logical one, like a shard, so loading, truncating and
+  // dropping the table goes through the same paths; the fragments of a partition carry its table id
+  std::vector<int32_t> physicalTables;
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    TableDescriptor tdp(td);
+    tdp.tableName = generatePartitionTableName(tdp.tableName, partitions[i].first);
+    tdp.shard = i;
+    tdp.partitionColumnId = 0;
+    tdp.partitionUpperBound = partitions[i].second;
+    createTable(tdp, cols, shared_dict_defs, false);  // create physical table
+    physicalTables.push_back(tdp.tableId);
+  }
+
+  const auto it_ok = logicalToPhysicalTableMapById_.emplace(logical_tb_id, physicalTables);
+  CHECK(it_ok.second);
+  updateLogicalToPhysicalTableMap(logical_tb_id);
+}
+
+void Catalog::sortRangePartitions() {
+  for (auto& logical_and_physical : logicalToPhysicalTableMapById_) {
+    const auto td = getMetadataForTable(logical_and_physical.first);
+    CHECK(td);
+    if (!table_is_range_partitioned(td)) {
+      continue;
+    }
+    auto& physicalTables = logical_and_physical.second;
+    std::sort(physicalTables.begin(), physicalTables.end(), [this](const int32_t lhs, const int32_t rhs) {
+      return getMetadataForTable(lhs)->partitionUpperBound < getMetadataForTable(rhs)->partitionUpperBound;
+    });
+  }
+}
+
 void Catalog::truncateTable(const TableDescriptor* td) {
   cat_write_lock write_lock(this);
 
@@ -3146,6 +3222,60 @@ void Catalog::dropTable(const TableDescriptor* td) {
   sys_conn->query("END TRANSACTION");
 }
 
+void Catalog::dropPartition(const TableDescriptor* td, const std::string& partitionName) {
+  sys_write_lock write_lock_sys(&SysCatalog::instance());
+  sys_sqlite_lock sqlite_lock_sys(&SysCatalog::instance());
+
+  cat_write_lock write_lock(this);
+  cat_sqlite_lock sqlite_lock(this);
+  CHECK(table_is_range_partitioned(td));
+  const auto physicalTableIt = logicalToPhysicalTableMapById_.find(td->tableId);
+  CHECK(physicalTableIt != logicalToPhysicalTableMapById_.end());
+  auto& physicalTables = physicalTableIt->second;
+  const auto partitionTableName = generatePartitionTableName(td->tableName, partitionName);
+  const auto partitionIt =
+      std::find_if(physicalTables.begin(), physicalTables.end(), [this, &partitionTableName](const int32_t tb_id) {
+        return to_upper(getMetadataForTable(tb_id)->tableName) == to_upper(partitionTableName);
+      });
+  if (partitionIt == physicalTables.end()) {
+    throw runtime_error("Partition " + partitionName + " of table " + td->tableName + " does not exist.");
+  }
+  if (physicalTables.size() == 1) {
+    throw runtime_error("Cannot drop the only partition of table " + td->tableName + ". Use DROP TABLE.");
+  }
+  const auto phys_td = getMetadataForTable(*partitionIt);
+  CHECK(phys_td);
+  const int32_t physical_tb_id = phys_td->tableId;
+
+  // only the catalog entries and the chunks of the partition go away, the other partitions aren't touched
+  SqliteConnector* sys_conn = SysCatalog::instance().getSqliteConnector();
+  SqliteConnector* drop_conn = sys_conn;
+  sys_conn->query("BEGIN TRANSACTION");
+  bool is_system_db = currentDB_.dbName == MAPD_SYSTEM_DB;  // whether we need two connectors or not
+  if (!is_system_db) {
+    drop_conn = &sqliteConnector_;
+    drop_conn->query("BEGIN TRANSACTION");
+  }
+  try {
+    doDropTable(phys_td, drop_conn);
+    drop_conn->query_with_text_params(
+        "DELETE FROM mapd_logical_to_physical WHERE logical_table_id = ? AND physical_table_id = ?",
+        std::vector<std::string>{std::to_string(td->tableId), std::to_string(physical_tb_id)});
+    removeTableFromMap(phys_td->tableName, physical_tb_id);
+  } catch (std::exception& e) {
+    if (!is_system_db) {
+      drop_conn->query("ROLLBACK TRANSACTION");
+    }
+    sys_conn->query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  if (!is_system_db) {
+    drop_conn->query("END TRANSACTION");
+  }
+  sys_conn->query("END TRANSACTION");
+  physicalTables.erase(partitionIt);
+}
+
 void Catalog::doDropTable(const TableDescriptor* td, SqliteConnector* conn) {
   bool view = td->isView;
 
@@ -3225,7 +3355,11 @@ void Catalog::renameTable(const TableDescriptor* td, const string& newTableName)
       int32_t physical_tb_id = physicalTables[i];
       const TableDescriptor* phys_td = getMetadataForTable(physical_tb_id);
       CHECK(phys_td);
-      std::string newPhysTableName = generatePhysicalTableName(newTableName, static_cast<int32_t>(i + 1));
+      std::string newPhysTableName =
+          table_is_range_partitioned(td)
+              ? generatePartitionTableName(newTableName, phys_td->tableName.substr(td->tableName.size() +
+                                                                                   partitionTableNameTag_.size()))
+              : generatePhysicalTableName(newTableName, static_cast<int32_t>(i + 1));
       renamePhysicalTable(phys_td, newPhysTableName);
     }
   }
@@ -3437,6 +3571,11 @@ std::string Catalog::generatePhysicalTableName(const std::string& logicalTableNa
   return (physicalTableName);
 }
 
+std::string Catalog::generatePartitionTableName(const std::string& logicalTableName,
+                                               const std::string& partitionName) {
+  return logicalTableName + partitionTableNameTag_ + partitionName;
+}
+
 bool SessionInfo::checkDBAccessPrivileges(const DBObjectType& permissionType,
                                           const AccessPrivileges& privs,
                                           const std::string& objectName) const {
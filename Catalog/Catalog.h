@@ -156,11 +156,17 @@ class Catalog {
   void createShardedTable(TableDescriptor& td,
                           const std::list<ColumnDescriptor>& columns,
                           const std::vector<Parser::SharedDictionaryDef>& shared_dict_defs);
+  // Creates one physical table per (name, exclusive upper bound) entry of partitions, bounds ascending.
+  void createRangePartitionedTable(TableDescriptor& td,
+                                   const std::list<ColumnDescriptor>& columns,
+                                   const std::vector<Parser::SharedDictionaryDef>& shared_dict_defs,
+                                   const std::vector<std::pair<std::string, int64_t>>& partitions);
   int32_t createFrontendView(FrontendViewDescriptor& vd);
   void replaceDashboard(FrontendViewDescriptor& vd);
   std::string createLink(LinkDescriptor& ld, size_t min_length);
   void dropTable(const TableDescriptor* td);
   void truncateTable(const TableDescriptor* td);
+  void dropPartition(const TableDescriptor* td, const std::string& partitionName);
   void renameTable(const TableDescriptor* td, const std::string& newTableName);
   void renameColumn(const TableDescriptor* td, const ColumnDescriptor* cd, const std::string& newColumnName);
 
@@ -290,6 +296,8 @@ class Catalog {
                                     const bool fetchPhysicalColumns) const;
   std::string calculateSHA1(const std::string& data);
   std::string generatePhysicalTableName(const std::string& logicalTableName, const int32_t& shardNumber);
+  std::string generatePartitionTableName(const std::string& logicalTableName, const std::string& partitionName);
+  void sortRangePartitions();
 
   std::string basePath_;
   TableDescriptorMap tableDescriptorMap_;
@@ -310,7 +318,8 @@ class Catalog {
   std::shared_ptr<Calcite> calciteMgr_;
 
   LogicalToPhysicalTableMapById logicalToPhysicalTableMapById_;
-  static const std::string physicalTableNameTag_;  // extra component added to the name of each physical table
+  static const std::string physicalTableNameTag_;   // extra component added to the name of each physical table
+  static const std::string partitionTableNameTag_;  // same for the physical tables of range partitions
   int nextTempTableId_;
   int nextTempDictId_;
 
@@ -488,16 +497,24 @@ class SessionInfo {
               const UserMetadata& user,
               const ExecutorDeviceType t,
               const std::string& sid)
-      : catalog_(cat), currentUser_(user), executor_device_type_(t), session_id(sid), last_used_time(time(0)) {}
+      : catalog_(cat),
+        currentUser_(user),
+        executor_device_type_(t),
+        session_id(sid),
+        last_used_time(time(0)),
+        statement_timeout_ms_(0) {}
   SessionInfo(const SessionInfo& s)
       : catalog_(s.catalog_),
         currentUser_(s.currentUser_),
         executor_device_type_(static_cast<ExecutorDeviceType>(s.executor_device_type_)),
-        session_id(s.session_id) {}
+        session_id(s.session_id),
+        statement_timeout_ms_(static_cast<unsigned>(s.statement_timeout_ms_)) {}
   Catalog& get_catalog() const { return *catalog_; }
   const UserMetadata& get_currentUser() const { return currentUser_; }
   const ExecutorDeviceType get_executor_device_type() const { return executor_device_type_; }
   void set_executor_device_type(ExecutorDeviceType t) { executor_device_type_ = t; }
+  unsigned get_statement_timeout() const { return statement_timeout_ms_; }
+  void set_statement_timeout(const unsigned timeout_ms) { statement_timeout_ms_ = timeout_ms; }
   std::string get_session_id() const { return session_id; }
   time_t get_last_used_time() const { return last_used_time; }
   void update_time() { last_used_time = time(0); }
@@ -513,6 +530,7 @@ class SessionInfo {
   std::atomic<ExecutorDeviceType> executor_device_type_;
   const std::string session_id;
   std::atomic<time_t> last_used_time;  // for cleaning up SessionInfo after client dies
+  std::atomic<unsigned> statement_timeout_ms_;  // 0 if the queries of the session use the server wide limit
 };
 
 }  // namespace Catalog_Namespace
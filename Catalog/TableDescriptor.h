@@ -19,6 +19,10 @@
 
 #include <string>
 #include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "../DataMgr/FileMgr/PageCompression.h"
 #include "../DataMgr/MemoryLevel.h"
 #include "../Shared/sqldefs.h"
 #include "../Fragmenter/AbstractFragmenter.h"
@@ -44,7 +48,7 @@ struct TableDescriptor {
   int32_t fragPageSize;                           // page size
   int64_t maxRows;                                // max number of rows in the table
   std::string partitions;                         // distributed partition scheme
-  std::string keyMetainfo;                        // meta-information about shard keys and shared dictionary, as JSON
+  std::string keyMetainfo;                        // shard key, sort key and shared dictionary meta-information, as JSON
 
   Fragmenter_Namespace::AbstractFragmenter*
       fragmenter;       // point to fragmenter object for the table.  it's instantiated upon first use.
@@ -54,17 +58,57 @@ struct TableDescriptor {
   bool hasDeletedCol;  // Does table has a delete col, Yes (VACUUM = DELAYED)
                        //                              No  (VACUUM = IMMEDIATE)
 
+  int partitionColumnId;        // Id of the PARTITION BY RANGE column of a logical table (default: 0)
+  int64_t partitionUpperBound;  // Exclusive upper bound of the values of a range partition, i.e. a physical table
+
+  File_Namespace::PageCompression pageCompression;  // Codec of the pages written to disk (PAGE_COMPRESSION)
+
   TableDescriptor()
       : tableId(-1),
         shard(-1),
         nShards(0),
         shardedColumnId(0),
         persistenceLevel(Data_Namespace::MemoryLevel::DISK_LEVEL),
-        hasDeletedCol(false) {}
+        hasDeletedCol(false),
+        partitionColumnId(0),
+        partitionUpperBound(0),
+        pageCompression(File_Namespace::PageCompression::NONE) {}
 };
 
 inline bool table_is_replicated(const TableDescriptor* td) {
   return td->partitions == "REPLICATED";
 }
 
+inline bool table_is_range_partitioned(const TableDescriptor* td) {
+  return td->partitionColumnId > 0;
+}
+
+// Upper bound of the last range partition of a table created with VALUES LESS THAN MAXVALUE.
+constexpr int64_t range_partition_max_value() {
+  return std::numeric_limits<int64_t>::max();
+}
+
+// Index of the partition which holds val, given the physical tables of a range partitioned table in
+// ascending order of their upper bounds. Partition i holds the values in [upper bound of i - 1,
+// upper bound of i), the first one everything below its bound and the nulls. Returns -1 if val
+// is at or above the bound of the last partition.
+inline int get_range_partition_index(const std::vector<const TableDescriptor*>& partitions,
+                                     const int64_t val,
+                                     const bool is_null) {
+  if (partitions.empty()) {
+    return -1;
+  }
+  if (is_null) {
+    return 0;
+  }
+  const auto it =
+      std::upper_bound(partitions.begin(), partitions.end(), val, [](const int64_t v, const TableDescriptor* td) {
+        return v < td->partitionUpperBound;
+      });
+  if (it == partitions.end()) {
+    return partitions.back()->partitionUpperBound == range_partition_max_value() ? partitions.size() - 1 : -1;
+  }
+  return it - partitions.begin();
+}
+
 #endif  // TABLE_DESCRIPTOR
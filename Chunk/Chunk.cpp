@@ -220,6 +220,16 @@ ChunkIter Chunk::begin_iterator(const ChunkMetadata& chunk_metadata, int start_i
     it.current_pos = it.start_pos = index_buf->getMemoryPtr() + start_idx * sizeof(StringOffsetT);
     it.end_pos = index_buf->getMemoryPtr() + index_buf->size() - sizeof(StringOffsetT);
     it.second_buf = buffer->getMemoryPtr();
+  } else if (column_desc->columnType.get_compression() == kENCODING_RL) {
+    // runs aren't addressable by row, positions only stand for row indices from the chunk start
+    it.current_pos = it.start_pos = buffer->getMemoryPtr() + start_idx * it.skip_size;
+    it.end_pos = buffer->getMemoryPtr() + chunk_metadata.numElements * it.skip_size;
+    it.second_buf = buffer->getMemoryPtr();
+  } else if (column_desc->columnType.get_compression() == kENCODING_DIFF) {
+    // skip the frame of reference base
+    it.current_pos = it.start_pos = buffer->getMemoryPtr() + sizeof(int64_t) + start_idx * it.skip_size;
+    it.end_pos = buffer->getMemoryPtr() + buffer->size();
+    it.second_buf = buffer->getMemoryPtr();
   } else {
     it.current_pos = it.start_pos = buffer->getMemoryPtr() + start_idx * it.skip_size;
     it.end_pos = buffer->getMemoryPtr() + buffer->size();
@@ -21,6 +21,7 @@
  */
 #include "BufferMgr.h"
 #include "Buffer.h"
+#include "Shared/lock_wait_stats.h"
 #include "Shared/measure.h"
 
 #include <algorithm>
@@ -666,7 +667,7 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
-  std::lock_guard<std::mutex> lock(globalMutex_);  // granular lock
+  const auto lock = timed_lock<std::unique_lock<std::mutex>>(globalMutex_, LockWaitSite::BUFFER_MGR_GLOBAL_MUTEX);
 
   std::unique_lock<std::mutex> sizedSegsLock(sizedSegsMutex_);
   std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
@@ -696,7 +697,7 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes)
 }
 
 void BufferMgr::fetchBuffer(const ChunkKey& key, AbstractBuffer* destBuffer, const size_t numBytes) {
-  std::unique_lock<std::mutex> lock(globalMutex_);  // granular lock
+  auto lock = timed_lock<std::unique_lock<std::mutex>>(globalMutex_, LockWaitSite::BUFFER_MGR_GLOBAL_MUTEX);
   std::unique_lock<std::mutex> sizedSegsLock(sizedSegsMutex_);
   std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
 
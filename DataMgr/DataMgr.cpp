@@ -35,6 +35,7 @@
 #include <boost/filesystem.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
 
 using namespace std;
@@ -323,6 +324,20 @@ AbstractBuffer* DataMgr::createChunkBuffer(const ChunkKey& key,
   return bufferMgrs_[level][deviceId]->createBuffer(key, page_size);
 }
 
+namespace {
+
+thread_local ChunkFetchStats* chunk_fetch_stats{nullptr};
+
+}  // namespace
+
+ChunkFetchStats::Scope::Scope(ChunkFetchStats* stats) : prev_stats_(chunk_fetch_stats) {
+  chunk_fetch_stats = stats;
+}
+
+ChunkFetchStats::Scope::~Scope() {
+  chunk_fetch_stats = prev_stats_;
+}
+
 AbstractBuffer* DataMgr::getChunkBuffer(const ChunkKey& key,
                                         const MemoryLevel memoryLevel,
                                         const int deviceId,
@@ -330,7 +345,22 @@ AbstractBuffer* DataMgr::getChunkBuffer(const ChunkKey& key,
   auto level = static_cast<size_t>(memoryLevel);
   assert(level < levelSizes_.size());     // make sure we have a legit buffermgr
   assert(deviceId < levelSizes_[level]);  // make sure we have a legit buffermgr
-  return bufferMgrs_[level][deviceId]->getBuffer(key, numBytes);
+  if (!chunk_fetch_stats) {
+    return bufferMgrs_[level][deviceId]->getBuffer(key, numBytes);
+  }
+  // the highest level which already holds the chunk serves it, the levels above load it from there
+  auto source_level = level;
+  while (source_level > DISK_LEVEL &&
+         !bufferMgrs_[source_level][source_level == level ? deviceId : 0]->isBufferOnDevice(key)) {
+    --source_level;
+  }
+  const auto clock_begin = std::chrono::steady_clock::now();
+  auto buffer = bufferMgrs_[level][deviceId]->getBuffer(key, numBytes);
+  ++chunk_fetch_stats->chunks[source_level];
+  chunk_fetch_stats->bytes[source_level] += numBytes ? numBytes : buffer->size();
+  chunk_fetch_stats->us[source_level] +=
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clock_begin).count();
+  return buffer;
 }
 
 void DataMgr::deleteChunksWithPrefix(const ChunkKey& keyPrefix) {
@@ -397,14 +427,25 @@ void DataMgr::checkpoint() {
 
 void DataMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
   dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->removeTableRelatedDS(db_id, tb_id);
+  boost::filesystem::remove(getInsertLogPath(db_id, tb_id));
 }
 
 void DataMgr::setTableEpoch(const int db_id, const int tb_id, const int start_epoch) {
   dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->setTableEpoch(db_id, tb_id, start_epoch);
+  // the log would replay batches on top of the epoch the table has been rolled back to
+  boost::filesystem::remove(getInsertLogPath(db_id, tb_id));
 }
 
 size_t DataMgr::getTableEpoch(const int db_id, const int tb_id) {
   return dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->getTableEpoch(db_id, tb_id);
 }
 
+void DataMgr::setTablePageCompression(const int db_id, const int tb_id, const File_Namespace::PageCompression codec) {
+  dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->setTablePageCompression(db_id, tb_id, codec);
+}
+
+std::string DataMgr::getInsertLogPath(const int db_id, const int tb_id) const {
+  return dataDir_ + "/insert_logs/table_" + std::to_string(db_id) + "_" + std::to_string(tb_id) + ".log";
+}
+
 }  // Data_Namespace
@@ -25,6 +25,7 @@
 #include "AbstractBufferMgr.h"
 #include "BufferMgr/Buffer.h"
 #include "BufferMgr/BufferMgr.h"
+#include "FileMgr/PageCompression.h"
 #include "MemoryLevel.h"
 #include "../Shared/mapd_shared_mutex.h"
 
@@ -61,6 +62,24 @@ struct MemoryInfo {
   std::vector<MemoryData> nodeMemoryData;
 };
 
+// Chunks fetched by a thread, by the memory level which actually served them: a buffer manager
+// hit at the requested level, or a load from a level below it. Only collected while a
+// ChunkFetchStats::Scope with non-null stats is alive on the fetching thread.
+struct ChunkFetchStats {
+  size_t chunks[3]{0, 0, 0};  // indexed by memory level
+  size_t bytes[3]{0, 0, 0};
+  int64_t us[3]{0, 0, 0};
+
+  class Scope {
+   public:
+    explicit Scope(ChunkFetchStats* stats);
+    ~Scope();
+
+   private:
+    ChunkFetchStats* prev_stats_;
+  };
+};
+
 class DataMgr {
   friend class GlobalFileMgr;
 
@@ -104,6 +123,8 @@ class DataMgr {
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  void setTablePageCompression(const int db_id, const int tb_id, const File_Namespace::PageCompression codec);
+  std::string getInsertLogPath(const int db_id, const int tb_id) const;
 
   CudaMgr_Namespace::CudaMgr* cudaMgr_;
 
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    DiffEncoder.h
+ * @brief   Frame of reference encoding for ENCODING DIFF(n) integer and time columns.
+ *
+ * The chunk starts with an int64_t base followed by one n-bit signed offset from the base per
+ * row, the most negative offset marks a null. The base is the smallest value of the first batch
+ * appended to the chunk (0 if that batch is all nulls), so clustered values (timestamps,
+ * sequential ids) fit in a fraction of their logical width while every row stays addressable
+ * with a load and an add; see diff_fixed_width_int_decode in QueryEngine/DecodersImpl.h.
+ *
+ * A value too far from the base moves it: the chunk is re-encoded around a base which leaves the
+ * most room in the direction the values went. The values of a chunk can't span more than the
+ * 2^n - 1 non-null offsets; the fragmenter rejects a batch which doesn't fit before appending
+ * any of it.
+ */
+
+#ifndef DIFF_ENCODER_H
+#define DIFF_ENCODER_H
+
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <glog/logging.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <typename T, typename V>
+class DiffEncoder : public Encoder {
+ public:
+  DiffEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : Encoder(buffer),
+        base(0),
+        dataMin(std::numeric_limits<T>::max()),
+        dataMax(std::numeric_limits<T>::min()),
+        has_nulls(false) {}
+
+  ChunkMetadata appendData(int8_t*& srcData, const size_t numAppendElems) {
+    T* unencodedData = reinterpret_cast<T*>(srcData);
+    T batchMin;
+    T batchMax;
+    const bool batchHasValues = getRange(unencodedData, numAppendElems, batchMin, batchMax);
+    rewroteChunk = false;
+    if (buffer_->size() == 0) {
+      base = batchHasValues ? batchMin : 0;
+      buffer_->append(reinterpret_cast<int8_t*>(&base), sizeof(int64_t));
+    }
+    if (batchHasValues && (!fitsOffset(base, batchMin) || !fitsOffset(base, batchMax))) {
+      const bool chunkHasValues = dataMin <= dataMax;
+      const T newMin = chunkHasValues ? std::min(dataMin, batchMin) : batchMin;
+      const T newMax = chunkHasValues ? std::max(dataMax, batchMax) : batchMax;
+      int64_t newBase;
+      if (!chooseBase(newMin, newMax, !chunkHasValues || batchMax > dataMax, newBase)) {
+        throw std::runtime_error(
+            "Frame of reference encoding failed, the values of the chunk are too far apart for ENCODING DIFF(" +
+            std::to_string(8 * sizeof(V)) + ")");
+      }
+      rebase(newBase);
+    }
+    auto encodedData = std::unique_ptr<V[]>(new V[numAppendElems]);
+    for (size_t i = 0; i < numAppendElems; ++i) {
+      const T data = unencodedData[i];
+      encodedData[i] = std::numeric_limits<V>::min();
+      if (data == inline_int_null_value<T>()) {
+        has_nulls = true;
+        continue;
+      }
+      encodedData[i] = static_cast<V>(static_cast<int64_t>(data) - base);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+    numElems += numAppendElems;
+
+    buffer_->append(reinterpret_cast<int8_t*>(encodedData.get()), numAppendElems * sizeof(V));
+    ChunkMetadata chunkMetadata;
+    getMetadata(chunkMetadata);
+    srcData += numAppendElems * sizeof(T);
+    return chunkMetadata;
+  }
+
+  bool canAppendData(const int8_t* srcData, const size_t numAppendElems, const bool newChunk) const {
+    T batchMin;
+    T batchMax;
+    if (!getRange(reinterpret_cast<const T*>(srcData), numAppendElems, batchMin, batchMax)) {
+      return true;
+    }
+    const bool chunkHasValues = !newChunk && dataMin <= dataMax;
+    int64_t newBase;
+    return chooseBase(chunkHasValues ? std::min(dataMin, batchMin) : batchMin,
+                      chunkHasValues ? std::max(dataMax, batchMax) : batchMax,
+                      true,
+                      newBase);
+  }
+
+  bool appendRewroteChunk() const { return rewroteChunk; }
+
+  void getMetadata(ChunkMetadata& chunkMetadata) {
+    Encoder::getMetadata(chunkMetadata);  // call on parent class
+    chunkMetadata.fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  ChunkMetadata getMetadata(const SQLTypeInfo& ti) {
+    ChunkMetadata chunk_metadata{ti, 0, 0, ChunkStats{}};
+    chunk_metadata.fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) {
+    const auto that_typed = static_cast<const DiffEncoder<T, V>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) {
+    numElems = copyFromEncoder->numElems;
+    auto castedEncoder = reinterpret_cast<const DiffEncoder<T, V>*>(copyFromEncoder);
+    base = castedEncoder->base;
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&numElems, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+    fwrite((int8_t*)&base, sizeof(int64_t), 1, f);
+  }
+
+  void readMetadata(FILE* f) {
+    // assumes pointer is already in right place
+    fread((int8_t*)&numElems, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, 1, sizeof(T), f);
+    fread((int8_t*)&dataMax, 1, sizeof(T), f);
+    fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+    fread((int8_t*)&base, 1, sizeof(int64_t), f);
+  }
+  int64_t base;
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+
+ private:
+  // The smallest and largest non-null value, false if there's none.
+  static bool getRange(const T* unencodedData, const size_t numAppendElems, T& rangeMin, T& rangeMax) {
+    rangeMin = std::numeric_limits<T>::max();
+    rangeMax = std::numeric_limits<T>::min();
+    bool found{false};
+    for (size_t i = 0; i < numAppendElems; ++i) {
+      const T data = unencodedData[i];
+      if (data != inline_int_null_value<T>()) {
+        rangeMin = std::min(rangeMin, data);
+        rangeMax = std::max(rangeMax, data);
+        found = true;
+      }
+    }
+    return found;
+  }
+
+  // Any base in [rangeMax - max offset, rangeMin - min offset - 1] encodes the whole range. The
+  // largest one leaves the most room for bigger values, the smallest for smaller ones.
+  static bool chooseBase(const T rangeMin, const T rangeMax, const bool growsUp, int64_t& chunkBase) {
+    const uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(rangeMax)) - static_cast<int64_t>(rangeMin);
+    const uint64_t maxSpan = static_cast<uint64_t>(std::numeric_limits<V>::max()) -
+                             static_cast<int64_t>(std::numeric_limits<V>::min()) - 1;
+    if (span > maxSpan) {
+      return false;
+    }
+    const int64_t minOffset = static_cast<int64_t>(std::numeric_limits<V>::min()) + 1;
+    const int64_t maxOffset = std::numeric_limits<V>::max();
+    if (growsUp) {
+      chunkBase = rangeMin > std::numeric_limits<int64_t>::max() + minOffset ? std::numeric_limits<int64_t>::max()
+                                                                              : rangeMin - minOffset;
+    } else {
+      chunkBase = rangeMax < std::numeric_limits<int64_t>::min() + maxOffset ? std::numeric_limits<int64_t>::min()
+                                                                              : rangeMax - maxOffset;
+    }
+    return true;
+  }
+
+  // Re-encodes the offsets already in the chunk relative to a new base.
+  void rebase(const int64_t newBase) {
+    const size_t encodedBytes = buffer_->size() - sizeof(int64_t);
+    if (encodedBytes) {
+      std::vector<V> encodedData(encodedBytes / sizeof(V));
+      buffer_->read(reinterpret_cast<int8_t*>(&encodedData[0]), encodedBytes, sizeof(int64_t));
+      for (auto& offset : encodedData) {
+        if (offset != std::numeric_limits<V>::min()) {
+          offset = static_cast<V>(base + offset - newBase);
+        }
+      }
+      buffer_->write(reinterpret_cast<int8_t*>(&encodedData[0]), encodedBytes, sizeof(int64_t));
+      rewroteChunk = true;
+    }
+    base = newBase;
+    buffer_->write(reinterpret_cast<int8_t*>(&base), sizeof(int64_t), 0);
+  }
+
+  // The offset has to be representable and must not collide with the null sentinel.
+  static bool fitsOffset(const int64_t chunkBase, const T data) {
+    const int64_t value = data;
+    if ((chunkBase > 0 && value < std::numeric_limits<int64_t>::min() + chunkBase) ||
+        (chunkBase < 0 && value > std::numeric_limits<int64_t>::max() + chunkBase)) {
+      return false;
+    }
+    const int64_t offset = value - chunkBase;
+    return offset > std::numeric_limits<V>::min() && offset <= std::numeric_limits<V>::max();
+  }
+
+  bool rewroteChunk{false};
+};  // DiffEncoder
+
+#endif  // DIFF_ENCODER_H
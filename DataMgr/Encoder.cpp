@@ -17,6 +17,8 @@
 #include "Encoder.h"
 #include "NoneEncoder.h"
 #include "FixedLengthEncoder.h"
+#include "DiffEncoder.h"
+#include "RunLengthEncoder.h"
 #include "StringNoneEncoder.h"
 #include "ArrayNoneEncoder.h"
 #include <glog/logging.h>
@@ -140,6 +142,63 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer, const SQLTypeIn
       }  // switch (sqlType)
       break;
     }  // Case: kENCODING_FIXED
+    case kENCODING_DIFF: {
+      switch (sqlType.get_type()) {
+        case kSMALLINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int16_t, int8_t>(buffer);
+            default:
+              return 0;
+          }
+        }
+        case kINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int32_t, int8_t>(buffer);
+            case 16:
+              return new DiffEncoder<int32_t, int16_t>(buffer);
+            default:
+              return 0;
+          }
+        }
+        case kBIGINT:
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int64_t, int8_t>(buffer);
+            case 16:
+              return new DiffEncoder<int64_t, int16_t>(buffer);
+            case 32:
+              return new DiffEncoder<int64_t, int32_t>(buffer);
+            default:
+              return 0;
+          }
+        }
+        default:
+          return 0;
+      }
+      break;
+    }  // Case: kENCODING_DIFF
+    case kENCODING_RL: {
+      switch (sqlType.get_type()) {
+        case kSMALLINT:
+          return new RunLengthEncoder<int16_t>(buffer);
+        case kINT:
+          return new RunLengthEncoder<int32_t>(buffer);
+        case kBIGINT:
+          return new RunLengthEncoder<int64_t>(buffer);
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE:
+          return new RunLengthEncoder<time_t>(buffer);
+        default:
+          return 0;
+      }
+      break;
+    }  // Case: kENCODING_RL
     case kENCODING_DICT: {
       if (sqlType.get_type() == kARRAY) {
         CHECK(IS_STRING(sqlType.get_subtype()));
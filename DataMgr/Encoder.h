@@ -38,6 +38,14 @@ class Encoder {
   static Encoder* Create(Data_Namespace::AbstractBuffer* buffer, const SQLTypeInfo sqlType);
   Encoder(Data_Namespace::AbstractBuffer* buffer) : numElems(0), buffer_(buffer) {}
   virtual ChunkMetadata appendData(int8_t*& srcData, const size_t numAppendElems) = 0;
+  // Whether the chunk, or the empty chunk of a new fragment, can encode the next numAppendElems
+  // values. Checked for the whole batch before the fragmenter appends any column.
+  virtual bool canAppendData(const int8_t* srcData, const size_t numAppendElems, const bool newChunk) const {
+    return true;
+  }
+  // Whether the last appendData changed the chunk ahead of the appended bytes, copies of it cached
+  // at other memory levels can't be refreshed by fetching the new tail only.
+  virtual bool appendRewroteChunk() const { return false; }
   virtual void getMetadata(ChunkMetadata& chunkMetadata);
   // Only called from the executor for synthesized meta-information.
   virtual ChunkMetadata getMetadata(const SQLTypeInfo& ti);
@@ -25,6 +25,7 @@
 #include "FileMgr.h"
 #include <map>
 #include <glog/logging.h>
+#include <cstring>
 #include <thread>
 #include <future>
 
@@ -40,11 +41,12 @@ FileBuffer::FileBuffer(FileMgr* fm, const size_t pageSize, const ChunkKey& chunk
       fm_(fm),
       metadataPages_(METADATA_PAGE_SIZE),
       pageSize_(pageSize),
-      chunkKey_(chunkKey) {
+      chunkKey_(chunkKey),
+      pageCompression_(fm->getPageCompression()) {
   // Create a new FileBuffer
   CHECK(fm_);
   calcHeaderBuffer();
-  pageDataSize_ = pageSize_ - reservedHeaderSize_;
+  calcPageDataSize();
   //@todo reintroduce initialSize - need to develop easy way of
   // differentiating these pre-allocated pages from "written-to" pages
   /*
@@ -69,10 +71,11 @@ FileBuffer::FileBuffer(FileMgr* fm,
       fm_(fm),
       metadataPages_(METADATA_PAGE_SIZE),
       pageSize_(pageSize),
-      chunkKey_(chunkKey) {
+      chunkKey_(chunkKey),
+      pageCompression_(fm->getPageCompression()) {
   CHECK(fm_);
   calcHeaderBuffer();
-  pageDataSize_ = pageSize_ - reservedHeaderSize_;
+  calcPageDataSize();
 }
 
 FileBuffer::FileBuffer(FileMgr* fm,
@@ -83,7 +86,8 @@ FileBuffer::FileBuffer(FileMgr* fm,
       fm_(fm),
       metadataPages_(METADATA_PAGE_SIZE),
       pageSize_(0),
-      chunkKey_(chunkKey) {
+      chunkKey_(chunkKey),
+      pageCompression_(PageCompression::NONE) {
   // We are being assigned an existing FileBuffer on disk
 
   CHECK(fm_);
@@ -108,7 +112,7 @@ FileBuffer::FileBuffer(FileMgr* fm,
           // If we are on first real page
           CHECK(metadataPages_.pageVersions.back().fileId != -1);  // was initialized
           readMetadata(metadataPages_.pageVersions.back());
-          pageDataSize_ = pageSize_ - reservedHeaderSize_;
+          calcPageDataSize();
         }
         MultiPage multiPage(pageSize_);
         multiPages_.push_back(multiPage);
@@ -119,7 +123,7 @@ FileBuffer::FileBuffer(FileMgr* fm,
     }
     if (curPageId == -1) {  // meaning there was only a metadata page
       readMetadata(metadataPages_.pageVersions.back());
-      pageDataSize_ = pageSize_ - reservedHeaderSize_;
+      calcPageDataSize();
     }
   }
   // auto lastHeaderIt = std::prev(headerEndIt);
@@ -154,6 +158,11 @@ void FileBuffer::calcHeaderBuffer() {
   // pageDataSize_ = pageSize_-reservedHeaderSize_;
 }
 
+void FileBuffer::calcPageDataSize() {
+  // the data portion of compressed pages starts with the size of the stored content
+  pageDataSize_ = pageSize_ - reservedHeaderSize_ - (isCompressed() ? sizeof(int32_t) : 0);
+}
+
 void FileBuffer::freePages() {
   // Need to zero headers (actually just first four bytes of header)
 
@@ -203,7 +212,12 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
     // Read the page into the destination (dst) buffer at its
     // current (cur) location
     size_t bytesRead = 0;
-    if (isFirstPage) {
+    if (fileBuffer->isCompressed()) {
+      const size_t pageOffset = isFirstPage ? threadDS.t_startPageOffset : 0;
+      bytesRead = fileBuffer->readCompressedPage(
+          page, pageOffset, min(fileBuffer->pageDataSize() - pageOffset, bytesLeft), curPtr);
+      isFirstPage = false;
+    } else if (isFirstPage) {
       bytesRead = fileInfo->read(
           page.pageNum * fileBuffer->pageSize() + threadDS.t_startPageOffset + fileBuffer->reservedHeaderSize(),
           min(fileBuffer->pageDataSize() - threadDS.t_startPageOffset, bytesLeft),
@@ -320,6 +334,99 @@ void FileBuffer::read(int8_t* const dst,
   CHECK(bytesRead == numBytes);
 }
 
+size_t FileBuffer::readCompressedPage(const Page& page, const size_t offset, const size_t numBytes, int8_t* dst) {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  CHECK(fileInfo);
+  const size_t pageDataOffset = page.pageNum * pageSize_ + reservedHeaderSize_;
+  int32_t storedSize{0};
+  fileInfo->read(pageDataOffset, sizeof(int32_t), reinterpret_cast<int8_t*>(&storedSize));
+  if (!storedSize) {
+    return fileInfo->read(pageDataOffset + sizeof(int32_t) + offset, numBytes, dst);
+  }
+  CHECK_GT(storedSize, 0);
+  CHECK_LE(static_cast<size_t>(storedSize), pageDataSize_);
+  std::vector<int8_t> stored(storedSize);
+  fileInfo->read(pageDataOffset + sizeof(int32_t), storedSize, &stored[0]);
+  if (!offset && numBytes == pageDataSize_) {
+    // whole page, decompress straight into the destination
+    CHECK_EQ(numBytes, decompress_page(pageCompression_, &stored[0], storedSize, dst, numBytes));
+    return numBytes;
+  }
+  std::vector<int8_t> content(pageDataSize_);
+  const auto contentSize = decompress_page(pageCompression_, &stored[0], storedSize, &content[0], content.size());
+  CHECK_LE(offset + numBytes, contentSize);
+  std::memcpy(dst, &content[offset], numBytes);
+  return numBytes;
+}
+
+void FileBuffer::writeCompressedPage(const Page& page,
+                                     const int8_t* content,
+                                     const size_t contentSize,
+                                     int8_t* scratch) {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  CHECK(fileInfo);
+  const size_t typeSize = hasEncoder && sqlType.get_size() > 0 ? sqlType.get_size() : 1;
+  int32_t storedSize = compress_page(pageCompression_, content, contentSize, scratch, typeSize);
+  const size_t pageDataOffset = page.pageNum * pageSize_ + reservedHeaderSize_;
+  fileInfo->write(pageDataOffset, sizeof(int32_t), reinterpret_cast<int8_t*>(&storedSize));
+  if (storedSize) {
+    fileInfo->write(pageDataOffset + sizeof(int32_t), storedSize, scratch);
+  } else {
+    fileInfo->write(pageDataOffset + sizeof(int32_t), contentSize, const_cast<int8_t*>(content));
+  }
+}
+
+void FileBuffer::writeCompressed(int8_t* src, const size_t numBytes, const size_t offset, const size_t oldSize) {
+  const size_t startPage = offset / pageDataSize_;
+  const size_t endPage = (offset + numBytes + pageDataSize_ - 1) / pageDataSize_;
+  const int epoch = fm_->epoch();
+  for (size_t pageNum = multiPages_.size(); pageNum < startPage; ++pageNum) {
+    Page page = addNewMultiPage(epoch);
+    writeHeader(page, pageNum, epoch);
+    // no content is written to a gap page, but its stored size must not be whatever the free page held
+    int32_t storedSize{0};
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    CHECK(fileInfo);
+    fileInfo->write(
+        page.pageNum * pageSize_ + reservedHeaderSize_, sizeof(int32_t), reinterpret_cast<int8_t*>(&storedSize));
+  }
+  std::vector<int8_t> content(pageDataSize_, 0);
+  std::vector<int8_t> scratch(pageDataSize_);
+  int8_t* curPtr = src;
+  for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
+    const size_t pageStart = pageNum * pageDataSize_;
+    const size_t writeStart = max(offset, pageStart) - pageStart;
+    const size_t writeEnd = min(offset + numBytes, pageStart + pageDataSize_) - pageStart;
+    const size_t oldContentSize = oldSize > pageStart ? min(oldSize - pageStart, pageDataSize_) : 0;
+    const size_t contentSize = max(oldContentSize, writeEnd);
+    // the content which isn't overwritten is carried over from the current version of the page
+    if (pageNum < multiPages_.size() && oldContentSize && (writeStart > 0 || writeEnd < oldContentSize)) {
+      readCompressedPage(multiPages_[pageNum].current(), 0, oldContentSize, &content[0]);
+    }
+    if (writeStart > oldContentSize) {
+      std::fill(content.begin() + oldContentSize, content.begin() + writeStart, 0);
+    }
+    std::memcpy(&content[writeStart], curPtr, writeEnd - writeStart);
+    curPtr += writeEnd - writeStart;
+    Page page;
+    if (pageNum >= multiPages_.size()) {
+      page = addNewMultiPage(epoch);
+      writeHeader(page, pageNum, epoch);
+    } else if (multiPages_[pageNum].epochs.back() < epoch) {
+      // the page is rewritten as a whole, don't touch the checkpointed version
+      page = fm_->requestFreePage(pageSize_, false);
+      multiPages_[pageNum].epochs.push_back(epoch);
+      multiPages_[pageNum].pageVersions.push_back(page);
+      writeHeader(page, pageNum, epoch);
+    } else {
+      page = multiPages_[pageNum].current();
+    }
+    CHECK(page.fileId >= 0);  // make sure page was initialized
+    writeCompressedPage(page, &content[0], contentSize, &scratch[0]);
+  }
+  CHECK(curPtr == src + numBytes);
+}
+
 void FileBuffer::copyPage(Page& srcPage, Page& destPage, const size_t numBytes, const size_t offset) {
   // FILE *srcFile = fm_->files_[srcPage.fileId]->f;
   // FILE *destFile = fm_->files_[destPage.fileId]->f;
@@ -366,9 +473,12 @@ void FileBuffer::readMetadata(const Page& page) {
   fread((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(
       NUM_METADATA);  // assumes we will encode hasEncoder, bufferType, encodingType, encodingBits all as int
-  fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
+  fread((int8_t*)&(typeData[0]), sizeof(int), 1, f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK(version == 0 || version == METADATA_VERSION);  // add backward compatibility code here
+  // version 0 predates page compression, which is the last field
+  fread((int8_t*)&(typeData[1]), sizeof(int), (version == 0 ? NUM_METADATA - 1 : NUM_METADATA) - 1, f);
+  pageCompression_ = static_cast<PageCompression>(typeData[10]);
   hasEncoder = static_cast<bool>(typeData[1]);
   if (hasEncoder) {
     sqlType.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -407,6 +517,7 @@ void FileBuffer::writeMetadata(const int epoch) {
     typeData[8] = sqlType.get_comp_param();
     typeData[9] = sqlType.get_size();
   }
+  typeData[10] = static_cast<int>(pageCompression_);
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   if (hasEncoder) {  // redundant
     encoder->writeMetadata(f);
@@ -431,6 +542,13 @@ void FileBuffer::append(int8_t* src, const size_t numBytes, const MemoryLevel sr
   isDirty_ = true;
   isAppended_ = true;
 
+  if (isCompressed()) {
+    const size_t oldSize = size_;
+    size_ += numBytes;
+    writeCompressed(src, numBytes, oldSize, oldSize);
+    return;
+  }
+
   size_t startPage = size_ / pageDataSize_;
   size_t startPageOffset = size_ % pageDataSize_;
   size_t numPagesToWrite = (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
@@ -479,6 +597,7 @@ void FileBuffer::write(int8_t* src,
     isUpdated_ = true;
   }
   bool tempIsAppended = false;
+  const size_t oldSize = size_;
 
   if (offset + numBytes > size_) {
     tempIsAppended = true;  // because isAppended_ could have already been true - to avoid rewriting header
@@ -486,6 +605,11 @@ void FileBuffer::write(int8_t* src,
     size_ = offset + numBytes;
   }
 
+  if (isCompressed()) {
+    writeCompressed(src, numBytes, offset, oldSize);
+    return;
+  }
+
   size_t startPage = offset / pageDataSize_;
   size_t startPageOffset = offset % pageDataSize_;
   size_t numPagesToWrite = (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
@@ -25,14 +25,15 @@
 
 #include "../AbstractBuffer.h"
 #include "Page.h"
+#include "PageCompression.h"
 
 #include <iostream>
 #include <stdexcept>
 
 using namespace Data_Namespace;
 
-#define NUM_METADATA 10
-#define METADATA_VERSION 0
+#define NUM_METADATA 11
+#define METADATA_VERSION 1
 
 namespace File_Namespace {
 
@@ -135,6 +136,18 @@ class FileBuffer : public AbstractBuffer {
   /// Returns whether or not the FileBuffer has been modified since the last flush/checkpoint.
   virtual bool isDirty() const { return isDirty_; }
 
+  /// Returns whether the pages of the FileBuffer are written through a PAGE_COMPRESSION codec.
+  inline bool isCompressed() const { return pageCompression_ != PageCompression::NONE; }
+
+  /**
+   * @brief Reads numBytes of the content of a compressed page, starting at offset, into dst.
+   *
+   * The data portion of a compressed page starts with the int32_t size of the compressed content
+   * which follows it, 0 if the content didn't compress and has been stored as is. Only the stored
+   * bytes are read from disk; called from the FileMgr reader threads.
+   */
+  size_t readCompressedPage(const Page& page, const size_t offset, const size_t numBytes, int8_t* dst);
+
  private:
   // FileBuffer(const FileBuffer&);      // private copy constructor
   // FileBuffer& operator=(const FileBuffer&); // private overloaded assignment operator
@@ -146,6 +159,11 @@ class FileBuffer : public AbstractBuffer {
   void writeMetadata(const int epoch);
   void readMetadata(const Page& page);
   void calcHeaderBuffer();
+  void calcPageDataSize();
+
+  /// Writes numBytes of src at offset through the codec; every page touched is rewritten as a whole.
+  void writeCompressed(int8_t* src, const size_t numBytes, const size_t offset, const size_t oldSize);
+  void writeCompressedPage(const Page& page, const int8_t* content, const size_t contentSize, int8_t* scratch);
 
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available files
   static size_t headerBufferOffset_;
@@ -155,6 +173,7 @@ class FileBuffer : public AbstractBuffer {
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
   ChunkKey chunkKey_;
+  PageCompression pageCompression_;  // set at creation from the FileMgr, read back from the metadata page
 };
 
 }  // File_Namespace
@@ -70,7 +70,8 @@ FileMgr::FileMgr(const int deviceId,
       fileMgrKey_(fileMgrKey),
       defaultPageSize_(defaultPageSize),
       nextFileId_(0),
-      epoch_(epoch) {
+      epoch_(epoch),
+      pageCompression_(PageCompression::NONE) {
   init(num_reader_threads);
 }
 
@@ -81,7 +82,8 @@ FileMgr::FileMgr(GlobalFileMgr* gfm, const size_t defaultPageSize, std::string b
       fileMgrBasePath_(basePath),
       defaultPageSize_(defaultPageSize),
       nextFileId_(0),
-      epoch_(-1) {
+      epoch_(-1),
+      pageCompression_(PageCompression::NONE) {
   init(basePath);
 }
 
@@ -725,7 +727,7 @@ Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   int pageNum = -1;
   for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
-    FileInfo* fileInfo = files_[fileIt->second];
+    FileInfo* fileInfo = getFileInfoForFileId(fileIt->second);
     pageNum = fileInfo->getFreePage();
     if (pageNum != -1) {
       return (Page(fileInfo->fileId, pageNum));
@@ -753,7 +755,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   size_t numPagesNeeded = numPagesRequested;
   for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
-    FileInfo* fileInfo = files_[fileIt->second];
+    FileInfo* fileInfo = getFileInfoForFileId(fileIt->second);
     int pageNum;
     do {
       pageNum = fileInfo->getFreePage();
@@ -835,7 +837,7 @@ FileInfo* FileMgr::createFile(const size_t pageSize, const size_t numPages) {
 
 FILE* FileMgr::getFileForFileId(const int fileId) {
   assert(fileId >= 0);
-  return files_[fileId]->f;
+  return getFileInfoForFileId(fileId)->f;
 }
 /*
 void FileMgr::getAllChunkMetaInfo(std::vector<std::pair<ChunkKey, int64_t> > &metadata) {
@@ -141,7 +141,11 @@ class FileMgr : public AbstractBufferMgr {  // implements
   virtual inline size_t getAllocated() { return 0; }
   virtual inline bool isAllocationCapped() { return false; }
 
-  inline FileInfo* getFileInfoForFileId(const int fileId) { return files_[fileId]; }
+  // createFile can grow files_ while the per-column appends of an insert read it
+  inline FileInfo* getFileInfoForFileId(const int fileId) {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
+    return files_[fileId];
+  }
 
   void init(const size_t num_reader_threads);
   void init(const std::string dataPathToConvertFrom);
@@ -192,6 +196,13 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /**
+   * @brief Codec of the buffers created from now on, existing buffers keep the one
+   * recorded in their metadata page.
+   */
+  inline PageCompression getPageCompression() const { return pageCompression_; }
+  inline void setPageCompression(const PageCompression codec) { pageCompression_ = codec; }
+
   /**
    * @brief Returns FILE pointer associated with
    * requested fileId
@@ -226,6 +237,7 @@ class FileMgr : public AbstractBufferMgr {  // implements
   size_t defaultPageSize_;
   unsigned nextFileId_;  /// the index of the next file id
   int epoch_;            /// the current epoch (time of last checkpoint)
+  PageCompression pageCompression_;  /// PAGE_COMPRESSION option of the table
   FILE* epochFile_;
   int db_version_;    /// DB version from dbmeta file, should be compatible with GlobalFileMgr::mapd_db_version_
   FILE* DBMetaFile_;  /// pointer to DB level metadata
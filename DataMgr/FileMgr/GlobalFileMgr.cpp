@@ -152,6 +152,10 @@ FileMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
       return it->second;
     }
     FileMgr* fm = new FileMgr(0, this, file_mgr_key, num_reader_threads_, epoch_, defaultPageSize_);
+    auto codec_it = tablePageCompression_.find(file_mgr_key);
+    if (codec_it != tablePageCompression_.end()) {
+      fm->setPageCompression(codec_it->second);
+    }
     auto it_ok = fileMgrs_.insert(std::make_pair(file_mgr_key, fm));
     CHECK(it_ok.second);
 
@@ -180,6 +184,10 @@ void GlobalFileMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
   fm->closeRemovePhysical();
   /* remove table related in-memory DS only if directory was removed successfully */
   delete fm;
+  {
+    mapd_lock_guard<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
+    tablePageCompression_.erase(std::make_pair(db_id, tb_id));
+  }
 }
 
 void GlobalFileMgr::setTableEpoch(const int db_id, const int tb_id, const int start_epoch) {
@@ -205,4 +213,14 @@ size_t GlobalFileMgr::getTableEpoch(const int db_id, const int tb_id) {
   return fm->epoch_;
 }
 
+void GlobalFileMgr::setTablePageCompression(const int db_id, const int tb_id, const PageCompression codec) {
+  const auto file_mgr_key = std::make_pair(db_id, tb_id);
+  mapd_lock_guard<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
+  tablePageCompression_[file_mgr_key] = codec;
+  auto it = fileMgrs_.find(file_mgr_key);
+  if (it != fileMgrs_.end()) {
+    it->second->setPageCompression(codec);
+  }
+}
+
 }  // File_Namespace
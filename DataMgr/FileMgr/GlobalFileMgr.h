@@ -145,6 +145,7 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  void setTablePageCompression(const int db_id, const int tb_id, const PageCompression codec);
 
  private:
   std::string basePath_;       /// The OS file system path containing the files.
@@ -162,6 +163,7 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
                           */
   bool dbConvert_;       /// true if conversion should be done between different "mapd_db_version_"
   std::map<std::pair<int, int>, FileMgr*> fileMgrs_;
+  std::map<std::pair<int, int>, PageCompression> tablePageCompression_;  /// applied to FileMgrs as they're created
   mapd_shared_mutex fileMgrs_mutex_;
 };
 
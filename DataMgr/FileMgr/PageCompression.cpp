@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PageCompression.h"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <glog/logging.h>
+#include <zlib.h>
+#ifdef HAVE_BLOSC
+#include <blosc.h>
+#endif  // HAVE_BLOSC
+
+#include <stdexcept>
+
+namespace File_Namespace {
+
+namespace {
+
+#ifdef HAVE_BLOSC
+const char* blosc_compressor_name(const PageCompression codec) {
+  switch (codec) {
+    case PageCompression::LZ4:
+      return "lz4";
+    case PageCompression::ZSTD:
+      return "zstd";
+    default:
+      CHECK(false);
+  }
+  return nullptr;
+}
+#endif  // HAVE_BLOSC
+
+}  // namespace
+
+bool is_page_compression_available(const PageCompression codec) {
+  switch (codec) {
+    case PageCompression::NONE:
+    case PageCompression::ZLIB:
+      return true;
+    case PageCompression::LZ4:
+    case PageCompression::ZSTD:
+#ifdef HAVE_BLOSC
+      return blosc_compname_to_compcode(blosc_compressor_name(codec)) >= 0;
+#else
+      return false;
+#endif  // HAVE_BLOSC
+    default:
+      return false;
+  }
+}
+
+PageCompression page_compression_from_string(const std::string& codec_name) {
+  const auto codec_name_uc = boost::algorithm::to_upper_copy(codec_name);
+  PageCompression codec{PageCompression::NONE};
+  if (codec_name_uc == "ZLIB") {
+    codec = PageCompression::ZLIB;
+  } else if (codec_name_uc == "LZ4") {
+    codec = PageCompression::LZ4;
+  } else if (codec_name_uc == "ZSTD") {
+    codec = PageCompression::ZSTD;
+  } else if (codec_name_uc != "NONE") {
+    throw std::runtime_error("PAGE_COMPRESSION must be NONE, ZLIB, LZ4 or ZSTD.");
+  }
+  if (!is_page_compression_available(codec)) {
+    throw std::runtime_error("PAGE_COMPRESSION " + codec_name_uc + " is not supported by this build.");
+  }
+  return codec;
+}
+
+size_t compress_page(const PageCompression codec,
+                     const int8_t* src,
+                     const size_t src_size,
+                     int8_t* dst,
+                     const size_t type_size) {
+  switch (codec) {
+    case PageCompression::ZLIB: {
+      uLongf dst_size = src_size;
+      // favor speed, the pages are compressed on every append to them
+      const auto err = compress2(reinterpret_cast<Bytef*>(dst),
+                                 &dst_size,
+                                 reinterpret_cast<const Bytef*>(src),
+                                 src_size,
+                                 Z_BEST_SPEED);
+      if (err != Z_OK) {
+        CHECK_EQ(Z_BUF_ERROR, err);
+        return 0;
+      }
+      return dst_size < src_size ? dst_size : 0;
+    }
+#ifdef HAVE_BLOSC
+    case PageCompression::LZ4:
+    case PageCompression::ZSTD: {
+      const auto dst_size = blosc_compress_ctx(
+          5, BLOSC_SHUFFLE, type_size, src_size, src, dst, src_size, blosc_compressor_name(codec), 0, 1);
+      CHECK_GE(dst_size, 0);
+      return static_cast<size_t>(dst_size) < src_size ? dst_size : 0;
+    }
+#endif  // HAVE_BLOSC
+    default:
+      CHECK(false);
+  }
+  return 0;
+}
+
+size_t decompress_page(const PageCompression codec,
+                       const int8_t* src,
+                       const size_t src_size,
+                       int8_t* dst,
+                       const size_t dst_capacity) {
+  switch (codec) {
+    case PageCompression::ZLIB: {
+      uLongf dst_size = dst_capacity;
+      const auto err =
+          uncompress(reinterpret_cast<Bytef*>(dst), &dst_size, reinterpret_cast<const Bytef*>(src), src_size);
+      if (err != Z_OK) {
+        LOG(FATAL) << "Failure decompressing a page, zlib error " << err;
+      }
+      return dst_size;
+    }
+#ifdef HAVE_BLOSC
+    case PageCompression::LZ4:
+    case PageCompression::ZSTD: {
+      const auto dst_size = blosc_decompress_ctx(src, dst, dst_capacity, 1);
+      if (dst_size <= 0) {
+        LOG(FATAL) << "Failure decompressing a page, blosc error " << dst_size;
+      }
+      return dst_size;
+    }
+#endif  // HAVE_BLOSC
+    default:
+      LOG(FATAL) << "Page compressed with codec " << static_cast<int>(codec) << ", which this build doesn't support";
+  }
+  return 0;
+}
+
+}  // namespace File_Namespace
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    PageCompression.h
+ * @brief   Codecs for the PAGE_COMPRESSION table option, applied by FileBuffer to every page it writes.
+ *
+ * ZLIB is always available since zlib is a required dependency. LZ4 and ZSTD go through blosc, which
+ * also byte-shuffles fixed width values before compressing them; they're available if the server was
+ * built with blosc (HAVE_BLOSC) and blosc was built with the codec.
+ */
+
+#ifndef DATAMGR_FILE_PAGECOMPRESSION_H
+#define DATAMGR_FILE_PAGECOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace File_Namespace {
+
+// Persisted in the catalog and in the metadata page of every buffer, don't renumber.
+enum class PageCompression { NONE = 0, ZLIB = 1, LZ4 = 2, ZSTD = 3 };
+
+bool is_page_compression_available(const PageCompression codec);
+
+// Parses the value of the PAGE_COMPRESSION option, throws for unknown or unavailable codecs.
+PageCompression page_compression_from_string(const std::string& codec_name);
+
+// Compresses src_size bytes of src into dst. Returns the compressed size, or 0 if the result wouldn't
+// be smaller than the input; the page is stored uncompressed in that case. dst must hold src_size bytes.
+size_t compress_page(const PageCompression codec,
+                     const int8_t* src,
+                     const size_t src_size,
+                     int8_t* dst,
+                     const size_t type_size);
+
+// Decompresses a page written by compress_page into dst, returns the size of the page content.
+size_t decompress_page(const PageCompression codec,
+                       const int8_t* src,
+                       const size_t src_size,
+                       int8_t* dst,
+                       const size_t dst_capacity);
+
+}  // namespace File_Namespace
+
+#endif  // DATAMGR_FILE_PAGECOMPRESSION_H
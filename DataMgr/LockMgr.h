@@ -18,6 +18,7 @@
 #define LOCKMGR_H
 
 #include "Shared/types.h"
+#include "Shared/lock_wait_stats.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Catalog/Catalog.h"
 
@@ -63,6 +64,26 @@ std::shared_ptr<MutexType> LockMgr<MutexType, KeyType>::getMutex(const LockType
   return tMutex;
 }
 
+inline LockWaitSite getLockWaitSite(const LockType lock_type) {
+  switch (lock_type) {
+    case TableMetadataLock:
+      return LockWaitSite::TABLE_METADATA_LOCK;
+    case CheckpointLock:
+      return LockWaitSite::CHECKPOINT_LOCK;
+    case UpdateDeleteLock:
+      return LockWaitSite::UPDATE_DELETE_LOCK;
+    default:
+      return LockWaitSite::EXECUTOR_OUTER_LOCK;
+  }
+}
+
+// The one executor wide lock: shared by queries, exclusive for statements which can't run next to them.
+template <template <typename> class LockType>
+LockType<mapd_shared_mutex> getExecutorOuterLock() {
+  return timed_lock<LockType<mapd_shared_mutex>>(*LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true),
+                                                 LockWaitSite::EXECUTOR_OUTER_LOCK);
+}
+
 ChunkKey getTableChunkKey(const Catalog_Namespace::Catalog& cat, const std::string& tableName);
 void getTableNames(std::map<std::string, bool>& tableNames, const Value& value);
 void getTableNames(std::map<std::string, bool>& tableNames, const std::string query_ra);
@@ -81,7 +102,8 @@ template <typename MutexType, template <typename> class LockType>
 LockType<MutexType> getTableLock(const Catalog_Namespace::Catalog& cat,
                                  const std::string& tableName,
                                  const Lock_Namespace::LockType lockType) {
-  auto lock = LockType<MutexType>(*getTableMutex<MutexType>(cat, tableName, lockType));
+  auto lock = timed_lock<LockType<MutexType>>(*getTableMutex<MutexType>(cat, tableName, lockType),
+                                              getLockWaitSite(lockType));
   // "... we need to make sure that the table (and after alter column) the columns are still around after obtaining our
   // locks ..."
   auto chunkKey = getTableChunkKey(cat, tableName);
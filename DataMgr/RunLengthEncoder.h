@@ -0,0 +1,164 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    RunLengthEncoder.h
+ * @brief   Run length encoding for ENCODING RL integer and time columns.
+ *
+ * The chunk is an array of int64_t: the run count, then for every run the row one past its end
+ * and its value, nulls stored as the logical null. Decoding a row is a binary search over the run
+ * ends, see run_length_int_decode in QueryEngine/DecodersImpl.h.
+ *
+ * An append reads the run count and the last run, which the first new rows may extend, and
+ * writes them back together with the new runs; the rest of the chunk isn't touched. The count and
+ * the last run sit ahead of the appended bytes though, so cached copies of the chunk at other
+ * memory levels can't be refreshed by fetching the new tail only; the fragmenter drops them after
+ * every append.
+ */
+
+#ifndef RUN_LENGTH_ENCODER_H
+#define RUN_LENGTH_ENCODER_H
+
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <vector>
+
+template <typename T>
+class RunLengthEncoder : public Encoder {
+ public:
+  RunLengthEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : Encoder(buffer),
+        dataMin(std::numeric_limits<T>::max()),
+        dataMax(std::numeric_limits<T>::min()),
+        has_nulls(false) {}
+
+  ChunkMetadata appendData(int8_t*& srcData, const size_t numAppendElems) {
+    T* unencodedData = reinterpret_cast<T*>(srcData);
+    int64_t runCount{0};
+    std::vector<int64_t> tailRuns;  // the last run of the chunk, then the new ones
+    if (buffer_->size()) {
+      buffer_->read(reinterpret_cast<int8_t*>(&runCount), sizeof(int64_t));
+    }
+    const size_t tailOffset = sizeof(int64_t) * (runCount ? 2 * runCount - 1 : 1);
+    if (runCount) {
+      tailRuns.resize(2);
+      buffer_->read(reinterpret_cast<int8_t*>(&tailRuns[0]), 2 * sizeof(int64_t), tailOffset);
+    }
+    for (size_t i = 0; i < numAppendElems; ++i) {
+      const T data = unencodedData[i];
+      if (data == inline_int_null_value<T>()) {
+        has_nulls = true;
+      } else {
+        dataMin = std::min(dataMin, data);
+        dataMax = std::max(dataMax, data);
+      }
+      const int64_t row_end = numElems + i + 1;
+      if (!tailRuns.empty() && tailRuns.back() == data) {
+        tailRuns[tailRuns.size() - 2] = row_end;
+      } else {
+        tailRuns.push_back(row_end);
+        tailRuns.push_back(data);
+        ++runCount;
+      }
+    }
+    numElems += numAppendElems;
+
+    buffer_->write(reinterpret_cast<int8_t*>(&runCount), sizeof(int64_t), 0);
+    if (!tailRuns.empty()) {
+      buffer_->write(reinterpret_cast<int8_t*>(&tailRuns[0]), tailRuns.size() * sizeof(int64_t), tailOffset);
+    }
+    ChunkMetadata chunkMetadata;
+    getMetadata(chunkMetadata);
+    srcData += numAppendElems * sizeof(T);
+    return chunkMetadata;
+  }
+
+  bool appendRewroteChunk() const { return true; }
+
+  void getMetadata(ChunkMetadata& chunkMetadata) {
+    Encoder::getMetadata(chunkMetadata);  // call on parent class
+    chunkMetadata.fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  ChunkMetadata getMetadata(const SQLTypeInfo& ti) {
+    ChunkMetadata chunk_metadata{ti, 0, 0, ChunkStats{}};
+    chunk_metadata.fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) {
+    const auto that_typed = static_cast<const RunLengthEncoder<T>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) {
+    numElems = copyFromEncoder->numElems;
+    auto castedEncoder = reinterpret_cast<const RunLengthEncoder<T>*>(copyFromEncoder);
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&numElems, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  void readMetadata(FILE* f) {
+    // assumes pointer is already in right place
+    fread((int8_t*)&numElems, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, 1, sizeof(T), f);
+    fread((int8_t*)&dataMax, 1, sizeof(T), f);
+    fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+  }
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+};  // RunLengthEncoder
+
+#endif  // RUN_LENGTH_ENCODER_H
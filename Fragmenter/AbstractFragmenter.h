@@ -72,6 +72,13 @@ class AbstractFragmenter {
   // virtual void getFragmentsForQuery(QueryInfo &queryInfo, const void *predicate = 0) = 0;
   virtual TableInfo getFragmentsForQuery() = 0;
 
+  /**
+   * @brief Same fragments as getFragmentsForQuery, shared by all the readers
+   * until the next change of the table. Holding the pointer pins the metadata.
+   */
+
+  virtual std::shared_ptr<const TableInfo> getFragmentsSnapshot() = 0;
+
   /**
    * @brief Given data wrapped in an InsertData struct,
    * inserts it into the correct partitions
@@ -17,10 +17,13 @@
 #ifndef FRAGMENTER_H
 #define FRAGMENTER_H
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <deque>
 #include <list>
 #include <mutex>
+#include <vector>
 #include "../Shared/types.h"
 #include "../Shared/mapd_shared_mutex.h"
 #include "../DataMgr/ChunkMetadata.h"
@@ -63,11 +66,81 @@ struct InsertData {
   std::vector<DataBlockPtr> data;  /// points to the start of the data block per column for the row(s) being inserted
 };
 
+/**
+ * @class ChunkMetadataMap
+ * @brief Chunk metadata of a fragment by column id, kept in flat arrays: the entries
+ * sorted by column id and an index from column id to entry. Same lookup interface
+ * as the std::map it replaces, without chasing tree nodes.
+ */
+
+class ChunkMetadataMap {
+ public:
+  typedef std::pair<int, ChunkMetadata> value_type;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  ChunkMetadataMap() {}
+
+  explicit ChunkMetadataMap(const std::map<int, ChunkMetadata>& chunkMetadataMap) {
+    entries_.assign(chunkMetadataMap.begin(), chunkMetadataMap.end());
+    reindex(0);
+  }
+
+  const_iterator begin() const { return entries_.begin(); }
+
+  const_iterator end() const { return entries_.end(); }
+
+  size_t size() const { return entries_.size(); }
+
+  bool empty() const { return entries_.empty(); }
+
+  const_iterator find(const int col) const {
+    if (col < 0 || static_cast<size_t>(col) >= index_.size() || index_[col] < 0) {
+      return entries_.end();
+    }
+    return entries_.begin() + index_[col];
+  }
+
+  size_t count(const int col) const { return find(col) == end() ? 0 : 1; }
+
+  void set(const int col, const ChunkMetadata& chunkMetadata) {
+    const auto it = find(col);
+    if (it != end()) {
+      entries_[it - begin()].second = chunkMetadata;
+      return;
+    }
+    const auto pos = std::lower_bound(entries_.begin(),
+                                      entries_.end(),
+                                      col,
+                                      [](const value_type& entry, const int col) { return entry.first < col; }) -
+                     entries_.begin();
+    entries_.insert(entries_.begin() + pos, std::make_pair(col, chunkMetadata));
+    reindex(pos);
+  }
+
+  std::map<int, ChunkMetadata> toMap() const { return std::map<int, ChunkMetadata>(entries_.begin(), entries_.end()); }
+
+ private:
+  void reindex(const size_t startPos) {
+    if (!entries_.empty() && static_cast<size_t>(entries_.back().first) >= index_.size()) {
+      index_.resize(entries_.back().first + 1, -1);
+    }
+    for (size_t pos = startPos; pos < entries_.size(); ++pos) {
+      index_[entries_[pos].first] = pos;
+    }
+  }
+
+  std::vector<value_type> entries_;  // sorted by column id
+  std::vector<int32_t> index_;       // column id to position in entries_, -1 if the column has no entry
+};
+
 /**
  * @class FragmentInfo
  * @brief Used by Fragmenter classes to store info about each
  * fragment - the fragment id and number of tuples(rows)
  * currently stored by that fragment
+ *
+ * Copies of a fragment share its chunk metadata, the fragmenter replaces rather than
+ * modifies metadata other copies can see, so a copy keeps the metadata it was taken with.
  */
 
 class FragmentInfo {
@@ -83,14 +156,24 @@ class FragmentInfo {
         synthesizedMetadataIsValid(false) {}
 
   void setChunkMetadataMap(const std::map<int, ChunkMetadata>& chunkMetadataMap) {
-    this->chunkMetadataMap = chunkMetadataMap;
+    this->chunkMetadataMap = std::make_shared<ChunkMetadataMap>(chunkMetadataMap);
   }
 
-  void setChunkMetadata(const int col, const ChunkMetadata& chunkMetadata) { chunkMetadataMap[col] = chunkMetadata; }
+  void setChunkMetadata(const int col, const ChunkMetadata& chunkMetadata) {
+    if (!chunkMetadataMap) {
+      chunkMetadataMap = std::make_shared<ChunkMetadataMap>();
+    } else if (chunkMetadataMap.use_count() > 1) {
+      chunkMetadataMap = std::make_shared<ChunkMetadataMap>(*chunkMetadataMap);
+    }
+    chunkMetadataMap->set(col, chunkMetadata);
+  }
 
-  const std::map<int, ChunkMetadata>& getChunkMetadataMap() const;
+  const ChunkMetadataMap& getChunkMetadataMap() const;
 
-  const std::map<int, ChunkMetadata>& getChunkMetadataMapPhysical() const { return chunkMetadataMap; }
+  const ChunkMetadataMap& getChunkMetadataMapPhysical() const {
+    static const ChunkMetadataMap emptyChunkMetadataMap;
+    return chunkMetadataMap ? *chunkMetadataMap : emptyChunkMetadataMap;
+  }
 
   size_t getNumTuples() const;
 
@@ -114,7 +197,7 @@ class FragmentInfo {
 
  private:
   mutable size_t numTuples;
-  mutable std::map<int, ChunkMetadata> chunkMetadataMap;
+  mutable std::shared_ptr<ChunkMetadataMap> chunkMetadataMap;
   mutable bool synthesizedNumTuplesIsValid;
   mutable bool synthesizedMetadataIsValid;
 };
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InsertLog.h"
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace Fragmenter_Namespace {
+
+namespace {
+
+const uint32_t insert_log_record_magic{0x4c534e49};  // "INSL"
+
+uint32_t payload_checksum(const std::string& payload) {
+  boost::crc_32_type crc;
+  crc.process_bytes(payload.data(), payload.size());
+  return crc.checksum();
+}
+
+int sync_fd(const int fd) {
+#ifdef __APPLE__
+  return fcntl(fd, F_FULLFSYNC);
+#else
+  return fdatasync(fd);
+#endif
+}
+
+}  // namespace
+
+InsertLog::InsertLog(const std::string& path)
+    : path_(path),
+      fd_(-1),
+      size_bytes_(0),
+      appended_lsn_(0),
+      durable_lsn_(0),
+      sync_in_progress_(false),
+      sync_count_(0) {
+  const auto dir = boost::filesystem::path(path_).parent_path();
+  boost::filesystem::create_directories(dir);
+  const bool created = !boost::filesystem::exists(path_);
+  fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("Could not open insert log " + path_ + ": " + std::strerror(errno));
+  }
+  if (created) {
+    // make the directory entry durable as well
+    const int dir_fd = open(dir.string().c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+      fsync(dir_fd);
+      close(dir_fd);
+    }
+  }
+  size_bytes_ = lseek(fd_, 0, SEEK_END);
+}
+
+InsertLog::~InsertLog() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+uint64_t InsertLog::append(const int epoch, const std::string& payload) {
+  RecordHeader header{insert_log_record_magic,
+                      static_cast<uint32_t>(payload.size()),
+                      static_cast<int32_t>(epoch),
+                      payload_checksum(payload)};
+  std::string record(sizeof(header) + payload.size(), '\0');
+  memcpy(&record[0], &header, sizeof(header));
+  memcpy(&record[sizeof(header)], payload.data(), payload.size());
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  writeAll(reinterpret_cast<const int8_t*>(record.data()), record.size());
+  size_bytes_ += record.size();
+  appended_lsn_ += record.size();
+  return appended_lsn_;
+}
+
+void InsertLog::sync(const uint64_t lsn) {
+  std::unique_lock<std::mutex> lock(sync_mutex_);
+  while (durable_lsn_ < lsn) {
+    if (sync_in_progress_) {
+      sync_done_.wait(lock);
+      continue;
+    }
+    // Become the leader: everything appended so far rides on this sync, the writers which
+    // append in the meantime wait for it and sync together afterwards.
+    sync_in_progress_ = true;
+    const uint64_t target_lsn = appended_lsn_;
+    lock.unlock();
+    const int status = sync_fd(fd_);
+    lock.lock();
+    sync_in_progress_ = false;
+    if (status != 0) {
+      LOG(FATAL) << "Could not sync insert log " << path_ << " to disk";
+    }
+    ++sync_count_;
+    durable_lsn_ = std::max(durable_lsn_, target_lsn);
+    sync_done_.notify_all();
+  }
+}
+
+void InsertLog::reset() {
+  std::lock_guard<std::mutex> append_lock(append_mutex_);
+  if (ftruncate(fd_, 0) != 0 || sync_fd(fd_) != 0) {
+    LOG(FATAL) << "Could not truncate insert log " << path_;
+  }
+  size_bytes_ = 0;
+  std::lock_guard<std::mutex> sync_lock(sync_mutex_);
+  durable_lsn_ = appended_lsn_;
+  sync_done_.notify_all();
+}
+
+void InsertLog::rollback(const size_t size_bytes) {
+  std::lock_guard<std::mutex> append_lock(append_mutex_);
+  CHECK_LE(size_bytes, size_bytes_.load());
+  // a sync on behalf of another writer could have made the records durable already
+  if (ftruncate(fd_, size_bytes) != 0 || sync_fd(fd_) != 0) {
+    LOG(FATAL) << "Could not truncate insert log " << path_;
+  }
+  size_bytes_ = size_bytes;
+}
+
+void InsertLog::replay(const std::function<void(const int epoch, const std::string& payload)>& callback) {
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  const off_t file_size = lseek(fd_, 0, SEEK_END);
+  off_t offset = 0;
+  while (offset + static_cast<off_t>(sizeof(RecordHeader)) <= file_size) {
+    RecordHeader header;
+    if (pread(fd_, &header, sizeof(header), offset) != sizeof(header) || header.magic != insert_log_record_magic ||
+        offset + static_cast<off_t>(sizeof(header) + header.payload_size) > file_size) {
+      break;
+    }
+    std::string payload(header.payload_size, '\0');
+    if (pread(fd_, &payload[0], payload.size(), offset + sizeof(header)) != static_cast<ssize_t>(payload.size()) ||
+        payload_checksum(payload) != header.checksum) {
+      break;
+    }
+    callback(header.epoch, payload);
+    offset += sizeof(header) + payload.size();
+  }
+  if (offset != file_size) {
+    LOG(WARNING) << "Dropping " << file_size - offset << " bytes of torn records at the end of insert log " << path_;
+    if (ftruncate(fd_, offset) != 0 || sync_fd(fd_) != 0) {
+      LOG(FATAL) << "Could not truncate insert log " << path_;
+    }
+  }
+  size_bytes_ = offset;
+}
+
+void InsertLog::writeAll(const int8_t* buff, const size_t size) {
+  size_t written = 0;
+  while (written < size) {
+    const auto crt_written = write(fd_, buff + written, size - written);
+    if (crt_written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const std::string error = std::strerror(errno);
+      // don't leave a partial record behind for the next append
+      if (ftruncate(fd_, size_bytes_) != 0) {
+        LOG(FATAL) << "Could not roll back a failed write to insert log " << path_;
+      }
+      throw std::runtime_error("Could not append to insert log " + path_ + ": " + error);
+    }
+    written += crt_written;
+  }
+}
+
+}  // Fragmenter_Namespace
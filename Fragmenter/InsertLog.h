@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    InsertLog.h
+ * @brief   Append-only write-ahead log of the insert batches of a table.
+ *
+ * Every record is tagged with the table epoch it was appended in. A batch is durable once the
+ * log has been synced past it; concurrent writers share a single fdatasync (group commit). The
+ * log is emptied whenever the table is checkpointed and replayed onto the last checkpointed
+ * epoch at startup, skipping the records of epochs which made it to the data files.
+ **/
+
+#ifndef FRAGMENTER_INSERTLOG_H
+#define FRAGMENTER_INSERTLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace Fragmenter_Namespace {
+
+class InsertLog {
+ public:
+  explicit InsertLog(const std::string& path);
+  ~InsertLog();
+
+  // Returns the sequence number to pass to sync().
+  uint64_t append(const int epoch, const std::string& payload);
+
+  // Blocks until the log is on disk up to the given sequence number.
+  void sync(const uint64_t lsn);
+
+  // Drops all the records, they've been checkpointed.
+  void reset();
+
+  // Cuts off the records appended since the log was sizeBytes() long, their batches didn't
+  // make it into the table.
+  void rollback(const size_t size_bytes);
+
+  // Calls back for every intact record, in append order. A torn record at the end, left by
+  // a crash in the middle of an append, is cut off.
+  void replay(const std::function<void(const int epoch, const std::string& payload)>& callback);
+
+  size_t sizeBytes() const { return size_bytes_; }
+
+  size_t syncCount() const { return sync_count_; }
+
+  const std::string& getPath() const { return path_; }
+
+ private:
+  struct RecordHeader {
+    uint32_t magic;
+    uint32_t payload_size;
+    int32_t epoch;
+    uint32_t checksum;
+  };
+
+  void writeAll(const int8_t* buff, const size_t size);
+
+  const std::string path_;
+  int fd_;
+  std::mutex append_mutex_;
+  std::atomic<size_t> size_bytes_;
+  std::atomic<uint64_t> appended_lsn_;
+  std::mutex sync_mutex_;
+  std::condition_variable sync_done_;
+  uint64_t durable_lsn_;
+  bool sync_in_progress_;
+  std::atomic<size_t> sync_count_;
+};
+
+}  // Fragmenter_Namespace
+
+#endif  // FRAGMENTER_INSERTLOG_H
@@ -18,15 +18,23 @@
 #include "../DataMgr/LockMgr.h"
 #include "../DataMgr/DataMgr.h"
 #include "../DataMgr/AbstractBuffer.h"
+#include "../Shared/checked_alloc.h"
+#include "../Shared/thread_count.h"
 #include <glog/logging.h>
 #include <math.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <list>
 #include <thread>
 
 #include <assert.h>
 #include <boost/lexical_cast.hpp>
 
 #define DROP_FRAGMENT_FACTOR 0.97  // drop to 97% of max so we don't keep adding and dropping fragments
+#define PARALLEL_APPEND_MIN_CELLS 1000000  // smallest rows x columns batch for which columns are appended in parallel
 
 using Data_Namespace::AbstractBuffer;
 using Data_Namespace::DataMgr;
@@ -34,8 +42,72 @@ using Chunk_NS::Chunk;
 
 using namespace std;
 
+bool g_enable_insert_log{false};
+size_t g_insert_log_checkpoint_bytes{size_t(256) << 20};
+size_t g_insert_log_checkpoint_interval_ms{10000};
+
 namespace Fragmenter_Namespace {
 
+namespace {
+
+// How a column of InsertData is laid out, see encodeInsertData in the importer.
+enum class InsertColumnKind : int8_t { Numbers, Strings, Arrays };
+
+InsertColumnKind get_insert_column_kind(const SQLTypeInfo& ti) {
+  if (ti.is_array()) {
+    return InsertColumnKind::Arrays;
+  }
+  if ((ti.is_string() && ti.get_compression() == kENCODING_NONE) || ti.is_geometry()) {
+    return InsertColumnKind::Strings;
+  }
+  return InsertColumnKind::Numbers;
+}
+
+// Width of the values handed to the fragmenter, the encoders compress them on append.
+size_t get_insert_column_width(const SQLTypeInfo& ti) {
+  return ti.is_string() ? ti.get_size() : ti.get_logical_size();
+}
+
+template <typename T>
+void append_to_record(std::string& record, const T value) {
+  record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+class InsertLogRecordReader {
+ public:
+  explicit InsertLogRecordReader(const std::string& record) : record_(record), offset_(0) {}
+
+  template <typename T>
+  T read() {
+    T value;
+    memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const char* readBytes(const size_t size) {
+    if (offset_ + size > record_.size()) {
+      throw std::runtime_error("Insert log record is truncated");
+    }
+    const auto bytes = record_.data() + offset_;
+    offset_ += size;
+    return bytes;
+  }
+
+ private:
+  const std::string& record_;
+  size_t offset_;
+};
+
+// Owns the buffers InsertData points to while a logged batch is replayed.
+struct ReplayedInsertData {
+  InsertData insert_data;
+  std::list<std::vector<int8_t>> numbers;
+  std::list<std::vector<std::string>> strings;
+  std::list<std::vector<ArrayDatum>> arrays;
+};
+
+}  // namespace
+
 InsertOrderFragmenter::InsertOrderFragmenter(const vector<int> chunkKeyPrefix,
                                              vector<Chunk>& chunkVec,
                                              Data_Namespace::DataMgr* dataMgr,
@@ -59,8 +131,11 @@ InsertOrderFragmenter::InsertOrderFragmenter(const vector<int> chunkKeyPrefix,
       maxChunkSize_(maxChunkSize),
       maxRows_(maxRows),
       fragmenterType_("insert_order"),
+      fragmentInfoVersion_(0),
+      fragmentsSnapshotVersion_(0),
       defaultInsertLevel_(defaultInsertLevel),
-      hasMaterializedRowId_(false) {
+      hasMaterializedRowId_(false),
+      stopCheckpoints_(false) {
   // Note that Fragmenter is not passed virtual columns and so should only
   // find row id column if it is non virtual
 
@@ -73,9 +148,32 @@ InsertOrderFragmenter::InsertOrderFragmenter(const vector<int> chunkKeyPrefix,
     }
   }
   getChunkMetadata();
+  if (defaultInsertLevel_ == Data_Namespace::DISK_LEVEL) {
+    const auto insertLogPath = dataMgr_->getInsertLogPath(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+    // a log left behind while the insert log was enabled still has to be replayed
+    if (g_enable_insert_log || boost::filesystem::exists(insertLogPath)) {
+      insertLog_.reset(new InsertLog(insertLogPath));
+      replayInsertLog();
+      if (g_enable_insert_log) {
+        checkpointThread_ = std::thread(&InsertOrderFragmenter::runInsertLogCheckpoints, this);
+      } else {
+        insertLog_.reset();
+        boost::filesystem::remove(insertLogPath);
+      }
+    }
+  }
 }
 
-InsertOrderFragmenter::~InsertOrderFragmenter() {}
+InsertOrderFragmenter::~InsertOrderFragmenter() {
+  if (checkpointThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(checkpointMutex_);
+      stopCheckpoints_ = true;
+    }
+    checkpointCondition_.notify_one();
+    checkpointThread_.join();
+  }
+}
 
 void InsertOrderFragmenter::getChunkMetadata() {
   if (defaultInsertLevel_ ==
@@ -126,6 +224,9 @@ void InsertOrderFragmenter::getChunkMetadata() {
       varLenColInfo_.insert(std::make_pair(colIt->first, 0));
       size = 8;  // b/c we use this for string and array indices - gross to have magic number here
     }
+    if (colIt->second.get_column_desc()->columnType.get_compression() == kENCODING_RL) {
+      size = 2 * sizeof(int64_t);  // worst case, every row starts a new run
+    }
     maxFixedColSize = std::max(maxFixedColSize, size);
   }
 
@@ -192,6 +293,7 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
   mapd_unique_lock<mapd_shared_mutex> deleteLock(
       *LockMgr<mapd_shared_mutex, ChunkKey>::getMutex(LockType::UpdateDeleteLock, chunkKeyPrefix));
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  ++fragmentInfoVersion_;
 
   for (const auto fragId : dropFragIds) {
     for (const auto& col : columnMap_) {
@@ -205,6 +307,30 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
 }
 
 void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
+  if (insertLog_) {
+    // The batch is durable once it's in the log; the data files catch up at the next
+    // checkpoint. The sync happens outside the insert lock, so that the batches of the
+    // writers queued up behind this one share it.
+    uint64_t lsn{0};
+    {
+      mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+      const auto logSize = insertLog_->sizeBytes();
+      lsn = insertLog_->append(dataMgr_->getTableEpoch(chunkKeyPrefix_[0], chunkKeyPrefix_[1]),
+                               serializeInsertData(insertDataStruct));
+      try {
+        insertDataImpl(insertDataStruct);
+      } catch (...) {
+        // the statement fails, replaying the batch would insert it after all
+        insertLog_->rollback(logSize);
+        throw;
+      }
+    }
+    insertLog_->sync(lsn);
+    if (insertLog_->sizeBytes() >= g_insert_log_checkpoint_bytes) {
+      checkpointCondition_.notify_one();
+    }
+    return;
+  }
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   mapd_unique_lock<mapd_shared_mutex> insertLock(
       insertMutex_);  // prevent two threads from trying to insert into the same table simultaneously
@@ -222,6 +348,147 @@ void InsertOrderFragmenter::insertDataNoCheckpoint(InsertData& insertDataStruct)
   insertDataImpl(insertDataStruct);
 }
 
+std::string InsertOrderFragmenter::serializeInsertData(const InsertData& insertDataStruct) const {
+  std::string record;
+  append_to_record<uint64_t>(record, insertDataStruct.numRows);
+  append_to_record<uint32_t>(record, insertDataStruct.columnIds.size());
+  for (size_t i = 0; i < insertDataStruct.columnIds.size(); ++i) {
+    const auto columnId = insertDataStruct.columnIds[i];
+    const auto colMapIt = columnMap_.find(columnId);
+    CHECK(colMapIt != columnMap_.end());
+    const auto& ti = colMapIt->second.get_column_desc()->columnType;
+    const auto kind = get_insert_column_kind(ti);
+    append_to_record<int32_t>(record, columnId);
+    append_to_record<int8_t>(record, static_cast<int8_t>(kind));
+    const auto& dataBlock = insertDataStruct.data[i];
+    switch (kind) {
+      case InsertColumnKind::Numbers: {
+        const auto width = get_insert_column_width(ti);
+        append_to_record<uint32_t>(record, width);
+        record.append(reinterpret_cast<const char*>(dataBlock.numbersPtr), width * insertDataStruct.numRows);
+        break;
+      }
+      case InsertColumnKind::Strings: {
+        CHECK_EQ(insertDataStruct.numRows, dataBlock.stringsPtr->size());
+        for (const auto& str : *dataBlock.stringsPtr) {
+          append_to_record<uint32_t>(record, str.size());
+          record.append(str);
+        }
+        break;
+      }
+      case InsertColumnKind::Arrays: {
+        CHECK_EQ(insertDataStruct.numRows, dataBlock.arraysPtr->size());
+        for (const auto& arr : *dataBlock.arraysPtr) {
+          append_to_record<int8_t>(record, arr.is_null);
+          append_to_record<uint64_t>(record, arr.is_null ? 0 : arr.length);
+          if (!arr.is_null) {
+            record.append(reinterpret_cast<const char*>(arr.pointer), arr.length);
+          }
+        }
+        break;
+      }
+    }
+  }
+  return record;
+}
+
+void InsertOrderFragmenter::replayInsertLog() {
+  const int epoch = dataMgr_->getTableEpoch(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+  size_t replayedBatches{0};
+  size_t replayedRows{0};
+  insertLog_->replay([this, epoch, &replayedBatches, &replayedRows](const int recordEpoch, const std::string& record) {
+    if (recordEpoch < epoch) {
+      return;  // made it to the data files before the log could be emptied
+    }
+    ReplayedInsertData replayed;
+    auto& insertDataStruct = replayed.insert_data;
+    insertDataStruct.databaseId = chunkKeyPrefix_[0];
+    insertDataStruct.tableId = chunkKeyPrefix_[1];
+    InsertLogRecordReader reader(record);
+    insertDataStruct.numRows = reader.read<uint64_t>();
+    const auto columnCount = reader.read<uint32_t>();
+    for (size_t i = 0; i < columnCount; ++i) {
+      const auto columnId = reader.read<int32_t>();
+      const auto kind = static_cast<InsertColumnKind>(reader.read<int8_t>());
+      const auto colMapIt = columnMap_.find(columnId);
+      if (colMapIt == columnMap_.end() ||
+          get_insert_column_kind(colMapIt->second.get_column_desc()->columnType) != kind) {
+        throw std::runtime_error("Insert log " + insertLog_->getPath() + " doesn't match the columns of the table");
+      }
+      DataBlockPtr dataBlock;
+      switch (kind) {
+        case InsertColumnKind::Numbers: {
+          const auto width = reader.read<uint32_t>();
+          const auto bytes = reader.readBytes(width * insertDataStruct.numRows);
+          replayed.numbers.emplace_back(bytes, bytes + width * insertDataStruct.numRows);
+          dataBlock.numbersPtr = replayed.numbers.back().data();
+          break;
+        }
+        case InsertColumnKind::Strings: {
+          replayed.strings.emplace_back();
+          auto& strings = replayed.strings.back();
+          for (size_t row = 0; row < insertDataStruct.numRows; ++row) {
+            const auto length = reader.read<uint32_t>();
+            strings.emplace_back(reader.readBytes(length), length);
+          }
+          dataBlock.stringsPtr = &strings;
+          break;
+        }
+        case InsertColumnKind::Arrays: {
+          replayed.arrays.emplace_back();
+          auto& arrays = replayed.arrays.back();
+          for (size_t row = 0; row < insertDataStruct.numRows; ++row) {
+            const bool isNull = reader.read<int8_t>();
+            const auto length = reader.read<uint64_t>();
+            if (isNull) {
+              arrays.emplace_back(0, nullptr, true);
+              continue;
+            }
+            auto buff = static_cast<int8_t*>(checked_malloc(length));
+            memcpy(buff, reader.readBytes(length), length);
+            arrays.emplace_back(length, buff, false);
+          }
+          dataBlock.arraysPtr = &arrays;
+          break;
+        }
+      }
+      insertDataStruct.columnIds.push_back(columnId);
+      insertDataStruct.data.push_back(dataBlock);
+    }
+    insertDataImpl(insertDataStruct);
+    ++replayedBatches;
+    replayedRows += insertDataStruct.numRows;
+  });
+  if (replayedBatches) {
+    dataMgr_->checkpoint(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+    LOG(INFO) << "Replayed " << replayedBatches << " batches, " << replayedRows << " rows from insert log "
+              << insertLog_->getPath();
+  }
+  insertLog_->reset();
+}
+
+void InsertOrderFragmenter::checkpointInsertLog() {
+  mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+  if (!insertLog_->sizeBytes()) {
+    return;
+  }
+  dataMgr_->checkpoint(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+  insertLog_->reset();
+}
+
+void InsertOrderFragmenter::runInsertLogCheckpoints() {
+  std::unique_lock<std::mutex> lock(checkpointMutex_);
+  while (!stopCheckpoints_) {
+    checkpointCondition_.wait_for(lock, std::chrono::milliseconds(g_insert_log_checkpoint_interval_ms));
+    if (stopCheckpoints_) {
+      break;
+    }
+    lock.unlock();
+    checkpointInsertLog();
+    lock.lock();
+  }
+}
+
 void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   // populate deleted system column of it exists, as it will not come from client
   std::unique_ptr<int8_t[]> data_for_deleted_column;
@@ -258,6 +525,21 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   }
   size_t startFragment = fragmentInfoVec_.size() - 1;
 
+  // A DIFF chunk only takes values within an offset's range of each other. Reject the batch before
+  // anything gets appended, checking all of it against the chunk it starts in.
+  const bool startsNewFragment = currentFragment->shadowNumTuples == maxFragmentRows_;
+  for (size_t insertId = 0; insertId < insertDataStruct.columnIds.size(); ++insertId) {
+    const auto colMapIt = columnMap_.find(insertDataStruct.columnIds[insertId]);
+    CHECK(colMapIt != columnMap_.end());
+    const auto cd = colMapIt->second.get_column_desc();
+    if (cd->columnType.get_compression() == kENCODING_DIFF &&
+        !colMapIt->second.get_buffer()->encoder->canAppendData(
+            dataCopy[insertId].numbersPtr, numRowsLeft, startsNewFragment)) {
+      throw std::runtime_error("Values of column " + cd->columnName + " are too far apart for ENCODING DIFF(" +
+                               std::to_string(cd->columnType.get_comp_param()) + ")");
+    }
+  }
+
   while (numRowsLeft > 0) {  // may have to create multiple fragments for bulk insert
     // loop until done inserting all rows
     CHECK_LE(currentFragment->shadowNumTuples, maxFragmentRows_);
@@ -303,17 +585,7 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
     CHECK_GT(numRowsToInsert, size_t(0));  // would put us into an endless loop as we'd never be able to insert anything
 
     // for each column, append the data in the appropriate insert buffer
-    for (size_t i = 0; i < insertDataStruct.columnIds.size(); ++i) {
-      int columnId = insertDataStruct.columnIds[i];
-      auto colMapIt = columnMap_.find(columnId);
-      assert(colMapIt != columnMap_.end());
-      currentFragment->shadowChunkMetadataMap[columnId] =
-          colMapIt->second.appendData(dataCopy[i], numRowsToInsert, numRowsInserted);
-      auto varLenColInfoIt = varLenColInfo_.find(columnId);
-      if (varLenColInfoIt != varLenColInfo_.end()) {
-        varLenColInfoIt->second = colMapIt->second.get_buffer()->size();
-      }
-    }
+    appendColumns(insertDataStruct, dataCopy, numRowsToInsert, numRowsInserted, *currentFragment);
     if (hasMaterializedRowId_) {
       size_t startId = maxFragmentRows_ * currentFragment->fragmentId + currentFragment->shadowNumTuples;
       int64_t* rowIdData = new int64_t[numRowsToInsert];
@@ -341,11 +613,67 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
       partIt->setPhysicalNumTuples(partIt->shadowNumTuples);
       partIt->setChunkMetadataMap(partIt->shadowChunkMetadataMap);
     }
+    ++fragmentInfoVersion_;
   }
   numTuples_ += insertDataStruct.numRows;
   dropFragmentsToSize(maxRows_);
 }
 
+void InsertOrderFragmenter::appendColumns(const InsertData& insertDataStruct,
+                                          std::vector<DataBlockPtr>& dataCopy,
+                                          const size_t numRowsToInsert,
+                                          const size_t numRowsInserted,
+                                          FragmentInfo& fragment) {
+  const size_t numColumns = insertDataStruct.columnIds.size();
+  std::vector<ChunkMetadata> chunkMetadata(numColumns);
+  auto appendColumnRange = [&](const size_t startCol, const size_t endCol) {
+    for (size_t i = startCol; i < endCol; ++i) {
+      auto colMapIt = columnMap_.find(insertDataStruct.columnIds[i]);
+      CHECK(colMapIt != columnMap_.end());
+      chunkMetadata[i] = colMapIt->second.appendData(dataCopy[i], numRowsToInsert, numRowsInserted);
+    }
+  };
+  // Each column appends to its own chunk buffer, so they can go in parallel; the buffer
+  // managers serialize page allocation and file writes internally. Small batches aren't worth
+  // the thread launches.
+  const size_t numWorkers =
+      numRowsToInsert * numColumns < PARALLEL_APPEND_MIN_CELLS ? 1 : std::min(numColumns, size_t(cpu_threads()));
+  if (numWorkers <= 1) {
+    appendColumnRange(0, numColumns);
+  } else {
+    std::vector<std::future<void>> workerThreads;
+    const size_t columnsPerWorker = (numColumns + numWorkers - 1) / numWorkers;
+    for (size_t startCol = 0; startCol < numColumns; startCol += columnsPerWorker) {
+      workerThreads.push_back(std::async(
+          std::launch::async, appendColumnRange, startCol, std::min(startCol + columnsPerWorker, numColumns)));
+    }
+    for (auto& workerThread : workerThreads) {
+      workerThread.wait();
+    }
+    for (auto& workerThread : workerThreads) {
+      workerThread.get();
+    }
+  }
+  for (size_t i = 0; i < numColumns; ++i) {
+    const int columnId = insertDataStruct.columnIds[i];
+    fragment.shadowChunkMetadataMap[columnId] = chunkMetadata[i];
+    auto varLenColInfoIt = varLenColInfo_.find(columnId);
+    if (varLenColInfoIt != varLenColInfo_.end()) {
+      varLenColInfoIt->second = columnMap_.find(columnId)->second.get_buffer()->size();
+    }
+    // Run length appends and DIFF re-bases rewrite the chunk, copies cached above the insert level
+    // would only fetch the new tail on their next use.
+    if (columnMap_.find(columnId)->second.get_buffer()->encoder->appendRewroteChunk()) {
+      ChunkKey chunkKey = chunkKeyPrefix_;
+      chunkKey.push_back(columnId);
+      chunkKey.push_back(fragment.fragmentId);
+      for (int level = static_cast<int>(defaultInsertLevel_) + 1; level <= Data_Namespace::GPU_LEVEL; ++level) {
+        dataMgr_->deleteChunksWithPrefix(chunkKey, static_cast<Data_Namespace::MemoryLevel>(level));
+      }
+    }
+  }
+}
+
 FragmentInfo* InsertOrderFragmenter::createNewFragment(const Data_Namespace::MemoryLevel memoryLevel) {
   // also sets the new fragment as the insertBuffer for each column
 
@@ -372,53 +700,50 @@ FragmentInfo* InsertOrderFragmenter::createNewFragment(const Data_Namespace::Mem
 
   mapd_lock_guard<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
   fragmentInfoVec_.push_back(newFragmentInfo);
+  ++fragmentInfoVersion_;
   return &(fragmentInfoVec_.back());
 }
 
 TableInfo InsertOrderFragmenter::getFragmentsForQuery() {
+  return *getFragmentsSnapshot();
+}
+
+std::shared_ptr<const TableInfo> InsertOrderFragmenter::getFragmentsSnapshot() {
   mapd_shared_lock<mapd_shared_mutex> readLock(fragmentInfoMutex_);
-  TableInfo queryInfo;
-  queryInfo.chunkKeyPrefix = chunkKeyPrefix_;
-  // right now we don't test predicate, so just return (copy of) all fragments
-  bool fragmentsExist = false;
+  std::lock_guard<std::mutex> snapshotLock(fragmentsSnapshotMutex_);
+  if (fragmentsSnapshot_ && fragmentsSnapshotVersion_ == fragmentInfoVersion_) {
+    return fragmentsSnapshot_;
+  }
+  auto queryInfo = std::make_shared<TableInfo>();
+  queryInfo->chunkKeyPrefix = chunkKeyPrefix_;
+  queryInfo->setPhysicalNumTuples(0);
+  for (const auto& fragment : fragmentInfoVec_) {
+    if (fragment.getPhysicalNumTuples() == 0) {
+      // this means that a concurrent insert query is filling a new fragment which
+      // hasn't been published yet. To make sure we don't mess up the executor we leave
+      // this fragment out of the metadatamap (fixes earlier bug found 2015-05-08)
+      continue;
+    }
+    queryInfo->fragments.push_back(fragment);
+    // the staging metadata of the insert path isn't for readers, don't hand it out
+    queryInfo->fragments.back().shadowChunkMetadataMap.clear();
+    queryInfo->setPhysicalNumTuples(queryInfo->getPhysicalNumTuples() + fragment.getPhysicalNumTuples());
+  }
   if (fragmentInfoVec_.empty()) {
     // If we have no fragments add a dummy empty fragment to make the executor
     // not have separate logic for 0-row tables
-    int maxFragmentId = 0;
     FragmentInfo emptyFragmentInfo;
-    emptyFragmentInfo.fragmentId = maxFragmentId;
+    emptyFragmentInfo.fragmentId = 0;
     emptyFragmentInfo.shadowNumTuples = 0;
     emptyFragmentInfo.setPhysicalNumTuples(0);
     emptyFragmentInfo.deviceIds.resize(dataMgr_->levelSizes_.size());
     emptyFragmentInfo.physicalTableId = physicalTableId_;
     emptyFragmentInfo.shard = shard_;
-    queryInfo.fragments.push_back(emptyFragmentInfo);
-  } else {
-    fragmentsExist = true;
-    queryInfo.fragments = fragmentInfoVec_;  // makes a copy
-  }
-  readLock.unlock();
-  queryInfo.setPhysicalNumTuples(0);
-  auto partIt = queryInfo.fragments.begin();
-  if (fragmentsExist) {
-    while (partIt != queryInfo.fragments.end()) {
-      if (partIt->getPhysicalNumTuples() == 0) {
-        // this means that a concurrent insert query inserted tuples into a new fragment but when the query came in we
-        // didn't have this fragment.
-        // To make sure we don't mess up the executor we delete this
-        // fragment from the metadatamap (fixes earlier bug found
-        // 2015-05-08)
-        partIt = queryInfo.fragments.erase(partIt);
-      } else {
-        queryInfo.setPhysicalNumTuples(queryInfo.getPhysicalNumTuples() + partIt->getPhysicalNumTuples());
-        ++partIt;
-      }
-    }
-  } else {
-    // We added a dummy fragment and know the table is empty
-    queryInfo.setPhysicalNumTuples(0);
+    queryInfo->fragments.push_back(emptyFragmentInfo);
   }
-  return queryInfo;
+  fragmentsSnapshot_ = queryInfo;
+  fragmentsSnapshotVersion_ = fragmentInfoVersion_;
+  return fragmentsSnapshot_;
 }
 
 }  // Fragmenter_Namespace
@@ -24,11 +24,15 @@
 #include "../Shared/mapd_shared_mutex.h"
 #include "../Shared/types.h"
 #include "AbstractFragmenter.h"
+#include "InsertLog.h"
 #include "../DataMgr/MemoryLevel.h"
 #include "../Chunk/Chunk.h"
 
+#include <condition_variable>
+#include <memory>
 #include <vector>
 #include <map>
+#include <thread>
 #include <unordered_map>
 #include <mutex>
 
@@ -41,6 +45,10 @@ class DataMgr;
 #define DEFAULT_MAX_ROWS (1L) << 62        // in rows
 #define DEFAULT_MAX_CHUNK_SIZE 1073741824  // in bytes
 
+extern bool g_enable_insert_log;
+extern size_t g_insert_log_checkpoint_bytes;
+extern size_t g_insert_log_checkpoint_interval_ms;
+
 namespace Fragmenter_Namespace {
 /**
  * @type InsertOrderFragmenter
@@ -75,6 +83,8 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   // virtual void getFragmentsForQuery(QueryInfo &queryInfo, const void *predicate = 0);
   virtual TableInfo getFragmentsForQuery();
 
+  virtual std::shared_ptr<const TableInfo> getFragmentsSnapshot();
+
   /**
    * @brief appends data onto the most recently occuring
    * fragment, creating a new one if necessary
@@ -158,12 +168,21 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   size_t maxRows_;
   std::string fragmenterType_;
   mapd_shared_mutex fragmentInfoMutex_;  // to prevent read-write conflicts for fragmentInfoVec_
+  size_t fragmentInfoVersion_;           // bumped under fragmentInfoMutex_ whenever fragmentInfoVec_ changes
+  std::shared_ptr<const TableInfo> fragmentsSnapshot_;  // published fragmentInfoVec_, built on demand
+  size_t fragmentsSnapshotVersion_;
+  std::mutex fragmentsSnapshotMutex_;
   mapd_shared_mutex insertMutex_;  // to prevent race conditions on insert - only one insert statement should be going
                                    // to a table at a time
   Data_Namespace::MemoryLevel defaultInsertLevel_;
   bool hasMaterializedRowId_;
   int rowIdColId_;
   std::unordered_map<int, size_t> varLenColInfo_;
+  std::unique_ptr<InsertLog> insertLog_;  // only for disk resident tables, when g_enable_insert_log is set
+  std::thread checkpointThread_;
+  std::mutex checkpointMutex_;
+  std::condition_variable checkpointCondition_;
+  bool stopCheckpoints_;
 
   /**
    * @brief creates new fragment, calling createChunk()
@@ -181,6 +200,25 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   void lockInsertCheckpointData(const InsertData& insertDataStruct);
   void insertDataImpl(InsertData& insertDataStruct);
 
+  /**
+   * @brief makes the batches of the insert log which didn't make it to the
+   * last checkpoint durable again
+   */
+  void replayInsertLog();
+  std::string serializeInsertData(const InsertData& insertDataStruct) const;
+  /**
+   * @brief checkpoints the table and empties the insert log, called from
+   * the checkpoint thread every g_insert_log_checkpoint_interval_ms or once
+   * the log grows past g_insert_log_checkpoint_bytes
+   */
+  void checkpointInsertLog();
+  void runInsertLogCheckpoints();
+  void appendColumns(const InsertData& insertDataStruct,
+                     std::vector<DataBlockPtr>& dataCopy,
+                     const size_t numRowsToInsert,
+                     const size_t numRowsInserted,
+                     FragmentInfo& fragment);
+
   InsertOrderFragmenter(const InsertOrderFragmenter&);
   InsertOrderFragmenter& operator=(const InsertOrderFragmenter&);
   // FIX-ME:  Temporary lock; needs removing.
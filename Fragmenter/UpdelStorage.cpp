@@ -87,6 +87,10 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
   if (0 == nrow)
     return;
   CHECK(nrow == nval || 1 == nval);
+  if (cd->columnType.get_compression() == kENCODING_RL || cd->columnType.get_compression() == kENCODING_DIFF) {
+    throw std::runtime_error("UPDATE is not supported on run length or frame of reference encoded column " +
+                             cd->columnName + ".");
+  }
 
   auto fragment_it = std::find_if(fragmentInfoVec_.begin(), fragmentInfoVec_.end(), [=](FragmentInfo& f) -> bool {
     return f.fragmentId == fragmentId;
@@ -303,7 +307,7 @@ void InsertOrderFragmenter::updateColumnMetadata(const ColumnDescriptor* cd,
   auto key = std::make_pair(td, &fragment);
   std::lock_guard<std::mutex> lck(updelRoll.mutex);
   if (0 == updelRoll.chunkMetadata.count(key))
-    updelRoll.chunkMetadata[key] = fragment.getChunkMetadataMapPhysical();
+    updelRoll.chunkMetadata[key] = fragment.getChunkMetadataMapPhysical().toMap();
   if (0 == updelRoll.numTuples.count(key))
     updelRoll.numTuples[key] = fragment.shadowNumTuples;
   auto& chunkMetadata = updelRoll.chunkMetadata[key];
@@ -341,6 +345,7 @@ void InsertOrderFragmenter::updateMetadata(const Catalog_Namespace::Catalog* cat
     fragmentInfo.setChunkMetadataMap(chunkMetadata);
     fragmentInfo.shadowNumTuples = updelRoll.numTuples[key];
     fragmentInfo.setPhysicalNumTuples(fragmentInfo.shadowNumTuples);
+    ++fragmentInfoVersion_;
     // TODO(ppan): When fragment-level compaction is enable, the following code should suffice.
     // When not (ie. existing code), we'll revert to update InsertOrderFragmenter::varLenColInfo_
     /*
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file CsvTokenizer.h
+ * @brief Zero-copy tokenizer for delimited files
+ *
+ * Splits a row of delimited text into fields without allocating a string per field.
+ * Runs of ordinary characters are skipped 16 bytes at a time using SSE2 compare masks;
+ * only delimiters, quotes, escapes, array brackets and line endings go through the
+ * scalar state machine. Fields are returned as views into the read buffer, except for
+ * fields which had to be unescaped: those point into a scratch buffer owned by the
+ * tokenizer and stay valid until the next call to get_row().
+ */
+
+#ifndef IMPORT_CSVTOKENIZER_H_
+#define IMPORT_CSVTOKENIZER_H_
+
+#include "Importer.h"
+
+#include <boost/utility/string_ref.hpp>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Importer_NS {
+
+class CsvTokenizer {
+ public:
+  CsvTokenizer(const CopyParams& copy_params, const bool* is_array)
+      : copy_params_(copy_params), is_array_(is_array), special_char_count_(0) {
+    std::fill(std::begin(is_special_), std::end(is_special_), false);
+    std::fill(std::begin(is_eol_), std::end(is_eol_), false);
+    for (const char c : {copy_params.line_delim, '\r', '\n'}) {
+      is_eol_[static_cast<unsigned char>(c)] = true;
+    }
+    addSpecialChar(copy_params.delimiter);
+    addSpecialChar(copy_params.line_delim);
+    addSpecialChar('\r');
+    addSpecialChar('\n');
+    addSpecialChar(copy_params.escape);
+    if (copy_params.quoted) {
+      addSpecialChar(copy_params.quote);
+    }
+    if (is_array) {
+      addSpecialChar(copy_params.array_begin);
+      addSpecialChar(copy_params.array_end);
+    }
+  }
+
+  // Same contract as the legacy string-based get_row: consumes one row starting at buf,
+  // returns the position of its last character. Field views are appended to row.
+  const char* get_row(const char* buf,
+                      const char* buf_end,
+                      const char* entire_buf_end,
+                      std::vector<boost::string_ref>& row,
+                      bool& try_single_thread) {
+    const char* field = buf;
+    const char* p;
+    bool in_quote = false;
+    bool in_array = false;
+    bool has_escape = false;
+    bool strip_quotes = false;
+    try_single_thread = false;
+    scratch_.clear();
+    scratch_fields_.clear();
+    for (p = findSpecial(buf, entire_buf_end); p < entire_buf_end; p = findSpecial(p + 1, entire_buf_end)) {
+      if (*p == copy_params_.escape && p < entire_buf_end - 1 && *(p + 1) == copy_params_.quote) {
+        p++;
+        has_escape = true;
+      } else if (copy_params_.quoted && *p == copy_params_.quote) {
+        in_quote = !in_quote;
+        if (in_quote) {
+          strip_quotes = true;
+        }
+      } else if (!in_quote && is_array_ != nullptr && *p == copy_params_.array_begin && is_array_[row.size()]) {
+        in_array = true;
+      } else if (!in_quote && is_array_ != nullptr && *p == copy_params_.array_end && is_array_[row.size()]) {
+        in_array = false;
+      } else if (*p == copy_params_.delimiter || isEol(*p)) {
+        if (!in_quote && !in_array) {
+          if (!has_escape && !strip_quotes) {
+            row.push_back(trimSpace(field, p - field));
+          } else {
+            addUnescapedField(field, p, has_escape, row);
+          }
+          field = p + 1;
+          has_escape = false;
+          strip_quotes = false;
+        }
+        if (isEol(*p) && ((!in_quote && !in_array) || copy_params_.threads != 1)) {
+          while (p + 1 < buf_end && isEol(*(p + 1))) {
+            p++;
+          }
+          break;
+        }
+      }
+    }
+    // the scratch buffer may have been reallocated while the row was built, point the
+    // unescaped fields at its final location
+    for (const auto& scratch_field : scratch_fields_) {
+      auto& field_ref = row[scratch_field.first];
+      field_ref = boost::string_ref(scratch_.data() + scratch_field.second, field_ref.size());
+    }
+    if (in_quote) {
+      LOG(ERROR) << "Unmatched quote.";
+      try_single_thread = true;
+    }
+    if (in_array) {
+      LOG(ERROR) << "Unmatched array.";
+      try_single_thread = true;
+    }
+    return p;
+  }
+
+ private:
+  static constexpr size_t kMaxSpecialChars = 8;
+
+  void addSpecialChar(const char c) {
+    auto& is_special = is_special_[static_cast<unsigned char>(c)];
+    if (is_special) {
+      return;
+    }
+    is_special = true;
+    CHECK(special_char_count_ < kMaxSpecialChars);
+#ifdef __SSE2__
+    special_vecs_[special_char_count_] = _mm_set1_epi8(c);
+#endif
+    ++special_char_count_;
+  }
+
+  bool isEol(const char c) const { return is_eol_[static_cast<unsigned char>(c)]; }
+
+  // Returns the first character in [p, end) the row state machine has to look at.
+  const char* findSpecial(const char* p, const char* end) const {
+#ifdef __SSE2__
+    while (p + sizeof(__m128i) <= end) {
+      const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      auto hits = _mm_cmpeq_epi8(chunk, special_vecs_[0]);
+      for (size_t i = 1; i < special_char_count_; ++i) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, special_vecs_[i]));
+      }
+      const int mask = _mm_movemask_epi8(hits);
+      if (mask) {
+        return p + __builtin_ctz(mask);
+      }
+      p += sizeof(__m128i);
+    }
+#endif
+    while (p < end && !is_special_[static_cast<unsigned char>(*p)]) {
+      ++p;
+    }
+    return p;
+  }
+
+  static boost::string_ref trimSpace(const char* field, const size_t len) {
+    size_t i = 0;
+    size_t j = len;
+    while (i < j && (field[i] == ' ' || field[i] == '\r')) {
+      i++;
+    }
+    while (i < j && (field[j - 1] == ' ' || field[j - 1] == '\r')) {
+      j--;
+    }
+    return boost::string_ref(field + i, j - i);
+  }
+
+  // Quoted or escaped fields can't be returned as a view of the input; unescape them into
+  // the scratch buffer and record where they start so get_row can fix the views up.
+  void addUnescapedField(const char* field, const char* p, const bool has_escape, std::vector<boost::string_ref>& row) {
+    const size_t offset = scratch_.size();
+    for (ptrdiff_t i = 0; i < p - field; i++) {
+      if (has_escape && field[i] == copy_params_.escape && field[i + 1] == copy_params_.quote) {
+        scratch_.push_back(copy_params_.quote);
+        i++;
+      } else {
+        scratch_.push_back(field[i]);
+      }
+    }
+    auto s = trimSpace(scratch_.data() + offset, scratch_.size() - offset);
+    if (copy_params_.quoted && s.size() > 0 && s.front() == copy_params_.quote) {
+      s.remove_prefix(1);
+    }
+    if (copy_params_.quoted && s.size() > 0 && s.back() == copy_params_.quote) {
+      s.remove_suffix(1);
+    }
+    scratch_fields_.emplace_back(row.size(), s.data() - scratch_.data());
+    row.push_back(s);
+  }
+
+  const CopyParams& copy_params_;
+  const bool* is_array_;
+  bool is_special_[256];
+  bool is_eol_[256];
+  size_t special_char_count_;
+#ifdef __SSE2__
+  __m128i special_vecs_[kMaxSpecialChars];
+#endif
+  std::string scratch_;
+  std::vector<std::pair<size_t, size_t>> scratch_fields_;  // (field index in row, offset in scratch_)
+};
+
+}  // namespace Importer_NS
+
+#endif  // IMPORT_CSVTOKENIZER_H_
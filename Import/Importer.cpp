@@ -36,9 +36,12 @@
 #include <thread>
 #include <future>
 #include <mutex>
+#include <numeric>
+#include <cmath>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <rapidjson/document.h>
 #include <glog/logging.h>
 #include <ogrsf_frmts.h>
 #include <gdal.h>
@@ -53,6 +56,7 @@
 #include "../Shared/import_helpers.h"
 
 #include "Importer.h"
+#include "CsvTokenizer.h"
 #include "DataMgr/LockMgr.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Utils/ChunkAccessorTable.h"
@@ -68,6 +72,9 @@
 
 using std::ostream;
 
+// had to port timegm because the one on MacOS is horrendously slow.
+extern time_t my_timegm(const struct tm* tm);
+
 namespace {
 
 struct OGRDataSourceDeleter {
@@ -165,27 +172,6 @@ void Importer::set_import_status(const std::string& import_id, ImportStatus is)
   import_status_map[import_id] = is;
 }
 
-static const std::string trim_space(const char* field, const size_t len) {
-  size_t i = 0;
-  size_t j = len;
-  while (i < j && (field[i] == ' ' || field[i] == '\r')) {
-    i++;
-  }
-  while (i < j && (field[j - 1] == ' ' || field[j - 1] == '\r')) {
-    j--;
-  }
-  return std::string(field + i, j - i);
-}
-
-static const bool is_eol(const char& p, const std::string& line_delims) {
-  for (auto i : line_delims) {
-    if (p == i) {
-      return true;
-    }
-  }
-  return false;
-}
-
 static const char* get_row(const char* buf,
                            const char* buf_end,
                            const char* entire_buf_end,
@@ -194,73 +180,11 @@ static const char* get_row(const char* buf,
                            const bool* is_array,
                            std::vector<std::string>& row,
                            bool& try_single_thread) {
-  const char* field = buf;
-  const char* p;
-  bool in_quote = false;
-  bool in_array = false;
-  bool has_escape = false;
-  bool strip_quotes = false;
-  try_single_thread = false;
-  std::string line_endings({copy_params.line_delim, '\r', '\n'});
-  for (p = buf; p < entire_buf_end; p++) {
-    if (*p == copy_params.escape && p < entire_buf_end - 1 && *(p + 1) == copy_params.quote) {
-      p++;
-      has_escape = true;
-    } else if (copy_params.quoted && *p == copy_params.quote) {
-      in_quote = !in_quote;
-      if (in_quote)
-        strip_quotes = true;
-    } else if (!in_quote && is_array != nullptr && *p == copy_params.array_begin && is_array[row.size()]) {
-      in_array = true;
-    } else if (!in_quote && is_array != nullptr && *p == copy_params.array_end && is_array[row.size()]) {
-      in_array = false;
-    } else if (*p == copy_params.delimiter || is_eol(*p, line_endings)) {
-      if (!in_quote && !in_array) {
-        if (!has_escape && !strip_quotes) {
-          std::string s = trim_space(field, p - field);
-          row.push_back(s);
-        } else {
-          auto field_buf = std::unique_ptr<char[]>(new char[p - field + 1]);
-          int j = 0, i = 0;
-          for (; i < p - field; i++, j++) {
-            if (has_escape && field[i] == copy_params.escape && field[i + 1] == copy_params.quote) {
-              field_buf[j] = copy_params.quote;
-              i++;
-            } else {
-              field_buf[j] = field[i];
-            }
-          }
-          std::string s = trim_space(field_buf.get(), j);
-          if (copy_params.quoted && s.size() > 0 && s.front() == copy_params.quote) {
-            s.erase(0, 1);
-          }
-          if (copy_params.quoted && s.size() > 0 && s.back() == copy_params.quote) {
-            s.pop_back();
-          }
-          row.push_back(s);
-        }
-        field = p + 1;
-        has_escape = false;
-        strip_quotes = false;
-      }
-      if (is_eol(*p, line_endings) && ((!in_quote && !in_array) || copy_params.threads != 1)) {
-        while (p + 1 < buf_end && is_eol(*(p + 1), line_endings)) {
-          p++;
-        }
-        break;
-      }
-    }
-  }
-  /*
-  @TODO(wei) do error handling
-  */
-  if (in_quote) {
-    LOG(ERROR) << "Unmatched quote.";
-    try_single_thread = true;
-  }
-  if (in_array) {
-    LOG(ERROR) << "Unmatched array.";
-    try_single_thread = true;
+  CsvTokenizer tokenizer(copy_params, is_array);
+  std::vector<boost::string_ref> fields;
+  const char* p = tokenizer.get_row(buf, buf_end, entire_buf_end, fields, try_single_thread);
+  for (const auto& field : fields) {
+    row.push_back(field.to_string());
   }
   return p;
 }
@@ -1258,6 +1182,188 @@ void TypedImportBuffer::add_value(const ColumnDescriptor* cd, const TDatum& datu
   }
 }
 
+namespace {
+
+// Fast paths for the canonical textual forms of the most common column types. Each returns
+// false when the input isn't in the form it understands, in which case the caller falls back
+// to StringToDatum, which also produces the error messages for malformed values.
+
+bool parse_digits(const char* p, const char* end, int64_t& result) {
+  result = 0;
+  for (; p < end; ++p) {
+    const unsigned digit = static_cast<unsigned char>(*p) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+  return true;
+}
+
+bool parse_integer_fast(const boost::string_ref val, const bool is_bigint, int64_t& result) {
+  const char* p = val.begin();
+  const bool is_negative = p < val.end() && *p == '-';
+  if (is_negative) {
+    ++p;
+  }
+  const auto digit_count = val.end() - p;
+  // at most 18 digits can't overflow int64_t; std::stoi throws above 32 bits, let it
+  if (digit_count == 0 || digit_count > (is_bigint ? 18 : 9)) {
+    return false;
+  }
+  if (!parse_digits(p, val.end(), result)) {
+    return false;
+  }
+  if (is_negative) {
+    result = -result;
+  }
+  return true;
+}
+
+// Mirrors parse_numeric, including its choice of scale and precision for the literal.
+bool parse_decimal_fast(const boost::string_ref val, int64_t& result, SQLTypeInfo& ti) {
+  const auto dot = val.find('.');
+  const auto before_dot = val.substr(0, dot);
+  const bool is_negative = !before_dot.empty() && before_dot.front() == '-';
+  const auto int_digits = before_dot.substr(is_negative ? 1 : 0);
+  if (int_digits.empty() && (dot != 0 || is_negative)) {
+    return false;
+  }
+  const auto after_dot = dot == boost::string_ref::npos ? boost::string_ref() : val.substr(dot + 1);
+  if (int_digits.size() + after_dot.size() > 18) {
+    return false;
+  }
+  int64_t int_part = 0;
+  int64_t fraction = 0;
+  if (!parse_digits(int_digits.begin(), int_digits.end(), int_part) ||
+      !parse_digits(after_dot.begin(), after_dot.end(), fraction)) {
+    return false;
+  }
+  // without a decimal point parse_numeric treats the value as having a single zero fraction digit
+  const int scale = dot == boost::string_ref::npos ? 1 : after_dot.size();
+  ti.set_scale(scale);
+  ti.set_dimension((dot == 0 ? 1 : before_dot.size()) + scale);
+  ti.set_notnull(false);
+  result = int_part;
+  for (int i = 0; i < scale; i++) {
+    result *= 10;
+  }
+  result += fraction;
+  if (is_negative) {
+    result = -result;
+  }
+  return true;
+}
+
+bool parse_fixed_width_field(const char* p, const size_t width, const int min_val, const int max_val, int& result) {
+  int64_t val;
+  if (!parse_digits(p, p + width, val) || val < min_val || val > max_val) {
+    return false;
+  }
+  result = val;
+  return true;
+}
+
+// Accepts YYYY-MM-DD for dates and YYYY-MM-DD[T ]HH:MM:SS for timestamps.
+bool parse_time_fast(const boost::string_ref val, const SQLTypes type, time_t& result) {
+  constexpr size_t date_len = 10;
+  constexpr size_t timestamp_len = 19;
+  if (type != kDATE && type != kTIMESTAMP) {
+    return false;
+  }
+  if (val.size() != (type == kDATE ? date_len : timestamp_len)) {
+    return false;
+  }
+  const char* p = val.data();
+  std::tm tm_struct = {0};
+  if (p[4] != '-' || p[7] != '-' || !parse_fixed_width_field(p, 4, 0, 9999, tm_struct.tm_year) ||
+      !parse_fixed_width_field(p + 5, 2, 1, 12, tm_struct.tm_mon) ||
+      !parse_fixed_width_field(p + 8, 2, 1, 31, tm_struct.tm_mday)) {
+    return false;
+  }
+  tm_struct.tm_year -= 1900;
+  tm_struct.tm_mon -= 1;
+  if (type == kTIMESTAMP) {
+    if ((p[10] != ' ' && p[10] != 'T') || p[13] != ':' || p[16] != ':' ||
+        !parse_fixed_width_field(p + 11, 2, 0, 23, tm_struct.tm_hour) ||
+        !parse_fixed_width_field(p + 14, 2, 0, 59, tm_struct.tm_min) ||
+        !parse_fixed_width_field(p + 17, 2, 0, 59, tm_struct.tm_sec)) {
+      return false;
+    }
+  }
+  result = my_timegm(&tm_struct);
+  return true;
+}
+
+}  // namespace
+
+void TypedImportBuffer::add_value(const ColumnDescriptor* cd,
+                                  const boost::string_ref val,
+                                  const bool is_null,
+                                  const CopyParams& copy_params) {
+  const auto& col_ti = cd->columnType;
+  if (is_null || val.empty()) {
+    add_value(cd, val.to_string(), is_null, copy_params);
+    return;
+  }
+  switch (col_ti.get_type()) {
+    case kTINYINT:
+    case kSMALLINT:
+    case kINT:
+    case kBIGINT: {
+      int64_t int_val;
+      if (!parse_integer_fast(val, col_ti.get_type() == kBIGINT, int_val)) {
+        break;
+      }
+      switch (col_ti.get_type()) {
+        case kTINYINT:
+          addTinyint(int_val);
+          break;
+        case kSMALLINT:
+          addSmallint(int_val);
+          break;
+        case kINT:
+          addInt(int_val);
+          break;
+        default:
+          addBigint(int_val);
+          break;
+      }
+      return;
+    }
+    case kDECIMAL:
+    case kNUMERIC: {
+      SQLTypeInfo ti(kNUMERIC, 0, 0, false);
+      int64_t decimal_val;
+      if (!parse_decimal_fast(val, decimal_val, ti)) {
+        break;
+      }
+      addBigint(convert_decimal_value_to_scale(decimal_val, ti, col_ti));
+      return;
+    }
+    case kDATE:
+    case kTIMESTAMP: {
+      time_t time_val;
+      if (!parse_time_fast(val, col_ti.get_type(), time_val)) {
+        break;
+      }
+      addTime(time_val);
+      return;
+    }
+    case kTEXT:
+    case kVARCHAR:
+    case kCHAR:
+      if (val.size() > StringDictionary::MAX_STRLEN) {
+        break;
+      }
+      string_buffer_->emplace_back(val.data(), val.size());
+      return;
+    default:
+      break;
+  }
+  add_value(cd, val.to_string(), is_null, copy_params);
+}
+
 template <typename T>
 ostream& operator<<(ostream& out, const std::vector<T>& v) {
   out << "[";
@@ -1678,24 +1784,16 @@ static ImportStatus import_thread_delimited(
     auto us = measure<std::chrono::microseconds>::execution([&]() {});
     for (const auto& p : import_buffers)
       p->clear();
-    std::vector<std::string> row;
+    CsvTokenizer tokenizer(copy_params, importer->get_is_array());
+    std::vector<boost::string_ref> row;
     for (const char* p = thread_buf; p < thread_buf_end; p++) {
       row.clear();
       if (DEBUG_TIMING) {
-        us = measure<std::chrono::microseconds>::execution([&]() {
-          p = get_row(p,
-                      thread_buf_end,
-                      buf_end,
-                      copy_params,
-                      p == thread_buf,
-                      importer->get_is_array(),
-                      row,
-                      try_single_thread);
-        });
+        us = measure<std::chrono::microseconds>::execution(
+            [&]() { p = tokenizer.get_row(p, thread_buf_end, buf_end, row, try_single_thread); });
         total_get_row_time_us += us;
       } else
-        p = get_row(
-            p, thread_buf_end, buf_end, copy_params, p == thread_buf, importer->get_is_array(), row, try_single_thread);
+        p = tokenizer.get_row(p, thread_buf_end, buf_end, row, try_single_thread);
       int phys_cols = 0;
       int point_cols = 0;
       for (const auto cd : col_descs) {
@@ -1739,7 +1837,7 @@ static ImportStatus import_thread_delimited(
               import_buffers[col_idx]->add_value(cd, copy_params.null_str, true, copy_params);
 
               // WKT from string we're not storing
-              std::string wkt{row[import_idx]};
+              std::string wkt{row[import_idx].to_string()};
 
               // next
               ++import_idx;
@@ -1759,7 +1857,7 @@ static ImportStatus import_thread_delimited(
                 // Try custom POINT import: from two separate scalars rather than WKT string
                 double lon = std::atof(wkt.c_str());
                 double lat = NAN;
-                std::string lat_str{row[import_idx]};
+                std::string lat_str{row[import_idx].to_string()};
                 ++import_idx;
                 if (lat_str.size() > 0 && (lat_str[0] == '.' || isdigit(lat_str[0]) || lat_str[0] == '-')) {
                   lat = std::atof(lat_str.c_str());
@@ -2189,13 +2287,170 @@ double double_value_at(const TypedImportBuffer& import_buffer, const size_t inde
   return reinterpret_cast<const double*>(may_alias_ptr(values_buffer))[index];
 }
 
+// Appends row i of the input buffers to the output buffers, which have the same columns.
+void append_row(std::vector<std::unique_ptr<TypedImportBuffer>>& output_buffers,
+                const std::vector<std::unique_ptr<TypedImportBuffer>>& input_buffers,
+                const size_t i) {
+  for (size_t col_idx = 0; col_idx < input_buffers.size(); ++col_idx) {
+    const auto& input_buffer = input_buffers[col_idx];
+    const auto& col_ti = input_buffer->getTypeInfo();
+    const auto type = col_ti.is_decimal() ? decimal_to_int_type(col_ti) : col_ti.get_type();
+    switch (type) {
+      case kBOOLEAN:
+        output_buffers[col_idx]->addBoolean(int_value_at(*input_buffer, i));
+        break;
+      case kTINYINT:
+        output_buffers[col_idx]->addTinyint(int_value_at(*input_buffer, i));
+        break;
+      case kSMALLINT:
+        output_buffers[col_idx]->addSmallint(int_value_at(*input_buffer, i));
+        break;
+      case kINT:
+        output_buffers[col_idx]->addInt(int_value_at(*input_buffer, i));
+        break;
+      case kBIGINT:
+        output_buffers[col_idx]->addBigint(int_value_at(*input_buffer, i));
+        break;
+      case kFLOAT:
+        output_buffers[col_idx]->addFloat(float_value_at(*input_buffer, i));
+        break;
+      case kDOUBLE:
+        output_buffers[col_idx]->addDouble(double_value_at(*input_buffer, i));
+        break;
+      case kTEXT:
+      case kVARCHAR:
+      case kCHAR: {
+        CHECK_LT(i, input_buffer->getStringBuffer()->size());
+        output_buffers[col_idx]->addString((*input_buffer->getStringBuffer())[i]);
+        break;
+      }
+      case kTIME:
+      case kTIMESTAMP:
+      case kDATE:
+        output_buffers[col_idx]->addTime(int_value_at(*input_buffer, i));
+        break;
+      case kARRAY:
+        if (IS_STRING(col_ti.get_subtype())) {
+          CHECK(input_buffer->getStringArrayBuffer());
+          CHECK_LT(i, input_buffer->getStringArrayBuffer()->size());
+          const auto& input_arr = (*(input_buffer->getStringArrayBuffer()))[i];
+          output_buffers[col_idx]->addStringArray(input_arr);
+        } else {
+          output_buffers[col_idx]->addArray((*input_buffer->getArrayBuffer())[i]);
+        }
+        break;
+      case kPOINT:
+      case kLINESTRING:
+      case kPOLYGON: {
+        CHECK_LT(i, input_buffer->getGeoStringBuffer()->size());
+        output_buffers[col_idx]->addGeoString((*input_buffer->getGeoStringBuffer())[i]);
+        break;
+      }
+      default:
+        CHECK(false);
+    }
+  }
+}
+
+// Positions in column_descs of the SORT KEY columns recorded in the key meta-information of the table.
+std::vector<size_t> get_sort_key_column_indices(const std::string& key_metainfo,
+                                                const std::list<const ColumnDescriptor*>& column_descs) {
+  rapidjson::Document document;
+  document.Parse(key_metainfo.c_str());
+  if (document.HasParseError() || !document.IsArray()) {
+    return {};
+  }
+  std::vector<size_t> sort_key_col_idxs;
+  for (auto it = document.Begin(); it != document.End(); ++it) {
+    const auto& key_with_spec_json = *it;
+    if (!key_with_spec_json.IsObject() || std::string(key_with_spec_json["type"].GetString()) != "SORT KEY") {
+      continue;
+    }
+    const std::string sort_key_spec = key_with_spec_json["name"].GetString();
+    std::vector<std::string> col_names;
+    boost::split(col_names, sort_key_spec, boost::is_any_of(","));
+    for (auto& col_name : col_names) {
+      boost::trim(col_name);
+      size_t col_idx{0};
+      for (const auto cd : column_descs) {
+        if (cd->columnName == col_name) {
+          sort_key_col_idxs.push_back(col_idx);
+          break;
+        }
+        ++col_idx;
+      }
+    }
+  }
+  return sort_key_col_idxs;
+}
+
+// NaN sorts after every number and ties with the other NaNs, `<` alone isn't a strict weak ordering with them.
+bool sort_key_fp_less(const double lhs, const double rhs) {
+  if (std::isnan(lhs) || std::isnan(rhs)) {
+    return !std::isnan(lhs) && std::isnan(rhs);
+  }
+  return lhs < rhs;
+}
+
 }  // namespace
 
+Loader::OneShardBuffers Loader::sortBySortKey(const OneShardBuffers& import_buffers, const size_t row_count) const {
+  struct SortKeyValues {
+    bool is_fp;
+    std::vector<int64_t> int_vals;
+    std::vector<double> fp_vals;
+  };
+  std::vector<SortKeyValues> sort_keys;
+  for (const auto col_idx : sort_key_col_idxs) {
+    CHECK_LT(col_idx, import_buffers.size());
+    const auto& input_buffer = *import_buffers[col_idx];
+    const auto& col_ti = input_buffer.getTypeInfo();
+    SortKeyValues sort_key{col_ti.is_fp(), {}, {}};
+    for (size_t i = 0; i < row_count; ++i) {
+      if (!sort_key.is_fp) {
+        sort_key.int_vals.push_back(int_value_at(input_buffer, i));
+      } else if (col_ti.get_type() == kFLOAT) {
+        sort_key.fp_vals.push_back(float_value_at(input_buffer, i));
+      } else {
+        sort_key.fp_vals.push_back(double_value_at(input_buffer, i));
+      }
+    }
+    sort_keys.push_back(std::move(sort_key));
+  }
+  std::vector<size_t> row_order(row_count);
+  std::iota(row_order.begin(), row_order.end(), 0);
+  std::stable_sort(row_order.begin(), row_order.end(), [&sort_keys](const size_t lhs, const size_t rhs) {
+    for (const auto& sort_key : sort_keys) {
+      if (sort_key.is_fp) {
+        if (sort_key_fp_less(sort_key.fp_vals[lhs], sort_key.fp_vals[rhs])) {
+          return true;
+        }
+        if (sort_key_fp_less(sort_key.fp_vals[rhs], sort_key.fp_vals[lhs])) {
+          return false;
+        }
+      } else if (sort_key.int_vals[lhs] != sort_key.int_vals[rhs]) {
+        return sort_key.int_vals[lhs] < sort_key.int_vals[rhs];
+      }
+    }
+    return false;
+  });
+  OneShardBuffers sorted_import_buffers;
+  for (const auto& typed_import_buffer : import_buffers) {
+    sorted_import_buffers.emplace_back(
+        new TypedImportBuffer(typed_import_buffer->getColumnDesc(), typed_import_buffer->getStringDictionary()));
+  }
+  for (const auto i : row_order) {
+    append_row(sorted_import_buffers, import_buffers, i);
+  }
+  return sorted_import_buffers;
+}
+
 void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_buffers,
                                 std::vector<size_t>& all_shard_row_counts,
                                 const OneShardBuffers& import_buffers,
                                 const size_t row_count,
-                                const size_t shard_count) {
+                                const std::vector<const TableDescriptor*>& shard_tables) {
+  const size_t shard_count = shard_tables.size();
   all_shard_row_counts.resize(shard_count);
   for (size_t shard_idx = 0; shard_idx < shard_count; ++shard_idx) {
     all_shard_import_buffers.emplace_back();
@@ -2204,21 +2459,25 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
           new TypedImportBuffer(typed_import_buffer->getColumnDesc(), typed_import_buffer->getStringDictionary()));
     }
   }
-  CHECK_GT(table_desc->shardedColumnId, 0);
+  // range partitions are physical tables as well, the rows are routed by the partition column instead
+  const bool is_range_partitioned = table_is_range_partitioned(table_desc);
+  const int shard_col_id = is_range_partitioned ? table_desc->partitionColumnId : table_desc->shardedColumnId;
+  CHECK_GT(shard_col_id, 0);
   int col_idx{0};
   const ColumnDescriptor* shard_col_desc{nullptr};
   for (const auto col_desc : column_descs) {
     ++col_idx;
-    if (col_idx == table_desc->shardedColumnId) {
+    if (col_idx == shard_col_id) {
       shard_col_desc = col_desc;
       break;
     }
   }
   CHECK(shard_col_desc);
-  CHECK_LE(static_cast<size_t>(table_desc->shardedColumnId), import_buffers.size());
-  auto& shard_column_input_buffer = import_buffers[table_desc->shardedColumnId - 1];
+  CHECK_LE(static_cast<size_t>(shard_col_id), import_buffers.size());
+  auto& shard_column_input_buffer = import_buffers[shard_col_id - 1];
   const auto& shard_col_ti = shard_col_desc->columnType;
-  CHECK(shard_col_ti.is_integer() || (shard_col_ti.is_string() && shard_col_ti.get_compression() == kENCODING_DICT));
+  CHECK(shard_col_ti.is_integer() || (shard_col_ti.is_string() && shard_col_ti.get_compression() == kENCODING_DICT) ||
+        (is_range_partitioned && shard_col_ti.is_time()));
   if (shard_col_ti.is_string()) {
     const auto payloads_ptr = shard_column_input_buffer->getStringBuffer();
     CHECK(payloads_ptr);
@@ -2226,67 +2485,18 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
   }
   for (size_t i = 0; i < row_count; ++i) {
     const auto val = int_value_at(*shard_column_input_buffer, i);
-    const auto shard = val % shard_count;
-    auto& shard_output_buffers = all_shard_import_buffers[shard];
-    for (size_t col_idx = 0; col_idx < import_buffers.size(); ++col_idx) {
-      const auto& input_buffer = import_buffers[col_idx];
-      const auto& col_ti = input_buffer->getTypeInfo();
-      const auto type = col_ti.is_decimal() ? decimal_to_int_type(col_ti) : col_ti.get_type();
-      switch (type) {
-        case kBOOLEAN:
-          shard_output_buffers[col_idx]->addBoolean(int_value_at(*input_buffer, i));
-          break;
-        case kTINYINT:
-          shard_output_buffers[col_idx]->addTinyint(int_value_at(*input_buffer, i));
-          break;
-        case kSMALLINT:
-          shard_output_buffers[col_idx]->addSmallint(int_value_at(*input_buffer, i));
-          break;
-        case kINT:
-          shard_output_buffers[col_idx]->addInt(int_value_at(*input_buffer, i));
-          break;
-        case kBIGINT:
-          shard_output_buffers[col_idx]->addBigint(int_value_at(*input_buffer, i));
-          break;
-        case kFLOAT:
-          shard_output_buffers[col_idx]->addFloat(float_value_at(*input_buffer, i));
-          break;
-        case kDOUBLE:
-          shard_output_buffers[col_idx]->addDouble(double_value_at(*input_buffer, i));
-          break;
-        case kTEXT:
-        case kVARCHAR:
-        case kCHAR: {
-          CHECK_LT(i, input_buffer->getStringBuffer()->size());
-          shard_output_buffers[col_idx]->addString((*input_buffer->getStringBuffer())[i]);
-          break;
-        }
-        case kTIME:
-        case kTIMESTAMP:
-        case kDATE:
-          shard_output_buffers[col_idx]->addTime(int_value_at(*input_buffer, i));
-          break;
-        case kARRAY:
-          if (IS_STRING(col_ti.get_subtype())) {
-            CHECK(input_buffer->getStringArrayBuffer());
-            CHECK_LT(i, input_buffer->getStringArrayBuffer()->size());
-            const auto& input_arr = (*(input_buffer->getStringArrayBuffer()))[i];
-            shard_output_buffers[col_idx]->addStringArray(input_arr);
-          } else {
-            shard_output_buffers[col_idx]->addArray((*input_buffer->getArrayBuffer())[i]);
-          }
-          break;
-        case kPOINT:
-        case kLINESTRING:
-        case kPOLYGON: {
-          CHECK_LT(i, input_buffer->getGeoStringBuffer()->size());
-          shard_output_buffers[col_idx]->addGeoString((*input_buffer->getGeoStringBuffer())[i]);
-          break;
-        }
-        default:
-          CHECK(false);
+    size_t shard{0};
+    if (is_range_partitioned) {
+      const auto partition_idx = get_range_partition_index(shard_tables, val, val == inline_int_null_val(shard_col_ti));
+      if (partition_idx < 0) {
+        throw std::runtime_error("Value " + std::to_string(val) + " of column " + shard_col_desc->columnName +
+                                 " has no partition in table " + table_desc->tableName);
       }
+      shard = partition_idx;
+    } else {
+      shard = val % shard_count;
     }
+    append_row(all_shard_import_buffers[shard], import_buffers, i);
     ++all_shard_row_counts[shard];
   }
 }
@@ -2294,35 +2504,102 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
 bool Loader::loadImpl(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
                       size_t row_count,
                       bool checkpoint) {
-  if (table_desc->nShards) {
+  // rows of a SORT KEY table are loaded in sort key order, a fragment at a time: the fragments get narrow
+  // min / max ranges of the key instead of interleaving the whole range of values in arrival order
+  const auto load_to_shard = sort_key_col_idxs.empty() ? &Loader::loadToShard : &Loader::holdBackRows;
+  bool success = true;
+  if (table_desc->nShards || table_is_range_partitioned(table_desc)) {
     std::vector<OneShardBuffers> all_shard_import_buffers;
     std::vector<size_t> all_shard_row_counts;
     const auto shard_tables = catalog.getPhysicalTablesDescriptors(table_desc);
-    distributeToShards(all_shard_import_buffers, all_shard_row_counts, import_buffers, row_count, shard_tables.size());
-    bool success = true;
+    distributeToShards(all_shard_import_buffers, all_shard_row_counts, import_buffers, row_count, shard_tables);
+    // every shard has its own fragmenter, load them concurrently
+    std::vector<std::future<bool>> shard_loads;
     for (size_t shard_idx = 0; shard_idx < shard_tables.size(); ++shard_idx) {
       if (!all_shard_row_counts[shard_idx]) {
         continue;
       }
-      success = success && loadToShard(all_shard_import_buffers[shard_idx],
+      shard_loads.push_back(std::async(std::launch::async,
+                                       load_to_shard,
+                                       this,
+                                       std::cref(all_shard_import_buffers[shard_idx]),
                                        all_shard_row_counts[shard_idx],
                                        shard_tables[shard_idx],
-                                       checkpoint);
+                                       checkpoint));
     }
-    return success;
+    for (auto& shard_load : shard_loads) {
+      success = shard_load.get() && success;
+    }
+  } else {
+    success = (this->*load_to_shard)(import_buffers, row_count, table_desc, checkpoint);
   }
-  return loadToShard(import_buffers, row_count, table_desc, checkpoint);
+  if (checkpoint && !sort_key_col_idxs.empty()) {
+    success = loadPendingRows(true) && success;
+  }
+  return success;
 }
 
-bool Loader::loadToShard(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
-                         size_t row_count,
-                         const TableDescriptor* shard_table,
-                         bool checkpoint) {
-  std::lock_guard<std::mutex> loader_lock(loader_mutex_);
+bool Loader::holdBackRows(const OneShardBuffers& import_buffers,
+                          const size_t row_count,
+                          const TableDescriptor* shard_table,
+                          const bool checkpoint) {
+  PendingRows full_rows;
+  {
+    std::lock_guard<std::mutex> pending_rows_lock(pending_rows_mutex);
+    auto& rows = pending_rows[shard_table->tableId];
+    if (rows.import_buffers.empty()) {
+      rows.shard_table = shard_table;
+      for (const auto& typed_import_buffer : import_buffers) {
+        rows.import_buffers.emplace_back(
+            new TypedImportBuffer(typed_import_buffer->getColumnDesc(), typed_import_buffer->getStringDictionary()));
+      }
+    }
+    // the import threads reuse their buffers, copy the rows
+    for (size_t i = 0; i < row_count; ++i) {
+      append_row(rows.import_buffers, import_buffers, i);
+    }
+    rows.row_count += row_count;
+    // a checkpointing load() loads all the pending rows at its end
+    if (checkpoint || rows.row_count < static_cast<size_t>(shard_table->maxFragRows)) {
+      return true;
+    }
+    full_rows = std::move(rows);
+    pending_rows.erase(shard_table->tableId);
+  }
+  return loadSortedToShard(full_rows, false);
+}
 
+bool Loader::loadSortedToShard(const PendingRows& rows, const bool checkpoint) {
+  if (rows.row_count > 1) {
+    const auto sorted_import_buffers = sortBySortKey(rows.import_buffers, rows.row_count);
+    return loadToShard(sorted_import_buffers, rows.row_count, rows.shard_table, checkpoint);
+  }
+  return loadToShard(rows.import_buffers, rows.row_count, rows.shard_table, checkpoint);
+}
+
+bool Loader::loadPendingRows(const bool checkpoint) {
+  std::map<int, PendingRows> rows_to_load;
+  {
+    std::lock_guard<std::mutex> pending_rows_lock(pending_rows_mutex);
+    rows_to_load.swap(pending_rows);
+  }
+  std::vector<std::future<bool>> shard_loads;
+  for (const auto& rows : rows_to_load) {
+    shard_loads.push_back(
+        std::async(std::launch::async, &Loader::loadSortedToShard, this, std::cref(rows.second), checkpoint));
+  }
+  bool success = true;
+  for (auto& shard_load : shard_loads) {
+    success = shard_load.get() && success;
+  }
+  return success;
+}
+
+Fragmenter_Namespace::InsertData Loader::encodeInsertData(
+    const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+    size_t row_count) {
   Fragmenter_Namespace::InsertData ins_data(insert_data);
   ins_data.numRows = row_count;
-  bool success = true;
   for (const auto& import_buff : import_buffers) {
     DataBlockPtr p;
     if (import_buff->getTypeInfo().is_number() || import_buff->getTypeInfo().is_time() ||
@@ -2351,18 +2628,27 @@ bool Loader::loadToShard(const std::vector<std::unique_ptr<TypedImportBuffer>>&
     }
     ins_data.data.push_back(p);
   }
-  {
-    try {
-      if (checkpoint)
-        shard_table->fragmenter->insertData(ins_data);
-      else
-        shard_table->fragmenter->insertDataNoCheckpoint(ins_data);
-    } catch (std::exception& e) {
-      LOG(ERROR) << "Fragmenter Insert Exception: " << e.what();
-      success = false;
-    }
+  return ins_data;
+}
+
+bool Loader::loadToShard(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+                         size_t row_count,
+                         const TableDescriptor* shard_table,
+                         bool checkpoint) {
+  // Dictionary encoding runs on the calling import thread, string dictionaries do their own
+  // locking. The fragmenter serializes inserts into the same (shard) table by itself, so
+  // batches for different shards can be inserted at the same time.
+  auto ins_data = encodeInsertData(import_buffers, row_count);
+  try {
+    if (checkpoint)
+      shard_table->fragmenter->insertData(ins_data);
+    else
+      shard_table->fragmenter->insertDataNoCheckpoint(ins_data);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Fragmenter Insert Exception: " << e.what();
+    return false;
   }
-  return success;
+  return true;
 }
 
 void Loader::init() {
@@ -2378,6 +2664,7 @@ void Loader::init() {
     }
   }
   insert_data.numRows = 0;
+  sort_key_col_idxs = get_sort_key_column_indices(table_desc->keyMetainfo, column_descs);
 }
 
 void Detector::init() {
@@ -3124,6 +3411,9 @@ ImportStatus Importer::importDelimited(const std::string& file_path, const bool
     for (auto& p : threads)
       p.wait();
 
+    if (!load_failed && !loader->loadPendingRows(false)) {
+      load_failed = true;
+    }
     if (load_failed) {
       // rollback to starting epoch - undo all the added records
       loader->setTableEpoch(start_epoch);
@@ -3170,6 +3460,11 @@ int32_t Loader::getTableEpoch() {
 }
 
 void Loader::setTableEpoch(int32_t start_epoch) {
+  {
+    // the held back rows belong to the rolled back load
+    std::lock_guard<std::mutex> pending_rows_lock(pending_rows_mutex);
+    pending_rows.clear();
+  }
   get_catalog().setTableEpoch(get_catalog().get_currentDB().dbId, get_table_desc()->tableId, start_epoch);
 }
 
@@ -3773,6 +4068,9 @@ ImportStatus Importer::importGDAL(ColumnNameToSourceNameMapType columnNameToSour
   }
 #endif
 
+  if (!load_failed && !loader->loadPendingRows(false)) {
+    load_failed = true;
+  }
   if (load_failed) {
     // rollback to starting epoch - undo all the added records
     loader->setTableEpoch(start_epoch);
@@ -28,9 +28,11 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <boost/noncopyable.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <glog/logging.h>
 #include "../Shared/fixautotools.h"
 #include <ogrsf_frmts.h>
@@ -518,6 +520,10 @@ class TypedImportBuffer : boost::noncopyable {
   size_t add_arrow_values(const ColumnDescriptor* cd, const arrow::Array& data);
 
   void add_value(const ColumnDescriptor* cd, const std::string& val, const bool is_null, const CopyParams& copy_params);
+  void add_value(const ColumnDescriptor* cd,
+                 const boost::string_ref val,
+                 const bool is_null,
+                 const CopyParams& copy_params);
   void add_value(const ColumnDescriptor* cd, const TDatum& val, const bool is_null);
   void pop_value();
 
@@ -568,6 +574,8 @@ class Loader {
   virtual bool loadImpl(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
                         size_t row_count,
                         bool checkpoint);
+  // Loads the rows of a SORT KEY table held back by loadNoCheckpoint, before the importer checkpoints.
+  virtual bool loadPendingRows(const bool checkpoint);
   virtual void checkpoint();
   virtual int32_t getTableEpoch();
   virtual void setTableEpoch(const int32_t new_epoch);
@@ -578,20 +586,37 @@ class Loader {
   std::list<const ColumnDescriptor*> column_descs;
   Fragmenter_Namespace::InsertData insert_data;
   std::map<int, StringDictionary*> dict_map;
+  std::vector<size_t> sort_key_col_idxs;  // positions of the SORT KEY columns in column_descs
   void init();
   typedef std::vector<std::unique_ptr<TypedImportBuffer>> OneShardBuffers;
+  // Rows of a SORT KEY table are held back per physical table until a fragment's worth of them can be sorted.
+  struct PendingRows {
+    const TableDescriptor* shard_table{nullptr};
+    OneShardBuffers import_buffers;
+    size_t row_count{0};
+  };
+  std::map<int, PendingRows> pending_rows;
+  std::mutex pending_rows_mutex;
+  OneShardBuffers sortBySortKey(const OneShardBuffers& import_buffers, const size_t row_count) const;
   void distributeToShards(std::vector<OneShardBuffers>& all_shard_import_buffers,
                           std::vector<size_t>& all_shard_row_counts,
                           const OneShardBuffers& import_buffers,
                           const size_t row_count,
-                          const size_t shard_count);
+                          const std::vector<const TableDescriptor*>& shard_tables);
 
  private:
+  Fragmenter_Namespace::InsertData encodeInsertData(
+      const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+      size_t row_count);
   bool loadToShard(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
                    size_t row_count,
                    const TableDescriptor* shard_table,
                    bool checkpoint);
-  std::mutex loader_mutex_;
+  bool holdBackRows(const OneShardBuffers& import_buffers,
+                    const size_t row_count,
+                    const TableDescriptor* shard_table,
+                    const bool checkpoint);
+  bool loadSortedToShard(const PendingRows& rows, const bool checkpoint);
 };
 
 struct ImportStatus {
@@ -24,6 +24,7 @@
  **/
 
 #include <cstring>
+#include <fstream>
 #include <string>
 #include <iostream>
 #include <iterator>
@@ -80,12 +81,93 @@ class RebalanceCb : public RdKafka::RebalanceCb {
   }
 };
 
+using Transformation = std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>;
+
+// splits a delimited message into the fields of a row, returns false if it doesn't hold a row of the table
+bool parse_message(const char* payload,
+                   const size_t len,
+                   const TRowDescriptor& row_desc,
+                   const std::vector<const Transformation*>& xforms,
+                   const Importer_NS::CopyParams& copy_params,
+                   const bool remove_quotes,
+                   std::vector<TStringValue>& row) {
+  char field[MAX_FIELD_LEN];
+  size_t field_i = 0;
+
+  bool backEscape = false;
+
+  // the message is terminated by a line delimiter
+  for (size_t i = 0; i <= len; ++i) {
+    const char iit = i < len ? payload[i] : copy_params.line_delim;
+    if (iit == copy_params.delimiter || iit == copy_params.line_delim) {
+      bool end_of_field = (iit == copy_params.delimiter);
+      bool end_of_row;
+      if (end_of_field)
+        end_of_row = false;
+      else {
+        end_of_row = (row_desc[row.size()].col_type.type != TDatumType::STR) || (row.size() == row_desc.size() - 1);
+        if (!end_of_row) {
+          size_t l = copy_params.null_str.size();
+          if (field_i >= l && strncmp(field + field_i - l, copy_params.null_str.c_str(), l) == 0) {
+            end_of_row = true;
+          }
+        }
+      }
+      if (!end_of_field && !end_of_row) {
+        // not enough columns yet and it is a string column
+        // treat the line delimiter as part of the string
+        field[field_i++] = iit;
+      } else {
+        field[field_i] = '\0';
+        field_i = 0;
+        TStringValue ts;
+        ts.str_val = std::string(field);
+        ts.is_null = (ts.str_val.empty() || ts.str_val == copy_params.null_str);
+        auto xform = row.size() < row_desc.size() ? xforms[row.size()] : nullptr;
+        if (!ts.is_null && xform != nullptr) {
+          if (print_transformation)
+            std::cout << "\ntransforming\n" << ts.str_val << "\nto\n";
+          ts.str_val = boost::regex_replace(ts.str_val, *xform->first, *xform->second);
+          if (ts.str_val.empty())
+            ts.is_null = true;
+          if (print_transformation)
+            std::cout << ts.str_val << std::endl;
+        }
+
+        row.push_back(ts);  // add column value to row
+        if (end_of_row || (row.size() > row_desc.size())) {
+          break;  // found row
+        }
+      }
+    } else {
+      if (iit == '\\') {
+        backEscape = true;
+      } else if (backEscape || !remove_quotes || iit != '\"') {
+        field[field_i++] = iit;
+        backEscape = false;
+      }
+      // else if unescaped double-quote, continue without adding the
+      // character to the field string.
+    }
+    if (field_i >= MAX_FIELD_LEN) {
+      field[MAX_FIELD_LEN - 1] = '\0';
+      std::cerr << "String too long for buffer." << std::endl;
+      if (print_error_data)
+        std::cerr << field << std::endl;
+      field_i = 0;
+      break;
+    }
+  }
+  return row.size() == row_desc.size();
+}
+
 bool msg_consume(RdKafka::Message* message,
-                 RowToColumnLoader& row_loader,
-                 Importer_NS::CopyParams copy_params,
-                 const std::map<std::string, std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>>&
-                     transformations,
-                 const bool remove_quotes) {
+                 const StreamingColumnarLoader& row_loader,
+                 const TRowDescriptor& row_desc,
+                 const Importer_NS::CopyParams& copy_params,
+                 const std::vector<const Transformation*>& xforms,
+                 const bool remove_quotes,
+                 std::vector<TStringValue>& row) {
   switch (message->err()) {
     case RdKafka::ERR__TIMED_OUT:
       VLOG(1) << " Timed out";
@@ -106,101 +188,16 @@ bool msg_consume(RdKafka::Message* message,
         VLOG(1) << "Timestamp: " << tsname << " " << ts.timestamp << std::endl;
       }
 
-      char buffer[message->len() + 1];
-      sprintf(buffer, "%.*s\n", static_cast<int>(message->len()), static_cast<const char*>(message->payload()));
-      VLOG(1) << "Full Message received is :'" << buffer << "'";
-
-      char field[MAX_FIELD_LEN];
-      size_t field_i = 0;
-
-      bool backEscape = false;
+      const auto payload = static_cast<const char*>(message->payload());
+      VLOG(1) << "Full Message received is :'" << std::string(payload, message->len()) << "'";
 
-      auto row_desc = row_loader.get_row_descriptor();
-
-      const std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>* xforms[row_desc.size()];
-      for (size_t i = 0; i < row_desc.size(); i++) {
-        auto it = transformations.find(row_desc[i].col_name);
-        if (it != transformations.end())
-          xforms[i] = &(it->second);
-        else
-          xforms[i] = nullptr;
-      }
-
-      std::vector<TStringValue> row;  // used to store each row as we move through the stream
-
-      for (auto iit : buffer) {
-        if (iit == copy_params.delimiter || iit == copy_params.line_delim) {
-          bool end_of_field = (iit == copy_params.delimiter);
-          bool end_of_row;
-          if (end_of_field)
-            end_of_row = false;
-          else {
-            end_of_row = (row_desc[row.size()].col_type.type != TDatumType::STR) || (row.size() == row_desc.size() - 1);
-            if (!end_of_row) {
-              size_t l = copy_params.null_str.size();
-              if (field_i >= l && strncmp(field + field_i - l, copy_params.null_str.c_str(), l) == 0) {
-                end_of_row = true;
-              }
-            }
-          }
-          if (!end_of_field && !end_of_row) {
-            // not enough columns yet and it is a string column
-            // treat the line delimiter as part of the string
-            field[field_i++] = iit;
-          } else {
-            field[field_i] = '\0';
-            field_i = 0;
-            TStringValue ts;
-            ts.str_val = std::string(field);
-            ts.is_null = (ts.str_val.empty() || ts.str_val == copy_params.null_str);
-            auto xform = row.size() < row_desc.size() ? xforms[row.size()] : nullptr;
-            if (!ts.is_null && xform != nullptr) {
-              if (print_transformation)
-                std::cout << "\ntransforming\n" << ts.str_val << "\nto\n";
-              ts.str_val = boost::regex_replace(ts.str_val, *xform->first, *xform->second);
-              if (ts.str_val.empty())
-                ts.is_null = true;
-              if (print_transformation)
-                std::cout << ts.str_val << std::endl;
-            }
-
-            row.push_back(ts);  // add column value to row
-            if (end_of_row || (row.size() > row_desc.size())) {
-              break;  // found row
-            }
-          }
-        } else {
-          if (iit == '\\') {
-            backEscape = true;
-          } else if (backEscape || !remove_quotes || iit != '\"') {
-            field[field_i++] = iit;
-            backEscape = false;
-          }
-          // else if unescaped double-quote, continue without adding the
-          // character to the field string.
-        }
-        if (field_i >= MAX_FIELD_LEN) {
-          field[MAX_FIELD_LEN - 1] = '\0';
-          std::cerr << "String too long for buffer." << std::endl;
-          if (print_error_data)
-            std::cerr << field << std::endl;
-          field_i = 0;
-          break;
-        }
-      }
-      if (row.size() == row_desc.size()) {
-        // add the new data in the column format
-        bool record_loaded = row_loader.convert_string_to_column(row, copy_params);
-        if (!record_loaded) {
-          // record could not be parsed correctly consider it skipped
-          return false;
-        } else {
-          return true;
-        }
+      if (parse_message(payload, message->len(), row_desc, xforms, copy_params, remove_quotes, row)) {
+        // the conversion to the column format happens on the loader's parse threads
+        return true;
       } else {
         if (print_error_data) {
           std::cerr << "Incorrect number of columns for row: ";
-          std::cerr << row_loader.print_row_with_delim(row, copy_params) << std::endl;
+          std::cerr << row_loader.print_row_with_delim(row) << std::endl;
           return false;
         }
       }
@@ -268,10 +265,75 @@ class EventCb : public RdKafka::EventCb {
   }
 };
 
+std::vector<const Transformation*> get_column_transformations(
+    const TRowDescriptor& row_desc,
+    const std::map<std::string, Transformation>& transformations) {
+  std::vector<const Transformation*> xforms(row_desc.size(), nullptr);
+  for (size_t i = 0; i < row_desc.size(); i++) {
+    auto it = transformations.find(row_desc[i].col_name);
+    if (it != transformations.end())
+      xforms[i] = &(it->second);
+  }
+  return xforms;
+}
+
+// adds a parsed row to the batch, returns true when the batch was full and got handed to the loader
+bool add_row_to_batch(StreamingColumnarLoader& row_loader,
+                      std::vector<TStringValue>&& row,
+                      std::vector<std::vector<TStringValue>>& batch,
+                      const Importer_NS::CopyParams& copy_params) {
+  batch.push_back(std::move(row));
+  if (batch.size() < copy_params.batch_size) {
+    return false;
+  }
+  row_loader.add_rows(std::move(batch));
+  batch.clear();
+  batch.reserve(copy_params.batch_size);
+  return true;
+}
+
+// feeds the lines of a file through the same path as the messages consumed from a topic, one
+// message per line, to measure the importer without a broker
+void replay_insert(StreamingColumnarLoader& row_loader,
+                   const std::map<std::string, Transformation>& transformations,
+                   const Importer_NS::CopyParams& copy_params,
+                   const bool remove_quotes,
+                   const std::string& replay_file) {
+  std::ifstream replay(replay_file, std::ios::binary);
+  if (!replay) {
+    LOG(FATAL) << "Could not open replay file " << replay_file;
+  }
+  const auto row_desc = row_loader.get_row_descriptor();
+  const auto xforms = get_column_transformations(row_desc, transformations);
+  const auto start = std::chrono::steady_clock::now();
+  size_t skipped = 0;
+  std::vector<std::vector<TStringValue>> batch;
+  batch.reserve(copy_params.batch_size);
+  std::string message;
+  while (std::getline(replay, message, copy_params.line_delim)) {
+    msg_cnt++;
+    msg_bytes += message.size();
+    std::vector<TStringValue> row;
+    if (parse_message(message.data(), message.size(), row_desc, xforms, copy_params, remove_quotes, row)) {
+      add_row_to_batch(row_loader, std::move(row), batch, copy_params);
+    } else {
+      skipped++;
+    }
+  }
+  row_loader.add_rows(std::move(batch));
+  row_loader.flush();
+  const auto elapsed_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  const auto rows_loaded = row_loader.get_rows_loaded();
+  LOG(INFO) << "Replayed " << msg_cnt << " messages (" << msg_bytes << " bytes)";
+  std::cout << rows_loaded << " Rows Inserted, " << skipped + row_loader.get_rows_skipped() << " rows skipped in "
+            << elapsed_ms << " ms (" << (elapsed_ms ? rows_loaded * 1000 / elapsed_ms : rows_loaded) << " rows/s)."
+            << std::endl;
+}
+
 // reads from a kafka topic (expects delimited string input)
-void kafka_insert(RowToColumnLoader& row_loader,
-                  const std::map<std::string, std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>>&
-                      transformations,
+void kafka_insert(StreamingColumnarLoader& row_loader,
+                  const std::map<std::string, Transformation>& transformations,
                   const Importer_NS::CopyParams& copy_params,
                   const bool remove_quotes,
                   std::string group_id,
@@ -406,21 +468,26 @@ void kafka_insert(RowToColumnLoader& row_loader,
   /*
    * Consume messages
    */
-  size_t recv_rows = 0;
+  const auto row_desc = row_loader.get_row_descriptor();
+  const auto xforms = get_column_transformations(row_desc, transformations);
+  std::vector<std::vector<TStringValue>> batch;
+  batch.reserve(copy_params.batch_size);
+  size_t batches_in_flight = 0;
   int skipped = 0;
-  int rows_loaded = 0;
   while (run) {
     RdKafka::Message* msg = consumer->consume(10000);
     if (msg->err() == RdKafka::ERR_NO_ERROR) {
       if (!use_ccb) {
-        bool added = msg_consume(msg, row_loader, copy_params, transformations, remove_quotes);
+        std::vector<TStringValue> row;
+        bool added = msg_consume(msg, row_loader, row_desc, copy_params, xforms, remove_quotes, row);
         if (added) {
-          recv_rows++;
-          if (recv_rows == copy_params.batch_size) {
-            recv_rows = 0;
-            row_loader.do_load(rows_loaded, skipped, copy_params);
-            // make sure we now commit that we are up to here to cover the mesages we just loaded
+          if (add_row_to_batch(row_loader, std::move(row), batch, copy_params) &&
+              ++batches_in_flight == row_loader.get_connection_count()) {
+            // keep a batch loading on every connection, then wait for all of them before committing
+            // that we are up to here to cover the mesages we just loaded
+            row_loader.flush();
             consumer->commitSync();
+            batches_in_flight = 0;
           }
         } else {
           // LOG(ERROR) << " messsage was skipped ";
@@ -437,7 +504,8 @@ void kafka_insert(RowToColumnLoader& row_loader,
   consumer->close();
   delete consumer;
 
-  LOG(INFO) << "Consumed " << msg_cnt << " messages (" << msg_bytes << " bytes)";
+  LOG(INFO) << "Consumed " << msg_cnt << " messages (" << msg_bytes << " bytes), "
+            << skipped + row_loader.get_rows_skipped() << " rows skipped";
   LOG(FATAL) << "Consumer shut down, probably due to an error please review logs";
 };
 
@@ -458,13 +526,16 @@ int main(int argc, char** argv) {
   std::string group_id;
   std::string topic;
   std::string brokers;
+  std::string replay_file;
   std::string delim_str(","), nulls("\\N"), line_delim_str("\n"), quoted("false");
   size_t batch_size = 10000;
   size_t retry_count = 10;
   size_t retry_wait = 5;
+  size_t parse_threads = std::thread::hardware_concurrency();
+  size_t connections = 4;
   bool remove_quotes = false;
   std::vector<std::string> xforms;
-  std::map<std::string, std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>> transformations;
+  std::map<std::string, Transformation> transformations;
 
   google::InitGoogleLogging(argv[0]);
 
@@ -493,9 +564,18 @@ int main(int argc, char** argv) {
       "transform,t", po::value<std::vector<std::string>>(&xforms)->multitoken(), "Column Transformations");
   desc.add_options()("print_error", "Print Error Rows");
   desc.add_options()("print_transform", "Print Transformations");
-  desc.add_options()("topic", po::value<std::string>(&topic)->required(), "Kafka topic to consume from ");
-  desc.add_options()("group-id", po::value<std::string>(&group_id)->required(), "Group id this consumer is part of");
-  desc.add_options()("brokers", po::value<std::string>(&brokers)->required(), "list of kafka brokers for topic");
+  desc.add_options()("topic", po::value<std::string>(&topic), "Kafka topic to consume from ");
+  desc.add_options()("group-id", po::value<std::string>(&group_id), "Group id this consumer is part of");
+  desc.add_options()("brokers", po::value<std::string>(&brokers), "list of kafka brokers for topic");
+  desc.add_options()("replay",
+                     po::value<std::string>(&replay_file),
+                     "Load the messages of a file, one per line, instead of consuming a topic");
+  desc.add_options()("threads",
+                     po::value<size_t>(&parse_threads)->default_value(parse_threads),
+                     "Number of threads converting rows to columns");
+  desc.add_options()("connections",
+                     po::value<size_t>(&connections)->default_value(connections),
+                     "Number of server connections loading batches concurrently");
 
   po::positional_options_description positionalOptions;
   positionalOptions.add("table", 1);
@@ -510,7 +590,9 @@ int main(int argc, char** argv) {
           << "Usage: <table name> <database name> {-u|--user} <user> {-p|--passwd} <password> [{--host} "
              "<hostname>][--port <port number>][--delim <delimiter>][--null <null string>][--line <line "
              "delimiter>][--batch <batch size>][{-t|--transform} transformation [--quoted <true|false>] "
-             "...][--retry_count <num_of_retries>] [--retry_wait <wait in secs>][--print_error][--print_transform]\n\n";
+             "...][--retry_count <num_of_retries>] [--retry_wait <wait in secs>][--print_error][--print_transform]"
+             "[--topic <topic> --group-id <group id> --brokers <brokers> | --replay <file>][--threads <parse "
+             "threads>][--connections <server connections>]\n\n";
       std::cout << desc << std::endl;
       return 0;
     }
@@ -524,6 +606,10 @@ int main(int argc, char** argv) {
     std::cerr << "Usage Error: " << e.what() << std::endl;
     return 1;
   }
+  if (replay_file.empty() && (topic.empty() || group_id.empty() || brokers.empty())) {
+    std::cerr << "Usage Error: --topic, --group-id and --brokers are required unless replaying a file" << std::endl;
+    return 1;
+  }
 
   char delim = delim_str[0];
   if (delim == '\\') {
@@ -618,8 +704,16 @@ int main(int argc, char** argv) {
   }
 
   Importer_NS::CopyParams copy_params(delim, nulls, line_delim, batch_size, retry_count, retry_wait);
-  RowToColumnLoader row_loader(server_host, port, db_name, user_name, passwd, table_name);
-
+  StreamingColumnarLoader row_loader(ConnectionDetails(server_host, port, db_name, user_name, passwd),
+                                     table_name,
+                                     copy_params,
+                                     parse_threads,
+                                     connections);
+
+  if (!replay_file.empty()) {
+    replay_insert(row_loader, transformations, copy_params, remove_quotes, replay_file);
+    return 0;
+  }
   kafka_insert(row_loader, transformations, copy_params, remove_quotes, group_id, topic, brokers);
   return 0;
 }
@@ -121,7 +121,7 @@ SQLTypeInfo create_array_sql_type_info_from_col_type(const TColumnType& ct) {
 }
 
 std::string RowToColumnLoader::print_row_with_delim(std::vector<TStringValue> row,
-                                                    const Importer_NS::CopyParams& copy_params) {
+                                                    const Importer_NS::CopyParams& copy_params) const {
   std::ostringstream out;
   bool first = true;
   for (TStringValue ts : row) {
@@ -272,12 +272,18 @@ void populate_TColumn(TStringValue ts,
   }
 }
 
-TRowDescriptor RowToColumnLoader::get_row_descriptor() {
+TRowDescriptor RowToColumnLoader::get_row_descriptor() const {
   return row_desc_;
 };
 
 bool RowToColumnLoader::convert_string_to_column(std::vector<TStringValue> row,
                                                  const Importer_NS::CopyParams& copy_params) {
+  return convert_string_to_column(row, copy_params, input_columns_);
+}
+
+bool RowToColumnLoader::convert_string_to_column(const std::vector<TStringValue>& row,
+                                                 const Importer_NS::CopyParams& copy_params,
+                                                 std::vector<TColumn>& columns) const {
   // create datum and push data to column structure from row data
   uint curr_col = 0;
   for (TStringValue ts : row) {
@@ -295,15 +301,15 @@ bool RowToColumnLoader::convert_string_to_column(std::vector<TStringValue> row,
             // now put into TColumn
             populate_TColumn(tsa, array_column_type_info_[curr_col], array_tcol, copy_params);
           }
-          input_columns_[curr_col].nulls.push_back(false);
-          input_columns_[curr_col].data.arr_col.push_back(array_tcol);
+          columns[curr_col].nulls.push_back(false);
+          columns[curr_col].data.arr_col.push_back(array_tcol);
 
         } break;
         default:
-          populate_TColumn(ts, column_type_info_[curr_col], input_columns_[curr_col], copy_params);
+          populate_TColumn(ts, column_type_info_[curr_col], columns[curr_col], copy_params);
       }
     } catch (const std::exception& e) {
-      remove_partial_row(curr_col, column_type_info_, input_columns_);
+      remove_partial_row(curr_col, column_type_info_, columns);
       // import_status.rows_rejected++;
       LOG(ERROR) << "Input exception thrown: " << e.what() << ". Row discarded, issue at column : " << (curr_col + 1)
                  << " data :" << print_row_with_delim(row, copy_params);
@@ -387,20 +393,11 @@ void RowToColumnLoader::wait_disconnet_reconnnect_retry(size_t tries,
   createConnection(conn_details);
 }
 
-void RowToColumnLoader::do_load(int& nrows, int& nskipped, Importer_NS::CopyParams copy_params) {
+template <typename LOAD>
+void RowToColumnLoader::load_with_retries(LOAD load, const Importer_NS::CopyParams& copy_params) {
   for (size_t tries = 0; tries < copy_params.retry_count; tries++) {  // allow for retries in case of insert failure
     try {
-      client_->load_table_binary_columnar(session_, table_name_, input_columns_);
-      //      client->load_table(session, table_name, input_rows);
-      nrows += input_columns_[0].nulls.size();
-      std::cout << nrows << " Rows Inserted, " << nskipped << " rows skipped." << std::endl;
-      // we successfully loaded the data, lets move on
-      input_columns_.clear();
-      // create vector for storage of the actual column data
-      for (TColumnType column : row_desc_) {
-        TColumn t;
-        input_columns_.push_back(t);
-      }
+      load();
       return;
     } catch (TMapDException& e) {
       std::cerr << "Exception trying to insert data " << e.error_msg << std::endl;
@@ -413,3 +410,157 @@ void RowToColumnLoader::do_load(int& nrows, int& nskipped, Importer_NS::CopyPara
   std::cerr << "Retries exhausted program terminated" << std::endl;
   exit(1);
 }
+
+void RowToColumnLoader::do_load(int& nrows, int& nskipped, Importer_NS::CopyParams copy_params) {
+  load_columns(input_columns_, copy_params);
+  nrows += input_columns_[0].nulls.size();
+  std::cout << nrows << " Rows Inserted, " << nskipped << " rows skipped." << std::endl;
+  // we successfully loaded the data, lets move on
+  input_columns_.clear();
+  // create vector for storage of the actual column data
+  for (TColumnType column : row_desc_) {
+    TColumn t;
+    input_columns_.push_back(t);
+  }
+}
+
+void RowToColumnLoader::load_columns(const std::vector<TColumn>& columns, const Importer_NS::CopyParams& copy_params) {
+  load_with_retries([this, &columns] { client_->load_table_binary_columnar(session_, table_name_, columns); },
+                    copy_params);
+}
+
+void RowToColumnLoader::load_arrow_stream(const std::string& arrow_stream, const Importer_NS::CopyParams& copy_params) {
+  load_with_retries([this, &arrow_stream] { client_->load_table_binary_arrow(session_, table_name_, arrow_stream); },
+                    copy_params);
+}
+
+namespace {
+
+std::vector<std::unique_ptr<ColumnarLoaderConnection>> connect(const ConnectionDetails& conn_details,
+                                                               const std::string& table_name,
+                                                               const size_t connection_count) {
+  std::vector<std::unique_ptr<ColumnarLoaderConnection>> connections;
+  for (size_t i = 0; i < std::max(connection_count, size_t(1)); ++i) {
+    connections.emplace_back(new RowToColumnLoader(conn_details.server_host,
+                                                   conn_details.port,
+                                                   conn_details.db_name,
+                                                   conn_details.user_name,
+                                                   conn_details.passwd,
+                                                   table_name));
+  }
+  return connections;
+}
+
+}  // namespace
+
+StreamingColumnarLoader::StreamingColumnarLoader(const ConnectionDetails& conn_details,
+                                                 const std::string& table_name,
+                                                 const Importer_NS::CopyParams& copy_params,
+                                                 const size_t parse_threads,
+                                                 const size_t connections)
+    : StreamingColumnarLoader(connect(conn_details, table_name, connections), copy_params, parse_threads) {}
+
+StreamingColumnarLoader::StreamingColumnarLoader(std::vector<std::unique_ptr<ColumnarLoaderConnection>>&& connections,
+                                                 const Importer_NS::CopyParams& copy_params,
+                                                 const size_t parse_threads)
+    : copy_params_(copy_params),
+      connections_(std::move(connections)),
+      parse_queue_(parse_threads),
+      load_queue_(connections_.size()),
+      pending_batches_(0),
+      rows_loaded_(0),
+      rows_skipped_(0) {
+  CHECK(!connections_.empty());
+  for (size_t i = 0; i < std::max(parse_threads, size_t(1)); ++i) {
+    parse_threads_.emplace_back([this] { parse_rows(); });
+  }
+  for (auto& connection : connections_) {
+    auto connection_ptr = connection.get();
+    load_threads_.emplace_back([this, connection_ptr] { load_batches(connection_ptr); });
+  }
+}
+
+StreamingColumnarLoader::~StreamingColumnarLoader() {
+  parse_queue_.close();
+  for (auto& parse_thread : parse_threads_) {
+    parse_thread.join();
+  }
+  load_queue_.close();
+  for (auto& load_thread : load_threads_) {
+    load_thread.join();
+  }
+}
+
+void StreamingColumnarLoader::add_rows(std::vector<std::vector<TStringValue>>&& rows) {
+  if (rows.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    ++pending_batches_;
+  }
+  parse_queue_.push(std::move(rows));
+}
+
+void StreamingColumnarLoader::add_arrow_stream(std::string&& arrow_stream, const size_t row_count) {
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    ++pending_batches_;
+  }
+  LoadBatch batch;
+  batch.arrow_stream = std::move(arrow_stream);
+  batch.row_count = row_count;
+  load_queue_.push(std::move(batch));
+}
+
+void StreamingColumnarLoader::flush() {
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  pending_done_.wait(lock, [this] { return pending_batches_ == 0; });
+}
+
+void StreamingColumnarLoader::parse_rows() {
+  const auto& converter = *connections_.front();
+  const auto column_count = converter.get_row_descriptor().size();
+  std::vector<std::vector<TStringValue>> rows;
+  while (parse_queue_.pop(rows)) {
+    LoadBatch batch;
+    batch.columns.resize(column_count);
+    batch.row_count = 0;
+    for (const auto& row : rows) {
+      if (converter.convert_string_to_column(row, copy_params_, batch.columns)) {
+        ++batch.row_count;
+      } else {
+        ++rows_skipped_;
+      }
+    }
+    if (batch.row_count) {
+      load_queue_.push(std::move(batch));
+    } else {
+      batch_done();
+    }
+  }
+}
+
+void StreamingColumnarLoader::load_batches(ColumnarLoaderConnection* connection) {
+  LoadBatch batch;
+  while (load_queue_.pop(batch)) {
+    if (batch.arrow_stream.empty()) {
+      connection->load_columns(batch.columns, copy_params_);
+    } else {
+      connection->load_arrow_stream(batch.arrow_stream, copy_params_);
+    }
+    const size_t nrows = rows_loaded_ += batch.row_count;
+    std::ostringstream progress;
+    progress << nrows << " Rows Inserted, " << rows_skipped_ << " rows skipped." << std::endl;
+    std::cout << progress.str();
+    batch_done();
+  }
+}
+
+void StreamingColumnarLoader::batch_done() {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  CHECK_GT(pending_batches_, size_t(0));
+  if (--pending_batches_ == 0) {
+    pending_done_.notify_all();
+  }
+}
@@ -37,8 +37,14 @@
 #include "Shared/mapd_shared_ptr.h"
 #include "Shared/sqltypes.h"
 
-#include <thread>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <boost/program_options.hpp>
 
@@ -70,7 +76,22 @@ struct ConnectionDetails {
   ConnectionDetails(){};
 };
 
-class RowToColumnLoader {
+// What StreamingColumnarLoader needs from a connection to the server, RowToColumnLoader
+// implements it over Thrift.
+class ColumnarLoaderConnection {
+ public:
+  virtual ~ColumnarLoaderConnection() {}
+  virtual bool convert_string_to_column(const std::vector<TStringValue>& row,
+                                        const Importer_NS::CopyParams& copy_params,
+                                        std::vector<TColumn>& columns) const = 0;
+  virtual void load_columns(const std::vector<TColumn>& columns, const Importer_NS::CopyParams& copy_params) = 0;
+  virtual void load_arrow_stream(const std::string& arrow_stream, const Importer_NS::CopyParams& copy_params) = 0;
+  virtual TRowDescriptor get_row_descriptor() const = 0;
+  virtual std::string print_row_with_delim(std::vector<TStringValue> row,
+                                           const Importer_NS::CopyParams& copy_params) const = 0;
+};
+
+class RowToColumnLoader : public ColumnarLoaderConnection {
  public:
   RowToColumnLoader(const std::string server_host,
                     const int port,
@@ -78,11 +99,19 @@ class RowToColumnLoader {
                     const std::string user_name,
                     const std::string passwd,
                     const std::string table_name);
-  ~RowToColumnLoader();
+  ~RowToColumnLoader() override;
   void do_load(int& nrows, int& nskipped, Importer_NS::CopyParams copy_params);
   bool convert_string_to_column(std::vector<TStringValue> row, const Importer_NS::CopyParams& copy_params);
-  TRowDescriptor get_row_descriptor();
-  std::string print_row_with_delim(std::vector<TStringValue> row, const Importer_NS::CopyParams& copy_params);
+  // Converts a row into the given columns rather than the loader's own, safe to call from several threads.
+  bool convert_string_to_column(const std::vector<TStringValue>& row,
+                                const Importer_NS::CopyParams& copy_params,
+                                std::vector<TColumn>& columns) const override;
+  // Loads a batch over this loader's connection, reconnecting and retrying on failure.
+  void load_columns(const std::vector<TColumn>& columns, const Importer_NS::CopyParams& copy_params) override;
+  void load_arrow_stream(const std::string& arrow_stream, const Importer_NS::CopyParams& copy_params) override;
+  TRowDescriptor get_row_descriptor() const override;
+  std::string print_row_with_delim(std::vector<TStringValue> row,
+                                   const Importer_NS::CopyParams& copy_params) const override;
 
  private:
   std::string table_name_;
@@ -104,6 +133,105 @@ class RowToColumnLoader {
   void wait_disconnet_reconnnect_retry(size_t tries,
                                        Importer_NS::CopyParams copy_params,
                                        ConnectionDetails conn_details);
+  template <typename LOAD>
+  void load_with_retries(LOAD load, const Importer_NS::CopyParams& copy_params);
+};
+
+// Bounded queue between the stages of StreamingColumnarLoader. push() blocks while the queue
+// is full, pop() returns false once the queue has been closed and drained.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(const size_t capacity) : capacity_(std::max(capacity, size_t(1))), closed_(false) {}
+
+  void push(T&& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::deque<T> items_;
+  bool closed_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+// Pipelined version of RowToColumnLoader for the streaming importers: batches of delimited rows
+// are converted into typed columns on parse_threads threads and loaded over a pool of
+// connections, so that up to two batches per connection are in flight instead of one
+// synchronous batch at a time. Serialized Arrow record batches skip the parse stage.
+class StreamingColumnarLoader {
+ public:
+  StreamingColumnarLoader(const ConnectionDetails& conn_details,
+                          const std::string& table_name,
+                          const Importer_NS::CopyParams& copy_params,
+                          const size_t parse_threads,
+                          const size_t connections);
+  // Runs the pipeline over the given connections, the first one also converts the rows.
+  StreamingColumnarLoader(std::vector<std::unique_ptr<ColumnarLoaderConnection>>&& connections,
+                          const Importer_NS::CopyParams& copy_params,
+                          const size_t parse_threads);
+  ~StreamingColumnarLoader();
+
+  // Both block while the pipeline is full.
+  void add_rows(std::vector<std::vector<TStringValue>>&& rows);
+  void add_arrow_stream(std::string&& arrow_stream, const size_t row_count);
+
+  // Waits until everything added so far has been loaded.
+  void flush();
+
+  TRowDescriptor get_row_descriptor() const { return connections_.front()->get_row_descriptor(); }
+  std::string print_row_with_delim(std::vector<TStringValue> row) const {
+    return connections_.front()->print_row_with_delim(row, copy_params_);
+  }
+  size_t get_connection_count() const { return connections_.size(); }
+  size_t get_rows_loaded() const { return rows_loaded_; }
+  size_t get_rows_skipped() const { return rows_skipped_; }
+
+ private:
+  struct LoadBatch {
+    std::vector<TColumn> columns;
+    std::string arrow_stream;
+    size_t row_count;
+  };
+
+  void parse_rows();
+  void load_batches(ColumnarLoaderConnection* connection);
+  void batch_done();
+
+  const Importer_NS::CopyParams copy_params_;
+  std::vector<std::unique_ptr<ColumnarLoaderConnection>> connections_;
+  BoundedQueue<std::vector<std::vector<TStringValue>>> parse_queue_;
+  BoundedQueue<LoadBatch> load_queue_;
+  std::vector<std::thread> parse_threads_;
+  std::vector<std::thread> load_threads_;
+  std::mutex pending_mutex_;
+  std::condition_variable pending_done_;
+  size_t pending_batches_;
+  std::atomic<size_t> rows_loaded_;
+  std::atomic<size_t> rows_skipped_;
 };
 
 #endif  // _ROWTOCOLUMNLOADER_H_
@@ -23,6 +23,7 @@
  * Copyright (c) 2017 MapD Technologies, Inc.  All rights reserved.
  **/
 
+#include <cerrno>
 #include <cstring>
 #include <string>
 #include <iostream>
@@ -40,28 +41,56 @@
 
 #include <boost/program_options.hpp>
 
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
+
 #define MAX_FIELD_LEN 20000
 
 bool print_error_data = false;
 bool print_transformation = false;
 
-// reads copy_params.delimiter delimited rows from std::cin and load them to
-// table_name in batches of size copy_params.batch_size until EOF
-void stream_insert(RowToColumnLoader& row_loader,
+// Reads the input a block at a time, std::istream_iterator<char> costs a stream call per character.
+class BlockReader {
+ public:
+  explicit BlockReader(FILE* file) : file_(file), buffer_(1 << 20), pos_(0), end_(0) { fill(); }
+
+  bool eof() const { return pos_ == end_; }
+
+  char get() const { return buffer_[pos_]; }
+
+  void next() {
+    if (pos_ < end_ && ++pos_ == end_) {
+      fill();
+    }
+  }
+
+ private:
+  void fill() {
+    pos_ = 0;
+    end_ = fread(&buffer_[0], 1, buffer_.size(), file_);
+  }
+
+  FILE* file_;
+  std::vector<char> buffer_;
+  size_t pos_;
+  size_t end_;
+};
+
+// reads copy_params.delimiter delimited rows from input and hands them to the loader in
+// batches of size copy_params.batch_size until EOF
+void stream_insert(StreamingColumnarLoader& row_loader,
+                   FILE* input,
                    const std::map<std::string, std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>>&
                        transformations,
                    const Importer_NS::CopyParams& copy_params,
-                   const bool remove_quotes) {
-  std::ios_base::sync_with_stdio(false);
-  std::istream_iterator<char> eos;
-  std::cin >> std::noskipws;
-  std::istream_iterator<char> iit(std::cin);
+                   const bool remove_quotes,
+                   size_t& nskipped) {
+  BlockReader iit(input);
 
   char field[MAX_FIELD_LEN];
   size_t field_i = 0;
 
-  int nrows = 0;
-  int nskipped = 0;
   bool backEscape = false;
 
   auto row_desc = row_loader.get_row_descriptor();
@@ -76,13 +105,15 @@ void stream_insert(RowToColumnLoader& row_loader,
   }
 
   std::vector<TStringValue> row;  // used to store each row as we move through the stream
+  std::vector<std::vector<TStringValue>> batch;
+  batch.reserve(copy_params.batch_size);
 
-  int read_rows = 0;
-  while (iit != eos) {
+  while (!iit.eof()) {
     // construct a row
-    while (iit != eos) {
-      if (*iit == copy_params.delimiter || *iit == copy_params.line_delim) {
-        bool end_of_field = (*iit == copy_params.delimiter);
+    while (!iit.eof()) {
+      const char c = iit.get();
+      if (c == copy_params.delimiter || c == copy_params.line_delim) {
+        bool end_of_field = (c == copy_params.delimiter);
         bool end_of_row;
         if (end_of_field)
           end_of_row = false;
@@ -98,7 +129,7 @@ void stream_insert(RowToColumnLoader& row_loader,
         if (!end_of_field && !end_of_row) {
           // not enough columns yet and it is a string column
           // treat the line delimiter as part of the string
-          field[field_i++] = *iit;
+          field[field_i++] = c;
         } else {
           field[field_i] = '\0';
           field_i = 0;
@@ -122,10 +153,10 @@ void stream_insert(RowToColumnLoader& row_loader,
           }
         }
       } else {
-        if (*iit == '\\') {
+        if (c == '\\') {
           backEscape = true;
-        } else if (backEscape || !remove_quotes || *iit != '\"') {
-          field[field_i++] = *iit;
+        } else if (backEscape || !remove_quotes || c != '\"') {
+          field[field_i++] = c;
           backEscape = false;
         }
         // else if unescaped double-quote, continue without adding the
@@ -139,39 +170,81 @@ void stream_insert(RowToColumnLoader& row_loader,
         field_i = 0;
         break;
       }
-      ++iit;
+      iit.next();
     }
     if (row.size() == row_desc.size()) {
-      // add the new data in the column format
-      bool record_loaded = row_loader.convert_string_to_column(row, copy_params);
-      read_rows++;
-      if (!record_loaded) {
-        // record could not be parsed correctly conside rit skipped
-        ++nskipped;
-      }
-      row.clear();
-      if (read_rows % copy_params.batch_size == 0) {
-        row_loader.do_load(nrows, nskipped, copy_params);
+      // conversion to the column format happens on the loader's parse threads
+      batch.push_back(std::move(row));
+      if (batch.size() == copy_params.batch_size) {
+        row_loader.add_rows(std::move(batch));
+        batch.clear();
+        batch.reserve(copy_params.batch_size);
       }
     } else {
       ++nskipped;
       if (print_error_data) {
         std::cerr << "Incorrect number of columns for row: ";
-        std::cerr << row_loader.print_row_with_delim(row, copy_params) << std::endl;
+        std::cerr << row_loader.print_row_with_delim(row) << std::endl;
       }
       if (row.size() > row_desc.size()) {
         // skip to the next line delimiter
-        while (*iit != copy_params.line_delim)
-          ++iit;
+        while (!iit.eof() && iit.get() != copy_params.line_delim)
+          iit.next();
       }
-      row.clear();
     }
-    ++iit;
+    row.clear();
+    iit.next();
   }
   // load remaining rows if any
-  if (read_rows % copy_params.batch_size != 0) {
-    LOG(INFO) << " read_rows " << read_rows;
-    row_loader.do_load(nrows, nskipped, copy_params);
+  if (!batch.empty()) {
+    LOG(INFO) << " read_rows " << batch.size();
+    row_loader.add_rows(std::move(batch));
+  }
+}
+
+void throw_if_not_ok(const arrow::Status& status) {
+  if (!status.ok()) {
+    throw std::runtime_error(status.ToString());
+  }
+}
+
+// reads an Arrow IPC stream and loads every record batch of it through load_table_binary_arrow,
+// which takes a stream with a single batch
+void stream_insert_arrow(StreamingColumnarLoader& row_loader, const std::string& input_path) {
+  std::shared_ptr<arrow::io::InputStream> input;
+  if (input_path.empty()) {
+    std::ostringstream stdin_contents;
+    stdin_contents << std::cin.rdbuf();
+    const auto contents = std::make_shared<std::string>(stdin_contents.str());
+    auto buffer = std::make_shared<arrow::Buffer>(reinterpret_cast<const uint8_t*>(contents->data()),
+                                                  static_cast<int64_t>(contents->size()));
+    // keeps the contents alive along with the reader
+    input.reset(new arrow::io::BufferReader(buffer),
+                [contents](arrow::io::BufferReader* reader) { delete reader; });
+  } else {
+    std::shared_ptr<arrow::io::ReadableFile> file;
+    throw_if_not_ok(arrow::io::ReadableFile::Open(input_path, &file));
+    input = file;
+  }
+  std::shared_ptr<arrow::RecordBatchReader> batch_reader;
+  throw_if_not_ok(arrow::ipc::RecordBatchStreamReader::Open(input.get(), &batch_reader));
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    throw_if_not_ok(batch_reader->ReadNext(&batch));
+    if (batch == nullptr) {
+      break;
+    }
+    std::shared_ptr<arrow::io::BufferOutputStream> sink;
+    throw_if_not_ok(arrow::io::BufferOutputStream::Create(0, arrow::default_memory_pool(), &sink));
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> batch_writer;
+    throw_if_not_ok(arrow::ipc::RecordBatchStreamWriter::Open(sink.get(), batch->schema(), &batch_writer));
+    throw_if_not_ok(batch_writer->WriteRecordBatch(*batch));
+    throw_if_not_ok(batch_writer->Close());
+    std::shared_ptr<arrow::Buffer> serialized_batch;
+    throw_if_not_ok(sink->Finish(&serialized_batch));
+    row_loader.add_arrow_stream(
+        std::string(reinterpret_cast<const char*>(serialized_batch->data()), serialized_batch->size()),
+        batch->num_rows());
   }
 }
 
@@ -186,6 +259,9 @@ int main(int argc, char** argv) {
   size_t batch_size = 10000;
   size_t retry_count = 10;
   size_t retry_wait = 5;
+  size_t parse_threads = std::thread::hardware_concurrency();
+  size_t connections = 4;
+  std::string input_path;
   bool remove_quotes = false;
   std::vector<std::string> xforms;
   std::map<std::string, std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>> transformations;
@@ -217,6 +293,15 @@ int main(int argc, char** argv) {
       "transform,t", po::value<std::vector<std::string>>(&xforms)->multitoken(), "Column Transformations");
   desc.add_options()("print_error", "Print Error Rows");
   desc.add_options()("print_transform", "Print Transformations");
+  desc.add_options()(
+      "input", po::value<std::string>(&input_path), "File to read instead of stdin, e.g. to replay a captured stream");
+  desc.add_options()("arrow", "Input is an Arrow IPC stream instead of delimited text");
+  desc.add_options()("threads",
+                     po::value<size_t>(&parse_threads)->default_value(parse_threads),
+                     "Number of threads converting rows to columns");
+  desc.add_options()("connections",
+                     po::value<size_t>(&connections)->default_value(connections),
+                     "Number of server connections loading batches concurrently");
 
   po::positional_options_description positionalOptions;
   positionalOptions.add("table", 1);
@@ -231,7 +316,8 @@ int main(int argc, char** argv) {
           << "Usage: <table name> <database name> {-u|--user} <user> {-p|--passwd} <password> [{--host} "
              "<hostname>][--port <port number>][--delim <delimiter>][--null <null string>][--line <line "
              "delimiter>][--batch <batch size>][{-t|--transform} transformation [--quoted <true|false>] "
-             "...][--retry_count <num_of_retries>] [--retry_wait <wait in secs>][--print_error][--print_transform]\n\n";
+             "...][--retry_count <num_of_retries>] [--retry_wait <wait in secs>][--print_error][--print_transform]"
+             "[--input <file>][--arrow][--threads <parse threads>][--connections <server connections>]\n\n";
       std::cout << desc << std::endl;
       return 0;
     }
@@ -338,8 +424,45 @@ int main(int argc, char** argv) {
         std::unique_ptr<std::string>(new std::string(fmt_str)));
   }
 
+  FILE* input = stdin;
+  if (!input_path.empty() && !vm.count("arrow")) {
+    input = fopen(input_path.c_str(), "rb");
+    if (!input) {
+      std::cerr << "Could not open " << input_path << ": " << strerror(errno) << std::endl;
+      return 1;
+    }
+  }
+
   Importer_NS::CopyParams copy_params(delim, nulls, line_delim, batch_size, retry_count, retry_wait);
-  RowToColumnLoader row_loader(server_host, port, db_name, user_name, passwd, table_name);
-  stream_insert(row_loader, transformations, copy_params, remove_quotes);
+  const auto start = std::chrono::steady_clock::now();
+  size_t nrows = 0;
+  size_t nskipped = 0;
+  {
+    StreamingColumnarLoader row_loader(ConnectionDetails(server_host, port, db_name, user_name, passwd),
+                                       table_name,
+                                       copy_params,
+                                       parse_threads,
+                                       connections);
+    try {
+      if (vm.count("arrow")) {
+        stream_insert_arrow(row_loader, input_path);
+      } else {
+        stream_insert(row_loader, input, transformations, copy_params, remove_quotes, nskipped);
+      }
+    } catch (const std::exception& e) {
+      std::cerr << "Could not read input: " << e.what() << std::endl;
+      return 1;
+    }
+    row_loader.flush();
+    nrows = row_loader.get_rows_loaded();
+    nskipped += row_loader.get_rows_skipped();
+  }
+  if (input != stdin) {
+    fclose(input);
+  }
+  const auto elapsed_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << nrows << " Rows Inserted, " << nskipped << " rows skipped in " << elapsed_ms << " ms ("
+            << (elapsed_ms ? nrows * 1000 / elapsed_ms : nrows) << " rows/s)." << std::endl;
   return 0;
 }
@@ -16,11 +16,18 @@
 
 #include "MapDServer.h"
 #include "ThriftHandler/MapDHandler.h"
+#include "ThriftHandler/RequestScheduler.h"
 
 #include <thrift/concurrency/PlatformThreadFactory.h>
 #include <thrift/concurrency/ThreadManager.h>
 #include <thrift/protocol/TBinaryProtocol.h>
 #include <thrift/protocol/TJSONProtocol.h>
+#ifdef HAVE_THRIFT_NONBLOCKING
+#include <thrift/server/TNonblockingServer.h>
+#ifdef HAVE_THRIFT_STD_SHAREDPTR
+#include <thrift/transport/TNonblockingServerSocket.h>
+#endif
+#endif
 #include <thrift/server/TThreadedServer.h>
 #include <thrift/transport/TBufferTransports.h>
 #include <thrift/transport/THttpServer.h>
@@ -50,6 +57,9 @@ using namespace ::apache::thrift::transport;
 
 extern bool g_aggregator;
 extern size_t g_leaf_count;
+extern bool g_enable_insert_log;
+extern size_t g_insert_log_checkpoint_bytes;
+extern size_t g_insert_log_checkpoint_interval_ms;
 
 AggregatedColRange column_ranges_from_thrift(const std::vector<TColumnRange>& thrift_column_ranges) {
   AggregatedColRange column_ranges;
@@ -138,7 +148,7 @@ void register_signal_handler() {
   signal(SIGTERM, mapd_signal_handler);
 }
 
-void start_server(TThreadedServer& server) {
+void start_server(TServer& server) {
   try {
     server.serve();
   } catch (std::exception& e) {
@@ -312,6 +322,23 @@ int main(int argc, char** argv) {
       "disable-legacy-syntax",
       po::value<bool>(&enable_legacy_syntax)->default_value(enable_legacy_syntax)->implicit_value(false),
       "Enable legacy syntax");
+  desc_adv.add_options()("num-request-threads",
+                         po::value<size_t>(&mapd_parameters.num_request_threads)
+                             ->default_value(mapd_parameters.num_request_threads),
+                         "Max number of requests executing at the same time, 0 runs every request as it comes");
+  desc_adv.add_options()("request-queue-size",
+                         po::value<size_t>(&mapd_parameters.request_queue_size)
+                             ->default_value(mapd_parameters.request_queue_size),
+                         "Max number of requests waiting for an execution slot; further requests are rejected");
+  desc_adv.add_options()("nonblocking-server",
+                         po::value<bool>(&mapd_parameters.nonblocking_server)
+                             ->default_value(mapd_parameters.nonblocking_server)
+                             ->implicit_value(true),
+                         "Serve the binary protocol port with a non-blocking, worker pool server (framed transport)");
+  desc_adv.add_options()("cursor-idle-timeout",
+                         po::value<size_t>(&mapd_parameters.cursor_timeout_s)
+                             ->default_value(mapd_parameters.cursor_timeout_s),
+                         "Seconds after which a result cursor nobody fetched from is closed, 0 to never close them");
   desc_adv.add_options()("num-reader-threads",
                          po::value<size_t>(&num_reader_threads)->default_value(num_reader_threads),
                          "Number of reader threads to use");
@@ -368,11 +395,58 @@ int main(int argc, char** argv) {
       "hll-precision-bits",
       po::value<int>(&g_hll_precision_bits)->default_value(g_hll_precision_bits)->implicit_value(g_hll_precision_bits),
       "Number of bits used from the hash value used to specify the bucket number.");
+  desc_adv.add_options()("result-set-cache-bytes",
+                         po::value<size_t>(&g_result_set_cache_bytes)->default_value(g_result_set_cache_bytes),
+                         "Memory budget for caching final query results, 0 disables the cache");
+  desc_adv.add_options()("group-by-spill-entries",
+                         po::value<size_t>(&g_group_by_spill_entries)->default_value(g_group_by_spill_entries),
+                         "Output slots a group by keeps in memory, past it the groups are hash partitioned and "
+                         "spilled to the data directory");
+  desc_adv.add_options()("max-concurrent-steps",
+                         po::value<size_t>(&g_max_concurrent_steps)->default_value(g_max_concurrent_steps),
+                         "Independent steps and subqueries of a query which run at the same time, 1 runs them "
+                         "in order");
+  desc_adv.add_options()("enable-partitioned-reduction",
+                         po::value<bool>(&g_enable_partitioned_reduction)
+                             ->default_value(g_enable_partitioned_reduction)
+                             ->implicit_value(true),
+                         "Radix partition large group by hash tables by cache size when reducing them on the CPU, "
+                         "on by default; =false turns it off");
+  desc_adv.add_options()("enable-query-profile",
+                         po::value<bool>(&g_enable_query_profile)
+                             ->default_value(g_enable_query_profile)
+                             ->implicit_value(true),
+                         "Return the execution profile of every query, not just of EXPLAIN ANALYZE");
+  desc_adv.add_options()("enable-insert-log",
+                         po::value<bool>(&g_enable_insert_log)
+                             ->default_value(g_enable_insert_log)
+                             ->implicit_value(true),
+                         "Make inserts durable through a write-ahead log with group commit instead of a checkpoint "
+                         "per batch");
+  desc_adv.add_options()(
+      "insert-log-checkpoint-bytes",
+      po::value<size_t>(&g_insert_log_checkpoint_bytes)->default_value(g_insert_log_checkpoint_bytes),
+      "Checkpoint a table once its insert log grows past this size");
+  desc_adv.add_options()(
+      "insert-log-checkpoint-interval",
+      po::value<size_t>(&g_insert_log_checkpoint_interval_ms)->default_value(g_insert_log_checkpoint_interval_ms),
+      "Milliseconds between the background checkpoints of a table with a non-empty insert log");
   desc_adv.add_options()("inner-join-fragment-skipping",
                          po::value<bool>(&g_inner_join_fragment_skipping)
                              ->default_value(g_inner_join_fragment_skipping)
                              ->implicit_value(true),
                          "Enable/disable inner join fragment skipping.");
+  desc_adv.add_options()("enable-spatial-join-index",
+                         po::value<bool>(&g_enable_spatial_join_index)
+                             ->default_value(g_enable_spatial_join_index)
+                             ->implicit_value(true),
+                         "Enable/disable the grid index for ST_Contains and ST_Distance joins.");
+  desc_adv.add_options()("enable-inline-datetime",
+                         po::value<bool>(&g_enable_inline_datetime)
+                             ->default_value(g_enable_inline_datetime)
+                             ->implicit_value(true),
+                         "Generate DATE_TRUNC, EXTRACT and casts to DATE inline instead of calling the runtime "
+                         "functions.");
 
   po::positional_options_description positionalOptions;
   positionalOptions.add("data", 1);
@@ -563,6 +637,9 @@ int main(int argc, char** argv) {
   LOG(INFO) << " calcite JVM max memory  " << mapd_parameters.calcite_max_mem;
   LOG(INFO) << " MapD Server Port  " << mapd_parameters.mapd_server_port;
   LOG(INFO) << " MapD Calcite Port  " << mapd_parameters.calcite_port;
+  LOG(INFO) << " Request threads  " << mapd_parameters.num_request_threads;
+  LOG(INFO) << " Request queue size  " << mapd_parameters.request_queue_size;
+  LOG(INFO) << " Cursor idle timeout  " << mapd_parameters.cursor_timeout_s;
 
   boost::algorithm::trim_if(authMetadata.distinguishedName, boost::is_any_of("\"'"));
   boost::algorithm::trim_if(authMetadata.uri, boost::is_any_of("\"'"));
@@ -595,20 +672,50 @@ int main(int argc, char** argv) {
                                                         enable_access_priv_check));
 
   if (mapd_parameters.ha_group_id.empty()) {
-    mapd::shared_ptr<TProcessor> processor(new MapDProcessor(handler));
-
-    mapd::shared_ptr<TServerTransport> bufServerTransport(new TServerSocket(mapd_parameters.mapd_server_port));
+    mapd::shared_ptr<TProcessor> processor;
+    if (mapd_parameters.num_request_threads) {
+      auto request_scheduler = std::make_shared<RequestScheduler>(mapd_parameters.num_request_threads,
+                                                                  mapd_parameters.request_queue_size);
+      handler->setRequestScheduler(request_scheduler);
+      processor.reset(new ScheduledMapDProcessor(handler, request_scheduler));
+    } else {
+      processor.reset(new MapDProcessor(handler));
+    }
 
-    mapd::shared_ptr<TTransportFactory> bufTransportFactory(new TBufferedTransportFactory());
     mapd::shared_ptr<TProtocolFactory> bufProtocolFactory(new TBinaryProtocolFactory());
-    TThreadedServer bufServer(processor, bufServerTransport, bufTransportFactory, bufProtocolFactory);
+    std::unique_ptr<TServer> bufServer;
+    if (mapd_parameters.nonblocking_server) {
+#ifdef HAVE_THRIFT_NONBLOCKING
+      // every admitted or queued request needs a worker, the scheduler decides which of them runs; a few
+      // more are left for the control calls, which don't wait for a slot
+      const size_t control_call_threads{4};
+      auto threadManager = ThreadManager::newSimpleThreadManager(
+          mapd_parameters.num_request_threads + mapd_parameters.request_queue_size + control_call_threads);
+      threadManager->threadFactory(mapd::make_shared<PlatformThreadFactory>());
+      threadManager->start();
+#ifdef HAVE_THRIFT_STD_SHAREDPTR
+      mapd::shared_ptr<TNonblockingServerSocket> bufServerSocket(
+          new TNonblockingServerSocket(mapd_parameters.mapd_server_port));
+      bufServer.reset(new TNonblockingServer(processor, bufProtocolFactory, bufServerSocket, threadManager));
+#else
+      bufServer.reset(
+          new TNonblockingServer(processor, bufProtocolFactory, mapd_parameters.mapd_server_port, threadManager));
+#endif
+#else
+      LOG(FATAL) << "This build of mapd_server was built without the Thrift non-blocking server library";
+#endif
+    } else {
+      mapd::shared_ptr<TServerTransport> bufServerTransport(new TServerSocket(mapd_parameters.mapd_server_port));
+      mapd::shared_ptr<TTransportFactory> bufTransportFactory(new TBufferedTransportFactory());
+      bufServer.reset(new TThreadedServer(processor, bufServerTransport, bufTransportFactory, bufProtocolFactory));
+    }
 
     mapd::shared_ptr<TServerTransport> httpServerTransport(new TServerSocket(http_port));
     mapd::shared_ptr<TTransportFactory> httpTransportFactory(new THttpServerTransportFactory());
     mapd::shared_ptr<TProtocolFactory> httpProtocolFactory(new TJSONProtocolFactory());
     TThreadedServer httpServer(processor, httpServerTransport, httpTransportFactory, httpProtocolFactory);
 
-    std::thread bufThread(start_server, std::ref(bufServer));
+    std::thread bufThread(start_server, std::ref(*bufServer));
     std::thread httpThread(start_server, std::ref(httpServer));
 
     // run warm up queries if any exists
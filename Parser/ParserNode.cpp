@@ -1814,6 +1814,66 @@ void validate_shard_column_type(const size_t shard_column_id, const std::list<Co
                            col_ti.get_compression_name());
 }
 
+void validate_sort_key(const SortKeyDef* sort_key_def, const std::list<ColumnDescriptor>& columns) {
+  std::unordered_set<std::string> sort_col_names;
+  for (const auto& col_name : sort_key_def->get_column_list()) {
+    const auto sort_column_id = shard_column_index(*col_name, columns);
+    if (!sort_column_id) {
+      throw std::runtime_error("Specified sort key column " + *col_name + " doesn't exist");
+    }
+    if (!sort_col_names.insert(*col_name).second) {
+      throw std::runtime_error("Column " + *col_name + " specified more than once in the sort key");
+    }
+    auto column_it = columns.begin();
+    std::advance(column_it, sort_column_id - 1);
+    const auto& col_ti = column_it->columnType;
+    if (!col_ti.is_number() && !col_ti.is_time() && !col_ti.is_boolean()) {
+      throw std::runtime_error("Cannot sort on type " + col_ti.get_type_name());
+    }
+  }
+}
+
+int64_t partition_bound_value(const Literal* bound, const SQLTypeInfo& col_ti) {
+  if (dynamic_cast<const IntLiteral*>(bound)) {
+    return static_cast<const IntLiteral*>(bound)->get_intval();
+  }
+  if (col_ti.is_time() && dynamic_cast<const StringLiteral*>(bound)) {
+    auto ti = col_ti;
+    return StringToDatum(*static_cast<const StringLiteral*>(bound)->get_stringval(), ti).timeval;
+  }
+  throw std::runtime_error("Invalid VALUES LESS THAN value for a partition on type " + col_ti.get_type_name());
+}
+
+// Names and exclusive upper bounds of the partitions of a PARTITION BY RANGE clause, in ascending order.
+std::vector<std::pair<std::string, int64_t>> get_range_partitions(const RangePartitionDef* partition_def,
+                                                                  const size_t partition_column_id,
+                                                                  const std::list<ColumnDescriptor>& columns) {
+  CHECK_NE(size_t(0), partition_column_id);
+  CHECK_LE(partition_column_id, columns.size());
+  auto column_it = columns.begin();
+  std::advance(column_it, partition_column_id - 1);
+  const auto& col_ti = column_it->columnType;
+  if (!col_ti.is_integer() && !col_ti.is_time()) {
+    throw std::runtime_error("Cannot partition by range on type " + col_ti.get_type_name());
+  }
+  std::vector<std::pair<std::string, int64_t>> partitions;
+  std::unordered_set<std::string> uc_partition_names;
+  for (const auto& p : partition_def->get_partition_list()) {
+    if (!uc_partition_names.insert(boost::to_upper_copy<std::string>(*p->get_name())).second) {
+      throw std::runtime_error("Duplicate partition name " + *p->get_name());
+    }
+    if (!partitions.empty() && partitions.back().second == range_partition_max_value()) {
+      throw std::runtime_error("MAXVALUE can only be used in the last partition definition");
+    }
+    const auto bound = p->get_bound() ? partition_bound_value(p->get_bound(), col_ti) : range_partition_max_value();
+    if (!partitions.empty() && bound <= partitions.back().second) {
+      throw std::runtime_error("VALUES LESS THAN value must be strictly increasing for each partition");
+    }
+    partitions.emplace_back(*p->get_name(), bound);
+  }
+  return partitions;
+}
+
 void set_string_field(rapidjson::Value& obj,
                       const std::string& field_name,
                       const std::string& field_value,
@@ -1826,7 +1886,8 @@ void set_string_field(rapidjson::Value& obj,
 }
 
 std::string serialize_key_metainfo(const ShardKeyDef* shard_key_def,
-                                   const std::vector<SharedDictionaryDef>& shared_dict_defs) {
+                                   const std::vector<SharedDictionaryDef>& shared_dict_defs,
+                                   const SortKeyDef* sort_key_def) {
   rapidjson::Document document;
   auto& allocator = document.GetAllocator();
   rapidjson::Value arr(rapidjson::kArrayType);
@@ -1844,6 +1905,16 @@ std::string serialize_key_metainfo(const ShardKeyDef* shard_key_def,
     set_string_field(shared_dict_obj, "foreign_column", shared_dict_def.get_foreign_column(), document);
     arr.PushBack(shared_dict_obj, allocator);
   }
+  if (sort_key_def) {
+    std::vector<std::string> col_names;
+    for (const auto& col_name : sort_key_def->get_column_list()) {
+      col_names.push_back(*col_name);
+    }
+    rapidjson::Value sort_key_obj(rapidjson::kObjectType);
+    set_string_field(sort_key_obj, "type", "SORT KEY", document);
+    set_string_field(sort_key_obj, "name", boost::algorithm::join(col_names, ", "), document);
+    arr.PushBack(sort_key_obj, allocator);
+  }
   rapidjson::StringBuffer buffer;
   rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
   arr.Accept(writer);
@@ -1868,6 +1939,7 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   std::unordered_set<std::string> uc_col_names;
   std::vector<SharedDictionaryDef> shared_dict_defs;
   const ShardKeyDef* shard_key_def{nullptr};
+  const SortKeyDef* sort_key_def{nullptr};
   for (auto& e : table_element_list) {
     if (dynamic_cast<SharedDictionaryDef*>(e.get())) {
       auto shared_dict_def = static_cast<SharedDictionaryDef*>(e.get());
@@ -1882,6 +1954,13 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
       shard_key_def = static_cast<const ShardKeyDef*>(e.get());
       continue;
     }
+    if (dynamic_cast<SortKeyDef*>(e.get())) {
+      if (sort_key_def) {
+        throw std::runtime_error("Specified more than one sort key");
+      }
+      sort_key_def = static_cast<const SortKeyDef*>(e.get());
+      continue;
+    }
     if (!dynamic_cast<ColumnDef*>(e.get()))
       throw std::runtime_error("Table constraints are not supported yet.");
     ColumnDef* coldef = static_cast<ColumnDef*>(e.get());
@@ -1971,15 +2050,28 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
         cd.columnType.set_compression(kENCODING_FIXED);
         cd.columnType.set_comp_param(compression->get_encoding_param());
       } else if (boost::iequals(comp, "rl")) {
+        if (cd.columnType.is_array() || (!cd.columnType.is_integer() && !cd.columnType.is_time()) ||
+            cd.columnType.get_type() == kTINYINT)
+          throw std::runtime_error(cd.columnName +
+                                   ": RL encoding is only supported for SMALLINT, INTEGER, BIGINT or time columns.");
         // run length encoding
         cd.columnType.set_compression(kENCODING_RL);
         cd.columnType.set_comp_param(0);
-        // throw std::runtime_error("RL(Run Length) encoding not supported yet.");
       } else if (boost::iequals(comp, "diff")) {
-        // differential encoding
+        if (cd.columnType.is_array() || (!cd.columnType.is_integer() && !cd.columnType.is_time()) ||
+            cd.columnType.get_type() == kTINYINT)
+          throw std::runtime_error(cd.columnName +
+                                   ": DIFF encoding is only supported for SMALLINT, INTEGER, BIGINT or time columns.");
+        // frame of reference encoding: offsets from a per-chunk base, default to half the logical width
+        const int logical_bits = 8 * SQLTypeInfo(cd.columnType.get_type(), false).get_size();
+        comp_param = compression->get_encoding_param() == 0 ? logical_bits / 2 : compression->get_encoding_param();
+        if (comp_param != 8 && comp_param != 16 && comp_param != 32)
+          throw std::runtime_error(cd.columnName + ": Compression parameter for DIFF encoding must be 8 or 16 or 32.");
+        if (comp_param >= logical_bits)
+          throw std::runtime_error(cd.columnName + ": Compression parameter for DIFF encoding on " + t->to_string() +
+                                   " must be less than " + std::to_string(logical_bits) + ".");
         cd.columnType.set_compression(kENCODING_DIFF);
-        cd.columnType.set_comp_param(0);
-        // throw std::runtime_error("DIFF(differential) encoding not supported yet.");
+        cd.columnType.set_comp_param(comp_param);
       } else if (boost::iequals(comp, "dict")) {
         if (!cd.columnType.is_string() && !cd.columnType.is_string_array())
           throw std::runtime_error(cd.columnName +
@@ -2062,6 +2154,20 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
     }
     validate_shard_column_type(td.shardedColumnId, columns);
   }
+  if (sort_key_def) {
+    validate_sort_key(sort_key_def, columns);
+  }
+  std::vector<std::pair<std::string, int64_t>> partitions;
+  if (partition_def_) {
+    if (shard_key_def) {
+      throw std::runtime_error("A table cannot be sharded and range partitioned at the same time");
+    }
+    td.partitionColumnId = shard_column_index(*partition_def_->get_column(), columns);
+    if (!td.partitionColumnId) {
+      throw std::runtime_error("Specified partition column " + *partition_def_->get_column() + " doesn't exist");
+    }
+    partitions = get_range_partitions(partition_def_.get(), td.partitionColumnId, columns);
+  }
   if (is_temporary_)
     td.persistenceLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
   else
@@ -2132,17 +2238,32 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
         } else {
           td.hasDeletedCol = false;
         }
+      } else if (boost::iequals(*p->get_name(), "page_compression")) {
+        if (!dynamic_cast<const StringLiteral*>(p->get_value())) {
+          throw std::runtime_error("PAGE_COMPRESSION must be a string literal.");
+        }
+        const auto codec_name = static_cast<const StringLiteral*>(p->get_value())->get_stringval();
+        CHECK(codec_name);
+        td.pageCompression = File_Namespace::page_compression_from_string(*codec_name);
       } else {
         throw std::runtime_error("Invalid CREATE TABLE option " + *p->get_name() +
-                                 ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_ROWS, PARTITIONS, VACUUM or SHARD_COUNT.");
+                                 ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_ROWS, PARTITIONS, VACUUM, "
+                                 "PAGE_COMPRESSION or SHARD_COUNT.");
       }
     }
   }
   if (shard_key_def && !td.nShards) {
     throw std::runtime_error("Must specify the number of shards through the SHARD_COUNT option");
   }
-  td.keyMetainfo = serialize_key_metainfo(shard_key_def, shared_dict_defs);
-  catalog.createShardedTable(td, columns, shared_dict_defs);
+  if (partition_def_ && (td.nShards || !td.partitions.empty())) {
+    throw std::runtime_error("A range partitioned table cannot have the SHARD_COUNT or PARTITIONS options");
+  }
+  td.keyMetainfo = serialize_key_metainfo(shard_key_def, shared_dict_defs, sort_key_def);
+  if (partition_def_) {
+    catalog.createRangePartitionedTable(td, columns, shared_dict_defs, partitions);
+  } else {
+    catalog.createShardedTable(td, columns, shared_dict_defs);
+  }
   if (SysCatalog::instance().arePrivilegesOn()) {
     // TODO (max): It's transactionally unsafe, should be fixed: we may create object w/o privileges
     SysCatalog::instance().createDBObject(session.get_currentUser(), td.tableName, TableDBObjectType, catalog);
@@ -2382,6 +2503,8 @@ void DropTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   auto chkptlLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(catalog, *table, LockType::CheckpointLock);
   auto upddelLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(catalog, *table, LockType::UpdateDeleteLock);
   catalog.dropTable(td);
+  // table ids and epochs can repeat after a drop or truncate, drop cached results eagerly
+  ResultSetCache::yieldCacheInvalidator()();
 }
 
 void TruncateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -2407,6 +2530,30 @@ void TruncateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   if (td->isView)
     throw std::runtime_error(*table + " is a view.  Cannot Truncate.");
   catalog.truncateTable(td);
+  ResultSetCache::yieldCacheInvalidator()();
+}
+
+void DropPartitionStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.get_catalog();
+  const TableDescriptor* td = catalog.getMetadataForTable(*table);
+  if (td == nullptr) {
+    throw std::runtime_error("Table " + *table + " does not exist.");
+  }
+
+  // check access privileges
+  if (!session.checkDBAccessPrivileges(DBObjectType::TableDBObjectType, AccessPrivileges::DROP_TABLE, *table)) {
+    throw std::runtime_error("Partition " + *partition_name + " of table " + *table +
+                             " will not be dropped. User has no proper privileges.");
+  }
+
+  if (!table_is_range_partitioned(td)) {
+    throw std::runtime_error("Table " + *table + " is not partitioned by range.");
+  }
+
+  auto chkptlLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(catalog, *table, LockType::CheckpointLock);
+  auto upddelLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(catalog, *table, LockType::UpdateDeleteLock);
+  catalog.dropPartition(td, *partition_name);
+  ResultSetCache::yieldCacheInvalidator()();
 }
 
 void RenameTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -872,6 +872,62 @@ class ShardKeyDef : public TableConstraintDef {
   const std::string column_;
 };
 
+/*
+ * @type SortKeyDef
+ * @brief Sort key for a table, the loader keeps the rows of every batch ordered by these columns.
+ */
+class SortKeyDef : public TableConstraintDef {
+ public:
+  SortKeyDef(std::list<std::string*>* cl) {
+    CHECK(cl);
+    for (const auto s : *cl) {
+      column_list_.emplace_back(s);
+    }
+    delete cl;
+  }
+  const std::list<std::unique_ptr<std::string>>& get_column_list() const { return column_list_; }
+
+ private:
+  std::list<std::unique_ptr<std::string>> column_list_;
+};
+
+/*
+ * @type PartitionDef
+ * @brief A partition of a range partitioned table: PARTITION name VALUES LESS THAN (bound).
+ * The bound is nullptr for VALUES LESS THAN MAXVALUE.
+ */
+class PartitionDef : public Node {
+ public:
+  PartitionDef(std::string* name, Literal* bound) : name_(name), bound_(bound) {}
+  const std::string* get_name() const { return name_.get(); }
+  const Literal* get_bound() const { return bound_.get(); }
+
+ private:
+  std::unique_ptr<std::string> name_;
+  std::unique_ptr<Literal> bound_;
+};
+
+/*
+ * @type RangePartitionDef
+ * @brief PARTITION BY RANGE (column) clause. Every partition is stored as a physical table of the logical one.
+ */
+class RangePartitionDef : public Node {
+ public:
+  RangePartitionDef(std::string* column, std::list<PartitionDef*>* partitions) : column_(column) {
+    CHECK(partitions);
+    for (const auto p : *partitions) {
+      partition_list_.emplace_back(p);
+    }
+    delete partitions;
+  }
+  const std::string* get_column() const { return column_.get(); }
+  const std::list<std::unique_ptr<PartitionDef>>& get_partition_list() const { return partition_list_; }
+
+ private:
+  std::unique_ptr<std::string> column_;
+  std::list<std::unique_ptr<PartitionDef>> partition_list_;
+};
+
 /*
  * @type NameValueAssign
  * @brief Assignment of a string value to a named attribute
@@ -897,8 +953,9 @@ class CreateTableStmt : public DDLStmt {
                   std::list<TableElement*>* table_elems,
                   bool is_temporary,
                   bool if_not_exists,
-                  std::list<NameValueAssign*>* s)
-      : table(tab), is_temporary_(is_temporary), if_not_exists_(if_not_exists) {
+                  std::list<NameValueAssign*>* s,
+                  RangePartitionDef* partition_def)
+      : table(tab), is_temporary_(is_temporary), if_not_exists_(if_not_exists), partition_def_(partition_def) {
     CHECK(table_elems);
     for (const auto e : *table_elems) {
       table_element_list.emplace_back(e);
@@ -922,6 +979,7 @@ class CreateTableStmt : public DDLStmt {
   bool is_temporary_;
   bool if_not_exists_;
   std::list<std::unique_ptr<NameValueAssign>> storage_options;
+  std::unique_ptr<RangePartitionDef> partition_def_;
 };
 
 /*
@@ -970,6 +1028,20 @@ class TruncateTableStmt : public DDLStmt {
   std::unique_ptr<std::string> table;
 };
 
+/*
+ * @type DropPartitionStmt
+ * @brief ALTER TABLE DROP PARTITION statement
+ */
+class DropPartitionStmt : public DDLStmt {
+ public:
+  DropPartitionStmt(std::string* tab, std::string* partition) : table(tab), partition_name(partition) {}
+  virtual void execute(const Catalog_Namespace::SessionInfo& session);
+
+ private:
+  std::unique_ptr<std::string> table;
+  std::unique_ptr<std::string> partition_name;
+};
+
 class RenameTableStmt : public DDLStmt {
  public:
   RenameTableStmt(std::string* tab, std::string* new_tab_name) : table(tab), new_table_name(new_tab_name) {}
@@ -42,6 +42,7 @@ const std::vector<std::string> ParserWrapper::update_dml_cmd = {
 
 const std::string ParserWrapper::explain_str = {"explain"};
 const std::string ParserWrapper::calcite_explain_str = {"explain calcite"};
+const std::string ParserWrapper::analyze_explain_str = {"explain analyze"};
 
 ParserWrapper::ParserWrapper(std::string query_string) {
   if (boost::istarts_with(query_string, calcite_explain_str)) {
@@ -56,6 +57,18 @@ ParserWrapper::ParserWrapper(std::string query_string) {
     }
   }
 
+  if (boost::istarts_with(query_string, analyze_explain_str)) {
+    actual_query = boost::trim_copy(query_string.substr(analyze_explain_str.size()));
+    ParserWrapper inner{actual_query};
+    if (inner.is_ddl || inner.is_update_dml) {
+      is_other_explain = true;
+      return;
+    } else {
+      is_select_analyze_explain = true;
+      return;
+    }
+  }
+
   if (boost::istarts_with(query_string, explain_str)) {
     actual_query = boost::trim_copy(query_string.substr(explain_str.size()));
     ParserWrapper inner{actual_query};
@@ -198,6 +198,7 @@ sql:		/* schema {	$<nodeval>$ = $<nodeval>1; } */
 	| truncate_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| rename_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| rename_column_statement { $<nodeval>$ = $<nodeval>1; }
+	| drop_partition_statement { $<nodeval>$ = $<nodeval>1; }
   | copy_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| create_database_statement { $<nodeval>$ = $<nodeval>1; }
 	| drop_database_statement { $<nodeval>$ = $<nodeval>1; }
@@ -296,12 +297,73 @@ opt_temporary:
                 ;
 
 create_table_statement:
-		CREATE opt_temporary TABLE opt_if_not_exists table '(' base_table_element_commalist ')' opt_with_option_list
+		CREATE opt_temporary TABLE opt_if_not_exists table '(' base_table_element_commalist ')' opt_with_option_list opt_partition_by
 		{
-		  $<nodeval>$ = new CreateTableStmt($<stringval>5, reinterpret_cast<std::list<TableElement*>*>($<listval>7), $<boolval>2,  $<boolval>4, reinterpret_cast<std::list<NameValueAssign*>*>($<listval>9));
+		  $<nodeval>$ = new CreateTableStmt($<stringval>5, reinterpret_cast<std::list<TableElement*>*>($<listval>7), $<boolval>2,  $<boolval>4, reinterpret_cast<std::list<NameValueAssign*>*>($<listval>9), dynamic_cast<RangePartitionDef*>($<nodeval>10));
 		}
 	;
 
+opt_partition_by:
+		NAME BY NAME '(' column ')' '(' partition_def_commalist ')'
+		{
+			if (!boost::iequals(*$<stringval>1, "partition"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>1);
+			if (!boost::iequals(*$<stringval>3, "range"))
+				throw std::runtime_error("Only PARTITION BY RANGE is supported, syntax error at " + *$<stringval>3);
+			delete $<stringval>1;
+			delete $<stringval>3;
+			$<nodeval>$ = new RangePartitionDef($<stringval>5, reinterpret_cast<std::list<PartitionDef*>*>($<listval>8));
+		}
+		| /* empty */ { $<nodeval>$ = nullptr; }
+		;
+
+partition_def_commalist:
+		partition_def { $<listval>$ = new std::list<Node*>(1, $<nodeval>1); }
+	|	partition_def_commalist ',' partition_def
+	{
+		$<listval>$ = $<listval>1;
+		$<listval>$->push_back($<nodeval>3);
+	}
+	;
+
+partition_def:
+		NAME NAME VALUES NAME NAME '(' partition_bound ')'
+		{
+			if (!boost::iequals(*$<stringval>1, "partition"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>1);
+			if (!boost::iequals(*$<stringval>4, "less") || !boost::iequals(*$<stringval>5, "than"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>4 + " " + *$<stringval>5);
+			delete $<stringval>1;
+			delete $<stringval>4;
+			delete $<stringval>5;
+			$<nodeval>$ = new PartitionDef($<stringval>2, dynamic_cast<Literal*>($<nodeval>7));
+		}
+	|	NAME NAME VALUES NAME NAME NAME
+		{
+			if (!boost::iequals(*$<stringval>1, "partition"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>1);
+			if (!boost::iequals(*$<stringval>4, "less") || !boost::iequals(*$<stringval>5, "than"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>4 + " " + *$<stringval>5);
+			if (!boost::iequals(*$<stringval>6, "maxvalue"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>6);
+			delete $<stringval>1;
+			delete $<stringval>4;
+			delete $<stringval>5;
+			delete $<stringval>6;
+			$<nodeval>$ = new PartitionDef($<stringval>2, nullptr);
+		}
+	;
+
+partition_bound:
+		literal
+		{
+			if (!dynamic_cast<Literal*>($<nodeval>1))
+				throw std::runtime_error("VALUES LESS THAN value must be a literal");
+			$<nodeval>$ = $<nodeval>1;
+		}
+	|	'-' INTNUM { $<nodeval>$ = new IntLiteral(-$<intval>2); }
+	;
+
 show_table_schema:
 		SHOW CREATE TABLE table
 		{
@@ -325,6 +387,15 @@ truncate_table_statement:
 		  $<nodeval>$ = new TruncateTableStmt($<stringval>3);
 		}
 		;
+drop_partition_statement:
+		ALTER TABLE table DROP NAME NAME
+		{
+			if (!boost::iequals(*$<stringval>5, "partition"))
+				throw std::runtime_error("Syntax error at " + *$<stringval>5);
+			delete $<stringval>5;
+			$<nodeval>$ = new DropPartitionStmt($<stringval>3, $<stringval>6);
+		}
+		;
 rename_table_statement:
 		ALTER TABLE table RENAME TO table
 		{
@@ -486,6 +557,14 @@ table_constraint_def:
 	delete $<stringval>2;
 	delete $<stringval>4;
 	}
+	|	NAME NAME '(' column_commalist ')'
+	{
+	if (!boost::iequals(*$<stringval>1, "sort") || !boost::iequals(*$<stringval>2, "key"))
+	  throw std::runtime_error("Syntax error at " + *$<stringval>1);
+	$<nodeval>$ = new SortKeyDef($<slistval>4);
+	delete $<stringval>1;
+	delete $<stringval>2;
+	}
 	|	SHARED DICTIONARY '(' column ')' REFERENCES table '(' column ')'
 	{
 		$<nodeval>$ = new SharedDictionaryDef(*$<stringval>4, *$<stringval>7, *$<stringval>9);
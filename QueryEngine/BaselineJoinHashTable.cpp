@@ -264,6 +264,15 @@ T* transfer_pod_vector_to_gpu(const std::vector<T>& vec, ThrustAllocator& alloca
   return reinterpret_cast<T*>(gpu_vec);
 }
 
+size_t get_inner_row_count(const std::vector<std::vector<JoinColumn>>& join_columns_per_frag) {
+  size_t row_count = 0;
+  for (const auto& join_column_per_key : join_columns_per_frag) {
+    CHECK(!join_column_per_key.empty());
+    row_count += join_column_per_key.front().num_elems;
+  }
+  return row_count;
+}
+
 }  // namespace
 
 size_t BaselineJoinHashTable::approximateTupleCount(const std::vector<ColumnsForDevice>& columns_per_device) const {
@@ -281,8 +290,8 @@ size_t BaselineJoinHashTable::approximateTupleCount(const std::vector<ColumnsFor
   const auto padded_size_bytes = count_distinct_desc.bitmapPaddedSizeBytes();
   if (effective_memory_level == Data_Namespace::MemoryLevel::CPU_LEVEL) {
     const auto composite_key_info = get_composite_key_info(inner_outer_pairs, executor_);
-    CHECK(!columns_per_device.empty() && !columns_per_device.front().join_columns.empty());
-    HashTableCacheKey cache_key{columns_per_device.front().join_columns.front().num_elems,
+    CHECK(!columns_per_device.empty() && !columns_per_device.front().join_columns_per_frag.empty());
+    HashTableCacheKey cache_key{get_inner_row_count(columns_per_device.front().join_columns_per_frag),
                                 composite_key_info.cache_key_chunks,
                                 condition_->get_optype()};
     const auto cached_entry_count = getApproximateTupleCountFromCache(cache_key);
@@ -295,7 +304,7 @@ size_t BaselineJoinHashTable::approximateTupleCount(const std::vector<ColumnsFor
     approximate_distinct_tuples(hll_result,
                                 count_distinct_desc.bitmap_sz_bits,
                                 padded_size_bytes,
-                                columns_per_device.front().join_columns,
+                                columns_per_device.front().join_columns_per_frag,
                                 columns_per_device.front().join_column_types,
                                 thread_count);
     for (int i = 1; i < thread_count; ++i) {
@@ -318,11 +327,13 @@ size_t BaselineJoinHashTable::approximateTupleCount(const std::vector<ColumnsFor
           auto device_hll_buffer = allocator.allocateScopedBuffer(count_distinct_desc.bitmapPaddedSizeBytes());
           data_mgr.cudaMgr_->zeroDeviceMem(device_hll_buffer, count_distinct_desc.bitmapPaddedSizeBytes(), device_id);
           const auto& columns_for_device = columns_per_device[device_id];
-          auto join_columns_gpu = transfer_pod_vector_to_gpu(columns_for_device.join_columns, allocator);
+          CHECK_EQ(size_t(1), columns_for_device.join_columns_per_frag.size());
+          const auto& join_columns = columns_for_device.join_columns_per_frag.front();
+          auto join_columns_gpu = transfer_pod_vector_to_gpu(join_columns, allocator);
           auto join_column_types_gpu = transfer_pod_vector_to_gpu(columns_for_device.join_column_types, allocator);
           approximate_distinct_tuples_on_device(reinterpret_cast<uint8_t*>(device_hll_buffer),
                                                 count_distinct_desc.bitmap_sz_bits,
-                                                columns_for_device.join_columns.size(),
+                                                join_columns.size(),
                                                 join_columns_gpu,
                                                 join_column_types_gpu,
                                                 executor_->blockSize(),
@@ -359,7 +370,7 @@ BaselineJoinHashTable::ColumnsForDevice BaselineJoinHashTable::fetchColumnsForDe
   const bool has_multi_frag = fragments.size() > 1;
   const auto& catalog = *executor_->getCatalog();
   const auto inner_outer_pairs = normalize_column_pairs(condition_.get(), catalog, executor_->getTemporaryTables());
-  std::vector<JoinColumn> join_columns;
+  std::vector<std::vector<JoinColumn>> join_column_frags_per_key;
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   const auto& first_frag = fragments.front();
   const auto effective_memory_level = get_effective_memory_level(inner_outer_pairs, memory_level_, executor_);
@@ -370,14 +381,14 @@ BaselineJoinHashTable::ColumnsForDevice BaselineJoinHashTable::fetchColumnsForDe
     if (inner_cd && inner_cd->isVirtualCol) {
       return {{}, {}, {}, ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN};
     }
-    const int8_t* col_buff = nullptr;
-    size_t elem_count = 0;
+    std::vector<JoinColumn> join_column_frags;
     const size_t elem_width = inner_col->get_type_info().get_size();
     auto& data_mgr = catalog.get_dataMgr();
     ThrustAllocator dev_buff_owner(&data_mgr, device_id);
     if (has_multi_frag) {
       try {
-        std::tie(col_buff, elem_count) = getAllColumnFragments(*inner_col, fragments, chunks_owner);
+        join_column_frags = Executor::ExecutionDispatch::getAllColumnFragments(
+            executor_, *inner_col, fragments, chunks_owner, column_cache_);
       } catch (...) {
         return {{}, {}, {}, ERR_FAILED_TO_FETCH_COLUMN};
       }
@@ -385,25 +396,23 @@ BaselineJoinHashTable::ColumnsForDevice BaselineJoinHashTable::fetchColumnsForDe
     {
       std::lock_guard<std::mutex> fragment_fetch_lock(fragment_fetch_mutex);
       if (has_multi_frag) {
+        // The CPU builders read the fragments in place, the GPU ones need the column in one buffer.
         if (effective_memory_level == Data_Namespace::GPU_LEVEL) {
-          CHECK(col_buff != nullptr);
-          CHECK_NE(elem_count, size_t(0));
-          int8_t* dev_col_buff = nullptr;
-          dev_col_buff = dev_buff_owner.allocate(elem_count * elem_width);
-          copy_to_gpu(
-              &data_mgr, reinterpret_cast<CUdeviceptr>(dev_col_buff), col_buff, elem_count * elem_width, device_id);
-          col_buff = dev_col_buff;
+          join_column_frags = {transfer_join_column_frags_to_gpu(join_column_frags, elem_width, dev_buff_owner)};
         }
       } else {
+        const int8_t* col_buff = nullptr;
+        size_t elem_count = 0;
         try {
           std::tie(col_buff, elem_count) = Executor::ExecutionDispatch::getColumnFragment(
               executor_, *inner_col, first_frag, effective_memory_level, device_id, chunks_owner, column_cache_);
         } catch (...) {
           return {{}, {}, {}, ERR_FAILED_TO_FETCH_COLUMN};
         }
+        join_column_frags.push_back(JoinColumn{col_buff, elem_count, 0});
       }
     }
-    join_columns.emplace_back(JoinColumn{col_buff, elem_count});
+    join_column_frags_per_key.push_back(join_column_frags);
     const auto& ti = inner_col->get_type_info();
     join_column_types.emplace_back(JoinColumnTypeInfo{static_cast<size_t>(ti.get_size()),
                                                       0,
@@ -412,7 +421,18 @@ BaselineJoinHashTable::ColumnsForDevice BaselineJoinHashTable::fetchColumnsForDe
                                                       0,
                                                       is_unsigned_type(ti)});
   }
-  return {join_columns, join_column_types, chunks_owner, 0};
+  // The key columns belong to the same table, so their fragments line up.
+  CHECK(!join_column_frags_per_key.empty());
+  const auto frag_count = join_column_frags_per_key.front().size();
+  std::vector<std::vector<JoinColumn>> join_columns_per_frag(frag_count);
+  for (const auto& join_column_frags : join_column_frags_per_key) {
+    CHECK_EQ(frag_count, join_column_frags.size());
+    for (size_t frag_idx = 0; frag_idx < frag_count; ++frag_idx) {
+      CHECK_EQ(join_column_frags_per_key.front()[frag_idx].num_elems, join_column_frags[frag_idx].num_elems);
+      join_columns_per_frag[frag_idx].push_back(join_column_frags[frag_idx]);
+    }
+  }
+  return {join_columns_per_frag, join_column_types, chunks_owner, 0};
 }
 
 int BaselineJoinHashTable::reifyForDevice(const ColumnsForDevice& columns_for_device,
@@ -423,7 +443,7 @@ int BaselineJoinHashTable::reifyForDevice(const ColumnsForDevice& columns_for_de
   const auto effective_memory_level = get_effective_memory_level(inner_outer_pairs, memory_level_, executor_);
   int err{0};
   try {
-    err = initHashTableForDevice(columns_for_device.join_columns,
+    err = initHashTableForDevice(columns_for_device.join_columns_per_frag,
                                  columns_for_device.join_column_types,
                                  layout,
                                  effective_memory_level,
@@ -434,30 +454,6 @@ int BaselineJoinHashTable::reifyForDevice(const ColumnsForDevice& columns_for_de
   return err;
 }
 
-std::pair<const int8_t*, size_t> BaselineJoinHashTable::getAllColumnFragments(
-    const Analyzer::ColumnVar& hash_col,
-    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
-    std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
-  std::lock_guard<std::mutex> linearized_multifrag_column_lock(linearized_multifrag_column_mutex_);
-  auto linearized_column_cache_key = std::make_pair(hash_col.get_table_id(), hash_col.get_column_id());
-  const auto cache_it = linearized_multifrag_columns_.find(linearized_column_cache_key);
-  if (cache_it != linearized_multifrag_columns_.end()) {
-    return cache_it->second;
-  }
-  const int8_t* col_buff;
-  size_t total_elem_count;
-  std::tie(col_buff, total_elem_count) =
-      Executor::ExecutionDispatch::getAllColumnFragments(executor_, hash_col, fragments, chunks_owner, column_cache_);
-  linearized_multifrag_column_owner_.addColBuffer(col_buff);
-  const auto shard_count = shardCount();
-  if (!shard_count) {
-    const auto it_ok = linearized_multifrag_columns_.emplace(linearized_column_cache_key,
-                                                             LinearizedColumn{col_buff, total_elem_count});
-    CHECK(it_ok.second);
-  }
-  return {col_buff, total_elem_count};
-}
-
 size_t BaselineJoinHashTable::shardCount() const {
   if (memory_level_ != Data_Namespace::GPU_LEVEL) {
     return 0;
@@ -501,7 +497,7 @@ size_t get_key_component_width(const std::shared_ptr<Analyzer::BinOper> conditio
 
 }  // namespace
 
-int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& join_columns,
+int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                               const std::vector<JoinColumnTypeInfo>& join_column_types,
                                               const JoinHashTableInterface::HashType layout) {
   const auto col_tuple_expr = std::dynamic_pointer_cast<Analyzer::ExpressionTuple>(condition_->get_own_right_operand());
@@ -509,9 +505,9 @@ int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& joi
   const auto inner_outer_pairs =
       normalize_column_pairs(condition_.get(), *executor_->getCatalog(), executor_->getTemporaryTables());
   const auto composite_key_info = get_composite_key_info(inner_outer_pairs, executor_);
-  CHECK(!join_columns.empty());
-  HashTableCacheKey cache_key{
-      join_columns.front().num_elems, composite_key_info.cache_key_chunks, condition_->get_optype()};
+  CHECK(!join_columns_per_frag.empty());
+  const auto num_elements = get_inner_row_count(join_columns_per_frag);
+  HashTableCacheKey cache_key{num_elements, composite_key_info.cache_key_chunks, condition_->get_optype()};
   initHashTableOnCpuFromCache(cache_key);
   if (cpu_hash_table_buff_) {
     return 0;
@@ -520,7 +516,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& joi
   const auto entry_size =
       (inner_outer_pairs.size() + (layout == JoinHashTableInterface::HashType::OneToOne ? 1 : 0)) * key_component_width;
   const size_t one_to_many_hash_entries =
-      layout == JoinHashTableInterface::HashType::OneToMany ? 2 * entry_count_ + join_columns.front().num_elems : 0;
+      layout == JoinHashTableInterface::HashType::OneToMany ? 2 * entry_count_ + num_elements : 0;
   cpu_hash_table_buff_.reset(
       new std::vector<int8_t>(entry_size * entry_count_ + one_to_many_hash_entries * sizeof(int32_t)));
   const auto key_component_count = inner_outer_pairs.size();
@@ -558,49 +554,55 @@ int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& joi
   }
   std::vector<std::future<int>> fill_cpu_buff_threads;
   for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-    fill_cpu_buff_threads.emplace_back(
-        std::async(std::launch::async,
-                   [this,
-                    &composite_key_info,
-                    &join_columns,
-                    &join_column_types,
-                    key_component_count,
-                    key_component_width,
-                    layout,
-                    thread_idx,
-                    thread_count] {
-                     switch (key_component_width) {
-                       case 4:
-                         return fill_baseline_hash_join_buff_32(&(*cpu_hash_table_buff_)[0],
-                                                                entry_count_,
-                                                                -1,
-                                                                key_component_count,
-                                                                layout == JoinHashTableInterface::HashType::OneToOne,
-                                                                join_columns,
-                                                                join_column_types,
-                                                                composite_key_info.sd_inner_proxy_per_key,
-                                                                composite_key_info.sd_outer_proxy_per_key,
-                                                                thread_idx,
-                                                                thread_count);
-                         break;
-                       case 8:
-                         return fill_baseline_hash_join_buff_64(&(*cpu_hash_table_buff_)[0],
-                                                                entry_count_,
-                                                                -1,
-                                                                key_component_count,
-                                                                layout == JoinHashTableInterface::HashType::OneToOne,
-                                                                join_columns,
-                                                                join_column_types,
-                                                                composite_key_info.sd_inner_proxy_per_key,
-                                                                composite_key_info.sd_outer_proxy_per_key,
-                                                                thread_idx,
-                                                                thread_count);
-                         break;
-                       default:
-                         CHECK(false);
-                     }
-                     return -1;
-                   }));
+    fill_cpu_buff_threads.emplace_back(std::async(
+        std::launch::async,
+        [this,
+         &composite_key_info,
+         &join_columns_per_frag,
+         &join_column_types,
+         key_component_count,
+         key_component_width,
+         layout,
+         thread_idx,
+         thread_count] {
+          for (const auto& join_columns : join_columns_per_frag) {
+            int partial_err = 0;
+            switch (key_component_width) {
+              case 4:
+                partial_err = fill_baseline_hash_join_buff_32(&(*cpu_hash_table_buff_)[0],
+                                                              entry_count_,
+                                                              -1,
+                                                              key_component_count,
+                                                              layout == JoinHashTableInterface::HashType::OneToOne,
+                                                              join_columns,
+                                                              join_column_types,
+                                                              composite_key_info.sd_inner_proxy_per_key,
+                                                              composite_key_info.sd_outer_proxy_per_key,
+                                                              thread_idx,
+                                                              thread_count);
+                break;
+              case 8:
+                partial_err = fill_baseline_hash_join_buff_64(&(*cpu_hash_table_buff_)[0],
+                                                              entry_count_,
+                                                              -1,
+                                                              key_component_count,
+                                                              layout == JoinHashTableInterface::HashType::OneToOne,
+                                                              join_columns,
+                                                              join_column_types,
+                                                              composite_key_info.sd_inner_proxy_per_key,
+                                                              composite_key_info.sd_outer_proxy_per_key,
+                                                              thread_idx,
+                                                              thread_count);
+                break;
+              default:
+                CHECK(false);
+            }
+            if (partial_err) {
+              return partial_err;
+            }
+          }
+          return 0;
+        }));
   }
   int err = 0;
   for (auto& child : fill_cpu_buff_threads) {
@@ -624,7 +626,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& joi
                                                 entry_count_,
                                                 -1,
                                                 key_component_count,
-                                                join_columns,
+                                                join_columns_per_frag,
                                                 join_column_types,
                                                 composite_key_info.sd_inner_proxy_per_key,
                                                 composite_key_info.sd_outer_proxy_per_key,
@@ -638,7 +640,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& joi
                                                 entry_count_,
                                                 -1,
                                                 key_component_count,
-                                                join_columns,
+                                                join_columns_per_frag,
                                                 join_column_types,
                                                 composite_key_info.sd_inner_proxy_per_key,
                                                 composite_key_info.sd_outer_proxy_per_key,
@@ -775,7 +777,7 @@ int BaselineJoinHashTable::initHashTableOnGpu(const std::vector<JoinColumn>& joi
   return err;
 }
 
-int BaselineJoinHashTable::initHashTableForDevice(const std::vector<JoinColumn>& join_columns,
+int BaselineJoinHashTable::initHashTableForDevice(const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                                   const std::vector<JoinColumnTypeInfo>& join_column_types,
                                                   const JoinHashTableInterface::HashType layout,
                                                   const Data_Namespace::MemoryLevel effective_memory_level,
@@ -793,7 +795,9 @@ int BaselineJoinHashTable::initHashTableForDevice(const std::vector<JoinColumn>&
     const auto entry_size =
         (key_component_count + (layout == JoinHashTableInterface::HashType::OneToOne ? 1 : 0)) * key_component_width;
     const size_t one_to_many_hash_entries =
-        layout == JoinHashTableInterface::HashType::OneToMany ? 2 * entry_count_ + join_columns.front().num_elems : 0;
+        layout == JoinHashTableInterface::HashType::OneToMany
+            ? 2 * entry_count_ + get_inner_row_count(join_columns_per_frag)
+            : 0;
     gpu_hash_table_buff_[device_id] = alloc_gpu_abstract_buffer(
         &data_mgr, entry_size * entry_count_ + one_to_many_hash_entries * sizeof(int32_t), device_id);
   }
@@ -802,7 +806,7 @@ int BaselineJoinHashTable::initHashTableForDevice(const std::vector<JoinColumn>&
 #endif
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-    err = initHashTableOnCpu(join_columns, join_column_types, layout);
+    err = initHashTableOnCpu(join_columns_per_frag, join_column_types, layout);
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
     // Don't transfer the buffer if there was an error since we'll bail anyway.
@@ -818,8 +822,13 @@ int BaselineJoinHashTable::initHashTableForDevice(const std::vector<JoinColumn>&
 #endif
     }
   } else {
-    err = initHashTableOnGpu(
-        join_columns, join_column_types, layout, key_component_width, key_component_count, device_id);
+    CHECK_EQ(size_t(1), join_columns_per_frag.size());
+    err = initHashTableOnGpu(join_columns_per_frag.front(),
+                             join_column_types,
+                             layout,
+                             key_component_width,
+                             key_component_count,
+                             device_id);
   }
   return err;
 }
@@ -81,11 +81,6 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   static int getInnerTableId(const Analyzer::BinOper* condition, const Executor* executor);
 
-  std::pair<const int8_t*, size_t> getAllColumnFragments(
-      const Analyzer::ColumnVar& hash_col,
-      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
-      std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
-
   size_t shardCount() const;
 
   size_t computeShardCount() const;
@@ -95,7 +90,7 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   int reifyWithLayout(const int device_count, const JoinHashTableInterface::HashType layout);
 
   struct ColumnsForDevice {
-    const std::vector<JoinColumn> join_columns;
+    const std::vector<std::vector<JoinColumn>> join_columns_per_frag;  // key columns of every inner fragment
     const std::vector<JoinColumnTypeInfo> join_column_types;
     const std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
     const int err;
@@ -112,13 +107,13 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   void checkHashJoinReplicationConstraint(const int table_id) const;
 
-  int initHashTableForDevice(const std::vector<JoinColumn>& join_columns,
+  int initHashTableForDevice(const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                              const std::vector<JoinColumnTypeInfo>& join_column_types,
                              const JoinHashTableInterface::HashType layout,
                              const Data_Namespace::MemoryLevel effective_memory_level,
                              const int device_id);
 
-  int initHashTableOnCpu(const std::vector<JoinColumn>& join_columns,
+  int initHashTableOnCpu(const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                          const std::vector<JoinColumnTypeInfo>& join_column_types,
                          const JoinHashTableInterface::HashType layout);
 
@@ -169,11 +164,6 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 #ifdef HAVE_CUDA
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_buff_;
 #endif
-  typedef std::pair<const int8_t*, size_t> LinearizedColumn;
-  typedef std::pair<int, int> LinearizedColumnCacheKey;
-  std::map<LinearizedColumnCacheKey, LinearizedColumn> linearized_multifrag_columns_;
-  std::mutex linearized_multifrag_column_mutex_;
-  RowSetMemoryOwner linearized_multifrag_column_owner_;
   JoinHashTableInterface::HashType layout_;
 
   struct HashTableCacheValue {
@@ -111,6 +111,10 @@ inline SQLAgg to_agg_kind(const std::string& agg_name) {
   if (agg_name == std::string("LAST_SAMPLE")) {
     return kLAST_SAMPLE;
   }
+  // APPROX_MEDIAN(x) is APPROX_PERCENTILE(x, 0.5), the translator fills in the fraction
+  if (agg_name == std::string("APPROX_PERCENTILE") || agg_name == std::string("APPROX_MEDIAN")) {
+    return kAPPROX_PERCENTILE;
+  }
   throw std::runtime_error("Aggregate function " + agg_name + " not supported");
 }
 
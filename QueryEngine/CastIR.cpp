@@ -76,6 +76,13 @@ llvm::Value* Executor::codegenCast(llvm::Value* operand_lv,
 llvm::Value* Executor::codegenCastTimestampToDate(llvm::Value* ts_lv, const bool nullable) {
   static_assert(sizeof(time_t) == 4 || sizeof(time_t) == 8, "Unsupported time_t size");
   CHECK(ts_lv->getType()->isIntegerTy(32) || ts_lv->getType()->isIntegerTy(64));
+  const auto inline_datetrunc = codegenInlineDateTrunc(
+      dtDAY,
+      ts_lv,
+      nullable ? inlineIntNull(SQLTypeInfo(ts_lv->getType()->isIntegerTy(64) ? kBIGINT : kINT, false)) : nullptr);
+  if (inline_datetrunc) {
+    return inline_datetrunc;
+  }
   if (sizeof(time_t) == 4 && ts_lv->getType()->isIntegerTy(64)) {
     ts_lv = cgen_state_->ir_builder_.CreateCast(
         llvm::Instruction::CastOps::Trunc, ts_lv, get_int_type(32, cgen_state_->context_));
@@ -44,14 +44,20 @@ class FixedWidthUnsigned : public Decoder {
   const size_t byte_width_;
 };
 
+// Frame of reference offsets, the base is read from the chunk.
 class DiffFixedWidthInt : public Decoder {
  public:
-  DiffFixedWidthInt(const size_t byte_width, const int64_t baseline);
+  DiffFixedWidthInt(const size_t byte_width, const int64_t null_val);
   llvm::Instruction* codegenDecode(llvm::Value* byte_stream, llvm::Value* pos, llvm::Module* module) const override;
 
  private:
   const size_t byte_width_;
-  const int64_t baseline_;
+  const int64_t null_val_;
+};
+
+class RunLengthInt : public Decoder {
+ public:
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream, llvm::Value* pos, llvm::Module* module) const override;
 };
 
 class FixedWidthReal : public Decoder {
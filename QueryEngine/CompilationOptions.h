@@ -17,6 +17,11 @@
 #ifndef QUERYENGINE_COMPILATIONOPTIONS_H
 #define QUERYENGINE_COMPILATIONOPTIONS_H
 
+#include <memory>
+
+class QueryCancellationToken;
+class QueryProfile;
+
 enum class ExecutorDeviceType { CPU, GPU, Hybrid };
 
 enum class ExecutorOptLevel { Default, LoopStrengthReduction };
@@ -38,6 +43,8 @@ struct ExecutionOptions {
   const bool just_validate;
   const bool with_dynamic_watchdog;            // Per work unit, not global.
   const unsigned dynamic_watchdog_time_limit;  // Dynamic watchdog time limit, in milliseconds.
+  const std::shared_ptr<QueryCancellationToken> query_token;  // Lets the caller interrupt the query, can be null.
+  const std::shared_ptr<QueryProfile> query_profile;          // Collects timings for EXPLAIN ANALYZE, can be null.
 };
 
 #endif  // QUERYENGINE_COMPILATIONOPTIONS_H
@@ -16,6 +16,232 @@
 
 #include "Execute.h"
 
+namespace {
+
+// Emits DATE_TRUNC and EXTRACT of a constant field as straight-line integer arithmetic on the seconds since the
+// epoch, so that the row loop doesn't call into the runtime and can be vectorized. The calendar conversions are
+// Howard Hinnant's civil_from_days and days_from_civil: divisions by constants and selects only, exact for any
+// date of the proleptic Gregorian calendar, before the epoch included.
+class DateTimeIRBuilder {
+ public:
+  DateTimeIRBuilder(llvm::IRBuilder<>& ir_builder, llvm::LLVMContext& context)
+      : ir_builder_(ir_builder), i64_type_(get_int_type(64, context)) {}
+
+  static bool canExtract(const ExtractField field) { return field != kEPOCH; }
+
+  static bool canTruncate(const DatetruncField field) {
+    return field != dtMILLENNIUM && field != dtCENTURY && field != dtDECADE && field != dtINVALID;
+  }
+
+  llvm::Value* extract(const ExtractField field, llvm::Value* ts) {
+    switch (field) {
+      case kHOUR:
+        return ir_builder_.CreateUDiv(floorMod(ts, SECSPERDAY), i64(SECSPERHOUR));
+      case kMINUTE:
+        return ir_builder_.CreateUDiv(floorMod(ts, SECSPERHOUR), i64(SECSPERMIN));
+      case kSECOND:
+        return floorMod(ts, SECSPERMIN);
+      case kQUARTERDAY:
+        return ir_builder_.CreateAdd(ir_builder_.CreateUDiv(floorMod(ts, SECSPERDAY), i64(SECSPERQUARTERDAY)), i64(1));
+      case kDOW:
+        return dayOfWeek(floorDiv(ts, SECSPERDAY));
+      case kISODOW: {
+        const auto dow = dayOfWeek(floorDiv(ts, SECSPERDAY));
+        return ir_builder_.CreateSelect(ir_builder_.CreateICmpEQ(dow, i64(0)), i64(DAYSPERWEEK), dow);
+      }
+      default:
+        break;
+    }
+    const auto days = floorDiv(ts, SECSPERDAY);
+    const auto date = civilFromDays(days);
+    switch (field) {
+      case kYEAR:
+        return date.year;
+      case kQUARTER:
+        return ir_builder_.CreateAdd(quarterIndex(date.month), i64(1));
+      case kMONTH:
+        return date.month;
+      case kDAY:
+        return date.day;
+      case kDOY:
+        return ir_builder_.CreateAdd(dayOfYear(days, date.year), i64(1));
+      case kWEEK: {
+        // same numbering as the runtime: weeks start on Sunday, the first (partial) week of the year is week 1
+        const auto doy = dayOfYear(days, date.year);
+        const auto week = ir_builder_.CreateAdd(ir_builder_.CreateUDiv(doy, i64(DAYSPERWEEK)), i64(1));
+        const auto dow = ir_builder_.CreateAdd(dayOfWeek(days), i64(1));
+        const auto in_first_week = ir_builder_.CreateICmpUGT(dow, ir_builder_.CreateURem(doy, i64(DAYSPERWEEK)));
+        return ir_builder_.CreateSelect(in_first_week, week, ir_builder_.CreateAdd(week, i64(1)));
+      }
+      default:
+        CHECK(false);
+    }
+    return nullptr;
+  }
+
+  llvm::Value* truncate(const DatetruncField field, llvm::Value* ts) {
+    switch (field) {
+      case dtMICROSECOND:
+      case dtMILLISECOND:
+      case dtSECOND:
+        return ts;
+      case dtMINUTE:
+        return floorToMultiple(ts, SECSPERMIN);
+      case dtHOUR:
+        return floorToMultiple(ts, SECSPERHOUR);
+      case dtQUARTERDAY:
+        return floorToMultiple(ts, SECSPERQUARTERDAY);
+      case dtDAY:
+        return floorToMultiple(ts, SECSPERDAY);
+      default:
+        break;
+    }
+    const auto days = floorDiv(ts, SECSPERDAY);
+    llvm::Value* first_day{nullptr};
+    switch (field) {
+      case dtWEEK:
+        first_day = ir_builder_.CreateSub(days, dayOfWeek(days));
+        break;
+      case dtMONTH: {
+        const auto date = civilFromDays(days);
+        first_day = ir_builder_.CreateAdd(ir_builder_.CreateSub(days, date.day), i64(1));
+        break;
+      }
+      case dtQUARTER: {
+        const auto date = civilFromDays(days);
+        const auto first_month =
+            ir_builder_.CreateAdd(ir_builder_.CreateMul(quarterIndex(date.month), i64(3)), i64(1));
+        first_day = daysFromCivil(date.year, first_month);
+        break;
+      }
+      case dtYEAR:
+        first_day = daysFromCivil(civilFromDays(days).year, i64(1));
+        break;
+      default:
+        CHECK(false);
+    }
+    return ir_builder_.CreateMul(first_day, i64(SECSPERDAY));
+  }
+
+  // Returns null_lv for the null sentinel, ret otherwise. The sentinel still goes through the arithmetic above,
+  // which wraps around without side effects.
+  llvm::Value* selectNull(llvm::Value* ts, llvm::Value* null_lv, llvm::Value* ret) {
+    null_lv = toInt64(null_lv);
+    return ir_builder_.CreateSelect(ir_builder_.CreateICmpEQ(ts, null_lv), null_lv, ret);
+  }
+
+  llvm::Value* toInt64(llvm::Value* lv) {
+    CHECK(lv->getType()->isIntegerTy(32) || lv->getType()->isIntegerTy(64));
+    return lv->getType()->isIntegerTy(64) ? lv : ir_builder_.CreateSExt(lv, i64_type_);
+  }
+
+ private:
+  struct CivilDate {
+    llvm::Value* year;
+    llvm::Value* month;  // 1 to 12
+    llvm::Value* day;    // 1 to 31
+  };
+
+  llvm::Value* i64(const int64_t v) const { return llvm::ConstantInt::get(i64_type_, v); }
+
+  llvm::Value* floorDiv(llvm::Value* x, const int64_t divisor) {
+    const auto quot = ir_builder_.CreateSDiv(x, i64(divisor));
+    const auto rem = ir_builder_.CreateSRem(x, i64(divisor));
+    return ir_builder_.CreateSub(quot, ir_builder_.CreateZExt(ir_builder_.CreateICmpSLT(rem, i64(0)), i64_type_));
+  }
+
+  llvm::Value* floorMod(llvm::Value* x, const int64_t divisor) {
+    const auto rem = ir_builder_.CreateSRem(x, i64(divisor));
+    return ir_builder_.CreateAdd(
+        rem, ir_builder_.CreateSelect(ir_builder_.CreateICmpSLT(rem, i64(0)), i64(divisor), i64(0)));
+  }
+
+  llvm::Value* floorToMultiple(llvm::Value* x, const int64_t divisor) {
+    return ir_builder_.CreateSub(x, floorMod(x, divisor));
+  }
+
+  // 1970-01-01 was a Thursday, Sunday is 0
+  llvm::Value* dayOfWeek(llvm::Value* days) { return floorMod(ir_builder_.CreateAdd(days, i64(4)), DAYSPERWEEK); }
+
+  llvm::Value* quarterIndex(llvm::Value* month) {
+    return ir_builder_.CreateUDiv(ir_builder_.CreateSub(month, i64(1)), i64(3));
+  }
+
+  // 0-based day of the year
+  llvm::Value* dayOfYear(llvm::Value* days, llvm::Value* year) {
+    return ir_builder_.CreateSub(days, daysFromCivil(year, i64(1)));
+  }
+
+  // Days from the start of a 400 years era to the start of its yoe-th year, the years starting on March 1st.
+  llvm::Value* daysBeforeYearOfEra(llvm::Value* yoe) {
+    const auto days = ir_builder_.CreateAdd(ir_builder_.CreateMul(yoe, i64(DAYS_PER_YEAR)),
+                                            ir_builder_.CreateUDiv(yoe, i64(4)));
+    return ir_builder_.CreateSub(days, ir_builder_.CreateUDiv(yoe, i64(100)));
+  }
+
+  // The years start on March 1st in the computation, which puts the leap day last; the values below the era are
+  // non-negative, hence the unsigned divisions.
+  CivilDate civilFromDays(llvm::Value* days) {
+    const auto z = ir_builder_.CreateAdd(days, i64(719468));  // days since 0000-03-01
+    const auto era = floorDiv(z, DAYS_PER_400_YEARS);
+    const auto doe = ir_builder_.CreateSub(z, ir_builder_.CreateMul(era, i64(DAYS_PER_400_YEARS)));  // [0, 146096]
+    auto yoe = ir_builder_.CreateSub(doe, ir_builder_.CreateUDiv(doe, i64(DAYS_PER_4_YEARS - 1)));
+    yoe = ir_builder_.CreateAdd(yoe, ir_builder_.CreateUDiv(doe, i64(DAYS_PER_100_YEARS)));
+    yoe = ir_builder_.CreateSub(yoe, ir_builder_.CreateUDiv(doe, i64(DAYS_PER_400_YEARS - 1)));
+    yoe = ir_builder_.CreateUDiv(yoe, i64(DAYS_PER_YEAR));  // [0, 399]
+    const auto doy = ir_builder_.CreateSub(doe, daysBeforeYearOfEra(yoe));  // [0, 365]
+    const auto mp = ir_builder_.CreateUDiv(ir_builder_.CreateAdd(ir_builder_.CreateMul(doy, i64(5)), i64(2)),
+                                           i64(153));  // [0, 11], 0 is March
+    const auto month_start_doy = ir_builder_.CreateUDiv(
+        ir_builder_.CreateAdd(ir_builder_.CreateMul(mp, i64(153)), i64(2)), i64(5));
+    const auto day = ir_builder_.CreateAdd(ir_builder_.CreateSub(doy, month_start_doy), i64(1));
+    const auto is_jan_or_feb = ir_builder_.CreateICmpUGE(mp, i64(10));
+    const auto month = ir_builder_.CreateAdd(mp, ir_builder_.CreateSelect(is_jan_or_feb, i64(-9), i64(3)));
+    auto year = ir_builder_.CreateAdd(yoe, ir_builder_.CreateMul(era, i64(400)));
+    year = ir_builder_.CreateAdd(year, ir_builder_.CreateZExt(is_jan_or_feb, i64_type_));
+    return {year, month, day};
+  }
+
+  // Days since the epoch of the first day of the given month.
+  llvm::Value* daysFromCivil(llvm::Value* year, llvm::Value* month) {
+    const auto is_jan_or_feb = ir_builder_.CreateICmpULE(month, i64(2));
+    year = ir_builder_.CreateSub(year, ir_builder_.CreateZExt(is_jan_or_feb, i64_type_));
+    const auto era = floorDiv(year, 400);
+    const auto yoe = ir_builder_.CreateSub(year, ir_builder_.CreateMul(era, i64(400)));  // [0, 399]
+    const auto mp = ir_builder_.CreateAdd(month, ir_builder_.CreateSelect(is_jan_or_feb, i64(9), i64(-3)));
+    const auto doy = ir_builder_.CreateUDiv(ir_builder_.CreateAdd(ir_builder_.CreateMul(mp, i64(153)), i64(2)),
+                                            i64(5));
+    const auto doe = ir_builder_.CreateAdd(daysBeforeYearOfEra(yoe), doy);
+    return ir_builder_.CreateSub(
+        ir_builder_.CreateAdd(ir_builder_.CreateMul(era, i64(DAYS_PER_400_YEARS)), doe), i64(719468));
+  }
+
+  llvm::IRBuilder<>& ir_builder_;
+  llvm::Type* i64_type_;
+};
+
+}  // namespace
+
+llvm::Value* Executor::codegenInlineExtract(const ExtractField field, llvm::Value* ts_lv, llvm::Value* null_lv) {
+  if (!g_enable_inline_datetime || !DateTimeIRBuilder::canExtract(field)) {
+    return nullptr;
+  }
+  DateTimeIRBuilder dt_builder(cgen_state_->ir_builder_, cgen_state_->context_);
+  ts_lv = dt_builder.toInt64(ts_lv);
+  const auto ret = dt_builder.extract(field, ts_lv);
+  return null_lv ? dt_builder.selectNull(ts_lv, null_lv, ret) : ret;
+}
+
+llvm::Value* Executor::codegenInlineDateTrunc(const DatetruncField field, llvm::Value* ts_lv, llvm::Value* null_lv) {
+  if (!g_enable_inline_datetime || !DateTimeIRBuilder::canTruncate(field)) {
+    return nullptr;
+  }
+  DateTimeIRBuilder dt_builder(cgen_state_->ir_builder_, cgen_state_->context_);
+  ts_lv = dt_builder.toInt64(ts_lv);
+  const auto ret = dt_builder.truncate(field, ts_lv);
+  return null_lv ? dt_builder.selectNull(ts_lv, null_lv, ret) : ret;
+}
+
 llvm::Value* Executor::codegen(const Analyzer::ExtractExpr* extract_expr, const CompilationOptions& co) {
   auto from_expr = codegen(extract_expr->get_from_expr(), true, co).front();
   const int32_t extract_field{extract_expr->get_field()};
@@ -29,6 +255,13 @@ llvm::Value* Executor::codegen(const Analyzer::ExtractExpr* extract_expr, const
     return from_expr;
   }
   CHECK(from_expr->getType()->isIntegerTy(32) || from_expr->getType()->isIntegerTy(64));
+  const auto inline_extract =
+      codegenInlineExtract(extract_expr->get_field(),
+                           from_expr,
+                           extract_expr_ti.get_notnull() ? nullptr : inlineIntNull(extract_expr_ti));
+  if (inline_extract) {
+    return inline_extract;
+  }
   static_assert(sizeof(time_t) == 4 || sizeof(time_t) == 8, "Unsupported time_t size");
   if (sizeof(time_t) == 4 && from_expr->getType()->isIntegerTy(64)) {
     from_expr = cgen_state_->ir_builder_.CreateCast(
@@ -95,6 +328,13 @@ llvm::Value* Executor::codegen(const Analyzer::DatetruncExpr* datetrunc_expr, co
   auto from_expr = codegen(datetrunc_expr->get_from_expr(), true, co).front();
   const auto& datetrunc_expr_ti = datetrunc_expr->get_from_expr()->get_type_info();
   CHECK(from_expr->getType()->isIntegerTy(32) || from_expr->getType()->isIntegerTy(64));
+  const auto inline_datetrunc =
+      codegenInlineDateTrunc(datetrunc_expr->get_field(),
+                             from_expr,
+                             datetrunc_expr_ti.get_notnull() ? nullptr : inlineIntNull(datetrunc_expr_ti));
+  if (inline_datetrunc) {
+    return inline_datetrunc;
+  }
   static_assert(sizeof(time_t) == 4 || sizeof(time_t) == 8, "Unsupported time_t size");
   if (sizeof(time_t) == 4 && from_expr->getType()->isIntegerTy(64)) {
     from_expr = cgen_state_->ir_builder_.CreateCast(
@@ -23,6 +23,12 @@
 
 #include <iostream>
 
+// Floors timeval to a multiple of scale seconds, also for the times before the epoch.
+DEVICE time_t floor_to_multiple(const time_t timeval, const time_t scale) {
+  const time_t rem = timeval % scale;
+  return timeval - (rem < 0 ? rem + scale : rem);
+}
+
 extern "C" NEVER_INLINE DEVICE time_t create_epoch(int year) {
   // Note this is not general purpose
   // it has a final assumption that the year being passed can never be a leap
@@ -80,38 +86,16 @@ extern "C" NEVER_INLINE DEVICE time_t DateTruncate(DatetruncField field, time_t
     case dtSECOND:
       /* this is the limit of current granularity*/
       return timeval;
-    case dtMINUTE: {
-      time_t ret = (uint64_t)(timeval / SECSPERMIN) * SECSPERMIN;
-      // in the case of a negative time we still want to push down so need to push one more
-      if (ret < 0)
-        ret -= SECSPERMIN;
-      return ret;
-    }
-    case dtHOUR: {
-      time_t ret = (uint64_t)(timeval / SECSPERHOUR) * SECSPERHOUR;
-      // in the case of a negative time we still want to push down so need to push one more
-      if (ret < 0)
-        ret -= SECSPERHOUR;
-      return ret;
-    }
-    case dtQUARTERDAY: {
-      time_t ret = (uint64_t)(timeval / SECSPERQUARTERDAY) * SECSPERQUARTERDAY;
-      // in the case of a negative time we still want to push down so need to push one more
-      if (ret < 0)
-        ret -= SECSPERQUARTERDAY;
-      return ret;
-    }
-    case dtDAY: {
-      time_t ret = (uint64_t)(timeval / SECSPERDAY) * SECSPERDAY;
-      // in the case of a negative time we still want to push down so need to push one more
-      if (ret < 0)
-        ret -= SECSPERDAY;
-      return ret;
-    }
+    case dtMINUTE:
+      return floor_to_multiple(timeval, SECSPERMIN);
+    case dtHOUR:
+      return floor_to_multiple(timeval, SECSPERHOUR);
+    case dtQUARTERDAY:
+      return floor_to_multiple(timeval, SECSPERQUARTERDAY);
+    case dtDAY:
+      return floor_to_multiple(timeval, SECSPERDAY);
     case dtWEEK: {
-      time_t day = (uint64_t)(timeval / SECSPERDAY) * SECSPERDAY;
-      if (day < 0)
-        day -= SECSPERDAY;
+      time_t day = floor_to_multiple(timeval, SECSPERDAY);
       int dow = extract_dow(&day);
       return day - (dow * SECSPERDAY);
     }
@@ -180,18 +164,14 @@ extern "C" NEVER_INLINE DEVICE time_t DateTruncate(DatetruncField field, time_t
   switch (field) {
     case dtMONTH: {
       // clear the time
-      time_t day = (uint64_t)(timeval / SECSPERDAY) * SECSPERDAY;
-      if (day < 0)
-        day -= SECSPERDAY;
+      time_t day = floor_to_multiple(timeval, SECSPERDAY);
       // calculate the day of month offset
       int dom = tm_struct.tm_mday;
       return day - ((dom - 1) * SECSPERDAY);
     }
     case dtQUARTER: {
       // clear the time
-      time_t day = (uint64_t)(timeval / SECSPERDAY) * SECSPERDAY;
-      if (day < 0)
-        day -= SECSPERDAY;
+      time_t day = floor_to_multiple(timeval, SECSPERDAY);
       // calculate the day of month offset
       int dom = tm_struct.tm_mday;
       // go to the start of the current month
@@ -217,9 +197,7 @@ extern "C" NEVER_INLINE DEVICE time_t DateTruncate(DatetruncField field, time_t
     }
     case dtYEAR: {
       // clear the time
-      time_t day = (uint64_t)(timeval / SECSPERDAY) * SECSPERDAY;
-      if (day < 0)
-        day -= SECSPERDAY;
+      time_t day = floor_to_multiple(timeval, SECSPERDAY);
       // calculate the day of year offset
       int doy = tm_struct.tm_yday;
       return day - ((doy)*SECSPERDAY);
@@ -89,11 +89,49 @@ extern "C" DEVICE NEVER_INLINE int64_t SUFFIX(fixed_width_unsigned_decode_noinli
   return SUFFIX(fixed_width_unsigned_decode)(byte_stream, byte_width, pos);
 }
 
+// Frame of reference chunks (ENCODING DIFF) start with the int64_t base, followed by the
+// byte_width offsets from it. The most negative offset is the null sentinel.
 extern "C" DEVICE ALWAYS_INLINE int64_t SUFFIX(diff_fixed_width_int_decode)(const int8_t* byte_stream,
                                                                             const int32_t byte_width,
-                                                                            const int64_t baseline,
+                                                                            const int64_t null_val,
                                                                             const int64_t pos) {
-  return SUFFIX(fixed_width_int_decode)(byte_stream, byte_width, pos) + baseline;
+  const auto offset = SUFFIX(fixed_width_int_decode)(byte_stream + sizeof(int64_t), byte_width, pos);
+  if (offset == -(int64_t(1) << (8 * byte_width - 1))) {
+    return null_val;
+  }
+  return *reinterpret_cast<const int64_t*>(byte_stream) + offset;
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t SUFFIX(diff_fixed_width_int_decode_noinline)(const int8_t* byte_stream,
+                                                                                    const int32_t byte_width,
+                                                                                    const int64_t null_val,
+                                                                                    const int64_t pos) {
+  return SUFFIX(diff_fixed_width_int_decode)(byte_stream, byte_width, null_val, pos);
+}
+
+// Run length chunks (ENCODING RL) are int64_t arrays: the run count, then the end (exclusive)
+// and the value of every run. Nulls are stored as the logical null of the column.
+extern "C" DEVICE ALWAYS_INLINE int64_t SUFFIX(run_length_int_decode)(const int8_t* byte_stream, const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  const auto runs = reinterpret_cast<const int64_t*>(byte_stream);
+  int64_t lo = 0;
+  int64_t hi = runs[0] - 1;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (runs[1 + 2 * mid] <= pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return runs[2 + 2 * lo];
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t SUFFIX(run_length_int_decode_noinline)(const int8_t* byte_stream,
+                                                                              const int64_t pos) {
+  return SUFFIX(run_length_int_decode)(byte_stream, pos);
 }
 
 extern "C" DEVICE ALWAYS_INLINE float SUFFIX(fixed_width_float_decode)(const int8_t* byte_stream, const int64_t pos) {
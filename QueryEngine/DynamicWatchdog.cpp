@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 #include "DynamicWatchdog.h"
@@ -32,44 +35,75 @@ static __inline__ uint64_t read_cycle_counter(void) {
 #endif
 }
 
-extern "C" uint64_t dynamic_watchdog_init(unsigned ms_budget) {
-  static uint64_t dw_cycle_start = 0ULL;
-  static uint64_t dw_cycle_budget = 0ULL;
-  static std::atomic_bool dw_abort{false};
+namespace {
 
-  if (ms_budget == static_cast<unsigned>(DW_DEADLINE)) {
-    if (dw_abort.load())
-      return 0LL;
-    return dw_cycle_start + dw_cycle_budget;
+thread_local const QueryCancellationToken* current_query_token{nullptr};
+
+// Cycle counter ticks per millisecond, measured once per process.
+uint64_t cycles_per_ms() {
+  static const uint64_t cycles_per_ms = []() {
+    const auto cycle_start = read_cycle_counter();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return std::max(read_cycle_counter() - cycle_start, uint64_t(1));
+  }();
+  return cycles_per_ms;
+}
+
+}  // namespace
+
+void QueryCancellationToken::startDeadline(const unsigned ms_budget) {
+  if (deadline_cycles_) {
+    return;
   }
-  if (ms_budget == static_cast<unsigned>(DW_ABORT)) {
-    dw_abort = true;
-    return 0LL;
+  const auto cycle_budget = cycles_per_ms() * static_cast<uint64_t>(ms_budget);
+  uint64_t no_deadline{0};
+  if (deadline_cycles_.compare_exchange_strong(no_deadline, read_cycle_counter() + cycle_budget)) {
+    VLOG(1) << "INIT: query token " << this << ": ms_budget " << ms_budget << ", cycle_budget " << cycle_budget
+            << ", deadline " << deadline_cycles_;
   }
-  if (ms_budget == static_cast<unsigned>(DW_RESET)) {
-    dw_abort = false;
-    return 0LL;
+}
+
+unsigned QueryCancellationToken::getRemainingMs() const {
+  const uint64_t deadline = deadline_cycles_;
+  const auto clock = read_cycle_counter();
+  return deadline > clock ? (deadline - clock) / cycles_per_ms() : 0;
+}
+
+bool QueryCancellationToken::shouldStop() const {
+  if (cancelled_) {
+    return true;
   }
+  const uint64_t deadline = deadline_cycles_;
+  return deadline && read_cycle_counter() > deadline;
+}
+
+QueryCancellationToken::ThreadScope::ThreadScope(const QueryCancellationToken* token)
+    : previous_token_(current_query_token) {
+  current_query_token = token;
+}
+
+QueryCancellationToken::ThreadScope::~ThreadScope() {
+  current_query_token = previous_token_;
+}
 
-  // Init cycle start, measure freq, set and return cycle budget
-  dw_cycle_start = read_cycle_counter();
-  std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  auto freq_kHz = read_cycle_counter() - dw_cycle_start;
-  dw_cycle_budget = freq_kHz * static_cast<uint64_t>(ms_budget);
-  VLOG(1) << "INIT: thread " << std::this_thread::get_id() << ": ms_budget " << ms_budget << ", cycle_start "
-          << dw_cycle_start << ", cycle_budget " << dw_cycle_budget << ", dw_deadline "
-          << dw_cycle_start + dw_cycle_budget;
-  return dw_cycle_budget;
+const QueryCancellationToken* QueryCancellationToken::current() {
+  return current_query_token;
 }
 
-// timeout detection
+// timeout and interrupt detection
 extern "C" bool dynamic_watchdog() {
-  auto clock = read_cycle_counter();
-  auto dw_deadline = dynamic_watchdog_init(static_cast<unsigned>(DW_DEADLINE));
-  if (clock > dw_deadline) {
-    LOG(INFO) << "TIMEOUT: thread " << std::this_thread::get_id() << ": clock " << clock << ", deadline "
-              << dw_deadline;
-    return true;
+  const auto token = current_query_token;
+  if (!token || !token->shouldStop()) {
+    return false;
+  }
+  LOG(INFO) << (token->isCancelled() ? "INTERRUPT" : "TIMEOUT") << ": thread " << std::this_thread::get_id()
+            << ", query token " << token;
+  return true;
+}
+
+void throw_query_interrupted(const char* stage) {
+  if (current_query_token && current_query_token->isCancelled()) {
+    throw std::runtime_error(std::string("Query execution has been interrupted during ") + stage);
   }
-  return false;
+  throw std::runtime_error(std::string("Query execution has exceeded the time limit during ") + stage);
 }
@@ -17,12 +17,68 @@
 #ifndef QUERYENGINE_DYNAMICWATCHDOG_H
 #define QUERYENGINE_DYNAMICWATCHDOG_H
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 
-enum DynamicWatchdogFlags { DW_DEADLINE = 0, DW_ABORT = -1, DW_RESET = -2 };
+// Deadline and cancellation flag of a single query. The session which issued the query
+// keeps a reference to interrupt it; the generated code and the host side reduction and
+// sort loops poll it through dynamic_watchdog() on the threads executing the query.
+class QueryCancellationToken {
+ public:
+  QueryCancellationToken() : cancelled_(false), deadline_cycles_(0) {}
 
-extern "C" uint64_t dynamic_watchdog_init(unsigned ms_budget);
+  // Starts the time budget of the query. Later calls, e.g. when the query is retried on
+  // CPU or moves on to its next step, keep the first deadline.
+  void startDeadline(const unsigned ms_budget);
 
+  void cancel() { cancelled_ = true; }
+
+  bool isCancelled() const { return cancelled_; }
+
+  bool hasDeadline() const { return deadline_cycles_ != 0; }
+
+  // Milliseconds left until the deadline, 0 if it has passed already.
+  unsigned getRemainingMs() const;
+
+  // True once the query has been cancelled or its deadline has passed.
+  bool shouldStop() const;
+
+  // Makes the token the one polled by dynamic_watchdog() on the calling thread, for the
+  // lifetime of the scope. Threads spawned on behalf of the query must open their own.
+  class ThreadScope {
+   public:
+    explicit ThreadScope(const QueryCancellationToken* token);
+    ~ThreadScope();
+
+   private:
+    ThreadScope(const ThreadScope&) = delete;
+    ThreadScope& operator=(const ThreadScope&) = delete;
+
+    const QueryCancellationToken* previous_token_;
+  };
+
+  // The token of the query running on the calling thread, nullptr if there's none.
+  static const QueryCancellationToken* current();
+
+ private:
+  std::atomic<bool> cancelled_;
+  std::atomic<uint64_t> deadline_cycles_;  // 0 while no deadline has been set
+};
+
+// Returns true if the query running on the calling thread must stop.
 extern "C" bool dynamic_watchdog();
 
+// Throws a std::runtime_error saying whether the query running on the calling thread has
+// been interrupted or has run out of time during the given stage.
+void throw_query_interrupted(const char* stage);
+
+// Polled by the host side loops of a query, which can't return an error code. Checks
+// once every 64 iterations of the loop.
+inline void check_query_interrupt(const size_t sample_seed, const char* stage) {
+  if ((sample_seed & 0x3F) == 0 && dynamic_watchdog()) {
+    throw_query_interrupted(stage);
+  }
+}
+
 #endif  // QUERYENGINE_DYNAMICWATCHDOG_H
@@ -29,6 +29,7 @@
 #include "QueryRewrite.h"
 #include "QueryTemplateGenerator.h"
 #include "RuntimeFunctions.h"
+#include "SpatialJoinHashTable.h"
 #include "SpeculativeTopN.h"
 
 #include "CudaMgr/CudaMgr.h"
@@ -65,6 +66,10 @@ unsigned g_trivial_loop_join_threshold{1000};
 bool g_left_deep_join_optimization{true};
 bool g_from_table_reordering{true};
 bool g_inner_join_fragment_skipping{false};
+bool g_enable_spatial_join_index{true};
+bool g_enable_inline_datetime{true};
+size_t g_group_by_spill_entries{1 << 22};
+size_t g_max_concurrent_steps{4};
 
 Executor::Executor(const int db_id,
                    const size_t block_size_x,
@@ -75,7 +80,8 @@ Executor::Executor(const int db_id,
     : cgen_state_(new CgenState({}, false, false)),
       is_nested_(false),
       gpu_active_modules_device_mask_(0x0),
-      interrupted_(false),
+      query_token_(std::make_shared<QueryCancellationToken>()),
+      step_profile_(nullptr),
       render_manager_(render_manager),
       block_size_x_(block_size_x),
       grid_size_x_(grid_size_x),
@@ -84,7 +90,8 @@ Executor::Executor(const int db_id,
       db_id_(db_id),
       catalog_(nullptr),
       temporary_tables_(nullptr),
-      input_table_info_cache_(this) {}
+      input_table_info_cache_(this),
+      is_step_executor_(false) {}
 
 std::shared_ptr<Executor> Executor::getExecutor(const int db_id,
                                                 const std::string& debug_dir,
@@ -169,6 +176,53 @@ ExpressionRange Executor::getColRange(const PhysicalInput& phys_input) const {
   return agg_col_range_cache_.getColRange(phys_input);
 }
 
+Executor* Executor::acquireStepExecutor() {
+  CHECK(!is_step_executor_);
+  std::shared_ptr<QueryCancellationToken> query_token;
+  {
+    std::lock_guard<std::mutex> lock(gpu_active_modules_mutex_);
+    query_token = query_token_;
+  }
+  Executor* step_executor{nullptr};
+  {
+    std::lock_guard<std::mutex> lock(step_executors_mutex_);
+    if (idle_step_executors_.empty()) {
+      step_executors_.emplace_back(
+          new Executor(db_id_, block_size_x_, grid_size_x_, debug_dir_, debug_file_, nullptr));
+      step_executor = step_executors_.back().get();
+      step_executor->is_step_executor_ = true;
+    } else {
+      step_executor = idle_step_executors_.back();
+      idle_step_executors_.pop_back();
+    }
+  }
+  step_executor->row_set_mem_owner_ = row_set_mem_owner_;
+  step_executor->catalog_ = catalog_;
+  step_executor->agg_col_range_cache_ = agg_col_range_cache_;
+  step_executor->string_dictionary_generations_ = string_dictionary_generations_;
+  step_executor->table_generations_ = table_generations_;
+  step_executor->resetInterrupt(query_token);
+  return step_executor;
+}
+
+void Executor::releaseStepExecutor(Executor* step_executor) {
+  CHECK(step_executor && step_executor->is_step_executor_);
+  // the catalog and the literal dictionary stay, results of the step read them until the query is over
+  step_executor->row_set_mem_owner_ = nullptr;
+  step_executor->temporary_tables_ = nullptr;
+  step_executor->clearMetaInfoCache();
+  std::lock_guard<std::mutex> lock(step_executors_mutex_);
+  idle_step_executors_.push_back(step_executor);
+}
+
+void Executor::resetStepExecutors() {
+  std::lock_guard<std::mutex> lock(step_executors_mutex_);
+  CHECK_EQ(step_executors_.size(), idle_step_executors_.size());
+  for (auto& step_executor : step_executors_) {
+    step_executor->lit_str_dict_proxy_ = nullptr;
+  }
+}
+
 void Executor::clearMetaInfoCache() {
   input_table_info_cache_.clear();
   agg_col_range_cache_.clear();
@@ -755,8 +809,12 @@ RowSetPtr Executor::reduceMultiDeviceResults(const RelAlgExecutionUnit& ra_exe_u
     return std::make_shared<ResultSet>(targets, ExecutorDeviceType::CPU, QueryMemoryDescriptor{}, nullptr, this);
   }
 
-  return reduceMultiDeviceResultSets(
+  auto reduced_results = reduceMultiDeviceResultSets(
       results_per_device, row_set_mem_owner, ResultSet::fixupQueryMemoryDescriptor(query_mem_desc));
+  if (row_set_mem_owner) {
+    row_set_mem_owner->flushTDigests();
+  }
+  return reduced_results;
 }
 
 RowSetPtr Executor::reduceMultiDeviceResultSets(
@@ -949,6 +1007,14 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
                                     RenderInfo* render_info,
                                     const bool has_cardinality_estimation) {
   INJECT_TIMER(Exec_executeWorkUnit);
+  if (options.with_dynamic_watchdog) {
+    CHECK_GT(options.dynamic_watchdog_time_limit, unsigned(0));
+    // the budget covers every step of the query, the first one to run starts it
+    query_token_->startDeadline(options.dynamic_watchdog_time_limit);
+  }
+  QueryCancellationToken::ThreadScope query_token_scope(query_token_.get());
+  step_profile_ = options.query_profile ? options.query_profile->currentStep() : nullptr;
+  ScopeGuard reset_step_profile = [this] { step_profile_ = nullptr; };
   const auto ra_exe_unit = addDeletedColumn(ra_exe_unit_in);
   const auto device_type = getDeviceTypeForTargets(ra_exe_unit, co.device_type_);
   CHECK(!query_infos.empty());
@@ -1007,8 +1073,14 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
                                          render_info);
     try {
       INJECT_TIMER(execution_dispatch_comp);
+      std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
+      const auto clock_begin = timer_start();
       crt_min_byte_width = execution_dispatch.compile(
           join_info, max_groups_buffer_entry_guess, crt_min_byte_width, options, has_cardinality_estimation);
+      if (step_profile_) {
+        step_profile_->addCompilation(
+            timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(clock_begin));
+      }
     } catch (CompilationRetryNoCompaction&) {
       crt_min_byte_width = MAX_BYTE_WIDTH_SUPPORTED;
       continue;
@@ -1068,7 +1140,7 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
                         available_gpus,
                         available_cpus);
     }
-    if (options.with_dynamic_watchdog && interrupted_ && *error_code == ERR_OUT_OF_TIME) {
+    if (isInterrupted() && *error_code == ERR_OUT_OF_TIME) {
       *error_code = ERR_INTERRUPTED;
     }
     cat.get_dataMgr().freeAllBuffers();
@@ -1083,7 +1155,14 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
     if (is_agg) {
       try {
         OOM_TRACE_PUSH();
-        return collectAllDeviceResults(execution_dispatch, ra_exe_unit.target_exprs, query_mem_desc, row_set_mem_owner);
+        const auto clock_begin = timer_start();
+        auto results =
+            collectAllDeviceResults(execution_dispatch, ra_exe_unit.target_exprs, query_mem_desc, row_set_mem_owner);
+        if (step_profile_) {
+          step_profile_->addReduction(
+              timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(clock_begin));
+        }
+        return results;
       } catch (ReductionRanOutOfSlots&) {
         *error_code = ERR_OUT_OF_SLOTS;
         std::vector<TargetInfo> targets;
@@ -1097,7 +1176,13 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
       }
     }
     OOM_TRACE_PUSH();
-    return resultsUnion(execution_dispatch);
+    const auto clock_begin = timer_start();
+    auto results = resultsUnion(execution_dispatch);
+    if (step_profile_) {
+      step_profile_->addReduction(
+          timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(clock_begin));
+    }
+    return results;
 
   } while (static_cast<size_t>(crt_min_byte_width) <= sizeof(int64_t));
 
@@ -1188,6 +1273,9 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
     const bool float_argument_input = takes_float_argument(agg_info);
     if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
       entry.push_back(0);
+    } else if (agg_info.agg_kind == kAPPROX_PERCENTILE) {
+      // no digest, read back as null
+      entry.push_back(0);
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.agg_arg_type, float_argument_input));
       entry.push_back(0);
@@ -1319,6 +1407,9 @@ std::unordered_map<int, const Analyzer::BinOper*> Executor::getInnerTabIdToJoinC
   const auto& join_info = plan_state_->join_info_;
   CHECK_EQ(join_info.equi_join_tautologies_.size(), join_info.join_hash_tables_.size());
   for (size_t i = 0; i < join_info.join_hash_tables_.size(); ++i) {
+    if (!join_info.equi_join_tautologies_[i]) {
+      continue;
+    }
     int inner_table_id = join_info.join_hash_tables_[i]->getInnerTableId();
     id_to_cond.insert(std::make_pair(inner_table_id, join_info.equi_join_tautologies_[i].get()));
   }
@@ -1354,6 +1445,7 @@ void Executor::dispatchFragments(
 
   const auto& query_mem_desc = execution_dispatch.getQueryMemoryDescriptor();
   const auto inner_table_id_to_join_condition = getInnerTabIdToJoinCond();
+  const auto skipped_partitions = getSkippedPartitions(outer_table_desc, ra_exe_unit.simple_quals);
 
   const bool allow_multifrag =
       eo.allow_multifrag && (ra_exe_unit.groupby_exprs.empty() || query_mem_desc.usesCachedContext() ||
@@ -1372,11 +1464,19 @@ void Executor::dispatchFragments(
     for (size_t outer_frag_id = 0; outer_frag_id < outer_fragments->size(); ++outer_frag_id) {
       const auto& fragment = (*outer_fragments)[outer_frag_id];
       auto skip_frag =
-          skipFragment(outer_table_desc, fragment, ra_exe_unit.simple_quals, execution_dispatch, outer_frag_id);
+          skipped_partitions.count(fragment.physicalTableId)
+              ? std::make_pair(true, int64_t(-1))
+              : skipFragment(outer_table_desc, fragment, ra_exe_unit.simple_quals, execution_dispatch, outer_frag_id);
+      if (!skip_frag.first && skip_fragment_by_geo_bounds(outer_table_desc.getTableId(), fragment, ra_exe_unit.quals)) {
+        skip_frag.first = true;
+      }
       if (g_inner_join_fragment_skipping && (skip_frag == std::pair<bool, int64_t>(false, -1))) {
         skip_frag = skipFragmentInnerJoins(outer_table_desc, fragment, execution_dispatch, outer_frag_id);
       }
       if (skip_frag.first) {
+        if (step_profile_) {
+          step_profile_->addSkippedFragments(1);
+        }
         continue;
       }
       const auto device_count = catalog_->get_dataMgr().cudaMgr_->getDeviceCount();
@@ -1413,8 +1513,16 @@ void Executor::dispatchFragments(
   } else {
     for (size_t i = 0; i < outer_fragments->size(); ++i) {
       const auto& fragment = (*outer_fragments)[i];
-      const auto skip_frag = skipFragment(outer_table_desc, fragment, ra_exe_unit.simple_quals, execution_dispatch, i);
+      auto skip_frag = skipped_partitions.count(fragment.physicalTableId)
+                           ? std::make_pair(true, int64_t(-1))
+                           : skipFragment(outer_table_desc, fragment, ra_exe_unit.simple_quals, execution_dispatch, i);
+      if (!skip_frag.first && skip_fragment_by_geo_bounds(outer_table_desc.getTableId(), fragment, ra_exe_unit.quals)) {
+        skip_frag.first = true;
+      }
       if (skip_frag.first) {
+        if (step_profile_) {
+          step_profile_->addSkippedFragments(1);
+        }
         continue;
       }
       rowid_lookup_key = std::max(rowid_lookup_key, skip_frag.second);
@@ -1884,7 +1992,7 @@ int32_t Executor::executePlanWithoutGroupBy(const RelAlgExecutionUnit& ra_exe_un
   const auto hoist_buf = serializeLiterals(compilation_result.literal_values, device_id);
   const auto join_hash_table_ptrs = getJoinHashTablePtrs(device_type, device_id);
   std::unique_ptr<OutVecOwner> output_memory_scope;
-  if (g_enable_dynamic_watchdog && interrupted_) {
+  if (isInterrupted()) {
     return ERR_INTERRUPTED;
   }
   if (device_type == ExecutorDeviceType::CPU) {
@@ -1957,8 +2065,10 @@ int32_t Executor::executePlanWithoutGroupBy(const RelAlgExecutionUnit& ra_exe_un
       CHECK(agg_info.is_agg);
       int64_t val1;
       const bool float_argument_input = takes_float_argument(agg_info);
-      if (is_distinct_target(agg_info)) {
-        CHECK(agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+      if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_PERCENTILE) {
+        // all the entries point to the same set or digest
+        CHECK(agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+              agg_info.agg_kind == kAPPROX_PERCENTILE);
         val1 = out_vec[out_vec_idx][0];
         error_code = 0;
       } else {
@@ -2055,7 +2165,7 @@ int32_t Executor::executePlanWithGroupBy(const RelAlgExecutionUnit& ra_exe_unit,
   auto hoist_buf = serializeLiterals(compilation_result.literal_values, device_id);
   int32_t error_code = device_type == ExecutorDeviceType::GPU ? 0 : start_rowid;
   const auto join_hash_table_ptrs = getJoinHashTablePtrs(device_type, device_id);
-  if (g_enable_dynamic_watchdog && interrupted_) {
+  if (isInterrupted()) {
     return ERR_INTERRUPTED;
   }
 
@@ -2244,6 +2354,10 @@ void Executor::executeSimpleInsert(const Planner::RootPlan* root_plan) {
   insert_data.databaseId = cat.get_currentDB().dbId;
   insert_data.tableId = table_id;
   int64_t int_col_val{0};
+  if (table_is_range_partitioned(table_descriptor)) {
+    // a partition column left out of the INSERT is null, nulls go to the first partition
+    shard = shard_tables.front();
+  }
   for (auto target_entry : targets) {
     auto col_cv = dynamic_cast<const Analyzer::Constant*>(target_entry->get_expr());
     if (!col_cv) {
@@ -2337,6 +2451,7 @@ void Executor::executeSimpleInsert(const Planner::RootPlan* root_plan) {
       case kDATE: {
         auto col_data = reinterpret_cast<time_t*>(col_data_bytes);
         *col_data = col_cv->get_is_null() ? inline_fixed_encoding_null_val(cd->columnType) : col_datum.timeval;
+        int_col_val = col_datum.timeval;
         break;
       }
       case kARRAY: {
@@ -2363,6 +2478,14 @@ void Executor::executeSimpleInsert(const Planner::RootPlan* root_plan) {
       default:
         CHECK(false);
     }
+    if (table_is_range_partitioned(table_descriptor) && cd->columnId == table_descriptor->partitionColumnId) {
+      const auto partition_idx = get_range_partition_index(shard_tables, int_col_val, col_cv->get_is_null());
+      if (partition_idx < 0) {
+        throw std::runtime_error("Value " + std::to_string(int_col_val) + " of column " + cd->columnName +
+                                 " has no partition in table " + table_descriptor->tableName);
+      }
+      shard = shard_tables[partition_idx];
+    }
     ++col_idx;
     if (col_idx == static_cast<size_t>(table_descriptor->shardedColumnId)) {
       shard = shard_tables[int_col_val % shard_tables.size()];
@@ -2594,6 +2717,23 @@ Executor::JoinHashTableOrError Executor::buildHashTableForQualifier(
   return {nullptr, ""};
 }
 
+Executor::JoinHashTableOrError Executor::buildSpatialHashTableForQualifier(
+    const std::shared_ptr<Analyzer::Expr>& qual,
+    const std::vector<InputTableInfo>& query_infos,
+    const MemoryLevel memory_level) {
+  const int device_count =
+      memory_level == MemoryLevel::GPU_LEVEL ? catalog_->get_dataMgr().cudaMgr_->getDeviceCount() : 1;
+  CHECK_GT(device_count, 0);
+  try {
+    OOM_TRACE_PUSH();
+    return {SpatialJoinHashTable::getInstance(qual, query_infos, memory_level, device_count, this), ""};
+  } catch (const HashJoinFail& e) {
+    return {nullptr, e.what()};
+  } catch (const TooManyHashEntries& e) {
+    return {nullptr, e.what()};
+  }
+}
+
 Executor::JoinInfo Executor::chooseJoinType(const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
                                             const std::vector<InputTableInfo>& query_infos,
                                             const RelAlgExecutionUnit& ra_exe_unit,
@@ -2833,6 +2973,82 @@ int Executor::getLocalColumnId(const Analyzer::ColumnVar* col_var, const bool fe
   return it->second;
 }
 
+// The fragments of a range partitioned table come from the physical tables of its partitions. A partition
+// is skipped if a qualifier on the partition column excludes every value it can hold, which only needs the
+// partition bounds from the catalog and none of the chunk metadata. Returns the physical table ids of the
+// skipped partitions, computed once per query rather than for every fragment.
+std::unordered_set<int> Executor::getSkippedPartitions(const InputDescriptor& table_desc,
+                                                       const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals) {
+  std::unordered_set<int> skipped_partitions;
+  const int table_id = table_desc.getTableId();
+  if (table_desc.getSourceType() != InputSourceType::TABLE || table_id <= 0 || simple_quals.empty()) {
+    return skipped_partitions;
+  }
+  const auto td = catalog_->getMetadataForTable(table_id);
+  if (!td || !table_is_range_partitioned(td)) {
+    return skipped_partitions;
+  }
+  std::vector<std::pair<SQLOps, int64_t>> partition_col_quals;
+  for (const auto simple_qual : simple_quals) {
+    const auto comp_expr = std::dynamic_pointer_cast<const Analyzer::BinOper>(simple_qual);
+    if (!comp_expr) {
+      continue;
+    }
+    const auto lhs_col = dynamic_cast<const Analyzer::ColumnVar*>(comp_expr->get_left_operand());
+    if (!lhs_col || lhs_col->get_table_id() != table_id || lhs_col->get_rte_idx() ||
+        lhs_col->get_column_id() != td->partitionColumnId) {
+      continue;
+    }
+    const auto rhs_const = dynamic_cast<const Analyzer::Constant*>(comp_expr->get_right_operand());
+    if (!rhs_const) {
+      continue;
+    }
+    partition_col_quals.emplace_back(comp_expr->get_optype(), codegenIntConst(rhs_const)->getSExtValue());
+  }
+  if (partition_col_quals.empty()) {
+    return skipped_partitions;
+  }
+  const auto partitions = catalog_->getPhysicalTablesDescriptors(td);
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    if (partitions[i]->tableId == table_id) {
+      continue;
+    }
+    const int64_t partition_min =
+        i == 0 ? std::numeric_limits<int64_t>::min() : partitions[i - 1]->partitionUpperBound;
+    const int64_t partition_max = partitions[i]->partitionUpperBound == range_partition_max_value()
+                                      ? std::numeric_limits<int64_t>::max()
+                                      : partitions[i]->partitionUpperBound - 1;
+    for (const auto& qual : partition_col_quals) {
+      const auto rhs_val = qual.second;
+      bool skip{false};
+      switch (qual.first) {
+        case kGE:
+          skip = partition_max < rhs_val;
+          break;
+        case kGT:
+          skip = partition_max <= rhs_val;
+          break;
+        case kLE:
+          skip = partition_min > rhs_val;
+          break;
+        case kLT:
+          skip = partition_min >= rhs_val;
+          break;
+        case kEQ:
+          skip = partition_min > rhs_val || partition_max < rhs_val;
+          break;
+        default:
+          break;
+      }
+      if (skip) {
+        skipped_partitions.insert(partitions[i]->tableId);
+        break;
+      }
+    }
+  }
+  return skipped_partitions;
+}
+
 std::pair<bool, int64_t> Executor::skipFragment(const InputDescriptor& table_desc,
                                                 const Fragmenter_Namespace::FragmentInfo& fragment,
                                                 const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
@@ -2982,4 +3198,6 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(const InputDescriptor&
 
 std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>, std::shared_ptr<Executor>> Executor::executors_;
 std::mutex Executor::execute_mutex_;
+std::mutex Executor::gpu_exec_mutex_[max_gpu_count];
+std::mutex Executor::compilation_mutex_;
 mapd_shared_mutex Executor::executors_cache_mutex_;
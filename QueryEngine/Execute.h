@@ -20,14 +20,17 @@
 #include "AggregatedColRange.h"
 #include "BufferCompaction.h"
 #include "CartesianProduct.h"
+#include "DynamicWatchdog.h"
 #include "GroupByAndAggregate.h"
 #include "IRCodegenUtils.h"
 #include "InValuesBitmap.h"
+#include "InValuesHashSet.h"
 #include "InputMetadata.h"
 #include "JoinHashTable.h"
 #include "LLVMGlobalContext.h"
 #include "LoopControlFlow/JoinLoop.h"
 #include "NvidiaKernel.h"
+#include "QueryProfile.h"
 #include "RelAlgExecutionUnit.h"
 #include "StringDictionaryGenerations.h"
 #include "TableGenerations.h"
@@ -75,6 +78,10 @@ extern bool g_null_div_by_zero;
 extern bool g_bigint_count;
 extern bool g_fast_strcmp;
 extern bool g_inner_join_fragment_skipping;
+extern bool g_enable_spatial_join_index;
+extern bool g_enable_inline_datetime;
+extern size_t g_group_by_spill_entries;
+extern size_t g_max_concurrent_steps;
 
 class ExecutionResult;
 
@@ -407,12 +414,29 @@ class Executor {
 
   void registerActiveModule(void* module, const int device_id) const;
   void unregisterActiveModule(void* module, const int device_id) const;
+  // Interrupts the query running on this executor, whichever it is.
   void interrupt();
-  void resetInterrupt();
+  // Interrupts the query owning the token, if it's the one running on this executor.
+  void interrupt(const QueryCancellationToken* query_token);
+  // Starts a new query, which can be interrupted through the given token. A new token is
+  // created if it's null.
+  void resetInterrupt(const std::shared_ptr<QueryCancellationToken>& query_token = nullptr);
+  const QueryCancellationToken* getQueryToken() const { return query_token_.get(); }
+  bool isInterrupted() const;
+
+  // Independent steps and subqueries of the query running on this executor run on helper
+  // executors, on other threads. A helper shares the query's memory owner, meta info caches
+  // and cancellation token and keeps its own code cache across queries.
+  Executor* acquireStepExecutor();
+  void releaseStepExecutor(Executor* step_executor);
+  // Drops what the helpers keep for the results of the query which just finished.
+  void resetStepExecutors();
+  bool isStepExecutor() const { return is_step_executor_; }
 
   static const size_t high_scan_limit{10000000};
 
  private:
+  void interruptUnlocked();
   void clearMetaInfoCache();
 
   template <class T>
@@ -465,6 +489,8 @@ class Executor {
   llvm::Value* codegen(const Analyzer::DateaddExpr*, const CompilationOptions&);
   llvm::Value* codegen(const Analyzer::DatediffExpr*, const CompilationOptions&);
   llvm::Value* codegen(const Analyzer::DatetruncExpr*, const CompilationOptions&);
+  llvm::Value* codegenInlineExtract(const ExtractField, llvm::Value* ts_lv, llvm::Value* null_lv);
+  llvm::Value* codegenInlineDateTrunc(const DatetruncField, llvm::Value* ts_lv, llvm::Value* null_lv);
   llvm::Value* codegen(const Analyzer::CharLengthExpr*, const CompilationOptions&);
   llvm::Value* codegen(const Analyzer::LikeExpr*, const CompilationOptions&);
   llvm::Value* codegenDictLike(const std::shared_ptr<Analyzer::Expr> arg,
@@ -480,7 +506,11 @@ class Executor {
                                  const CompilationOptions&);
   llvm::Value* codegen(const Analyzer::InValues*, const CompilationOptions&);
   llvm::Value* codegen(const Analyzer::InIntegerSet* expr, const CompilationOptions& co);
-  std::unique_ptr<InValuesBitmap> createInValuesBitmap(const Analyzer::InValues*, const CompilationOptions&);
+  // Sets in_values_hash_set instead of returning a bitmap if the values are too sparse.
+  std::unique_ptr<InValuesBitmap> createInValuesBitmap(const Analyzer::InValues*,
+                                                       const CompilationOptions&,
+                                                       std::unique_ptr<InValuesHashSet>& in_values_hash_set);
+  std::unique_ptr<InValuesHashSet> createInValuesHashSet(const Analyzer::InValues*, const CompilationOptions&);
   llvm::Value* codegenCmp(const Analyzer::BinOper*, const CompilationOptions&);
   llvm::Value* codegenCmpDecimalConst(const SQLOps,
                                       const SQLQualifier,
@@ -652,6 +682,7 @@ class Executor {
     std::vector<std::shared_ptr<Analyzer::BinOper>> equi_join_tautologies_;  // expressions we equi-join on are true by
                                                                              // definition when using a hash join; we'll
                                                                              // fold them to true during code generation
+                                                                             // (null for spatial joins)
     std::vector<std::shared_ptr<JoinHashTableInterface>> join_hash_tables_;
     std::string hash_join_fail_reason_;
     std::unordered_set<size_t> sharded_range_table_indices_;
@@ -687,7 +718,6 @@ class Executor {
     int32_t* error_code_;
     RenderInfo* render_info_;
     std::vector<std::pair<ResultPtr, std::vector<size_t>>> all_fragment_results_;
-    std::atomic_flag dynamic_watchdog_set_ = ATOMIC_FLAG_INIT;
     static std::mutex reduce_mutex_;
 
     typedef std::vector<int> CacheKey;
@@ -809,7 +839,8 @@ class Executor {
         std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
         ColumnCacheMap& column_cache);
 
-    static std::pair<const int8_t*, size_t> getAllColumnFragments(
+    // Fragments of the column at the CPU level, in place; row ids continue across fragments.
+    static std::vector<JoinColumn> getAllColumnFragments(
         Executor* executor,
         const Analyzer::ColumnVar& hash_col,
         const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
@@ -1083,6 +1114,9 @@ class Executor {
                                                   const MemoryLevel memory_level,
                                                   const std::unordered_set<int>& visited_tables,
                                                   ColumnCacheMap& column_cache);
+  JoinHashTableOrError buildSpatialHashTableForQualifier(const std::shared_ptr<Analyzer::Expr>& qual,
+                                                         const std::vector<InputTableInfo>& query_infos,
+                                                         const MemoryLevel memory_level);
   void nukeOldState(const bool allow_lazy_fetch,
                     const JoinInfo& join_info,
                     const std::vector<InputTableInfo>& query_infos,
@@ -1130,6 +1164,9 @@ class Executor {
   void allocateLocalColumnIds(const std::list<std::shared_ptr<const InputColDescriptor>>& global_col_ids);
   int getLocalColumnId(const Analyzer::ColumnVar* col_var, const bool fetch_column) const;
 
+  std::unordered_set<int> getSkippedPartitions(const InputDescriptor& table_desc,
+                                               const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals);
+
   std::pair<bool, int64_t> skipFragment(const InputDescriptor& table_desc,
                                         const Fragmenter_Namespace::FragmentInfo& frag_info,
                                         const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
@@ -1348,6 +1385,11 @@ class Executor {
       in_values_bitmaps_.emplace_back(std::move(in_values_bitmap));
       return in_values_bitmaps_.back().get();
     }
+
+    const InValuesHashSet* addInValuesHashSet(std::unique_ptr<InValuesHashSet>& in_values_hash_set) {
+      in_values_hash_sets_.emplace_back(std::move(in_values_hash_set));
+      return in_values_hash_sets_.back().get();
+    }
     // look up a runtime function based on the name, return type and type of
     // the arguments and call it; x64 only, don't call from GPU codegen
     llvm::Value* emitExternalCall(const std::string& fname,
@@ -1393,6 +1435,7 @@ class Executor {
     std::vector<llvm::BasicBlock*> match_scan_labels_;
     std::unordered_map<int, llvm::Value*> scan_idx_to_hash_pos_;
     std::vector<std::unique_ptr<const InValuesBitmap>> in_values_bitmaps_;
+    std::vector<std::unique_ptr<const InValuesHashSet>> in_values_hash_sets_;
     const std::vector<InputTableInfo>& query_infos_;
     bool needs_error_check_;
 
@@ -1505,12 +1548,16 @@ class Executor {
   bool is_nested_;
 
   static const int max_gpu_count{16};
-  std::mutex gpu_exec_mutex_[max_gpu_count];
+  // shared by all executors, a step executor would otherwise launch on a device its parent is using
+  static std::mutex gpu_exec_mutex_[max_gpu_count];
+  // the LLVM context is global, work units of concurrent steps compile one at a time
+  static std::mutex compilation_mutex_;
 
   mutable std::mutex gpu_active_modules_mutex_;
   mutable uint32_t gpu_active_modules_device_mask_;
   mutable void* gpu_active_modules_[max_gpu_count];
-  bool interrupted_;
+  std::shared_ptr<QueryCancellationToken> query_token_;  // of the running query, guarded by the mutex above
+  StepProfile* step_profile_;  // of the running work unit, null unless the query is profiled
 
   mutable std::shared_ptr<StringDictionaryProxy> lit_str_dict_proxy_;
   mutable std::mutex str_dict_mutex_;
@@ -1539,6 +1586,11 @@ class Executor {
   StringDictionaryGenerations string_dictionary_generations_;
   TableGenerations table_generations_;
 
+  bool is_step_executor_;
+  std::vector<std::unique_ptr<Executor>> step_executors_;
+  std::vector<Executor*> idle_step_executors_;
+  std::mutex step_executors_mutex_;
+
   static std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>, std::shared_ptr<Executor>> executors_;
   static std::mutex execute_mutex_;
   static mapd_shared_mutex executors_cache_mutex_;
@@ -1563,11 +1615,13 @@ class Executor {
   friend class ResultSet;
   friend class IteratorTable;
   friend class InValuesBitmap;
+  friend class InValuesHashSet;
   friend class JoinHashTable;
   friend class LeafAggregator;
   friend class QueryRewriter;
   friend class PendingExecutionClosure;
   friend class RelAlgExecutor;
+  friend class SpatialJoinHashTable;
 };
 
 inline std::string get_null_check_suffix(const SQLTypeInfo& lhs_ti, const SQLTypeInfo& rhs_ti) {
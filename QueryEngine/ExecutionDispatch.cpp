@@ -19,8 +19,9 @@
 #include "ExecutionException.h"
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/DataMgr.h"
 
-#include <numeric>
+#include <thread>
 
 std::mutex Executor::ExecutionDispatch::reduce_mutex_;
 
@@ -206,6 +207,18 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
   if (chosen_device_type == ExecutorDeviceType::GPU) {
     gpu_lock.reset(new std::lock_guard<std::mutex>(executor_->gpu_exec_mutex_[chosen_device_id]));
   }
+  auto step_profile = executor_->step_profile_;
+  std::unique_ptr<KernelProfile> kernel_profile;
+  if (step_profile) {
+    kernel_profile.reset(new KernelProfile{chosen_device_type == ExecutorDeviceType::GPU,
+                                           chosen_device_id,
+                                           outer_tab_frag_ids,
+                                           std::hash<std::thread::id>()(std::this_thread::get_id()),
+                                           0,
+                                           0,
+                                           0,
+                                           nullptr});
+  }
   FetchResult fetch_result;
   try {
     std::map<int, const TableFragments*> all_tables_fragments;
@@ -227,24 +240,37 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
       all_tables_fragments.insert(std::make_pair(table_id, &fragments));
     }
     OOM_TRACE_PUSH();
-    fetch_result = executor_->fetchChunks(*this,
-                                          ra_exe_unit_,
-                                          chosen_device_id,
-                                          memory_level,
-                                          all_tables_fragments,
-                                          frag_ids,
-                                          cat_,
-                                          *chunk_iterators_ptr,
-                                          chunks);
+    const auto fetch_clock_begin = timer_start();
+    Data_Namespace::ChunkFetchStats fetch_stats;
+    {
+      Data_Namespace::ChunkFetchStats::Scope fetch_stats_scope(kernel_profile ? &fetch_stats : nullptr);
+      fetch_result = executor_->fetchChunks(*this,
+                                            ra_exe_unit_,
+                                            chosen_device_id,
+                                            memory_level,
+                                            all_tables_fragments,
+                                            frag_ids,
+                                            cat_,
+                                            *chunk_iterators_ptr,
+                                            chunks);
+    }
+    if (kernel_profile) {
+      kernel_profile->fetch_us =
+          timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(fetch_clock_begin);
+      for (int level = Data_Namespace::DISK_LEVEL; level <= Data_Namespace::GPU_LEVEL; ++level) {
+        if (!fetch_stats.chunks[level]) {
+          continue;
+        }
+        kernel_profile->fetch_bytes += fetch_stats.bytes[level];
+        step_profile->addChunkFetch(static_cast<Data_Namespace::MemoryLevel>(level),
+                                    fetch_stats.chunks[level],
+                                    fetch_stats.bytes[level],
+                                    fetch_stats.us[level]);
+      }
+    }
     if (fetch_result.num_rows.empty()) {
       return;
     }
-    if (options.with_dynamic_watchdog && !dynamic_watchdog_set_.test_and_set(std::memory_order_acquire)) {
-      CHECK_GT(options.dynamic_watchdog_time_limit, 0);
-      auto cycle_budget = dynamic_watchdog_init(options.dynamic_watchdog_time_limit);
-      LOG(INFO) << "Dynamic Watchdog budget: CPU: " << std::to_string(options.dynamic_watchdog_time_limit) << "ms, "
-                << std::to_string(cycle_budget) << " cycles";
-    }
   } catch (const OutOfMemory&) {
     std::lock_guard<std::mutex> lock(reduce_mutex_);
     *error_code_ = ERR_OUT_OF_GPU_MEM;
@@ -319,6 +345,7 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
   }
 
   ResultPtr device_results;
+  const auto kernel_clock_begin = timer_start();
   if (ra_exe_unit_.groupby_exprs.empty()) {
     OOM_TRACE_PUSH();
     err = executor_->executePlanWithoutGroupBy(ra_exe_unit_,
@@ -358,6 +385,11 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
                                             ra_exe_unit_.input_descs.size(),
                                             do_render ? render_info_ : nullptr);
   }
+  if (kernel_profile) {
+    kernel_profile->kernel_us =
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(kernel_clock_begin);
+    step_profile->addKernel(std::move(kernel_profile));
+  }
   if (auto rows_pp = boost::get<RowSetPtr>(&device_results)) {
     if (auto& rows_ptr = *rows_pp) {
       std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
@@ -515,6 +547,8 @@ void Executor::ExecutionDispatch::run(const ExecutorDeviceType chosen_device_typ
                                       const std::vector<std::pair<int, std::vector<size_t>>>& frag_ids,
                                       const size_t ctx_idx,
                                       const int64_t rowid_lookup_key) noexcept {
+  // kernels run on their own threads, the generated code polls the token through dynamic_watchdog()
+  QueryCancellationToken::ThreadScope query_token_scope(executor_->getQueryToken());
   try {
     runImpl(chosen_device_type, chosen_device_id, options, frag_ids, ctx_idx, rowid_lookup_key);
   } catch (const std::bad_alloc& e) {
@@ -927,16 +961,15 @@ std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getColumnFragment(
   return {col_buff, fragment.getNumTuples()};
 }
 
-std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getAllColumnFragments(
+std::vector<JoinColumn> Executor::ExecutionDispatch::getAllColumnFragments(
     Executor* executor,
     const Analyzer::ColumnVar& hash_col,
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
     std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
     ColumnCacheMap& column_cache) {
   CHECK(!fragments.empty());
-  const size_t elem_width = hash_col.get_type_info().get_size();
-  std::vector<const int8_t*> col_frags;
-  std::vector<size_t> elem_counts;
+  std::vector<JoinColumn> join_column_frags;
+  size_t row_id_offset = 0;
   for (auto& frag : fragments) {
     const int8_t* col_frag = nullptr;
     size_t elem_count = 0;
@@ -946,17 +979,9 @@ std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getAllColumnFragme
       continue;
     }
     CHECK_NE(elem_count, size_t(0));
-    col_frags.push_back(col_frag);
-    elem_counts.push_back(elem_count);
-  }
-  CHECK(!col_frags.empty());
-  CHECK_EQ(col_frags.size(), elem_counts.size());
-  const auto total_elem_count = std::accumulate(elem_counts.begin(), elem_counts.end(), size_t(0));
-  OOM_TRACE_PUSH(+": col_buff " + std::to_string(total_elem_count * elem_width));
-  auto col_buff = reinterpret_cast<int8_t*>(checked_malloc(total_elem_count * elem_width));
-  for (size_t i = 0, offset = 0; i < col_frags.size(); ++i) {
-    memcpy(col_buff + offset, col_frags[i], elem_counts[i] * elem_width);
-    offset += elem_counts[i] * elem_width;
-  }
-  return {col_buff, total_elem_count};
+    join_column_frags.push_back(JoinColumn{col_frag, elem_count, row_id_offset});
+    row_id_offset += elem_count;
+  }
+  CHECK(!join_column_frags.empty());
+  return join_column_frags;
 }
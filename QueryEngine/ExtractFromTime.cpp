@@ -48,7 +48,11 @@ DEVICE int extract_minute(const time_t* tim_p) {
 
 DEVICE int extract_second(const time_t* tim_p) {
   const time_t lcltime = *tim_p;
-  return (int)((long)lcltime % SECSPERMIN);
+  long rem = ((long)lcltime) % SECSPERMIN;
+  if (rem < 0) {
+    rem += SECSPERMIN;
+  }
+  return (int)rem;
 }
 
 DEVICE int extract_dow(const time_t* tim_p) {
@@ -71,7 +75,14 @@ DEVICE int extract_quarterday(const time_t* tim_p) {
   long quarterdays;
   const time_t lcltime = *tim_p;
   quarterdays = ((long)lcltime) / SECSPERQUARTERDAY;
-  return (int)(quarterdays % 4) + 1;
+  if (((long)lcltime) % SECSPERQUARTERDAY < 0) {
+    --quarterdays;
+  }
+  long rem = quarterdays % 4;
+  if (rem < 0) {
+    rem += 4;
+  }
+  return (int)rem + 1;
 }
 
 DEVICE int extract_month_fast(const time_t* tim_p) {
@@ -42,8 +42,34 @@ void Executor::unregisterActiveModule(void* module, const int device_id) const {
 }
 
 void Executor::interrupt() {
+  {
+    std::lock_guard<std::mutex> lock(gpu_active_modules_mutex_);
+    interruptUnlocked();
+  }
+  std::lock_guard<std::mutex> lock(step_executors_mutex_);
+  for (auto& step_executor : step_executors_) {
+    step_executor->interrupt();
+  }
+}
+
+void Executor::interrupt(const QueryCancellationToken* query_token) {
+  {
+    std::lock_guard<std::mutex> lock(gpu_active_modules_mutex_);
+    if (query_token_.get() != query_token) {
+      // the query isn't running here (yet), the cancelled token is enough to stop it
+      return;
+    }
+    interruptUnlocked();
+  }
+  // steps of the query running on the helpers have the same token
+  std::lock_guard<std::mutex> lock(step_executors_mutex_);
+  for (auto& step_executor : step_executors_) {
+    step_executor->interrupt(query_token);
+  }
+}
+
+void Executor::interruptUnlocked() {
 #ifdef HAVE_CUDA
-  std::lock_guard<std::mutex> lock(gpu_active_modules_mutex_);
   VLOG(1) << "Executor " << this << ": Interrupting Active Modules: mask 0x" << std::hex
           << gpu_active_modules_device_mask_;
   CUcontext old_cu_context;
@@ -92,22 +118,15 @@ void Executor::interrupt() {
   checkCudaErrors(cuCtxSetCurrent(old_cu_context));
 #endif
 
-  dynamic_watchdog_init(static_cast<unsigned>(DW_ABORT));
-
-  interrupted_ = true;
+  query_token_->cancel();
   VLOG(1) << "INTERRUPT Executor " << this;
 }
 
-void Executor::resetInterrupt() {
-#ifdef HAVE_CUDA
+void Executor::resetInterrupt(const std::shared_ptr<QueryCancellationToken>& query_token) {
   std::lock_guard<std::mutex> lock(gpu_active_modules_mutex_);
-#endif
-
-  if (!interrupted_)
-    return;
-
-  dynamic_watchdog_init(static_cast<unsigned>(DW_RESET));
+  query_token_ = query_token ? query_token : std::make_shared<QueryCancellationToken>();
+}
 
-  interrupted_ = false;
-  VLOG(1) << "RESET Executor " << this << " that had previously been interrupted";
+bool Executor::isInterrupted() const {
+  return query_token_->isCancelled();
 }
@@ -29,6 +29,7 @@
 
 #include "../CudaMgr/CudaMgr.h"
 #include "../Shared/checked_alloc.h"
+#include "../Shared/thread_count.h"
 #include "../Utils/ChunkIter.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
 #include "Execute.h"
@@ -49,6 +50,7 @@
 
 bool g_cluster{false};
 bool g_use_result_set{true};
+bool g_enable_partitioned_reduction{true};
 bool g_bigint_count{false};
 int g_hll_precision_bits{11};
 extern size_t g_leaf_count;
@@ -333,7 +335,12 @@ void QueryExecutionContext::initColumnPerRow(const QueryMemoryDescriptor& query_
        col_ptr += query_mem_desc.getNextColOffInBytes(col_ptr, bin, col_idx++)) {
     const ssize_t bm_sz{bitmap_sizes[col_idx]};
     int64_t init_val{0};
-    if (!bm_sz || query_mem_desc.group_col_widths.empty()) {
+    if (!query_mem_desc.group_col_widths.empty() && col_idx < t_digest_fractions_.size() &&
+        !std::isnan(t_digest_fractions_[col_idx])) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.agg_col_widths[col_idx].compact), sizeof(int64_t));
+      init_val = allocateTDigest(t_digest_fractions_[col_idx]);
+      ++init_vec_idx;
+    } else if (!bm_sz || query_mem_desc.group_col_widths.empty()) {
       if (query_mem_desc.agg_col_widths[col_idx].compact > 0) {
         init_val = init_vals[init_vec_idx++];
       }
@@ -451,6 +458,9 @@ void QueryExecutionContext::initColumnarGroups(int64_t* groups_buffer,
 std::vector<ssize_t> QueryExecutionContext::allocateCountDistinctBuffers(const bool deferred) {
   const size_t agg_col_count{query_mem_desc_.agg_col_widths.size()};
   std::vector<ssize_t> agg_bitmap_size(deferred ? agg_col_count : 0);
+  if (deferred) {
+    t_digest_fractions_.assign(agg_col_count, std::numeric_limits<double>::quiet_NaN());
+  }
 
   CHECK_GE(agg_col_count, executor_->plan_state_->target_exprs_.size());
   for (size_t target_idx = 0, agg_col_idx = 0;
@@ -480,6 +490,17 @@ std::vector<ssize_t> QueryExecutionContext::allocateCountDistinctBuffers(const b
         }
       }
     }
+    if (agg_info.is_agg && agg_info.agg_kind == kAPPROX_PERCENTILE) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc_.agg_col_widths[agg_col_idx].actual), sizeof(int64_t));
+      const auto agg_expr = static_cast<const Analyzer::AggExpr*>(target_expr);
+      const auto fraction = std::dynamic_pointer_cast<const Analyzer::Constant>(agg_expr->get_arg1());
+      CHECK(fraction);
+      if (deferred) {
+        t_digest_fractions_[agg_col_idx] = fraction->get_constval().doubleval;
+      } else {
+        init_agg_vals_[agg_col_idx] = allocateTDigest(fraction->get_constval().doubleval);
+      }
+    }
     if (agg_info.agg_kind == kAVG) {
       ++agg_col_idx;
     }
@@ -508,6 +529,12 @@ int64_t QueryExecutionContext::allocateCountDistinctSet() {
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
 
+int64_t QueryExecutionContext::allocateTDigest(const double fraction) {
+  auto t_digest = new TDigest(fraction);
+  row_set_mem_owner_->addTDigest(t_digest);
+  return reinterpret_cast<int64_t>(t_digest);
+}
+
 RowSetPtr QueryExecutionContext::getRowSet(const RelAlgExecutionUnit& ra_exe_unit,
                                            const QueryMemoryDescriptor& query_mem_desc,
                                            const bool was_auto_device) const {
@@ -556,10 +583,12 @@ void QueryExecutionContext::initializeDynamicWatchdog(void* native_module, const
 
   CUdeviceptr dw_cycle_budget;
   size_t dw_cycle_budget_size;
-  // Translate milliseconds to device cycles
-  uint64_t cycle_budget = executor_->deviceCycles(g_dynamic_watchdog_time_limit);
+  // Translate the time left until the deadline of the query to device cycles
+  const auto query_token = executor_->getQueryToken();
+  const auto ms_budget = query_token->hasDeadline() ? query_token->getRemainingMs() : g_dynamic_watchdog_time_limit;
+  uint64_t cycle_budget = executor_->deviceCycles(ms_budget);
   if (device_id == 0) {
-    LOG(INFO) << "Dynamic Watchdog budget: GPU: " << std::to_string(g_dynamic_watchdog_time_limit) << "ms, "
+    LOG(INFO) << "Dynamic Watchdog budget: GPU: " << std::to_string(ms_budget) << "ms, "
               << std::to_string(cycle_budget) << " cycles";
   }
   checkCudaErrors(cuModuleGetGlobal(&dw_cycle_budget, &dw_cycle_budget_size, cu_module, "dw_cycle_budget"));
@@ -572,7 +601,7 @@ void QueryExecutionContext::initializeDynamicWatchdog(void* native_module, const
   CHECK_EQ(dw_sm_cycle_start_size, 64 * sizeof(uint64_t));
   checkCudaErrors(cuMemsetD32(dw_sm_cycle_start, 0, 64 * 2));
 
-  if (!executor_->interrupted_) {
+  if (!executor_->isInterrupted()) {
     // Executor is not marked as interrupted, make sure dynamic watchdog doesn't block execution
     CUdeviceptr dw_abort;
     size_t dw_abort_size;
@@ -895,11 +924,14 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
   cuEventCreate(&start2, 0);
   cuEventCreate(&stop2, 0);
 
-  if (g_enable_dynamic_watchdog) {
+  // the kernels of a query with a deadline have been generated with the watchdog checks
+  const bool with_dynamic_watchdog = executor_->getQueryToken()->hasDeadline();
+
+  if (with_dynamic_watchdog) {
     cuEventRecord(start0, 0);
   }
 
-  if (g_enable_dynamic_watchdog) {
+  if (with_dynamic_watchdog) {
     initializeDynamicWatchdog(cu_functions[device_id].second, device_id);
   }
 
@@ -948,7 +980,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
       param_ptrs.push_back(&param);
     }
 
-    if (g_enable_dynamic_watchdog) {
+    if (with_dynamic_watchdog) {
       cuEventRecord(stop0, 0);
       cuEventSynchronize(stop0);
       float milliseconds0 = 0;
@@ -986,7 +1018,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
                                      &param_ptrs[0],
                                      nullptr));
     }
-    if (g_enable_dynamic_watchdog) {
+    if (with_dynamic_watchdog) {
       executor_->registerActiveModule(cu_functions[device_id].second, device_id);
       cuEventRecord(stop1, 0);
       cuEventSynchronize(stop1);
@@ -1060,7 +1092,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
       param_ptrs.push_back(&param);
     }
 
-    if (g_enable_dynamic_watchdog) {
+    if (with_dynamic_watchdog) {
       cuEventRecord(stop0, 0);
       cuEventSynchronize(stop0);
       float milliseconds0 = 0;
@@ -1097,7 +1129,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
                                      nullptr));
     }
 
-    if (g_enable_dynamic_watchdog) {
+    if (with_dynamic_watchdog) {
       executor_->registerActiveModule(cu_functions[device_id].second, device_id);
       cuEventRecord(stop1, 0);
       cuEventSynchronize(stop1);
@@ -1137,7 +1169,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(const RelAlgExecution
                   device_id);
   }
 
-  if (g_enable_dynamic_watchdog) {
+  if (with_dynamic_watchdog) {
     cuEventRecord(stop2, 0);
     cuEventSynchronize(stop2);
     float milliseconds2 = 0;
@@ -2450,7 +2482,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
           CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -2758,6 +2790,22 @@ bool QueryMemoryDescriptor::sortOnGpu() const {
   return sort_on_gpu_;
 }
 
+// The number of partitions a baseline hash table is split in when reduced on the CPU,
+// sized so that the slots a reduction thread writes to fit in its L2 cache. 1 if the
+// whole table fits already or the layout isn't a row-wise baseline hash table.
+size_t QueryMemoryDescriptor::getReductionPartitionCount() const {
+  if (!g_enable_partitioned_reduction || hash_type != GroupByColRangeType::MultiCol || output_columnar) {
+    return 1;
+  }
+  static const size_t max_partition_count{4096};
+  const auto buffer_bytes = getBufferSizeBytes(ExecutorDeviceType::CPU);
+  const auto l2_cache_bytes = cpu_l2_cache_bytes();
+  if (buffer_bytes <= l2_cache_bytes) {
+    return 1;
+  }
+  return std::min(std::min((buffer_bytes + l2_cache_bytes - 1) / l2_cache_bytes, max_partition_count), entry_count);
+}
+
 GroupByAndAggregate::DiamondCodegen::DiamondCodegen(llvm::Value* cond,
                                                     Executor* executor,
                                                     const bool chain_to_next,
@@ -3233,6 +3281,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"agg_approximate_count_distinct"};
     case kLAST_SAMPLE:
       return {"agg_id"};
+    case kAPPROX_PERCENTILE:
+      return {"agg_approx_percentile"};
     default:
       abort();
   }
@@ -3523,6 +3573,18 @@ bool GroupByAndAggregate::codegenAggCalls(const std::tuple<llvm::Value*, llvm::V
         }
       }
 
+      if (agg_info.agg_kind == kAPPROX_PERCENTILE) {
+        CHECK_EQ(sizeof(int64_t), chosen_bytes);
+        codegenApproxPercentile(
+            executor_->castToIntPtrTyIn((is_group_by ? agg_col_ptr : agg_out_vec[agg_out_off]), 64),
+            target_lvs[target_lv_idx],
+            arg_expr->get_type_info(),
+            agg_info.skip_null_val);
+        ++agg_out_off;
+        ++target_lv_idx;
+        continue;
+      }
+
       const bool float_argument_input = takes_float_argument(agg_info);
       const bool is_count_in_avg = agg_info.agg_kind == kAVG && target_lv_idx == 1;
       // The count component of an average should never be compacted.
@@ -3697,6 +3759,30 @@ void GroupByAndAggregate::codegenCountDistinct(const size_t target_idx,
   emitCall(agg_fname, agg_args);
 }
 
+void GroupByAndAggregate::codegenApproxPercentile(llvm::Value* agg_col_ptr,
+                                                  llvm::Value* arg_lv,
+                                                  const SQLTypeInfo& arg_ti,
+                                                  const bool skip_null_val) {
+  // the digest works on doubles, whatever the type of the argument
+  auto val_lv = arg_lv;
+  if (val_lv->getType()->isIntegerTy()) {
+    val_lv = LL_BUILDER.CreateSIToFP(val_lv, llvm::Type::getDoubleTy(LL_CONTEXT));
+    if (arg_ti.is_decimal()) {
+      val_lv = LL_BUILDER.CreateFDiv(val_lv, LL_FP(static_cast<double>(exp_to_scale(arg_ti.get_scale()))));
+    }
+  } else if (val_lv->getType()->isFloatTy()) {
+    val_lv = LL_BUILDER.CreateFPExt(val_lv, llvm::Type::getDoubleTy(LL_CONTEXT));
+  }
+  CHECK(val_lv->getType()->isDoubleTy());
+  if (skip_null_val) {
+    // agg_approx_percentile ignores NaN
+    val_lv = LL_BUILDER.CreateSelect(executor_->codegenIsNullNumber(arg_lv, arg_ti),
+                                     LL_FP(std::numeric_limits<double>::quiet_NaN()),
+                                     val_lv);
+  }
+  emitCall("agg_approx_percentile", {agg_col_ptr, val_lv});
+}
+
 llvm::Value* GroupByAndAggregate::getAdditionalLiteral(const int32_t off) {
   CHECK_LT(off, 0);
   const auto lit_buff_lv = get_arg_by_name(ROW_FUNC, "literals");
@@ -251,6 +251,7 @@ class QueryExecutionContext : boost::noncopyable {
   std::vector<ssize_t> allocateCountDistinctBuffers(const bool deferred);
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
   int64_t allocateCountDistinctSet();
+  int64_t allocateTDigest(const double fraction);
 
   std::vector<ColumnLazyFetchInfo> getColLazyFetchInfo(const std::vector<Analyzer::Expr*>& target_exprs) const;
 
@@ -281,6 +282,8 @@ class QueryExecutionContext : boost::noncopyable {
   int8_t* count_distinct_bitmap_host_mem_;
   int8_t* count_distinct_bitmap_crt_ptr_;
   size_t count_distinct_bitmap_mem_bytes_;
+  // APPROX_PERCENTILE fraction per group by column, NaN for the other columns.
+  std::vector<double> t_digest_fractions_;
 
   friend class Executor;
   friend void copy_group_by_buffers_from_gpu(Data_Namespace::DataMgr* data_mgr,
@@ -417,6 +420,11 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxPercentile(llvm::Value* agg_col_ptr,
+                               llvm::Value* arg_lv,
+                               const SQLTypeInfo& arg_ti,
+                               const bool skip_null_val);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr, const CompilationOptions& co);
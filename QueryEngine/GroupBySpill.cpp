@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GroupBySpill.h"
+#include "GpuRtConstants.h"
+#include "MurmurHash.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <glog/logging.h>
+
+#include <fstream>
+
+namespace {
+
+// Not the seed of key_hash, the entries of a partition still spread over the whole hash
+// table of its reduction.
+const uint64_t partition_hash_seed{0x9e3779b97f4a7c15};
+
+bool is_empty_key(const int8_t* row_ptr, const size_t key_width) {
+  switch (key_width) {
+    case 4:
+      return *reinterpret_cast<const int32_t*>(row_ptr) == EMPTY_KEY_32;
+    case 8:
+      return *reinterpret_cast<const int64_t*>(row_ptr) == EMPTY_KEY_64;
+    default:
+      CHECK(false);
+  }
+  return false;
+}
+
+}  // namespace
+
+GroupBySpill::GroupBySpill(const boost::filesystem::path& spill_dir,
+                           const size_t partition_count,
+                           const size_t memory_budget_entries)
+    : spill_dir_(spill_dir),
+      memory_budget_entries_(memory_budget_entries),
+      partition_buffers_(partition_count),
+      spilled_entry_counts_(partition_count, 0),
+      spilled_bytes_(0) {
+  CHECK_GT(partition_count, size_t(0));
+  boost::filesystem::create_directories(spill_dir_);
+}
+
+GroupBySpill::~GroupBySpill() {
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(spill_dir_, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not remove group by spill directory " << spill_dir_ << ": " << ec.message();
+  }
+}
+
+void GroupBySpill::add(const ResultSet& partial_result) {
+  const auto storage = partial_result.getStorage();
+  if (!storage) {
+    return;
+  }
+  const auto& query_mem_desc = partial_result.getQueryMemDesc();
+  CHECK(query_mem_desc.hash_type == GroupByColRangeType::MultiCol);
+  CHECK(!query_mem_desc.output_columnar);
+  CHECK(!query_mem_desc.keyless_hash);
+  CHECK_EQ(size_t(0), query_mem_desc.entry_count_small);
+  const auto row_bytes = get_row_bytes(query_mem_desc);
+  const auto key_bytes = get_key_bytes_rowwise(query_mem_desc);
+  const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+  if (!query_mem_desc_) {
+    query_mem_desc_.reset(new QueryMemoryDescriptor(query_mem_desc));
+    targets_ = partial_result.getTargetInfos();
+  }
+  // the partial results come from the same compiled query, only their entry count differs
+  CHECK_EQ(get_row_bytes(*query_mem_desc_), row_bytes);
+  CHECK_EQ(query_mem_desc_->getEffectiveKeyWidth(), key_width);
+  const auto partition_count = partition_buffers_.size();
+  const auto partition_buffer_bytes = std::max(memory_budget_entries_ / partition_count, size_t(1)) * row_bytes;
+  const auto buff = storage->getUnderlyingBuffer();
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.entry_count; ++entry_idx) {
+    const auto row_ptr = row_ptr_rowwise(buff, query_mem_desc, entry_idx);
+    if (is_empty_key(row_ptr, key_width)) {
+      continue;
+    }
+    const auto partition_idx = MurmurHash64A(row_ptr, key_bytes, partition_hash_seed) % partition_count;
+    auto& partition_buffer = partition_buffers_[partition_idx];
+    partition_buffer.insert(partition_buffer.end(), row_ptr, row_ptr + row_bytes);
+    if (partition_buffer.size() >= partition_buffer_bytes) {
+      flush(partition_idx);
+    }
+  }
+}
+
+void GroupBySpill::flush(const size_t partition_idx) {
+  auto& partition_buffer = partition_buffers_[partition_idx];
+  if (partition_buffer.empty()) {
+    return;
+  }
+  const auto partition_path = getPartitionPath(partition_idx);
+  // reopened on every flush, there can be more partitions than file descriptors
+  std::ofstream partition_file(partition_path.string(), std::ios::binary | std::ios::app);
+  partition_file.write(reinterpret_cast<const char*>(&partition_buffer[0]), partition_buffer.size());
+  partition_file.close();
+  if (!partition_file) {
+    throw std::runtime_error("Could not write group by spill file " + partition_path.string());
+  }
+  spilled_entry_counts_[partition_idx] += partition_buffer.size() / get_row_bytes(*query_mem_desc_);
+  spilled_bytes_ += partition_buffer.size();
+  std::vector<int8_t>().swap(partition_buffer);
+}
+
+RowSetPtr GroupBySpill::reducePartition(const size_t partition_idx,
+                                        const std::vector<int64_t>& target_init_vals,
+                                        std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                                        const Executor* executor) {
+  CHECK_LT(partition_idx, partition_buffers_.size());
+  if (!query_mem_desc_) {
+    return nullptr;
+  }
+  const auto row_bytes = get_row_bytes(*query_mem_desc_);
+  const auto spilled_entry_count = spilled_entry_counts_[partition_idx];
+  std::vector<int8_t> entries(spilled_entry_count * row_bytes);
+  if (spilled_entry_count) {
+    const auto partition_path = getPartitionPath(partition_idx);
+    std::ifstream partition_file(partition_path.string(), std::ios::binary);
+    partition_file.read(reinterpret_cast<char*>(&entries[0]), entries.size());
+    if (!partition_file) {
+      throw std::runtime_error("Could not read group by spill file " + partition_path.string());
+    }
+    partition_file.close();
+    boost::filesystem::remove(partition_path);
+  }
+  auto& partition_buffer = partition_buffers_[partition_idx];
+  entries.insert(entries.end(), partition_buffer.begin(), partition_buffer.end());
+  std::vector<int8_t>().swap(partition_buffer);
+  const auto entry_count = entries.size() / row_bytes;
+  if (!entry_count) {
+    return nullptr;
+  }
+  auto spilled_query_mem_desc = *query_mem_desc_;
+  spilled_query_mem_desc.entry_count = entry_count;
+  ResultSet spilled_rows(targets_, ExecutorDeviceType::CPU, spilled_query_mem_desc, row_set_mem_owner, executor);
+  const auto spilled_storage = spilled_rows.allocateStorage(&entries[0], target_init_vals);
+  // the same group can come from several partial results, keep the fill rate at 50%
+  auto reduced_query_mem_desc = *query_mem_desc_;
+  reduced_query_mem_desc.entry_count = 2 * entry_count;
+  auto reduced_rows = std::make_shared<ResultSet>(
+      targets_, ExecutorDeviceType::CPU, reduced_query_mem_desc, row_set_mem_owner, executor);
+  const auto reduced_storage = reduced_rows->allocateStorage(target_init_vals);
+  reduced_rows->initializeStorage();
+  reduced_storage->reduce(*spilled_storage);
+  return reduced_rows;
+}
+
+boost::filesystem::path GroupBySpill::getPartitionPath(const size_t partition_idx) const {
+  return spill_dir_ / ("partition_" + std::to_string(partition_idx));
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    GroupBySpill.h
+ * @brief   Hash partitioning and spilling of partial group by results.
+ *
+ * A group by with more groups than the in-memory budget aggregates its input in batches.
+ * The entries of every partial result go to the partition their group key hashes to,
+ * each partition buffers up to its share of the budget and appends the rest to a file of
+ * its own. Partitions have disjoint groups: once the input is exhausted, each one is read
+ * back and reduced on its own.
+ */
+
+#ifndef QUERYENGINE_GROUPBYSPILL_H
+#define QUERYENGINE_GROUPBYSPILL_H
+
+#include "QueryMemoryDescriptor.h"
+#include "ResultSet.h"
+
+#include <boost/filesystem/path.hpp>
+
+#include <memory>
+#include <vector>
+
+typedef std::shared_ptr<ResultSet> RowSetPtr;
+
+class GroupBySpill {
+ public:
+  GroupBySpill(const boost::filesystem::path& spill_dir,
+               const size_t partition_count,
+               const size_t memory_budget_entries);
+  ~GroupBySpill();
+
+  // Partitions the entries of a row-wise baseline group by result.
+  void add(const ResultSet& partial_result);
+
+  // Reads back and reduces one partition, nullptr if no group hashed to it.
+  RowSetPtr reducePartition(const size_t partition_idx,
+                            const std::vector<int64_t>& target_init_vals,
+                            std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                            const Executor* executor);
+
+  size_t getPartitionCount() const { return partition_buffers_.size(); }
+
+  size_t getSpilledBytes() const { return spilled_bytes_; }
+
+ private:
+  void flush(const size_t partition_idx);
+
+  boost::filesystem::path getPartitionPath(const size_t partition_idx) const;
+
+  const boost::filesystem::path spill_dir_;
+  const size_t memory_budget_entries_;
+  std::vector<std::vector<int8_t>> partition_buffers_;
+  std::vector<size_t> spilled_entry_counts_;
+  std::vector<TargetInfo> targets_;
+  std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_;  // layout of the first partial result
+  size_t spilled_bytes_;
+};
+
+#endif  // QUERYENGINE_GROUPBYSPILL_H
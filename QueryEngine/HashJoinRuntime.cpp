@@ -102,7 +102,7 @@ DEVICE int SUFFIX(fill_hash_join_buff)(int32_t* buff,
     }
 #endif
     int32_t* entry_ptr = SUFFIX(get_hash_slot)(buff, elem, type_info.min_val);
-    if (mapd_cas(entry_ptr, invalid_slot_val, i) != invalid_slot_val) {
+    if (mapd_cas(entry_ptr, invalid_slot_val, join_column.row_id_offset + i) != invalid_slot_val) {
       return -1;
     }
   }
@@ -158,7 +158,7 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded)(int32_t* buff,
                                                        shard_info.entry_count_per_shard,
                                                        shard_info.num_shards,
                                                        shard_info.device_count);
-    if (mapd_cas(entry_ptr, invalid_slot_val, i) != invalid_slot_val) {
+    if (mapd_cas(entry_ptr, invalid_slot_val, join_column.row_id_offset + i) != invalid_slot_val) {
       return -1;
     }
   }
@@ -328,6 +328,7 @@ DEVICE int SUFFIX(fill_baseline_hash_join_buff)(int8_t* hash_buff,
   int32_t step = cpu_thread_count;
 #endif
   const auto num_elems = join_column_per_key[0].num_elems;
+  const auto row_id_offset = join_column_per_key[0].row_id_offset;
   T key_scratch_buff[g_maximum_conditions_to_coalesce];
   for (size_t i = start; i < num_elems; i += step) {
     bool skip_entry = false;
@@ -362,8 +363,13 @@ DEVICE int SUFFIX(fill_baseline_hash_join_buff)(int8_t* hash_buff,
       key_scratch_buff[key_component_index] = elem;
     }
     if (!skip_entry) {
-      int err = write_baseline_hash_slot<T>(
-          i, hash_buff, entry_count, key_scratch_buff, key_component_count, with_val_slot, invalid_slot_val);
+      int err = write_baseline_hash_slot<T>(row_id_offset + i,
+                                            hash_buff,
+                                            entry_count,
+                                            key_scratch_buff,
+                                            key_component_count,
+                                            with_val_slot,
+                                            invalid_slot_val);
       if (err) {
         return err;
       }
@@ -631,7 +637,7 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
 #endif
     const auto bin_idx = pos_ptr - pos_buff;
     const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
-    id_buff[id_buff_idx] = static_cast<int32_t>(i);
+    id_buff[id_buff_idx] = static_cast<int32_t>(join_column.row_id_offset + i);
   }
 }
 
@@ -695,7 +701,7 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
 #endif
     const auto bin_idx = pos_ptr - pos_buff;
     const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
-    id_buff[id_buff_idx] = static_cast<int32_t>(i);
+    id_buff[id_buff_idx] = static_cast<int32_t>(join_column.row_id_offset + i);
   }
 }
 
@@ -726,6 +732,7 @@ GLOBAL void SUFFIX(fill_row_ids_baseline)(int32_t* buff,
   int32_t step = cpu_thread_count;
 #endif
   const auto num_elems = join_column_per_key[0].num_elems;
+  const auto row_id_offset = join_column_per_key[0].row_id_offset;
   T key_scratch_buff[g_maximum_conditions_to_coalesce];
   for (size_t i = start; i < num_elems; i += step) {
     bool skip_entry = false;
@@ -772,7 +779,7 @@ GLOBAL void SUFFIX(fill_row_ids_baseline)(int32_t* buff,
 #endif
       const auto bin_idx = pos_ptr - pos_buff;
       const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
-      id_buff[id_buff_idx] = static_cast<int32_t>(i);
+      id_buff[id_buff_idx] = static_cast<int32_t>(row_id_offset + i);
     }
   }
   return;
@@ -895,7 +902,7 @@ void inclusive_scan(InputIterator first, InputIterator last, OutputIterator out,
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const int32_t hash_entry_count,
                                  const int32_t invalid_slot_val,
-                                 const JoinColumn& join_column,
+                                 const std::vector<JoinColumn>& join_column_frags,
                                  const JoinColumnTypeInfo& type_info,
                                  const void* sd_inner_proxy,
                                  const void* sd_outer_proxy,
@@ -906,15 +913,19 @@ void fill_one_to_many_hash_table(int32_t* buff,
   std::vector<std::future<void>> counter_threads;
   for (int cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     counter_threads.push_back(std::async(std::launch::async,
-                                         count_matches,
-                                         count_buff,
-                                         invalid_slot_val,
-                                         join_column,
-                                         type_info,
-                                         sd_inner_proxy,
-                                         sd_outer_proxy,
-                                         cpu_thread_idx,
-                                         cpu_thread_count));
+                                         [&](const int thread_idx) {
+                                           for (const auto& join_column : join_column_frags) {
+                                             count_matches(count_buff,
+                                                           invalid_slot_val,
+                                                           join_column,
+                                                           type_info,
+                                                           sd_inner_proxy,
+                                                           sd_outer_proxy,
+                                                           thread_idx,
+                                                           cpu_thread_count);
+                                           }
+                                         },
+                                         cpu_thread_idx));
   }
 
   for (auto& child : counter_threads) {
@@ -949,16 +960,21 @@ void fill_one_to_many_hash_table(int32_t* buff,
   std::vector<std::future<void>> rowid_threads;
   for (int cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     rowid_threads.push_back(std::async(std::launch::async,
-                                       SUFFIX(fill_row_ids),
-                                       buff,
-                                       hash_entry_count,
-                                       invalid_slot_val,
-                                       std::ref(join_column),
-                                       std::ref(type_info),
-                                       sd_inner_proxy,
-                                       sd_outer_proxy,
-                                       cpu_thread_idx,
-                                       cpu_thread_count));
+                                       [&](const int thread_idx) {
+                                         for (const auto& join_column : join_column_frags) {
+                                           SUFFIX(fill_row_ids)
+                                           (buff,
+                                            hash_entry_count,
+                                            invalid_slot_val,
+                                            join_column,
+                                            type_info,
+                                            sd_inner_proxy,
+                                            sd_outer_proxy,
+                                            thread_idx,
+                                            cpu_thread_count);
+                                         }
+                                       },
+                                       cpu_thread_idx));
   }
 
   for (auto& child : rowid_threads) {
@@ -1125,7 +1141,7 @@ void fill_one_to_many_baseline_hash_table(int32_t* buff,
                                           const size_t hash_entry_count,
                                           const int32_t invalid_slot_val,
                                           const size_t key_component_count,
-                                          const std::vector<JoinColumn>& join_column_per_key,
+                                          const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                           const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                           const std::vector<const void*>& sd_inner_proxy_per_key,
                                           const std::vector<const void*>& sd_outer_proxy_per_key,
@@ -1136,18 +1152,22 @@ void fill_one_to_many_baseline_hash_table(int32_t* buff,
   std::vector<std::future<void>> counter_threads;
   for (int cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     counter_threads.push_back(std::async(std::launch::async,
-                                         &count_matches_baseline<T>,
-                                         count_buff,
-                                         composite_key_dict,
-                                         hash_entry_count,
-                                         invalid_slot_val,
-                                         key_component_count,
-                                         &join_column_per_key[0],
-                                         &type_info_per_key[0],
-                                         &sd_inner_proxy_per_key[0],
-                                         &sd_outer_proxy_per_key[0],
-                                         cpu_thread_idx,
-                                         cpu_thread_count));
+                                         [&](const int thread_idx) {
+                                           for (const auto& join_column_per_key : join_columns_per_frag) {
+                                             count_matches_baseline<T>(count_buff,
+                                                                       composite_key_dict,
+                                                                       hash_entry_count,
+                                                                       invalid_slot_val,
+                                                                       key_component_count,
+                                                                       &join_column_per_key[0],
+                                                                       &type_info_per_key[0],
+                                                                       &sd_inner_proxy_per_key[0],
+                                                                       &sd_outer_proxy_per_key[0],
+                                                                       thread_idx,
+                                                                       cpu_thread_count);
+                                           }
+                                         },
+                                         cpu_thread_idx));
   }
 
   for (auto& child : counter_threads) {
@@ -1177,18 +1197,20 @@ void fill_one_to_many_baseline_hash_table(int32_t* buff,
   memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
   std::vector<std::future<void>> rowid_threads;
   for (int cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    SUFFIX(fill_row_ids_baseline)
-    (buff,
-     composite_key_dict,
-     hash_entry_count,
-     invalid_slot_val,
-     key_component_count,
-     &join_column_per_key[0],
-     &type_info_per_key[0],
-     &sd_inner_proxy_per_key[0],
-     &sd_outer_proxy_per_key[0],
-     cpu_thread_idx,
-     cpu_thread_count);
+    for (const auto& join_column_per_key : join_columns_per_frag) {
+      SUFFIX(fill_row_ids_baseline)
+      (buff,
+       composite_key_dict,
+       hash_entry_count,
+       invalid_slot_val,
+       key_component_count,
+       &join_column_per_key[0],
+       &type_info_per_key[0],
+       &sd_inner_proxy_per_key[0],
+       &sd_outer_proxy_per_key[0],
+       cpu_thread_idx,
+       cpu_thread_count);
+    }
   }
 
   for (auto& child : rowid_threads) {
@@ -1201,7 +1223,7 @@ void fill_one_to_many_baseline_hash_table_32(int32_t* buff,
                                              const size_t hash_entry_count,
                                              const int32_t invalid_slot_val,
                                              const size_t key_component_count,
-                                             const std::vector<JoinColumn>& join_column_per_key,
+                                             const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                              const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                              const std::vector<const void*>& sd_inner_proxy_per_key,
                                              const std::vector<const void*>& sd_outer_proxy_per_key,
@@ -1211,7 +1233,7 @@ void fill_one_to_many_baseline_hash_table_32(int32_t* buff,
                                                 hash_entry_count,
                                                 invalid_slot_val,
                                                 key_component_count,
-                                                join_column_per_key,
+                                                join_columns_per_frag,
                                                 type_info_per_key,
                                                 sd_inner_proxy_per_key,
                                                 sd_outer_proxy_per_key,
@@ -1223,7 +1245,7 @@ void fill_one_to_many_baseline_hash_table_64(int32_t* buff,
                                              const size_t hash_entry_count,
                                              const int32_t invalid_slot_val,
                                              const size_t key_component_count,
-                                             const std::vector<JoinColumn>& join_column_per_key,
+                                             const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                              const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                              const std::vector<const void*>& sd_inner_proxy_per_key,
                                              const std::vector<const void*>& sd_outer_proxy_per_key,
@@ -1233,7 +1255,7 @@ void fill_one_to_many_baseline_hash_table_64(int32_t* buff,
                                                 hash_entry_count,
                                                 invalid_slot_val,
                                                 key_component_count,
-                                                join_column_per_key,
+                                                join_columns_per_frag,
                                                 type_info_per_key,
                                                 sd_inner_proxy_per_key,
                                                 sd_outer_proxy_per_key,
@@ -1243,15 +1265,16 @@ void fill_one_to_many_baseline_hash_table_64(int32_t* buff,
 void approximate_distinct_tuples(uint8_t* hll_buffer_all_cpus,
                                  const uint32_t b,
                                  const size_t padded_size_bytes,
-                                 const std::vector<JoinColumn>& join_column_per_key,
+                                 const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                  const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                  const int thread_count) {
-  CHECK_EQ(join_column_per_key.size(), type_info_per_key.size());
-  CHECK(!join_column_per_key.empty());
+  CHECK(!join_columns_per_frag.empty());
+  CHECK_EQ(join_columns_per_frag.front().size(), type_info_per_key.size());
+  CHECK(!type_info_per_key.empty());
   std::vector<std::future<void>> approx_distinct_threads;
   for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
     approx_distinct_threads.push_back(std::async(std::launch::async,
-                                                 [&join_column_per_key,
+                                                 [&join_columns_per_frag,
                                                   &type_info_per_key,
                                                   b,
                                                   hll_buffer_all_cpus,
@@ -1260,13 +1283,15 @@ void approximate_distinct_tuples(uint8_t* hll_buffer_all_cpus,
                                                   thread_count] {
                                                    auto hll_buffer =
                                                        hll_buffer_all_cpus + thread_idx * padded_size_bytes;
-                                                   approximate_distinct_tuples_impl(hll_buffer,
-                                                                                    b,
-                                                                                    join_column_per_key.size(),
-                                                                                    &join_column_per_key[0],
-                                                                                    &type_info_per_key[0],
-                                                                                    thread_idx,
-                                                                                    thread_count);
+                                                   for (const auto& join_column_per_key : join_columns_per_frag) {
+                                                     approximate_distinct_tuples_impl(hll_buffer,
+                                                                                      b,
+                                                                                      join_column_per_key.size(),
+                                                                                      &join_column_per_key[0],
+                                                                                      &type_info_per_key[0],
+                                                                                      thread_idx,
+                                                                                      thread_count);
+                                                   }
                                                  }));
   }
   for (auto& child : approx_distinct_threads) {
@@ -74,11 +74,24 @@ void init_baseline_hash_join_buff_on_device_64(int8_t* hash_join_buff,
                                                const size_t block_size_x,
                                                const size_t grid_size_x);
 
+// A fixed width column, or one fragment of it. The inner column of a join over a multi-fragment
+// table is passed to the CPU builders as a list of fragments rather than copied into one buffer;
+// row_id_offset is the number of rows in the fragments before this one, so the row ids written in
+// the hash table are the same as for the concatenated column.
 struct JoinColumn {
   const int8_t* col_buff;
   size_t num_elems;
+  size_t row_id_offset;
 };
 
+inline size_t get_join_column_element_count(const std::vector<JoinColumn>& join_column_frags) {
+  size_t elem_count = 0;
+  for (const auto& join_column : join_column_frags) {
+    elem_count += join_column.num_elems;
+  }
+  return elem_count;
+}
+
 struct JoinColumnTypeInfo {
   size_t elem_sz;
   int64_t min_val;
@@ -124,7 +137,7 @@ void fill_hash_join_buff_on_device_sharded(int32_t* buff,
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const int32_t hash_entry_count,
                                  const int32_t invalid_slot_val,
-                                 const JoinColumn& join_column,
+                                 const std::vector<JoinColumn>& join_column_frags,
                                  const JoinColumnTypeInfo& type_info,
                                  const void* sd_inner_proxy,
                                  const void* sd_outer_proxy,
@@ -208,7 +221,7 @@ void fill_one_to_many_baseline_hash_table_32(int32_t* buff,
                                              const size_t hash_entry_count,
                                              const int32_t invalid_slot_val,
                                              const size_t key_component_count,
-                                             const std::vector<JoinColumn>& join_column_per_key,
+                                             const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                              const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                              const std::vector<const void*>& sd_inner_proxy_per_key,
                                              const std::vector<const void*>& sd_outer_proxy_per_key,
@@ -219,7 +232,7 @@ void fill_one_to_many_baseline_hash_table_64(int32_t* buff,
                                              const size_t hash_entry_count,
                                              const int32_t invalid_slot_val,
                                              const size_t key_component_count,
-                                             const std::vector<JoinColumn>& join_column_per_key,
+                                             const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                              const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                              const std::vector<const void*>& sd_inner_proxy_per_key,
                                              const std::vector<const void*>& sd_outer_proxy_per_key,
@@ -248,7 +261,7 @@ void fill_one_to_many_baseline_hash_table_on_device_64(int32_t* buff,
 void approximate_distinct_tuples(uint8_t* hll_buffer_all_cpus,
                                  const uint32_t b,
                                  const size_t padded_size_bytes,
-                                 const std::vector<JoinColumn>& join_column_per_key,
+                                 const std::vector<std::vector<JoinColumn>>& join_columns_per_frag,
                                  const std::vector<JoinColumnTypeInfo>& type_info_per_key,
                                  const int thread_count);
 
@@ -489,6 +489,24 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
       }
     }
   }
+  if (!current_level_hash_table && current_level_join_conditions.type == JoinType::INNER &&
+      g_enable_spatial_join_index) {
+    // The spatial index only narrows down the candidate rows, the qualifier has been added to
+    // the execution unit above and is still evaluated for each of them.
+    for (const auto& join_qual : current_level_join_conditions.quals) {
+      const auto hash_table_or_error = buildSpatialHashTableForQualifier(
+          join_qual,
+          query_infos,
+          co.device_type_ == ExecutorDeviceType::GPU ? MemoryLevel::GPU_LEVEL : MemoryLevel::CPU_LEVEL);
+      if (hash_table_or_error.hash_table) {
+        current_level_hash_table = hash_table_or_error.hash_table;
+        plan_state_->join_info_.join_hash_tables_.push_back(current_level_hash_table);
+        plan_state_->join_info_.equi_join_tautologies_.push_back(nullptr);
+        break;
+      }
+      fail_reasons.push_back(hash_table_or_error.fail_reason);
+    }
+  }
   return current_level_hash_table;
 }
 
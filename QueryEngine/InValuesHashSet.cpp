@@ -0,0 +1,311 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InValuesHashSet.h"
+#include "Execute.h"
+#ifdef HAVE_CUDA
+#include "GpuMemUtils.h"
+#endif  // HAVE_CUDA
+#include "MurmurHash.h"
+#include "RuntimeFunctions.h"
+#include "../Parser/ParserNode.h"
+#include "../Shared/checked_alloc.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// At most half of the slots are used, rounded up to a power of two number of groups.
+size_t get_group_count(const size_t value_count) {
+  const size_t min_slot_count = std::max(2 * value_count, size_t(IN_VALUES_HASH_SET_GROUP_SIZE));
+  size_t group_count = 1;
+  while (group_count * IN_VALUES_HASH_SET_GROUP_SIZE < min_slot_count) {
+    group_count <<= 1;
+  }
+  return group_count;
+}
+
+int64_t double_bits(const double val) {
+  // the set holds bit patterns, 0.0 and -0.0 must map to the same one
+  const double canonical_val = val == 0. ? 0. : val;
+  int64_t bits;
+  memcpy(&bits, &canonical_val, sizeof(bits));
+  return bits;
+}
+
+std::vector<int64_t> to_bits(const std::vector<double>& values, const double null_val, bool& rhs_has_null) {
+  std::vector<int64_t> bits;
+  bits.reserve(values.size());
+  for (const auto value : values) {
+    if (value == null_val) {
+      rhs_has_null = true;
+      continue;
+    }
+    bits.push_back(double_bits(value));
+  }
+  return bits;
+}
+
+}  // namespace
+
+InValuesHashSet::InValuesHashSet(const std::vector<int64_t>& values,
+                                 const int64_t null_val,
+                                 const Data_Namespace::MemoryLevel memory_level,
+                                 const int device_count,
+                                 Data_Namespace::DataMgr* data_mgr)
+    : key_type_(KeyType::Integer),
+      rhs_has_null_(false),
+      group_mask_(0),
+      null_val_(null_val),
+      memory_level_(memory_level),
+      device_count_(device_count) {
+#ifdef HAVE_CUDA
+  CHECK(memory_level_ == Data_Namespace::CPU_LEVEL || memory_level == Data_Namespace::GPU_LEVEL);
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif  // HAVE_CUDA
+  std::vector<int64_t> non_null_values;
+  non_null_values.reserve(values.size());
+  for (const auto value : values) {
+    if (value == null_val_) {
+      rhs_has_null_ = true;
+      continue;
+    }
+    non_null_values.push_back(value);
+  }
+  buildIntegerSet(non_null_values, data_mgr);
+}
+
+InValuesHashSet::InValuesHashSet(const std::vector<double>& values,
+                                 const double null_val,
+                                 const Data_Namespace::MemoryLevel memory_level,
+                                 const int device_count,
+                                 Data_Namespace::DataMgr* data_mgr)
+    : key_type_(KeyType::Double),
+      rhs_has_null_(false),
+      group_mask_(0),
+      null_val_(double_bits(null_val)),
+      memory_level_(memory_level),
+      device_count_(device_count) {
+#ifdef HAVE_CUDA
+  CHECK(memory_level_ == Data_Namespace::CPU_LEVEL || memory_level == Data_Namespace::GPU_LEVEL);
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif  // HAVE_CUDA
+  buildIntegerSet(to_bits(values, null_val, rhs_has_null_), data_mgr);
+}
+
+InValuesHashSet::InValuesHashSet(const std::vector<std::string>& values,
+                                 const bool rhs_has_null,
+                                 const Data_Namespace::MemoryLevel memory_level,
+                                 const int device_count,
+                                 Data_Namespace::DataMgr* data_mgr)
+    : key_type_(KeyType::String),
+      rhs_has_null_(rhs_has_null),
+      group_mask_(0),
+      null_val_(0),
+      memory_level_(memory_level),
+      device_count_(device_count) {
+#ifdef HAVE_CUDA
+  CHECK(memory_level_ == Data_Namespace::CPU_LEVEL || memory_level == Data_Namespace::GPU_LEVEL);
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif  // HAVE_CUDA
+  if (values.empty()) {
+    return;
+  }
+  const auto group_count = get_group_count(values.size());
+  const auto slot_count = group_count * IN_VALUES_HASH_SET_GROUP_SIZE;
+  group_mask_ = group_count - 1;
+  std::vector<int64_t> slots(slot_count, -1);
+  std::string payload;
+  for (const auto& value : values) {
+    CHECK_LE(value.size(), static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+    bool inserted{false};
+    for (size_t group = MurmurHash1(value.data(), value.size(), 0) & group_mask_; !inserted;
+         group = (group + 1) & group_mask_) {
+      for (size_t i = group * IN_VALUES_HASH_SET_GROUP_SIZE; i < (group + 1) * IN_VALUES_HASH_SET_GROUP_SIZE; ++i) {
+        if (slots[i] == -1) {
+          CHECK_LE(payload.size(), static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+          slots[i] = (static_cast<int64_t>(payload.size()) << 32) | static_cast<int64_t>(value.size());
+          payload += value;
+          inserted = true;
+          break;
+        }
+        const auto offset = slots[i] >> 32;
+        const auto len = static_cast<size_t>(slots[i] & 0xffffffff);
+        if (len == value.size() && !payload.compare(offset, len, value)) {
+          inserted = true;
+          break;
+        }
+      }
+    }
+  }
+  // the strings follow the slots in the same buffer, a single handle covers both
+  std::vector<int64_t> buffer(slot_count + (payload.size() + sizeof(int64_t) - 1) / sizeof(int64_t), 0);
+  std::copy(slots.begin(), slots.end(), buffer.begin());
+  memcpy(&buffer[slot_count], payload.data(), payload.size());
+  copyToDevices(buffer, data_mgr);
+}
+
+InValuesHashSet::~InValuesHashSet() {
+  if (buffers_.empty()) {
+    return;
+  }
+  if (memory_level_ == Data_Namespace::CPU_LEVEL) {
+    CHECK_EQ(size_t(1), buffers_.size());
+    free(buffers_.front());
+  }
+}
+
+void InValuesHashSet::buildIntegerSet(const std::vector<int64_t>& values, Data_Namespace::DataMgr* data_mgr) {
+  if (values.empty()) {
+    return;
+  }
+  const auto group_count = get_group_count(values.size());
+  group_mask_ = group_count - 1;
+  // the null sentinel marks empty slots, the needle is checked against it before probing
+  std::vector<int64_t> slots(group_count * IN_VALUES_HASH_SET_GROUP_SIZE, null_val_);
+  for (const auto value : values) {
+    bool inserted{false};
+    for (size_t group = in_values_hash_set_hash(value) & group_mask_; !inserted; group = (group + 1) & group_mask_) {
+      for (size_t i = group * IN_VALUES_HASH_SET_GROUP_SIZE; i < (group + 1) * IN_VALUES_HASH_SET_GROUP_SIZE; ++i) {
+        if (slots[i] == value) {
+          inserted = true;
+          break;
+        }
+        if (slots[i] == null_val_) {
+          slots[i] = value;
+          inserted = true;
+          break;
+        }
+      }
+    }
+  }
+  copyToDevices(slots, data_mgr);
+}
+
+void InValuesHashSet::copyToDevices(std::vector<int64_t>& cpu_buffer, Data_Namespace::DataMgr* data_mgr) {
+  const auto buffer_bytes = cpu_buffer.size() * sizeof(int64_t);
+#ifdef HAVE_CUDA
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    for (int device_id = 0; device_id < device_count_; ++device_id) {
+      auto gpu_buffer = alloc_gpu_mem(data_mgr, buffer_bytes, device_id, nullptr);
+      copy_to_gpu(data_mgr, gpu_buffer, &cpu_buffer[0], buffer_bytes, device_id);
+      buffers_.push_back(reinterpret_cast<int8_t*>(gpu_buffer));
+    }
+    return;
+  }
+#else
+  CHECK_EQ(1, device_count_);
+#endif  // HAVE_CUDA
+  auto buffer = static_cast<int8_t*>(checked_malloc(buffer_bytes));
+  memcpy(buffer, &cpu_buffer[0], buffer_bytes);
+  buffers_.push_back(buffer);
+}
+
+llvm::Value* InValuesHashSet::codegen(const std::vector<llvm::Value*>& needle_lvs, Executor* executor) const {
+  CHECK(!buffers_.empty());
+  std::vector<std::shared_ptr<const Analyzer::Constant>> constants_owned;
+  std::vector<const Analyzer::Constant*> constants;
+  for (const auto buffer : buffers_) {
+    const int64_t buffer_handle = reinterpret_cast<int64_t>(buffer);
+    const auto buffer_handle_literal =
+        std::dynamic_pointer_cast<Analyzer::Constant>(Parser::IntLiteral::analyzeValue(buffer_handle));
+    CHECK(buffer_handle_literal);
+    CHECK_EQ(kENCODING_NONE, buffer_handle_literal->get_type_info().get_compression());
+    constants_owned.push_back(buffer_handle_literal);
+    constants.push_back(buffer_handle_literal.get());
+  }
+  const auto buffer_handle_lvs = executor->codegenHoistedConstants(constants, kENCODING_NONE, 0);
+  CHECK_EQ(size_t(1), buffer_handle_lvs.size());
+  const auto buffer_handle = executor->castToTypeIn(buffer_handle_lvs.front(), 64);
+  const auto null_bool_val = executor->ll_int(static_cast<int8_t>(inline_int_null_val(SQLTypeInfo(kBOOLEAN, false))));
+  auto cgen_state = executor->cgen_state_.get();
+  switch (key_type_) {
+    case KeyType::Integer: {
+      CHECK_EQ(size_t(1), needle_lvs.size());
+      return cgen_state->emitCall("int_in_hash_set",
+                                  {buffer_handle,
+                                   executor->castToTypeIn(needle_lvs.front(), 64),
+                                   executor->ll_int(group_mask_),
+                                   executor->ll_int(null_val_),
+                                   null_bool_val});
+    }
+    case KeyType::Double: {
+      CHECK_EQ(size_t(1), needle_lvs.size());
+      auto needle = needle_lvs.front();
+      if (needle->getType()->isFloatTy()) {
+        needle = cgen_state->ir_builder_.CreateFPExt(needle, llvm::Type::getDoubleTy(cgen_state->context_));
+      }
+      CHECK(needle->getType()->isDoubleTy());
+      double null_val;
+      memcpy(&null_val, &null_val_, sizeof(null_val));
+      return cgen_state->emitCall(
+          "double_in_hash_set",
+          {buffer_handle, needle, executor->ll_int(group_mask_), executor->ll_fp(null_val), null_bool_val});
+    }
+    case KeyType::String: {
+      std::vector<llvm::Value*> str_lvs(needle_lvs);
+      // unpack pointer + length if necessary
+      if (str_lvs.size() != 3) {
+        CHECK_EQ(size_t(1), str_lvs.size());
+        str_lvs.push_back(cgen_state->emitCall("extract_str_ptr", {str_lvs.front()}));
+        str_lvs.push_back(cgen_state->emitCall("extract_str_len", {str_lvs.front()}));
+      }
+      return cgen_state->emitCall(
+          "string_in_hash_set",
+          {buffer_handle, str_lvs[1], str_lvs[2], executor->ll_int(group_mask_), null_bool_val});
+    }
+    default:
+      CHECK(false);
+  }
+  return nullptr;
+}
+
+bool InValuesHashSet::isEmpty() const {
+  return buffers_.empty();
+}
+
+bool InValuesHashSet::hasNull() const {
+  return rhs_has_null_;
+}
+
+bool InValuesHashSet::preferredOverBitmap(const std::vector<int64_t>& values, const int64_t null_val) {
+  int64_t min_val{std::numeric_limits<int64_t>::max()};
+  int64_t max_val{std::numeric_limits<int64_t>::min()};
+  size_t value_count{0};
+  for (const auto value : values) {
+    if (value == null_val) {
+      continue;
+    }
+    min_val = std::min(min_val, value);
+    max_val = std::max(max_val, value);
+    ++value_count;
+  }
+  if (!value_count) {
+    return false;
+  }
+  // a bitmap which fits in the L2 cache is hard to beat, past that one bit per value of
+  // the range has to be paid for with density
+  const uint64_t bitmap_bytes = (static_cast<uint64_t>(max_val) - static_cast<uint64_t>(min_val)) / 8 + 1;
+  const uint64_t hash_set_bytes = get_group_count(value_count) * IN_VALUES_HASH_SET_GROUP_SIZE * sizeof(int64_t);
+  return bitmap_bytes > 256 * 1024 && bitmap_bytes > 4 * hash_set_bytes;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    InValuesHashSet.h
+ * @brief   Read-only open addressing hash set for the right-hand side of IN.
+ *
+ * Used when InValuesBitmap can't represent the values (floating point, none encoded
+ * strings) or would be mostly empty (sparse integers). The set is built once per
+ * compilation, copied to every device and probed by the runtime functions
+ * int_in_hash_set, double_in_hash_set and string_in_hash_set.
+ */
+
+#ifndef QUERYENGINE_INVALUESHASHSET_H
+#define QUERYENGINE_INVALUESHASHSET_H
+
+#include "../DataMgr/DataMgr.h"
+
+#include <llvm/IR/Value.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Executor;
+
+class InValuesHashSet {
+ public:
+  // Integers, decimals, dates and dictionary ids.
+  InValuesHashSet(const std::vector<int64_t>& values,
+                  const int64_t null_val,
+                  const Data_Namespace::MemoryLevel memory_level,
+                  const int device_count,
+                  Data_Namespace::DataMgr* data_mgr);
+  // Floats are widened to double by the caller.
+  InValuesHashSet(const std::vector<double>& values,
+                  const double null_val,
+                  const Data_Namespace::MemoryLevel memory_level,
+                  const int device_count,
+                  Data_Namespace::DataMgr* data_mgr);
+  // None encoded strings, null strings are passed separately.
+  InValuesHashSet(const std::vector<std::string>& values,
+                  const bool rhs_has_null,
+                  const Data_Namespace::MemoryLevel memory_level,
+                  const int device_count,
+                  Data_Namespace::DataMgr* data_mgr);
+  ~InValuesHashSet();
+
+  // The needle is a single value, or the pointer / length pair of a none encoded string.
+  llvm::Value* codegen(const std::vector<llvm::Value*>& needle_lvs, Executor* executor) const;
+
+  bool isEmpty() const;
+
+  bool hasNull() const;
+
+  // True if a bitmap over the range of the values would be much larger than a hash set.
+  static bool preferredOverBitmap(const std::vector<int64_t>& values, const int64_t null_val);
+
+ private:
+  enum class KeyType { Integer, Double, String };
+
+  void buildIntegerSet(const std::vector<int64_t>& values, Data_Namespace::DataMgr* data_mgr);
+  void copyToDevices(std::vector<int64_t>& cpu_buffer, Data_Namespace::DataMgr* data_mgr);
+
+  const KeyType key_type_;
+  std::vector<int8_t*> buffers_;
+  bool rhs_has_null_;
+  int64_t group_mask_;
+  const int64_t null_val_;  // for doubles, the bit pattern of the null sentinel
+  const Data_Namespace::MemoryLevel memory_level_;
+  const int device_count_;
+};
+
+#endif  // QUERYENGINE_INVALUESHASHSET_H
@@ -34,7 +34,8 @@ llvm::Value* Executor::codegen(const Analyzer::InValues* expr, const Compilation
   }
   CHECK(result);
   if (co.hoist_literals_) {  // TODO(alex): remove this constraint
-    auto in_vals_bitmap = createInValuesBitmap(expr, co);
+    std::unique_ptr<InValuesHashSet> in_vals_hash_set;
+    auto in_vals_bitmap = createInValuesBitmap(expr, co, in_vals_hash_set);
     if (in_vals_bitmap) {
       if (in_vals_bitmap->isEmpty()) {
         return in_vals_bitmap->hasNull() ? inlineIntNull(SQLTypeInfo(kBOOLEAN, false)) : result;
@@ -42,6 +43,15 @@ llvm::Value* Executor::codegen(const Analyzer::InValues* expr, const Compilation
       CHECK_EQ(size_t(1), lhs_lvs.size());
       return cgen_state_->addInValuesBitmap(in_vals_bitmap)->codegen(lhs_lvs.front(), this);
     }
+    if (!in_vals_hash_set) {
+      in_vals_hash_set = createInValuesHashSet(expr, co);
+    }
+    if (in_vals_hash_set) {
+      if (in_vals_hash_set->isEmpty()) {
+        return in_vals_hash_set->hasNull() ? inlineIntNull(SQLTypeInfo(kBOOLEAN, false)) : result;
+      }
+      return cgen_state_->addInValuesHashSet(in_vals_hash_set)->codegen(lhs_lvs, this);
+    }
   }
   if (expr_ti.get_notnull()) {
     for (auto in_val : expr->get_value_list()) {
@@ -93,11 +103,13 @@ llvm::Value* Executor::codegen(const Analyzer::InIntegerSet* in_integer_set, con
 }
 
 std::unique_ptr<InValuesBitmap> Executor::createInValuesBitmap(const Analyzer::InValues* in_values,
-                                                               const CompilationOptions& co) {
+                                                               const CompilationOptions& co,
+                                                               std::unique_ptr<InValuesHashSet>& in_values_hash_set) {
   const auto& value_list = in_values->get_value_list();
   const auto val_count = value_list.size();
   const auto& ti = in_values->get_arg()->get_type_info();
-  if (!(ti.is_integer() || (ti.is_string() && ti.get_compression() == kENCODING_DICT))) {
+  if (!(ti.is_integer() || ti.is_decimal() || ti.is_time() ||
+        (ti.is_string() && ti.get_compression() == kENCODING_DICT))) {
     return nullptr;
   }
   const auto sdp = ti.is_string() ? getStringDictionaryProxy(ti.get_comp_param(), row_set_mem_owner_, true) : nullptr;
@@ -108,6 +120,7 @@ std::unique_ptr<InValuesBitmap> Executor::createInValuesBitmap(const Analyzer::I
     const int worker_count = val_count > 10000 ? cpu_threads() : int(1);
     std::vector<std::vector<int64_t>> values_set(worker_count, std::vector<int64_t>());
     std::vector<std::future<bool>> worker_threads;
+    bool success = true;
     auto start_it = value_list.begin();
     for (size_t i = 0, start_val = 0, stride = (val_count + worker_count - 1) / worker_count;
          i < val_count && start_val < val_count;
@@ -124,6 +137,12 @@ std::unique_ptr<InValuesBitmap> Executor::createInValuesBitmap(const Analyzer::I
           }
           const auto& in_val_ti = in_val->get_type_info();
           CHECK(in_val_ti == ti);
+          const auto& in_val_const_ti = in_val_const->get_type_info();
+          if ((ti.is_decimal() || ti.is_time()) &&
+              (in_val_const_ti.get_type() != ti.get_type() || in_val_const_ti.get_scale() != ti.get_scale())) {
+            // the cast to the argument type changes the representation, leave it to the comparisons
+            return false;
+          }
           if (ti.is_string()) {
             CHECK(sdp);
             const auto string_id = in_val_const->get_is_null()
@@ -141,10 +160,9 @@ std::unique_ptr<InValuesBitmap> Executor::createInValuesBitmap(const Analyzer::I
       if (worker_count > 1) {
         worker_threads.push_back(std::async(std::launch::async, do_work, std::ref(values_set[i]), start_it, end_it));
       } else {
-        do_work(std::ref(values), start_it, end_it);
+        success &= do_work(std::ref(values), start_it, end_it);
       }
     }
-    bool success = true;
     for (auto& worker : worker_threads) {
       success &= worker.get();
     }
@@ -161,16 +179,110 @@ std::unique_ptr<InValuesBitmap> Executor::createInValuesBitmap(const Analyzer::I
         values.insert(values.end(), vals.begin(), vals.end());
       }
     }
+    const auto memory_level =
+        co.device_type_ == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL : Data_Namespace::CPU_LEVEL;
     try {
-      return boost::make_unique<InValuesBitmap>(
-          values,
-          needle_null_val,
-          co.device_type_ == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL : Data_Namespace::CPU_LEVEL,
-          deviceCount(co.device_type_),
-          &catalog_->get_dataMgr());
+      if (!InValuesHashSet::preferredOverBitmap(values, needle_null_val)) {
+        return boost::make_unique<InValuesBitmap>(
+            values, needle_null_val, memory_level, deviceCount(co.device_type_), &catalog_->get_dataMgr());
+      }
+    } catch (const FailedToCreateBitmap&) {
+      // range too wide, fall through to the hash set
     } catch (...) {
       return nullptr;
     }
+    try {
+      in_values_hash_set = boost::make_unique<InValuesHashSet>(
+          values, needle_null_val, memory_level, deviceCount(co.device_type_), &catalog_->get_dataMgr());
+    } catch (...) {
+      // leave it to the comparisons
+    }
   }
   return nullptr;
 }
+
+namespace {
+
+// The constants of an IN list can still be wrapped in a cast to the type of the argument.
+bool get_fp_in_value(const Analyzer::Constant* constant, const SQLTypeInfo& arg_ti, double& value) {
+  const auto& ti = constant->get_type_info();
+  const auto& datum = constant->get_constval();
+  switch (ti.get_type()) {
+    case kFLOAT:
+      value = datum.floatval;
+      break;
+    case kDOUBLE:
+      value = datum.doubleval;
+      break;
+    case kSMALLINT:
+      value = datum.smallintval;
+      break;
+    case kINT:
+      value = datum.intval;
+      break;
+    case kBIGINT:
+      value = datum.bigintval;
+      break;
+    case kDECIMAL:
+    case kNUMERIC:
+      value = static_cast<double>(datum.bigintval) / exp_to_scale(ti.get_scale());
+      break;
+    default:
+      return false;
+  }
+  if (arg_ti.get_type() == kFLOAT) {
+    // compare in the domain of the argument, like the cast would
+    value = static_cast<float>(value);
+  }
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<InValuesHashSet> Executor::createInValuesHashSet(const Analyzer::InValues* in_values,
+                                                                 const CompilationOptions& co) {
+  const auto& value_list = in_values->get_value_list();
+  const auto& ti = in_values->get_arg()->get_type_info();
+  const bool is_none_encoded_string = ti.is_string() && ti.get_compression() == kENCODING_NONE;
+  if (value_list.size() <= 3 || !(ti.is_fp() || is_none_encoded_string)) {
+    return nullptr;
+  }
+  const auto memory_level =
+      co.device_type_ == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL : Data_Namespace::CPU_LEVEL;
+  if (is_none_encoded_string) {
+    std::vector<std::string> values;
+    bool rhs_has_null{false};
+    for (const auto& in_val : value_list) {
+      const auto in_val_const = dynamic_cast<const Analyzer::Constant*>(extract_cast_arg(in_val.get()));
+      if (!in_val_const || !in_val_const->get_type_info().is_string()) {
+        return nullptr;
+      }
+      if (in_val_const->get_is_null()) {
+        rhs_has_null = true;
+        continue;
+      }
+      values.push_back(*in_val_const->get_constval().stringval);
+    }
+    return boost::make_unique<InValuesHashSet>(
+        values, rhs_has_null, memory_level, deviceCount(co.device_type_), &catalog_->get_dataMgr());
+  }
+  const auto null_val = inline_fp_null_val(ti);
+  std::vector<double> values;
+  for (const auto& in_val : value_list) {
+    const auto in_val_const = dynamic_cast<const Analyzer::Constant*>(extract_cast_arg(in_val.get()));
+    if (!in_val_const) {
+      return nullptr;
+    }
+    if (in_val_const->get_is_null()) {
+      values.push_back(null_val);
+      continue;
+    }
+    double value;
+    if (!get_fp_in_value(in_val_const, ti, value)) {
+      return nullptr;
+    }
+    values.push_back(value);
+  }
+  return boost::make_unique<InValuesHashSet>(
+      values, null_val, memory_level, deviceCount(co.device_type_), &catalog_->get_dataMgr());
+}
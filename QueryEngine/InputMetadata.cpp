@@ -19,31 +19,30 @@
 
 #include "../Fragmenter/Fragmenter.h"
 
+#include <algorithm>
 #include <future>
+#include <limits>
 
 InputTableInfoCache::InputTableInfoCache(Executor* executor) : executor_(executor) {}
 
 namespace {
 
-Fragmenter_Namespace::TableInfo copy_table_info(const Fragmenter_Namespace::TableInfo& table_info) {
-  Fragmenter_Namespace::TableInfo table_info_copy;
-  table_info_copy.chunkKeyPrefix = table_info.chunkKeyPrefix;
-  table_info_copy.fragments = table_info.fragments;
-  table_info_copy.setPhysicalNumTuples(table_info.getPhysicalNumTuples());
-  return table_info_copy;
-}
-
-Fragmenter_Namespace::TableInfo build_table_info(const std::vector<const TableDescriptor*>& shard_tables) {
+std::shared_ptr<const Fragmenter_Namespace::TableInfo> build_table_info(
+    const std::vector<const TableDescriptor*>& shard_tables) {
+  if (shard_tables.size() == 1) {
+    CHECK(shard_tables.front()->fragmenter);
+    return shard_tables.front()->fragmenter->getFragmentsSnapshot();
+  }
   size_t total_number_of_tuples{0};
-  Fragmenter_Namespace::TableInfo table_info_all_shards;
+  auto table_info_all_shards = std::make_shared<Fragmenter_Namespace::TableInfo>();
   for (const TableDescriptor* shard_table : shard_tables) {
     CHECK(shard_table->fragmenter);
-    const auto& shard_metainfo = shard_table->fragmenter->getFragmentsForQuery();
-    total_number_of_tuples += shard_metainfo.getPhysicalNumTuples();
-    table_info_all_shards.fragments.insert(
-        table_info_all_shards.fragments.end(), shard_metainfo.fragments.begin(), shard_metainfo.fragments.end());
+    const auto shard_metainfo = shard_table->fragmenter->getFragmentsSnapshot();
+    total_number_of_tuples += shard_metainfo->getPhysicalNumTuples();
+    table_info_all_shards->fragments.insert(
+        table_info_all_shards->fragments.end(), shard_metainfo->fragments.begin(), shard_metainfo->fragments.end());
   }
-  table_info_all_shards.setPhysicalNumTuples(total_number_of_tuples);
+  table_info_all_shards->setPhysicalNumTuples(total_number_of_tuples);
   return table_info_all_shards;
 }
 
@@ -52,18 +51,17 @@ Fragmenter_Namespace::TableInfo build_table_info(const std::vector<const TableDe
 Fragmenter_Namespace::TableInfo InputTableInfoCache::getTableInfo(const int table_id) {
   const auto it = cache_.find(table_id);
   if (it != cache_.end()) {
-    const auto& table_info = it->second;
-    return copy_table_info(table_info);
+    return *it->second;
   }
   const auto cat = executor_->getCatalog();
   CHECK(cat);
   const auto td = cat->getMetadataForTable(table_id);
   CHECK(td);
   const auto shard_tables = cat->getPhysicalTablesDescriptors(td);
-  auto table_info = build_table_info(shard_tables);
-  auto it_ok = cache_.emplace(table_id, copy_table_info(table_info));
+  const auto table_info = build_table_info(shard_tables);
+  auto it_ok = cache_.emplace(table_id, table_info);
   CHECK(it_ok.second);
-  return copy_table_info(table_info);
+  return *table_info;
 }
 
 void InputTableInfoCache::clear() {
@@ -77,10 +75,79 @@ bool uses_int_meta(const SQLTypeInfo& col_ti) {
          (col_ti.is_string() && col_ti.get_compression() == kENCODING_DICT);
 }
 
-std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
+// The values a column of rows yields all go through the int64_t or all through the double
+// overload of Encoder::updateStats, so they can be read in bulk with ResultSet::getColumnValues.
+bool can_synthesize_metadata_directly(const ResultSet* rows) {
+  if (!rows->canReadColumnsDirectly()) {
+    return false;
+  }
+  for (size_t i = 0; i < rows->colCount(); ++i) {
+    const auto& col_ti = rows->getColType(i);
+    const bool is_fp_slot = get_compact_type(rows->getTargetInfos()[i]).is_fp();
+    if (!(uses_int_meta(col_ti) && !is_fp_slot) && !(col_ti.is_fp() && is_fp_slot)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Folds a block of values into the encoder: the minimum, the maximum and whether there were
+// nulls, instead of one virtual updateStats call per value.
+template <typename T>
+void update_stats_from_values(Encoder* encoder, const std::vector<T>& vals, const T null_val) {
+  T min_val = std::numeric_limits<T>::max();
+  T max_val = std::numeric_limits<T>::lowest();
+  bool has_vals{false};
+  bool has_nulls{false};
+  for (const auto val : vals) {
+    if (val == null_val) {
+      has_nulls = true;
+      continue;
+    }
+    min_val = std::min(min_val, val);
+    max_val = std::max(max_val, val);
+    has_vals = true;
+  }
+  if (has_vals) {
+    encoder->updateStats(min_val, false);
+    encoder->updateStats(max_val, false);
+  }
+  if (has_nulls) {
+    encoder->updateStats(null_val, true);
+  }
+}
+
+// Column by column over blocks of entries, reading the result buffer directly.
+void synthesize_stats_directly(const ResultSet* rows,
+                               const size_t start_entry,
+                               const size_t end_entry,
+                               std::vector<std::unique_ptr<Encoder>>& dummy_encoders) {
+  const size_t block_entries = 4096;
+  std::vector<int64_t> int_vals;
+  std::vector<double> fp_vals;
+  for (size_t block_start = start_entry; block_start < end_entry; block_start += block_entries) {
+    const auto block_end = std::min(block_start + block_entries, end_entry);
+    for (size_t i = 0; i < rows->colCount(); ++i) {
+      const auto& col_ti = rows->getColType(i);
+      if (col_ti.is_fp()) {
+        fp_vals.clear();
+        rows->getColumnValues(i, block_start, block_end, fp_vals);
+        update_stats_from_values(dummy_encoders[i].get(), fp_vals, inline_fp_null_val(col_ti));
+      } else {
+        int_vals.clear();
+        rows->getColumnValues(i, block_start, block_end, int_vals);
+        update_stats_from_values(dummy_encoders[i].get(), int_vals, inline_int_null_val(col_ti));
+      }
+    }
+  }
+}
+
+std::shared_ptr<Fragmenter_Namespace::ChunkMetadataMap> synthesize_metadata(const ResultSet* rows) {
   rows->moveToBegin();
   std::vector<std::vector<std::unique_ptr<Encoder>>> dummy_encoders;
-  const size_t worker_count = use_parallel_algorithms(*rows) ? cpu_threads() : 1;
+  const bool read_directly = can_synthesize_metadata_directly(rows);
+  const bool use_parallel = use_parallel_algorithms(*rows);
+  const size_t worker_count = use_parallel ? cpu_threads() : 1;
   for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     dummy_encoders.emplace_back();
     for (size_t i = 0; i < rows->colCount(); ++i) {
@@ -121,27 +188,31 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
       }
     }
   };
-  if (use_parallel_algorithms(*rows)) {
-    const size_t worker_count = cpu_threads();
+  if (use_parallel) {
     std::vector<std::future<void>> compute_stats_threads;
     const auto entry_count = rows->entryCount();
     for (size_t i = 0, start_entry = 0, stride = (entry_count + worker_count - 1) / worker_count;
          i < worker_count && start_entry < entry_count;
          ++i, start_entry += stride) {
       const auto end_entry = std::min(start_entry + stride, entry_count);
-      compute_stats_threads.push_back(
-          std::async(std::launch::async,
-                     [rows, &do_work, &dummy_encoders](const size_t start, const size_t end, const size_t worker_idx) {
-                       for (size_t i = start; i < end; ++i) {
-                         const auto crt_row = rows->getRowAtNoTranslations(i);
-                         if (!crt_row.empty()) {
-                           do_work(crt_row, dummy_encoders[worker_idx]);
-                         }
-                       }
-                     },
-                     start_entry,
-                     end_entry,
-                     i));
+      compute_stats_threads.push_back(std::async(
+          std::launch::async,
+          [rows, read_directly, &do_work, &dummy_encoders](
+              const size_t start, const size_t end, const size_t worker_idx) {
+            if (read_directly) {
+              synthesize_stats_directly(rows, start, end, dummy_encoders[worker_idx]);
+              return;
+            }
+            for (size_t i = start; i < end; ++i) {
+              const auto crt_row = rows->getRowAtNoTranslations(i);
+              if (!crt_row.empty()) {
+                do_work(crt_row, dummy_encoders[worker_idx]);
+              }
+            }
+          },
+          start_entry,
+          end_entry,
+          i));
     }
     for (auto& child : compute_stats_threads) {
       child.wait();
@@ -149,6 +220,8 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
     for (auto& child : compute_stats_threads) {
       child.get();
     }
+  } else if (read_directly) {
+    synthesize_stats_directly(rows, 0, rows->entryCount(), dummy_encoders[0]);
   } else {
     while (true) {
       auto crt_row = rows->getNextRow(false, false);
@@ -159,7 +232,7 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
     }
     rows->moveToBegin();
   }
-  std::map<int, ChunkMetadata> metadata_map;
+  auto metadata_map = std::make_shared<Fragmenter_Namespace::ChunkMetadataMap>();
   for (size_t worker_idx = 1; worker_idx < worker_count; ++worker_idx) {
     CHECK_LT(worker_idx, dummy_encoders.size());
     const auto& worker_encoders = dummy_encoders[worker_idx];
@@ -168,8 +241,7 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
     }
   }
   for (size_t i = 0; i < rows->colCount(); ++i) {
-    const auto it_ok = metadata_map.emplace(i, dummy_encoders[0][i]->getMetadata(rows->getColType(i)));
-    CHECK(it_ok.second);
+    metadata_map->set(i, dummy_encoders[0][i]->getMetadata(rows->getColType(i)));
   }
   return metadata_map;
 }
@@ -219,7 +291,7 @@ void collect_table_infos(std::vector<InputTableInfo>& table_infos,
     const auto cached_index_it = info_cache.find(table_id);
     if (cached_index_it != info_cache.end()) {
       CHECK_LT(cached_index_it->second, table_infos.size());
-      table_infos.push_back({table_id, copy_table_info(table_infos[cached_index_it->second].info)});
+      table_infos.push_back({table_id, table_infos[cached_index_it->second].info});
       continue;
     }
     if (input_desc.getSourceType() == InputSourceType::RESULT) {
@@ -275,12 +347,12 @@ std::vector<InputTableInfo> get_table_infos(const RelAlgExecutionUnit& ra_exe_un
   return table_infos;
 }
 
-const std::map<int, ChunkMetadata>& Fragmenter_Namespace::FragmentInfo::getChunkMetadataMap() const {
+const Fragmenter_Namespace::ChunkMetadataMap& Fragmenter_Namespace::FragmentInfo::getChunkMetadataMap() const {
   if (resultSet && !synthesizedMetadataIsValid) {
     chunkMetadataMap = synthesize_metadata(resultSet);
     synthesizedMetadataIsValid = true;
   }
-  return chunkMetadataMap;
+  return getChunkMetadataMapPhysical();
 }
 
 size_t Fragmenter_Namespace::FragmentInfo::getNumTuples() const {
@@ -44,7 +44,8 @@ class InputTableInfoCache {
   void clear();
 
  private:
-  std::unordered_map<int, Fragmenter_Namespace::TableInfo> cache_;
+  // snapshots pinned for the duration of the query, see AbstractFragmenter::getFragmentsSnapshot
+  std::unordered_map<int, std::shared_ptr<const Fragmenter_Namespace::TableInfo>> cache_;
   Executor* executor_;
 };
 
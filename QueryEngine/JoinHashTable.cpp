@@ -97,6 +97,10 @@ std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*> normalize_column_pa
         (inner_col_real_ti.is_string() && inner_col_real_ti.get_compression() == kENCODING_DICT))) {
     throw HashJoinFail("Can only apply hash join to integer-like types and dictionary encoded strings");
   }
+  // The hash table builders read the inner column as a plain fixed width array.
+  if (inner_col_real_ti.get_compression() == kENCODING_RL || inner_col_real_ti.get_compression() == kENCODING_DIFF) {
+    throw HashJoinFail("Cannot apply hash join to run length or frame of reference encoded column");
+  }
   return {inner_col, outer_col ? outer_col : outer_expr};
 }
 
@@ -297,23 +301,28 @@ std::pair<const int8_t*, size_t> JoinHashTable::getColumnFragment(
       executor_, hash_col, fragment, effective_mem_lvl, device_id, chunks_owner, column_cache_);
 }
 
-std::pair<const int8_t*, size_t> JoinHashTable::getAllColumnFragments(
+std::vector<JoinColumn> JoinHashTable::getAllColumnFragments(
     const Analyzer::ColumnVar& hash_col,
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
     std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
-  std::lock_guard<std::mutex> linearized_multifrag_column_lock(linearized_multifrag_column_mutex_);
-  if (linearized_multifrag_column_.first) {
-    return linearized_multifrag_column_;
-  }
-  const int8_t* col_buff;
-  size_t total_elem_count;
-  std::tie(col_buff, total_elem_count) =
-      Executor::ExecutionDispatch::getAllColumnFragments(executor_, hash_col, fragments, chunks_owner, column_cache_);
-  linearized_multifrag_column_owner_.addColBuffer(col_buff);
-  if (!shardCount()) {
-    linearized_multifrag_column_ = {col_buff, total_elem_count};
-  }
-  return {col_buff, total_elem_count};
+  return Executor::ExecutionDispatch::getAllColumnFragments(
+      executor_, hash_col, fragments, chunks_owner, column_cache_);
+}
+
+JoinColumn transfer_join_column_frags_to_gpu(const std::vector<JoinColumn>& join_column_frags,
+                                             const size_t elem_width,
+                                             ThrustAllocator& dev_buff_owner) {
+  const auto elem_count = get_join_column_element_count(join_column_frags);
+  CHECK_NE(elem_count, size_t(0));
+  auto dev_col_buff = dev_buff_owner.allocate(elem_count * elem_width);
+  for (const auto& join_column : join_column_frags) {
+    copy_to_gpu(dev_buff_owner.getDataMgr(),
+                reinterpret_cast<CUdeviceptr>(dev_col_buff + join_column.row_id_offset * elem_width),
+                join_column.col_buff,
+                join_column.num_elems * elem_width,
+                dev_buff_owner.getDeviceId());
+  }
+  return {dev_col_buff, elem_count, 0};
 }
 
 bool needs_dictionary_translation(const Analyzer::ColumnVar* inner_col,
@@ -427,7 +436,7 @@ int JoinHashTable::reify(const int device_count) {
   return 0;
 }
 
-std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
+std::vector<JoinColumn> JoinHashTable::fetchFragments(
     const Analyzer::ColumnVar* hash_col,
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragment_info,
     const Data_Namespace::MemoryLevel effective_memory_level,
@@ -441,16 +450,13 @@ std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
 #else
   const bool has_multi_frag = fragment_info.size() > 1;
 #endif
-  const auto& catalog = *executor_->getCatalog();
-  auto& data_mgr = catalog.get_dataMgr();
   const auto& first_frag = fragment_info.front();
-  const int8_t* col_buff = nullptr;
-  size_t elem_count = 0;
+  std::vector<JoinColumn> join_column_frags;
 
 #ifdef ENABLE_MULTIFRAG_JOIN
   const size_t elem_width = hash_col->get_type_info().get_size();
   if (has_multi_frag) {
-    std::tie(col_buff, elem_count) = getAllColumnFragments(*hash_col, fragment_info, chunks_owner);
+    join_column_frags = getAllColumnFragments(*hash_col, fragment_info, chunks_owner);
   }
 #endif
 
@@ -458,23 +464,21 @@ std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
     std::lock_guard<std::mutex> fragment_fetch_lock(fragment_fetch_mutex);
 #ifdef ENABLE_MULTIFRAG_JOIN
     if (has_multi_frag) {
+      // The CPU builders read the fragments in place, the GPU ones need the column in one buffer.
       if (effective_memory_level == Data_Namespace::GPU_LEVEL) {
-        CHECK(col_buff != nullptr);
-        CHECK_NE(elem_count, size_t(0));
-        int8_t* dev_col_buff = nullptr;
-        dev_col_buff = dev_buff_owner.allocate(elem_count * elem_width);
-        copy_to_gpu(
-            &data_mgr, reinterpret_cast<CUdeviceptr>(dev_col_buff), col_buff, elem_count * elem_width, device_id);
-        col_buff = dev_col_buff;
+        join_column_frags = {transfer_join_column_frags_to_gpu(join_column_frags, elem_width, dev_buff_owner)};
       }
     } else
 #endif
     {
+      const int8_t* col_buff = nullptr;
+      size_t elem_count = 0;
       std::tie(col_buff, elem_count) =
           getColumnFragment(*hash_col, first_frag, effective_memory_level, device_id, chunks_owner);
+      join_column_frags.push_back(JoinColumn{col_buff, elem_count, 0});
     }
   }
-  return {col_buff, elem_count};
+  return join_column_frags;
 }
 
 ChunkKey JoinHashTable::genHashTableKey(const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
@@ -529,15 +533,14 @@ int JoinHashTable::reifyOneToOneForDevice(const std::deque<Fragmenter_Namespace:
   if (fragments.empty()) {
     // No data in this fragment. Still need to create a hash table and initialize it properly.
     ChunkKey empty_chunk;
-    return initHashTableForDevice(empty_chunk, nullptr, 0, cols, effective_memory_level, buff_and_err, device_id);
+    return initHashTableForDevice(empty_chunk, {}, cols, effective_memory_level, buff_and_err, device_id);
   }
 
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   ThrustAllocator dev_buff_owner(&data_mgr, device_id);
-  const int8_t* col_buff = nullptr;
-  size_t elem_count = 0;
+  std::vector<JoinColumn> join_column_frags;
   try {
-    std::tie(col_buff, elem_count) =
+    join_column_frags =
         fetchFragments(inner_col, fragments, effective_memory_level, device_id, chunks_owner, dev_buff_owner);
   } catch (...) {
     return ERR_FAILED_TO_FETCH_COLUMN;
@@ -546,8 +549,7 @@ int JoinHashTable::reifyOneToOneForDevice(const std::deque<Fragmenter_Namespace:
   int err{0};
   try {
     err = initHashTableForDevice(genHashTableKey(fragments, cols.second, inner_col),
-                                 col_buff,
-                                 elem_count,
+                                 join_column_frags,
                                  cols,
                                  effective_memory_level,
                                  buff_and_err,
@@ -592,17 +594,16 @@ int JoinHashTable::reifyOneToManyForDevice(const std::deque<Fragmenter_Namespace
       needs_dictionary_translation(inner_col, cols.second, executor_) ? Data_Namespace::CPU_LEVEL : memory_level_;
   if (fragments.empty()) {
     ChunkKey empty_chunk;
-    initOneToManyHashTable(empty_chunk, nullptr, 0, cols, effective_memory_level, device_id);
+    initOneToManyHashTable(empty_chunk, {}, cols, effective_memory_level, device_id);
     return 0;
   }
 
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   ThrustAllocator dev_buff_owner(&data_mgr, device_id);
-  const int8_t* col_buff = nullptr;
-  size_t elem_count = 0;
+  std::vector<JoinColumn> join_column_frags;
 
   try {
-    std::tie(col_buff, elem_count) =
+    join_column_frags =
         fetchFragments(inner_col, fragments, effective_memory_level, device_id, chunks_owner, dev_buff_owner);
   } catch (...) {
     return ERR_FAILED_TO_FETCH_COLUMN;
@@ -610,8 +611,7 @@ int JoinHashTable::reifyOneToManyForDevice(const std::deque<Fragmenter_Namespace
 
   try {
     initOneToManyHashTable(genHashTableKey(fragments, cols.second, inner_col),
-                           col_buff,
-                           elem_count,
+                           join_column_frags,
                            cols,
                            effective_memory_level,
                            device_id);
@@ -636,8 +636,7 @@ void JoinHashTable::checkHashJoinReplicationConstraint(const int table_id) const
   }
 }
 
-int JoinHashTable::initHashTableOnCpu(const int8_t* col_buff,
-                                      const size_t num_elements,
+int JoinHashTable::initHashTableOnCpu(const std::vector<JoinColumn>& join_column_frags,
                                       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                                       const int32_t hash_entry_count,
                                       const int32_t hash_join_invalid_val) {
@@ -675,28 +674,32 @@ int JoinHashTable::initHashTableOnCpu(const int8_t* col_buff,
     for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
       init_cpu_buff_threads.emplace_back([this,
                                           hash_join_invalid_val,
-                                          col_buff,
-                                          num_elements,
+                                          &join_column_frags,
                                           sd_inner_proxy,
                                           sd_outer_proxy,
                                           thread_idx,
                                           thread_count,
                                           &ti,
                                           &err] {
-        int partial_err = fill_hash_join_buff(&(*cpu_hash_table_buff_)[0],
-                                              hash_join_invalid_val,
-                                              {col_buff, num_elements},
-                                              {static_cast<size_t>(ti.get_size()),
-                                               col_range_.getIntMin(),
-                                               inline_fixed_encoding_null_val(ti),
-                                               isBitwiseEq(),
-                                               col_range_.getIntMax() + 1,
-                                               is_unsigned_type(ti)},
-                                              sd_inner_proxy,
-                                              sd_outer_proxy,
-                                              thread_idx,
-                                              thread_count);
-        __sync_val_compare_and_swap(&err, 0, partial_err);
+        for (const auto& join_column : join_column_frags) {
+          int partial_err = fill_hash_join_buff(&(*cpu_hash_table_buff_)[0],
+                                                hash_join_invalid_val,
+                                                join_column,
+                                                {static_cast<size_t>(ti.get_size()),
+                                                 col_range_.getIntMin(),
+                                                 inline_fixed_encoding_null_val(ti),
+                                                 isBitwiseEq(),
+                                                 col_range_.getIntMax() + 1,
+                                                 is_unsigned_type(ti)},
+                                                sd_inner_proxy,
+                                                sd_outer_proxy,
+                                                thread_idx,
+                                                thread_count);
+          __sync_val_compare_and_swap(&err, 0, partial_err);
+          if (partial_err) {
+            break;
+          }
+        }
       });
     }
     for (auto& t : init_cpu_buff_threads) {
@@ -710,8 +713,7 @@ int JoinHashTable::initHashTableOnCpu(const int8_t* col_buff,
 }
 
 void JoinHashTable::initOneToManyHashTableOnCpu(
-    const int8_t* col_buff,
-    const size_t num_elements,
+    const std::vector<JoinColumn>& join_column_frags,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const int32_t hash_entry_count,
     const int32_t hash_join_invalid_val) {
@@ -721,7 +723,8 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
   if (cpu_hash_table_buff_) {
     return;
   }
-  cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(2 * hash_entry_count + num_elements);
+  cpu_hash_table_buff_ =
+      std::make_shared<std::vector<int32_t>>(2 * hash_entry_count + get_join_column_element_count(join_column_frags));
   const StringDictionaryProxy* sd_inner_proxy{nullptr};
   const StringDictionaryProxy* sd_outer_proxy{nullptr};
   if (ti.is_string()) {
@@ -753,7 +756,7 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
   fill_one_to_many_hash_table(&(*cpu_hash_table_buff_)[0],
                               hash_entry_count,
                               hash_join_invalid_val,
-                              {col_buff, num_elements},
+                              join_column_frags,
                               {static_cast<size_t>(ti.get_size()),
                                col_range_.getIntMin(),
                                inline_fixed_encoding_null_val(ti),
@@ -779,12 +782,12 @@ size_t get_entries_per_shard(const size_t total_entry_count, const size_t shard_
 
 int JoinHashTable::initHashTableForDevice(
     const ChunkKey& chunk_key,
-    const int8_t* col_buff,
-    const size_t num_elements,
+    const std::vector<JoinColumn>& join_column_frags,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const Data_Namespace::MemoryLevel effective_memory_level,
     std::pair<Data_Namespace::AbstractBuffer*, Data_Namespace::AbstractBuffer*>& buff_and_err,
     const int device_id) {
+  const auto num_elements = get_join_column_element_count(join_column_frags);
   auto hash_entry_count = get_hash_entry_count(col_range_, isBitwiseEq());
   if (!hash_entry_count) {
     return 0;
@@ -816,14 +819,14 @@ int JoinHashTable::initHashTableForDevice(
   int err = 0;
   const int32_t hash_join_invalid_val{-1};
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
-    CHECK(!chunk_key.empty() && col_buff);
+    CHECK(!chunk_key.empty() && !join_column_frags.empty());
     initHashTableOnCpuFromCache(chunk_key, num_elements, cols);
     if (cpu_hash_table_buff_ && cpu_hash_table_buff_->size() > hash_entry_count) {
       return ERR_COLUMN_NOT_UNIQUE;
     }
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      err = initHashTableOnCpu(col_buff, num_elements, cols, hash_entry_count, hash_join_invalid_val);
+      err = initHashTableOnCpu(join_column_frags, cols, hash_entry_count, hash_join_invalid_val);
     }
     if (err == -1) {
       err = ERR_COLUMN_NOT_UNIQUE;
@@ -862,7 +865,8 @@ int JoinHashTable::initHashTableForDevice(
     if (chunk_key.empty()) {
       return 0;
     }
-    JoinColumn join_column{col_buff, num_elements};
+    CHECK_EQ(size_t(1), join_column_frags.size());
+    const auto& join_column = join_column_frags.front();
     JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
                                  col_range_.getIntMin(),
                                  inline_fixed_encoding_null_val(ti),
@@ -903,11 +907,11 @@ int JoinHashTable::initHashTableForDevice(
 }
 
 void JoinHashTable::initOneToManyHashTable(const ChunkKey& chunk_key,
-                                           const int8_t* col_buff,
-                                           const size_t num_elements,
+                                           const std::vector<JoinColumn>& join_column_frags,
                                            const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                                            const Data_Namespace::MemoryLevel effective_memory_level,
                                            const int device_id) {
+  const auto num_elements = get_join_column_element_count(join_column_frags);
   auto hash_entry_count = get_hash_entry_count(col_range_, isBitwiseEq());
 #ifdef HAVE_CUDA
   const auto shard_count = get_shard_count(qual_bin_oper_.get(), ra_exe_unit_, executor_);
@@ -941,7 +945,7 @@ void JoinHashTable::initOneToManyHashTable(const ChunkKey& chunk_key,
     initHashTableOnCpuFromCache(chunk_key, num_elements, cols);
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      initOneToManyHashTableOnCpu(col_buff, num_elements, cols, hash_entry_count, hash_join_invalid_val);
+      initOneToManyHashTableOnCpu(join_column_frags, cols, hash_entry_count, hash_join_invalid_val);
     }
     if (inner_col->get_table_id() > 0) {
       putHashTableOnCpuToCache(chunk_key, num_elements, cols);
@@ -970,7 +974,8 @@ void JoinHashTable::initOneToManyHashTable(const ChunkKey& chunk_key,
                                   hash_join_invalid_val,
                                   executor_->blockSize(),
                                   executor_->gridSize());
-    JoinColumn join_column{col_buff, num_elements};
+    CHECK_LE(join_column_frags.size(), size_t(1));
+    const auto join_column = join_column_frags.empty() ? JoinColumn{nullptr, 0, 0} : join_column_frags.front();
     JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
                                  col_range_.getIntMin(),
                                  inline_fixed_encoding_null_val(ti),
@@ -29,6 +29,7 @@
 #include "../Chunk/Chunk.h"
 #include "ColumnarResults.h"
 #include "ExpressionRange.h"
+#include "HashJoinRuntime.h"
 #include "InputDescriptors.h"
 #include "InputMetadata.h"
 #include "JoinHashTableInterface.h"
@@ -147,7 +148,7 @@ class JoinHashTable : public JoinHashTableInterface {
                                                      const int device_id,
                                                      std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
-  std::pair<const int8_t*, size_t> getAllColumnFragments(
+  std::vector<JoinColumn> getAllColumnFragments(
       const Analyzer::ColumnVar& hash_col,
       const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
       std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
@@ -161,15 +162,13 @@ class JoinHashTable : public JoinHashTableInterface {
   int reifyOneToManyForDevice(const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments, const int device_id);
   void checkHashJoinReplicationConstraint(const int table_id) const;
   int initHashTableForDevice(const ChunkKey& chunk_key,
-                             const int8_t* col_buff,
-                             const size_t num_elements,
+                             const std::vector<JoinColumn>& join_column_frags,
                              const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                              const Data_Namespace::MemoryLevel effective_memory_level,
                              std::pair<Data_Namespace::AbstractBuffer*, Data_Namespace::AbstractBuffer*>& buff_and_err,
                              const int device_id);
   void initOneToManyHashTable(const ChunkKey& chunk_key,
-                              const int8_t* col_buff,
-                              const size_t num_elements,
+                              const std::vector<JoinColumn>& join_column_frags,
                               const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                               const Data_Namespace::MemoryLevel effective_memory_level,
                               const int device_id);
@@ -179,13 +178,11 @@ class JoinHashTable : public JoinHashTableInterface {
   void putHashTableOnCpuToCache(const ChunkKey& chunk_key,
                                 const size_t num_elements,
                                 const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols);
-  int initHashTableOnCpu(const int8_t* col_buff,
-                         const size_t num_elements,
+  int initHashTableOnCpu(const std::vector<JoinColumn>& join_column_frags,
                          const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                          const int32_t hash_entry_count,
                          const int32_t hash_join_invalid_val);
-  void initOneToManyHashTableOnCpu(const int8_t* col_buff,
-                                   const size_t num_elements,
+  void initOneToManyHashTableOnCpu(const std::vector<JoinColumn>& join_column_frags,
                                    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
                                    const int32_t hash_entry_count,
                                    const int32_t hash_join_invalid_val);
@@ -205,12 +202,12 @@ class JoinHashTable : public JoinHashTableInterface {
 
   llvm::Value* codegenOneToManyHashJoin(const CompilationOptions&, const size_t);
 
-  std::pair<const int8_t*, size_t> fetchFragments(const Analyzer::ColumnVar* hash_col,
-                                                  const std::deque<Fragmenter_Namespace::FragmentInfo>& fragment_info,
-                                                  const Data_Namespace::MemoryLevel effective_memory_level,
-                                                  const int device_id,
-                                                  std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
-                                                  ThrustAllocator& dev_buff_owner);
+  std::vector<JoinColumn> fetchFragments(const Analyzer::ColumnVar* hash_col,
+                                         const std::deque<Fragmenter_Namespace::FragmentInfo>& fragment_info,
+                                         const Data_Namespace::MemoryLevel effective_memory_level,
+                                         const int device_id,
+                                         std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
+                                         ThrustAllocator& dev_buff_owner);
 
   bool isBitwiseEq() const;
 
@@ -230,9 +227,6 @@ class JoinHashTable : public JoinHashTableInterface {
   const RelAlgExecutionUnit& ra_exe_unit_;
   ColumnCacheMap& column_cache_;
   const int device_count_;
-  std::pair<const int8_t*, size_t> linearized_multifrag_column_;
-  std::mutex linearized_multifrag_column_mutex_;
-  RowSetMemoryOwner linearized_multifrag_column_owner_;
 
   struct JoinHashTableCacheKey {
     const ExpressionRange col_range;
@@ -294,4 +288,9 @@ std::deque<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
 
 const InputTableInfo& get_inner_query_info(const int inner_table_id, const std::vector<InputTableInfo>& query_infos);
 
+// Copies the fragments of a join column into a single device buffer owned by dev_buff_owner.
+JoinColumn transfer_join_column_frags_to_gpu(const std::vector<JoinColumn>& join_column_frags,
+                                             const size_t elem_width,
+                                             ThrustAllocator& dev_buff_owner);
+
 #endif  // QUERYENGINE_JOINHASHTABLE_H
@@ -16,6 +16,7 @@
 
 #include "MurmurHash.h"
 #include "CompareKeysInl.h"
+#include "SpatialGrid.h"
 
 DEVICE bool compare_to_key(const int8_t* entry, const int8_t* key, const size_t key_bytes) {
   for (size_t i = 0; i < key_bytes; ++i) {
@@ -117,3 +118,29 @@ extern "C" NEVER_INLINE DEVICE int64_t get_composite_key_index_64(const int64_t*
                                                                   const size_t entry_count) {
   return get_composite_key_index_impl(key, key_component_count, composite_key_dict, entry_count);
 }
+
+// Returns the cell of the grid built by SpatialJoinHashTable which contains the given point, -1 if
+// the point is null or outside of the extent of the inner boxes.
+extern "C" NEVER_INLINE DEVICE int64_t spatial_grid_cell(const int8_t* grid_buff,
+                                                         const int8_t* coords,
+                                                         const int64_t coords_size,
+                                                         const int32_t compression) {
+  if (coords_size < 2 * (compression == 1 ? 4 : 8)) {
+    return -1;
+  }
+  const auto grid = reinterpret_cast<const SpatialGridHeader*>(grid_buff);
+  const auto x_cell = spatial_grid_axis_cell(spatial_grid_decode_coord(coords, 0, compression),
+                                             grid->min_x,
+                                             grid->max_x,
+                                             grid->x_cells_per_unit,
+                                             grid->x_cells);
+  const auto y_cell = spatial_grid_axis_cell(spatial_grid_decode_coord(coords, 1, compression),
+                                             grid->min_y,
+                                             grid->max_y,
+                                             grid->y_cells_per_unit,
+                                             grid->y_cells);
+  if (x_cell < 0 || y_cell < 0) {
+    return -1;
+  }
+  return y_cell * grid->x_cells + x_cell;
+}
@@ -560,9 +560,8 @@ std::shared_ptr<ResultSet> Executor::execute(const Planner::RootPlan* root_plan,
   // capture the lock acquistion time
   auto clock_begin = timer_start();
   std::lock_guard<std::mutex> lock(execute_mutex_);
-  if (g_enable_dynamic_watchdog) {
-    resetInterrupt();
-  }
+  resetInterrupt();
+  QueryCancellationToken::ThreadScope query_token_scope(query_token_.get());
   ScopeGuard restore_metainfo_cache = [this] { clearMetaInfoCache(); };
   int64_t queue_time_ms = timer_stop(clock_begin);
   ScopeGuard row_set_holder = [this] { row_set_mem_owner_ = nullptr; };
@@ -631,7 +630,7 @@ std::shared_ptr<ResultSet> Executor::execute(const Planner::RootPlan* root_plan,
         throw std::runtime_error("Self joins not supported yet");
       }
       if (error_code == ERR_OUT_OF_TIME) {
-        if (!interrupted_)
+        if (!isInterrupted())
           throw std::runtime_error("Query execution has exceeded the time limit");
         error_code = ERR_INTERRUPTED;
       }
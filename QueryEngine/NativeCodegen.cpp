@@ -137,6 +137,9 @@ std::vector<std::pair<void*, void*>> Executor::getCodeFromCache(
     const CodeCacheKey& key,
     const std::map<CodeCacheKey, std::pair<CodeCacheVal, llvm::Module*>>& cache) {
   auto it = cache.find(key);
+  if (step_profile_) {
+    step_profile_->addCodeCacheLookup(it != cache.end());
+  }
   if (it != cache.end()) {
     delete cgen_state_->module_;
     cgen_state_->module_ = it->second.second;
@@ -288,6 +291,7 @@ declare i64 @baseline_hash_join_idx_32(i8*, i8*, i64, i64);
 declare i64 @baseline_hash_join_idx_64(i8*, i8*, i64, i64);
 declare i64 @get_composite_key_index_32(i32*, i64, i32*, i64);
 declare i64 @get_composite_key_index_64(i64*, i64, i64*, i64);
+declare i64 @spatial_grid_cell(i8*, i8*, i64, i32);
 declare i64 @agg_count_shared(i64*, i64);
 declare i64 @agg_count_skip_val_shared(i64*, i64, i64);
 declare i32 @agg_count_int32_shared(i32*, i32);
@@ -875,6 +879,12 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.push_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_PERCENTILE:
+        if (!agg_type_info.is_number()) {
+          throw std::runtime_error("APPROX_PERCENTILE is only valid on integer, decimal and floating point");
+        }
+        result.push_back("agg_approx_percentile");
+        break;
       default:
         CHECK(false);
     }
@@ -1025,6 +1035,12 @@ Executor::CompilationResult Executor::compileWorkUnit(const std::vector<InputTab
         throw QueryMustRunOnCpu();
       }
     }
+    // the digests live in host memory
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      if (target_info(target_expr).agg_kind == kAPPROX_PERCENTILE) {
+        throw QueryMustRunOnCpu();
+      }
+    }
   }
 
   if (co.device_type_ == ExecutorDeviceType::GPU &&
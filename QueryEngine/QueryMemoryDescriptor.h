@@ -38,6 +38,7 @@
 
 extern bool g_cluster;
 extern bool g_use_result_set;
+extern bool g_enable_partitioned_reduction;
 
 class Executor;
 class QueryExecutionContext;
@@ -145,6 +146,8 @@ struct QueryMemoryDescriptor {
 
   bool sortOnGpu() const;
 
+  size_t getReductionPartitionCount() const;
+
   size_t getKeyOffInBytes(const size_t bin, const size_t key_idx = 0) const;
   size_t getNextKeyOffInBytes(const size_t key_idx) const;
   size_t getColOffInBytes(const size_t bin, const size_t col_idx) const;
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryProfile.h"
+
+#include <glog/logging.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+bool g_enable_query_profile{false};
+
+StepProfile::StepProfile(const unsigned node_id, const std::string& node_kind)
+    : node_id_(node_id),
+      node_kind_(node_kind),
+      compile_us_(0),
+      code_cache_hits_(0),
+      code_cache_misses_(0),
+      skipped_fragments_(0),
+      reduction_us_(0),
+      kernels_(nullptr) {
+  for (size_t i = 0; i < 3; ++i) {
+    fetch_chunks_[i] = 0;
+    fetch_bytes_[i] = 0;
+    fetch_us_[i] = 0;
+  }
+}
+
+StepProfile::~StepProfile() {
+  auto kernel = kernels_.load();
+  while (kernel) {
+    const auto next = kernel->next;
+    delete kernel;
+    kernel = next;
+  }
+}
+
+void StepProfile::addCompilation(const int64_t us) {
+  compile_us_ += us;
+}
+
+void StepProfile::addCodeCacheLookup(const bool hit) {
+  if (hit) {
+    ++code_cache_hits_;
+  } else {
+    ++code_cache_misses_;
+  }
+}
+
+void StepProfile::addSkippedFragments(const size_t count) {
+  skipped_fragments_ += count;
+}
+
+void StepProfile::addChunkFetch(const Data_Namespace::MemoryLevel memory_level,
+                                const size_t chunks,
+                                const size_t bytes,
+                                const int64_t us) {
+  CHECK_LT(static_cast<size_t>(memory_level), size_t(3));
+  fetch_chunks_[memory_level] += chunks;
+  fetch_bytes_[memory_level] += bytes;
+  fetch_us_[memory_level] += us;
+}
+
+void StepProfile::addKernel(std::unique_ptr<KernelProfile> kernel) {
+  auto head = kernel.release();
+  head->next = kernels_.load();
+  while (!kernels_.compare_exchange_weak(head->next, head)) {
+  }
+}
+
+void StepProfile::addReduction(const int64_t us) {
+  reduction_us_ += us;
+}
+
+StepProfile* QueryProfile::startStep(const unsigned node_id, const std::string& node_kind) {
+  std::lock_guard<std::mutex> lock(steps_mutex_);
+  return startStepUnlocked(node_id, node_kind);
+}
+
+StepProfile* QueryProfile::currentStep() {
+  std::lock_guard<std::mutex> lock(steps_mutex_);
+  const auto it = current_steps_.find(std::this_thread::get_id());
+  if (it == current_steps_.end()) {
+    return startStepUnlocked(0, "");
+  }
+  return it->second;
+}
+
+StepProfile* QueryProfile::startStepUnlocked(const unsigned node_id, const std::string& node_kind) {
+  steps_.emplace_back(new StepProfile(node_id, node_kind));
+  current_steps_[std::this_thread::get_id()] = steps_.back().get();
+  return steps_.back().get();
+}
+
+namespace {
+
+const char* memory_level_name(const int memory_level) {
+  switch (memory_level) {
+    case Data_Namespace::DISK_LEVEL:
+      return "disk";
+    case Data_Namespace::CPU_LEVEL:
+      return "cpu";
+    case Data_Namespace::GPU_LEVEL:
+      return "gpu";
+    default:
+      CHECK(false);
+  }
+  return "";
+}
+
+struct ThreadTotals {
+  size_t kernel_count;
+  int64_t kernel_us;
+};
+
+struct StepKernels {
+  std::vector<const KernelProfile*> kernels;  // in completion order
+  std::vector<size_t> thread_indices;         // parallel to kernels
+  std::vector<ThreadTotals> thread_totals;
+};
+
+// Collects the kernels of a step and the kernel time per worker thread. Thread ids are
+// renumbered by first appearance, the raw ones mean nothing to a client.
+StepKernels get_step_kernels(const StepProfile& step) {
+  StepKernels step_kernels;
+  for (auto kernel = step.getKernels(); kernel; kernel = kernel->next) {
+    step_kernels.kernels.push_back(kernel);
+  }
+  std::reverse(step_kernels.kernels.begin(), step_kernels.kernels.end());
+  std::map<size_t, size_t> thread_index;
+  for (const auto kernel : step_kernels.kernels) {
+    const auto it_ok = thread_index.emplace(kernel->thread_id, step_kernels.thread_totals.size());
+    if (it_ok.second) {
+      step_kernels.thread_totals.push_back({0, 0});
+    }
+    step_kernels.thread_indices.push_back(it_ok.first->second);
+    auto& totals = step_kernels.thread_totals[it_ok.first->second];
+    ++totals.kernel_count;
+    totals.kernel_us += kernel->kernel_us;
+  }
+  return step_kernels;
+}
+
+}  // namespace
+
+std::string QueryProfile::toJson() const {
+  rapidjson::Document document(rapidjson::kObjectType);
+  auto& allocator = document.GetAllocator();
+  rapidjson::Value steps(rapidjson::kArrayType);
+  for (const auto& step : steps_) {
+    rapidjson::Value step_obj(rapidjson::kObjectType);
+    step_obj.AddMember("node_id", step->getNodeId(), allocator);
+    step_obj.AddMember("node", rapidjson::Value(step->getNodeKind().c_str(), allocator), allocator);
+    step_obj.AddMember("compile_us", step->getCompileUs(), allocator);
+    step_obj.AddMember("code_cache_hits", static_cast<uint64_t>(step->getCodeCacheHits()), allocator);
+    step_obj.AddMember("code_cache_misses", static_cast<uint64_t>(step->getCodeCacheMisses()), allocator);
+    step_obj.AddMember("skipped_fragments", static_cast<uint64_t>(step->getSkippedFragments()), allocator);
+    rapidjson::Value fetch(rapidjson::kObjectType);
+    for (int level = Data_Namespace::DISK_LEVEL; level <= Data_Namespace::GPU_LEVEL; ++level) {
+      const auto memory_level = static_cast<Data_Namespace::MemoryLevel>(level);
+      rapidjson::Value level_obj(rapidjson::kObjectType);
+      level_obj.AddMember("chunks", static_cast<uint64_t>(step->getFetchChunks(memory_level)), allocator);
+      level_obj.AddMember("bytes", static_cast<uint64_t>(step->getFetchBytes(memory_level)), allocator);
+      level_obj.AddMember("us", step->getFetchUs(memory_level), allocator);
+      fetch.AddMember(rapidjson::StringRef(memory_level_name(level)), level_obj, allocator);
+    }
+    step_obj.AddMember("chunk_fetch", fetch, allocator);
+    step_obj.AddMember("reduction_us", step->getReductionUs(), allocator);
+    const auto step_kernels = get_step_kernels(*step);
+    rapidjson::Value kernels_arr(rapidjson::kArrayType);
+    for (size_t i = 0; i < step_kernels.kernels.size(); ++i) {
+      const auto kernel = step_kernels.kernels[i];
+      rapidjson::Value kernel_obj(rapidjson::kObjectType);
+      kernel_obj.AddMember("device", rapidjson::StringRef(kernel->on_gpu ? "gpu" : "cpu"), allocator);
+      kernel_obj.AddMember("device_id", kernel->device_id, allocator);
+      rapidjson::Value frag_ids(rapidjson::kArrayType);
+      for (const auto frag_id : kernel->outer_fragment_ids) {
+        frag_ids.PushBack(static_cast<uint64_t>(frag_id), allocator);
+      }
+      kernel_obj.AddMember("fragments", frag_ids, allocator);
+      kernel_obj.AddMember("thread", static_cast<uint64_t>(step_kernels.thread_indices[i]), allocator);
+      kernel_obj.AddMember("fetch_bytes", static_cast<uint64_t>(kernel->fetch_bytes), allocator);
+      kernel_obj.AddMember("fetch_us", kernel->fetch_us, allocator);
+      kernel_obj.AddMember("kernel_us", kernel->kernel_us, allocator);
+      kernels_arr.PushBack(kernel_obj, allocator);
+    }
+    step_obj.AddMember("kernels", kernels_arr, allocator);
+    rapidjson::Value threads_arr(rapidjson::kArrayType);
+    for (const auto& totals : step_kernels.thread_totals) {
+      rapidjson::Value thread_obj(rapidjson::kObjectType);
+      thread_obj.AddMember("kernels", static_cast<uint64_t>(totals.kernel_count), allocator);
+      thread_obj.AddMember("kernel_us", totals.kernel_us, allocator);
+      threads_arr.PushBack(thread_obj, allocator);
+    }
+    step_obj.AddMember("threads", threads_arr, allocator);
+    steps.PushBack(step_obj, allocator);
+  }
+  document.AddMember("steps", steps, allocator);
+  document.AddMember("result_cache_hit", isResultCacheHit(), allocator);
+  document.AddMember("result_conversion_us", getResultConversionUs(), allocator);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  return buffer.GetString();
+}
+
+std::string QueryProfile::toString() const {
+  std::ostringstream oss;
+  if (isResultCacheHit()) {
+    oss << "Result set cache hit\n";
+  }
+  for (const auto& step : steps_) {
+    oss << "Step " << step->getNodeId();
+    if (!step->getNodeKind().empty()) {
+      oss << " (" << step->getNodeKind() << ")";
+    }
+    oss << "\n";
+    oss << "  compile: " << step->getCompileUs() << " us, code cache hits: " << step->getCodeCacheHits()
+        << ", misses: " << step->getCodeCacheMisses() << "\n";
+    oss << "  fragments skipped: " << step->getSkippedFragments() << "\n";
+    for (int level = Data_Namespace::DISK_LEVEL; level <= Data_Namespace::GPU_LEVEL; ++level) {
+      const auto memory_level = static_cast<Data_Namespace::MemoryLevel>(level);
+      if (step->getFetchChunks(memory_level)) {
+        oss << "  chunks from " << memory_level_name(level) << ": " << step->getFetchChunks(memory_level) << ", "
+            << step->getFetchBytes(memory_level) << " bytes, " << step->getFetchUs(memory_level) << " us\n";
+      }
+    }
+    const auto step_kernels = get_step_kernels(*step);
+    for (size_t i = 0; i < step_kernels.kernels.size(); ++i) {
+      const auto kernel = step_kernels.kernels[i];
+      oss << "  kernel " << (kernel->on_gpu ? "gpu" : "cpu") << kernel->device_id << " thread "
+          << step_kernels.thread_indices[i] << " fragments [";
+      for (size_t j = 0; j < kernel->outer_fragment_ids.size(); ++j) {
+        oss << (j ? ", " : "") << kernel->outer_fragment_ids[j];
+      }
+      oss << "]: fetch " << kernel->fetch_bytes << " bytes in " << kernel->fetch_us << " us, run " << kernel->kernel_us
+          << " us\n";
+    }
+    for (size_t i = 0; i < step_kernels.thread_totals.size(); ++i) {
+      const auto& totals = step_kernels.thread_totals[i];
+      oss << "  thread " << i << ": " << totals.kernel_count << " kernels, " << totals.kernel_us << " us\n";
+    }
+    oss << "  reduction: " << step->getReductionUs() << " us\n";
+  }
+  oss << "Result conversion: " << getResultConversionUs() << " us";
+  return oss.str();
+}
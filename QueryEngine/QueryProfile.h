@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    QueryProfile.h
+ * @brief   Per-query execution profile, returned by EXPLAIN ANALYZE.
+ *
+ * A profile has one entry per relational algebra step and, within a step, one entry per
+ * kernel (a fragment or a group of fragments run on one device). Kernels run concurrently
+ * and record into their step through atomics, no lock is taken on the execution path.
+ */
+
+#ifndef QUERYENGINE_QUERYPROFILE_H
+#define QUERYENGINE_QUERYPROFILE_H
+
+#include "../DataMgr/MemoryLevel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+extern bool g_enable_query_profile;  // attach a profile to every query result, not just EXPLAIN ANALYZE
+
+struct KernelProfile {
+  bool on_gpu;
+  int device_id;
+  std::vector<size_t> outer_fragment_ids;
+  size_t thread_id;
+  size_t fetch_bytes;
+  int64_t fetch_us;
+  int64_t kernel_us;
+  KernelProfile* next;  // intrusive list, see StepProfile::addKernel
+};
+
+class StepProfile {
+ public:
+  StepProfile(const unsigned node_id, const std::string& node_kind);
+  ~StepProfile();
+
+  void addCompilation(const int64_t us);
+  void addCodeCacheLookup(const bool hit);
+  void addSkippedFragments(const size_t count);
+  // Chunks served by the given memory level: buffer manager hits at the level the kernel runs at,
+  // or loads from a level below it.
+  void addChunkFetch(const Data_Namespace::MemoryLevel memory_level,
+                     const size_t chunks,
+                     const size_t bytes,
+                     const int64_t us);
+  // Takes ownership of the kernel, can be called from any thread.
+  void addKernel(std::unique_ptr<KernelProfile> kernel);
+  void addReduction(const int64_t us);
+
+  unsigned getNodeId() const { return node_id_; }
+  const std::string& getNodeKind() const { return node_kind_; }
+  int64_t getCompileUs() const { return compile_us_; }
+  size_t getCodeCacheHits() const { return code_cache_hits_; }
+  size_t getCodeCacheMisses() const { return code_cache_misses_; }
+  size_t getSkippedFragments() const { return skipped_fragments_; }
+  size_t getFetchChunks(const Data_Namespace::MemoryLevel memory_level) const { return fetch_chunks_[memory_level]; }
+  size_t getFetchBytes(const Data_Namespace::MemoryLevel memory_level) const { return fetch_bytes_[memory_level]; }
+  int64_t getFetchUs(const Data_Namespace::MemoryLevel memory_level) const { return fetch_us_[memory_level]; }
+  int64_t getReductionUs() const { return reduction_us_; }
+  // Only valid once all kernels of the step have finished, in reverse completion order.
+  const KernelProfile* getKernels() const { return kernels_; }
+
+ private:
+  StepProfile(const StepProfile&) = delete;
+  StepProfile& operator=(const StepProfile&) = delete;
+
+  const unsigned node_id_;
+  const std::string node_kind_;
+  std::atomic<int64_t> compile_us_;
+  std::atomic<size_t> code_cache_hits_;
+  std::atomic<size_t> code_cache_misses_;
+  std::atomic<size_t> skipped_fragments_;
+  std::atomic<size_t> fetch_chunks_[3];  // indexed by the memory level which served the chunks
+  std::atomic<size_t> fetch_bytes_[3];
+  std::atomic<int64_t> fetch_us_[3];
+  std::atomic<int64_t> reduction_us_;
+  std::atomic<KernelProfile*> kernels_;
+};
+
+class QueryProfile {
+ public:
+  QueryProfile() : result_cache_hit_(false), result_conversion_us_(0) {}
+
+  // Called by the thread running a step, before its work units. Independent steps run on
+  // different threads, each thread records into the step it started last.
+  StepProfile* startStep(const unsigned node_id, const std::string& node_kind);
+  // Work units which don't belong to a step (subqueries, legacy plans) get an anonymous one.
+  StepProfile* currentStep();
+
+  // The result came from the result set cache, no step ran.
+  void setResultCacheHit() { result_cache_hit_ = true; }
+  void addResultConversion(const int64_t us) { result_conversion_us_ += us; }
+
+  // Only valid once the query has finished, in the order the steps started.
+  const std::vector<std::unique_ptr<StepProfile>>& getSteps() const { return steps_; }
+  bool isResultCacheHit() const { return result_cache_hit_; }
+  int64_t getResultConversionUs() const { return result_conversion_us_; }
+
+  std::string toJson() const;
+  // Indented, human readable version for EXPLAIN ANALYZE.
+  std::string toString() const;
+
+ private:
+  StepProfile* startStepUnlocked(const unsigned node_id, const std::string& node_kind);
+
+  std::vector<std::unique_ptr<StepProfile>> steps_;
+  std::unordered_map<std::thread::id, StepProfile*> current_steps_;
+  std::mutex steps_mutex_;
+  bool result_cache_hit_;
+  std::atomic<int64_t> result_conversion_us_;
+};
+
+#endif  // QUERYENGINE_QUERYPROFILE_H
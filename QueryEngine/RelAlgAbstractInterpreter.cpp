@@ -579,7 +579,8 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 || (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_PERCENTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
@@ -1598,6 +1599,7 @@ class RelAlgAbstractInterpreter {
       for (auto column_arr_it = update_columns.Begin(); column_arr_it != update_columns.End(); ++column_arr_it) {
         target_column_list.push_back(column_arr_it->GetString());
       }
+      check_partition_column_not_updated(cat_, table_descriptor, target_column_list);
     }
 
     auto modify_node =
@@ -1711,6 +1713,23 @@ std::shared_ptr<const RelAlgNode> deserialize_ra_dag(const std::string& query_ra
   return ra_interpret(query_ast, cat, ra_executor);
 }
 
+// Rows go to the partition of their partition column value when they're inserted. An UPDATE of that
+// value would leave them in their old partition, where partition pruning no longer looks for them.
+void check_partition_column_not_updated(const Catalog_Namespace::Catalog& cat,
+                                        const TableDescriptor* td,
+                                        const ColumnNameList& target_columns) {
+  if (!table_is_range_partitioned(td)) {
+    return;
+  }
+  for (const auto& column_name : target_columns) {
+    const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+    if (cd && cd->columnId == td->partitionColumnId) {
+      throw std::runtime_error("UPDATE of partition column " + column_name + " of table " + td->tableName +
+                               " is not supported.");
+    }
+  }
+}
+
 // Prints the relational algebra as a tree; useful for debugging.
 std::string tree_string(const RelAlgNode* ra, const size_t indent) {
   std::string result = std::string(indent, ' ') + ra->toString() + "\n";
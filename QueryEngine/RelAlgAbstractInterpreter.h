@@ -1229,6 +1229,10 @@ std::shared_ptr<const RelAlgNode> deserialize_ra_dag(const std::string& query_ra
 
 std::string tree_string(const RelAlgNode*, const size_t indent = 0);
 
+void check_partition_column_not_updated(const Catalog_Namespace::Catalog& cat,
+                                        const TableDescriptor* td,
+                                        const ColumnNameList& target_columns);
+
 typedef std::vector<RexInput> RANodeOutput;
 
 RANodeOutput get_node_output(const RelAlgNode* ra_node);
@@ -183,3 +183,35 @@ std::vector<RaExecutionDesc> get_execution_descriptors(const std::vector<const R
 
   return descs;
 }
+
+std::vector<std::vector<size_t>> get_step_inputs(const std::vector<RaExecutionDesc>& exec_descs) {
+  std::unordered_map<const RelAlgNode*, size_t> step_of_body;
+  for (size_t i = 0; i < exec_descs.size(); ++i) {
+    step_of_body.emplace(exec_descs[i].getBody(), i);
+  }
+  std::vector<std::vector<size_t>> step_inputs(exec_descs.size());
+  for (size_t i = 0; i < exec_descs.size(); ++i) {
+    // nodes folded into the step (sort inputs, joins) are walked through until another
+    // step or a physical table is reached
+    std::vector<const RelAlgNode*> stack(1, exec_descs[i].getBody());
+    std::unordered_set<const RelAlgNode*> visited;
+    while (!stack.empty()) {
+      const auto node = stack.back();
+      stack.pop_back();
+      for (size_t input_idx = 0; input_idx < node->inputCount(); ++input_idx) {
+        const auto input = node->getInput(input_idx);
+        if (!visited.insert(input).second || dynamic_cast<const RelScan*>(input)) {
+          continue;
+        }
+        const auto it = step_of_body.find(input);
+        if (it != step_of_body.end()) {
+          CHECK_LT(it->second, i);
+          step_inputs[i].push_back(it->second);
+          continue;
+        }
+        stack.push_back(input);
+      }
+    }
+  }
+  return step_inputs;
+}
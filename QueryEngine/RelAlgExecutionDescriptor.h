@@ -135,6 +135,16 @@ class RaExecutionDesc {
     body_->setContextData(this);
   }
 
+  // Replaces the result with an empty one once no later step reads it.
+  void releaseResult() {
+    result_ = ExecutionResult(std::make_shared<ResultSet>(std::vector<TargetInfo>{},
+                                                          ExecutorDeviceType::CPU,
+                                                          QueryMemoryDescriptor{},
+                                                          nullptr,
+                                                          nullptr),
+                              {});
+  }
+
   const RelAlgNode* getBody() const { return body_; }
 
  private:
@@ -145,4 +155,8 @@ class RaExecutionDesc {
 std::vector<RaExecutionDesc> get_execution_descriptors(const RelAlgNode*);
 std::vector<RaExecutionDesc> get_execution_descriptors(const std::vector<const RelAlgNode*>&);
 
+// Dependency DAG between the steps of a sequence: for each step, the earlier steps whose
+// results it reads.
+std::vector<std::vector<size_t>> get_step_inputs(const std::vector<RaExecutionDesc>& exec_descs);
+
 #endif  // QUERYENGINE_RELALGEXECUTIONDESCRIPTOR_H
@@ -22,16 +22,26 @@
 #include "EquiJoinCondition.h"
 #include "ExecutionException.h"
 #include "ExpressionRewrite.h"
+#include "GroupBySpill.h"
 #include "InputMetadata.h"
 #include "QueryPhysicalInputsCollector.h"
 #include "RangeTableIndexVisitor.h"
+#include "RelAlgVisitor.h"
 #include "RexVisitor.h"
 
 #include "../Parser/ParserNode.h"
+#include "../Shared/lock_wait_stats.h"
 #include "../Shared/measure.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <numeric>
+#include <set>
 
 namespace {
 
@@ -104,6 +114,115 @@ void scanForTablesAndAggsInRelAlgSeqForRender(std::vector<RaExecutionDesc>& exec
   }
 }
 
+typedef std::unordered_set<const RexSubQuery*> SubQuerySet;
+
+// Subqueries directly used by the expressions of a plan, not the ones nested in them.
+class RexSubQueriesVisitor : public RexVisitor<SubQuerySet> {
+ public:
+  SubQuerySet visitSubQuery(const RexSubQuery* subquery) const override { return {subquery}; }
+
+ protected:
+  SubQuerySet aggregateResult(const SubQuerySet& aggregate, const SubQuerySet& next_result) const override {
+    auto result = aggregate;
+    result.insert(next_result.begin(), next_result.end());
+    return result;
+  }
+};
+
+class RelAlgSubQueriesVisitor : public RelAlgVisitor<SubQuerySet> {
+ public:
+  SubQuerySet visitCompound(const RelCompound* compound) const override {
+    SubQuerySet result;
+    for (size_t i = 0; i < compound->getScalarSourcesSize(); ++i) {
+      result = aggregateResult(result, visitor_.visit(compound->getScalarSource(i)));
+    }
+    if (compound->getFilterExpr()) {
+      result = aggregateResult(result, visitor_.visit(compound->getFilterExpr()));
+    }
+    return result;
+  }
+
+  SubQuerySet visitFilter(const RelFilter* filter) const override { return visitor_.visit(filter->getCondition()); }
+
+  SubQuerySet visitJoin(const RelJoin* join) const override {
+    return join->getCondition() ? visitor_.visit(join->getCondition()) : SubQuerySet{};
+  }
+
+  SubQuerySet visitMultiJoin(const RelMultiJoin* multi_join) const override {
+    SubQuerySet result;
+    for (size_t i = 0; i < multi_join->joinCount(); ++i) {
+      const auto condition = multi_join->getConditions()[i].get();
+      if (condition) {
+        result = aggregateResult(result, visitor_.visit(condition));
+      }
+    }
+    return result;
+  }
+
+  SubQuerySet visitLeftDeepInnerJoin(const RelLeftDeepInnerJoin* left_deep_inner_join) const override {
+    SubQuerySet result;
+    if (left_deep_inner_join->getInnerCondition()) {
+      result = visitor_.visit(left_deep_inner_join->getInnerCondition());
+    }
+    for (size_t nesting_level = 1; nesting_level < left_deep_inner_join->inputCount(); ++nesting_level) {
+      const auto outer_condition = left_deep_inner_join->getOuterCondition(nesting_level);
+      if (outer_condition) {
+        result = aggregateResult(result, visitor_.visit(outer_condition));
+      }
+    }
+    return result;
+  }
+
+  SubQuerySet visitProject(const RelProject* project) const override {
+    SubQuerySet result;
+    for (size_t i = 0; i < project->size(); ++i) {
+      result = aggregateResult(result, visitor_.visit(project->getProjectAt(i)));
+    }
+    return result;
+  }
+
+ protected:
+  SubQuerySet aggregateResult(const SubQuerySet& aggregate, const SubQuerySet& next_result) const override {
+    auto result = aggregate;
+    result.insert(next_result.begin(), next_result.end());
+    return result;
+  }
+
+ private:
+  RexSubQueriesVisitor visitor_;
+};
+
+// Steps which write to tables or feed a render run in order on the query's own executor.
+bool steps_can_run_concurrently(const std::vector<RaExecutionDesc>& exec_descs,
+                                const size_t exec_desc_count,
+                                const ExecutionOptions& eo,
+                                const RenderInfo* render_info) {
+  if (g_max_concurrent_steps < 2 || exec_desc_count < 3 || eo.just_explain || render_info) {
+    return false;
+  }
+  for (size_t i = 0; i < exec_desc_count; ++i) {
+    const auto body = exec_descs[i].getBody();
+    const auto compound = dynamic_cast<const RelCompound*>(body);
+    const auto project = dynamic_cast<const RelProject*>(body);
+    if (dynamic_cast<const RelModify*>(body) ||
+        (compound && (compound->isUpdateViaSelect() || compound->isDeleteViaSelect())) ||
+        (project && (project->isUpdateViaSelect() || project->isDeleteViaSelect()))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Only plain reads of persisted tables can be served from the result set cache. Queries
+// with subqueries are skipped since the table inputs of the subqueries aren't tracked.
+bool is_result_cacheable(const std::string& query_ra,
+                         const ExecutionOptions& eo,
+                         const RenderInfo* render_info,
+                         const std::vector<RexSubQuery*>& subqueries) {
+  return g_result_set_cache_bytes && !eo.just_explain && !eo.just_validate && !render_info && subqueries.empty() &&
+         query_ra.find("LogicalTableModify") == std::string::npos && query_ra.find("\"NOW\"") == std::string::npos;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeRelAlgQuery(const std::string& query_ra,
@@ -130,11 +249,11 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
   const auto ra = deserialize_ra_dag(query_ra, cat_, this);
   // capture the lock acquistion time
   auto clock_begin = timer_start();
-  std::lock_guard<std::mutex> lock(executor_->execute_mutex_);
+  const auto lock = timed_lock<std::unique_lock<std::mutex>>(executor_->execute_mutex_, LockWaitSite::EXECUTE_MUTEX);
   int64_t queue_time_ms = timer_stop(clock_begin);
-  if (g_enable_dynamic_watchdog) {
-    executor_->resetInterrupt();
-  }
+  executor_->resetInterrupt(eo.query_token);
+  // covers the work done on this thread outside of the work units, like sorting the result
+  QueryCancellationToken::ThreadScope query_token_scope(executor_->getQueryToken());
   ScopeGuard row_set_holder = [this, &render_info] {
     if (render_info) {
       // need to hold onto the RowSetMemOwner for potential
@@ -143,6 +262,7 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
     }
     executor_->row_set_mem_owner_ = nullptr;
     executor_->lit_str_dict_proxy_ = nullptr;
+    executor_->resetStepExecutors();
   };
   executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>();
   executor_->catalog_ = &cat_;
@@ -150,6 +270,21 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
   executor_->string_dictionary_generations_ = computeStringDictionaryGenerations(ra.get());
   executor_->table_generations_ = computeTableGenerations(ra.get());
   ScopeGuard restore_metainfo_cache = [this] { executor_->clearMetaInfoCache(); };
+  std::string result_cache_key;
+  std::vector<TableVersion> table_versions;
+  if (is_result_cacheable(query_ra, eo, render_info, subqueries_) && computeTableVersions(table_versions, ra.get())) {
+    result_cache_key = std::to_string(cat_.get_currentDB().dbId) + ":" +
+                       std::to_string(static_cast<int>(co.device_type_)) + ":" + query_ra;
+    std::vector<TargetMetaInfo> targets_meta;
+    auto cached_rows = ResultSetCache::get(result_cache_key, table_versions, targets_meta);
+    if (cached_rows) {
+      if (eo.query_profile) {
+        eo.query_profile->setResultCacheHit();
+      }
+      cached_rows->setQueueTime(queue_time_ms);
+      return {cached_rows, targets_meta};
+    }
+  }
   auto ed_list = get_execution_descriptors(ra.get());
   if (render_info) {  // save the table names for render queries
     // set whether the render will be done in-situ (in_situ_data = true) or
@@ -161,13 +296,12 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
     scanForTablesAndAggsInRelAlgSeqForRender(ed_list, render_info);
   }
   // Dispatch the subqueries first
-  for (auto subquery : subqueries_) {
-    // Execute the subquery and cache the result.
-    RelAlgExecutor ra_executor(executor_, cat_);
-    auto result = ra_executor.executeRelAlgSubQuery(subquery, co, eo);
-    subquery->setExecutionResult(std::make_shared<ExecutionResult>(result));
+  executeSubqueries(co, eo);
+  auto result = executeRelAlgSeq(ed_list, co, eo, render_info, queue_time_ms);
+  if (!result_cache_key.empty()) {
+    ResultSetCache::put(result_cache_key, table_versions, result.getRows(), result.getTargetsMeta());
   }
-  return executeRelAlgSeq(ed_list, co, eo, render_info, queue_time_ms);
+  return result;
 }
 
 namespace {
@@ -233,6 +367,26 @@ TableGenerations RelAlgExecutor::computeTableGenerations(const RelAlgNode* ra) {
   return table_generations;
 }
 
+bool RelAlgExecutor::computeTableVersions(std::vector<TableVersion>& table_versions, const RelAlgNode* ra) {
+  const auto phys_table_ids = get_physical_table_inputs(ra);
+  std::vector<int> table_ids(phys_table_ids.begin(), phys_table_ids.end());
+  std::sort(table_ids.begin(), table_ids.end());
+  for (const int table_id : table_ids) {
+    const auto td = cat_.getMetadataForTable(table_id);
+    CHECK(td);
+    if (td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
+      // temporary tables don't have an epoch to detect changes with
+      return false;
+    }
+    const auto epoch = cat_.getTableEpoch(cat_.get_currentDB().dbId, table_id);
+    if (epoch < 0) {
+      return false;
+    }
+    table_versions.push_back({table_id, epoch, executor_->getTableGeneration(table_id).tuple_count});
+  }
+  return true;
+}
+
 Executor* RelAlgExecutor::getExecutor() const {
   return executor_;
 }
@@ -272,9 +426,7 @@ void RelAlgExecutor::prepareLeafExecution(const AggregatedColRange& agg_col_rang
                                           const TableGenerations& table_generations) {
   // capture the lock acquistion time
   auto clock_begin = timer_start();
-  if (g_enable_dynamic_watchdog) {
-    executor_->resetInterrupt();
-  }
+  executor_->resetInterrupt();
   queue_time_ms_ = timer_stop(clock_begin);
   executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>();
   executor_->table_generations_ = table_generations;
@@ -282,6 +434,66 @@ void RelAlgExecutor::prepareLeafExecution(const AggregatedColRange& agg_col_rang
   executor_->string_dictionary_generations_ = string_dictionary_generations;
 }
 
+void RelAlgExecutor::executeSubqueries(const CompilationOptions& co, const ExecutionOptions& eo) {
+  // A subquery runs once the subqueries it uses are done. The ones which are ready at the
+  // same time are independent, they run concurrently on step executors.
+  std::vector<SubQuerySet> used_subqueries;
+  for (const auto subquery : subqueries_) {
+    used_subqueries.push_back(RelAlgSubQueriesVisitor().visit(subquery->getRelAlg()));
+  }
+  const bool run_concurrently = g_max_concurrent_steps > 1 && !executor_->isStepExecutor();
+  SubQuerySet done;
+  std::vector<bool> started(subqueries_.size(), false);
+  while (done.size() < subqueries_.size()) {
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < subqueries_.size(); ++i) {
+      if (!started[i] && std::all_of(used_subqueries[i].begin(),
+                                     used_subqueries[i].end(),
+                                     [&done](const RexSubQuery* used) { return done.count(used); })) {
+        ready.push_back(i);
+      }
+    }
+    CHECK(!ready.empty());
+    ready.resize(run_concurrently ? std::min(ready.size(), g_max_concurrent_steps) : size_t(1));
+    if (ready.size() == 1) {
+      const auto subquery = subqueries_[ready.front()];
+      // Execute the subquery and cache the result.
+      RelAlgExecutor ra_executor(executor_, cat_);
+      auto result = ra_executor.executeRelAlgSubQuery(subquery, co, eo);
+      subquery->setExecutionResult(std::make_shared<ExecutionResult>(result));
+    } else {
+      std::vector<std::future<ExecutionResult>> results;
+      for (const auto i : ready) {
+        const auto step_executor = executor_->acquireStepExecutor();
+        const auto subquery = subqueries_[i];
+        results.push_back(std::async(std::launch::async, [this, step_executor, subquery, &co, &eo] {
+          ScopeGuard release_step_executor = [this, step_executor] { executor_->releaseStepExecutor(step_executor); };
+          QueryCancellationToken::ThreadScope query_token_scope(step_executor->getQueryToken());
+          RelAlgExecutor ra_executor(step_executor, cat_);
+          return ra_executor.executeRelAlgSubQuery(subquery, co, eo);
+        }));
+      }
+      std::exception_ptr first_error;
+      for (size_t j = 0; j < ready.size(); ++j) {
+        try {
+          subqueries_[ready[j]]->setExecutionResult(std::make_shared<ExecutionResult>(results[j].get()));
+        } catch (...) {
+          if (!first_error) {
+            first_error = std::current_exception();
+          }
+        }
+      }
+      if (first_error) {
+        std::rethrow_exception(first_error);
+      }
+    }
+    for (const auto i : ready) {
+      started[i] = true;
+      done.insert(subqueries_[i]);
+    }
+  }
+}
+
 ExecutionResult RelAlgExecutor::executeRelAlgSubQuery(const RexSubQuery* subquery,
                                                       const CompilationOptions& co,
                                                       const ExecutionOptions& eo) {
@@ -303,9 +515,157 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(std::vector<RaExecutionDesc>& e
   time(&now_);
   CHECK(!exec_descs.empty());
   const auto exec_desc_count = eo.just_explain ? size_t(1) : exec_descs.size();
+  // A step runs as soon as the steps it reads from are done. Independent steps run
+  // concurrently on step executors, the last one and the ones which are ready alone run on
+  // this executor. Each step still hands its whole result to its consumers: they need the
+  // column ranges and fragment sizes of their inputs to compile, and a result is a single
+  // fragment temporary table.
+  // Intermediate results are released as soon as no later step reads them. A step whose
+  // result isn't self contained (lazy fetch) can point into its inputs' buffers, those
+  // stay pinned until the step's own result is released.
+  const auto step_inputs = get_step_inputs(exec_descs);
+  std::vector<size_t> pending_consumers(exec_descs.size(), 0);
+  std::vector<size_t> pin_count(exec_descs.size(), 0);
+  std::vector<std::vector<size_t>> pinned_inputs(exec_descs.size());
+  std::vector<size_t> pending_inputs(exec_desc_count, 0);
+  std::vector<std::vector<size_t>> consumers(exec_descs.size());
+  for (size_t i = 0; i < step_inputs.size(); ++i) {
+    for (const auto input : step_inputs[i]) {
+      ++pending_consumers[input];
+      if (i < exec_desc_count) {
+        ++pending_inputs[i];
+        consumers[input].push_back(i);
+      }
+    }
+  }
+  std::set<size_t> ready_steps;
   for (size_t i = 0; i < exec_desc_count; ++i) {
-    // only render on the last step
-    executeRelAlgStep(i, exec_descs, co, eo, (i == exec_desc_count - 1 ? render_info : nullptr), queue_time_ms);
+    if (!pending_inputs[i]) {
+      ready_steps.insert(i);
+    }
+  }
+  std::function<void(const size_t)> release_step = [&](const size_t step) {
+    temporary_tables_.erase(-static_cast<int>(exec_descs[step].getBody()->getId()));
+    exec_descs[step].releaseResult();
+    for (const auto input : pinned_inputs[step]) {
+      CHECK_GT(pin_count[input], size_t(0));
+      if (--pin_count[input] == 0 && pending_consumers[input] == 0) {
+        release_step(input);
+      }
+    }
+  };
+  auto finish_step = [&](const size_t i) {
+    const auto rows = boost::get<RowSetPtr>(&exec_descs[i].getResult().getDataPtr());
+    const bool pins_inputs = !rows || !*rows || !(*rows)->isSelfContained();
+    for (const auto input : step_inputs[i]) {
+      CHECK_GT(pending_consumers[input], size_t(0));
+      --pending_consumers[input];
+      if (pins_inputs) {
+        ++pin_count[input];
+        pinned_inputs[i].push_back(input);
+      } else if (pending_consumers[input] == 0 && pin_count[input] == 0) {
+        release_step(input);
+      }
+    }
+    for (const auto consumer : consumers[i]) {
+      CHECK_GT(pending_inputs[consumer], size_t(0));
+      if (--pending_inputs[consumer] == 0) {
+        ready_steps.insert(consumer);
+      }
+    }
+  };
+
+  const bool run_concurrently = steps_can_run_concurrently(exec_descs, exec_desc_count, eo, render_info) &&
+                                leaf_results_.empty() && !executor_->isStepExecutor();
+  std::mutex completion_mutex;
+  std::condition_variable completion_cv;
+  std::deque<std::pair<size_t, std::exception_ptr>> completed_steps;
+  std::vector<std::unique_ptr<RelAlgExecutor>> step_ra_executors(exec_desc_count);
+  std::exception_ptr first_error;
+  size_t running_count{0};
+  size_t finished_count{0};
+  // declared last, destroying it waits for the steps still running
+  std::vector<std::future<void>> running_steps;
+  while (finished_count < exec_desc_count) {
+    while (!first_error && !ready_steps.empty()) {
+      const auto i = *ready_steps.begin();
+      const bool is_last = i == exec_desc_count - 1;
+      const bool on_step_executor = run_concurrently && !is_last && !exec_descs[i].getBody()->isNop() &&
+                                    (running_count || ready_steps.size() > 1);
+      if (on_step_executor && running_count >= g_max_concurrent_steps) {
+        break;
+      }
+      ready_steps.erase(ready_steps.begin());
+      if (!on_step_executor) {
+        try {
+          // only render on the last step
+          executeRelAlgStep(i, exec_descs, co, eo, (is_last ? render_info : nullptr), queue_time_ms);
+        } catch (...) {
+          first_error = std::current_exception();
+          break;
+        }
+        finish_step(i);
+        ++finished_count;
+        continue;
+      }
+      // the step gets its own view of the temporary tables, this one changes while it runs
+      const auto step_executor = executor_->acquireStepExecutor();
+      step_ra_executors[i].reset(new RelAlgExecutor(step_executor, cat_));
+      auto step_ra_executor = step_ra_executors[i].get();
+      for (const auto& temporary_table : temporary_tables_) {
+        step_ra_executor->temporary_tables_.emplace(temporary_table.first, temporary_table.second);
+      }
+      step_ra_executor->now_ = now_;
+      step_executor->temporary_tables_ = &step_ra_executor->temporary_tables_;
+      ++running_count;
+      running_steps.push_back(std::async(std::launch::async, [&, i, step_executor, step_ra_executor] {
+        std::exception_ptr error;
+        try {
+          QueryCancellationToken::ThreadScope query_token_scope(step_executor->getQueryToken());
+          step_ra_executor->executeRelAlgStep(i, exec_descs, co, eo, nullptr, queue_time_ms);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        executor_->releaseStepExecutor(step_executor);
+        {
+          std::lock_guard<std::mutex> lock(completion_mutex);
+          completed_steps.emplace_back(i, error);
+        }
+        completion_cv.notify_one();
+      }));
+    }
+    if (!running_count) {
+      CHECK(first_error || finished_count == exec_desc_count || !ready_steps.empty());
+      if (first_error) {
+        break;
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(completion_mutex);
+    completion_cv.wait(lock, [&completed_steps] { return !completed_steps.empty(); });
+    auto completed = std::move(completed_steps);
+    completed_steps.clear();
+    lock.unlock();
+    for (const auto& step_and_error : completed) {
+      const auto i = step_and_error.first;
+      --running_count;
+      auto step_ra_executor = std::move(step_ra_executors[i]);
+      if (step_and_error.second) {
+        if (!first_error) {
+          first_error = step_and_error.second;
+        }
+        continue;
+      }
+      target_exprs_owned_.insert(target_exprs_owned_.end(),
+                                 step_ra_executor->target_exprs_owned_.begin(),
+                                 step_ra_executor->target_exprs_owned_.end());
+      addTemporaryTable(-exec_descs[i].getBody()->getId(), exec_descs[i].getResult().getDataPtr());
+      finish_step(i);
+      ++finished_count;
+    }
+  }
+  if (first_error) {
+    std::rethrow_exception(first_error);
   }
 
   return exec_descs[exec_desc_count - 1].getResult();
@@ -424,6 +784,38 @@ void RelAlgExecutor::executeUnfoldedMultiJoin(const RelAlgNode* user,
   addTemporaryTable(-user->getId(), exec_desc.getResult().getDataPtr());
 }
 
+namespace {
+
+const char* get_node_kind(const RelAlgNode* node) {
+  if (dynamic_cast<const RelCompound*>(node)) {
+    return "Compound";
+  }
+  if (dynamic_cast<const RelProject*>(node)) {
+    return "Project";
+  }
+  if (dynamic_cast<const RelAggregate*>(node)) {
+    return "Aggregate";
+  }
+  if (dynamic_cast<const RelFilter*>(node)) {
+    return "Filter";
+  }
+  if (dynamic_cast<const RelSort*>(node)) {
+    return "Sort";
+  }
+  if (dynamic_cast<const RelJoin*>(node)) {
+    return "Join";
+  }
+  if (dynamic_cast<const RelLogicalValues*>(node)) {
+    return "Values";
+  }
+  if (dynamic_cast<const RelModify*>(node)) {
+    return "Modify";
+  }
+  return "";
+}
+
+}  // namespace
+
 void RelAlgExecutor::executeRelAlgStep(const size_t i,
                                        std::vector<RaExecutionDesc>& exec_descs,
                                        const CompilationOptions& co,
@@ -437,6 +829,9 @@ void RelAlgExecutor::executeRelAlgStep(const size_t i,
     handleNop(body);
     return;
   }
+  if (eo.query_profile) {
+    eo.query_profile->startStep(body->getId(), get_node_kind(body));
+  }
   const ExecutionOptions eo_work_unit{eo.output_columnar_hint,
                                       eo.allow_multifrag,
                                       eo.just_explain,
@@ -445,7 +840,9 @@ void RelAlgExecutor::executeRelAlgStep(const size_t i,
                                       eo.jit_debug,
                                       eo.just_validate,
                                       eo.with_dynamic_watchdog,
-                                      eo.dynamic_watchdog_time_limit};
+                                      eo.dynamic_watchdog_time_limit,
+                                      eo.query_token,
+                                      eo.query_profile};
 
   if (render_info && !render_info->table_names.size() && leaf_results_.size()) {
     // Save the table names for render queries for distributed aggregation queries.
@@ -1103,7 +1500,8 @@ std::vector<TargetMetaInfo> get_modify_manipulated_targets_meta(ModifyManipulati
     // TODO(alex): remove the count distinct type fixup.
     targets_meta.emplace_back(
         manip_node->getTargetColumns()[i],
-        is_count_distinct(target_exprs[i]) ? SQLTypeInfo(kBIGINT, false) : target_exprs[i]->get_type_info());
+        is_count_distinct(target_exprs[i]) ? SQLTypeInfo(kBIGINT, false)
+                                           : get_decoded_type_info(target_exprs[i]->get_type_info()));
   }
 
   return targets_meta;
@@ -1133,6 +1531,7 @@ void RelAlgExecutor::executeUpdateViaCompound(const RelCompound* compound,
     throw std::runtime_error(
         "Unsupported update operation encountered.  (None-encoded string column updates are not supported.)");
   }
+  check_partition_column_not_updated(cat_, compound->getModifiedTableDescriptor(), compound->getTargetColumns());
 
   const auto work_unit = createModifyCompoundWorkUnit(compound, {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
@@ -1163,6 +1562,7 @@ void RelAlgExecutor::executeUpdateViaProject(const RelProject* project,
     throw std::runtime_error(
         "Unsupported update operation encountered.  (None-encoded string column updates are not supported.)");
   }
+  check_partition_column_not_updated(cat_, project->getModifiedTableDescriptor(), project->getTargetColumns());
 
   auto work_unit = createModifyProjectWorkUnit(project, {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
@@ -1545,6 +1945,28 @@ size_t groups_approx_upper_bound(const std::vector<InputTableInfo>& table_infos)
   return std::max(max_num_groups, size_t(1));
 }
 
+// The group by buffers are spilled as raw bytes, the targets can't hold pointers.
+bool can_spill_group_by(const RelAlgExecutionUnit& ra_exe_unit, const bool is_agg) {
+  if (!is_agg || ra_exe_unit.groupby_exprs.empty() || !ra_exe_unit.groupby_exprs.front() || ra_exe_unit.estimator) {
+    return false;
+  }
+  // only the outer table is scanned in batches, a self join would restrict the inner side too
+  const auto outer_table_id = ra_exe_unit.input_descs.front().getTableId();
+  for (size_t i = 1; i < ra_exe_unit.input_descs.size(); ++i) {
+    if (ra_exe_unit.input_descs[i].getTableId() == outer_table_id) {
+      return false;
+    }
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto agg_info = target_info(target_expr);
+    if (agg_info.is_distinct || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        agg_info.agg_kind == kAPPROX_PERCENTILE || is_real_str_or_array(agg_info)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool can_use_scan_limit(const RelAlgExecutionUnit& ra_exe_unit) {
   for (const auto target_expr : ra_exe_unit.target_exprs) {
     if (dynamic_cast<const Analyzer::AggExpr*>(target_expr)) {
@@ -1596,7 +2018,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
     const auto bitmap_sz_bits = arg_range.getIntMax() - arg_range.getIntMin() + 1;
     const auto sub_bitmap_count = get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
-    const auto error_rate = static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+    const auto error_rate = static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
       CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -1704,6 +2126,12 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(const RelAlgExecutor::WorkUnit&
     max_groups_buffer_entry_guess =
         2 * std::min(groups_approx_upper_bound(table_infos), getNDVEstimation(work_unit, is_agg, co, eo));
     CHECK_GT(max_groups_buffer_entry_guess, size_t(0));
+    if (max_groups_buffer_entry_guess > g_group_by_spill_entries && !render_info &&
+        can_spill_group_by(ra_exe_unit, is_agg) &&
+        (co.device_type_ == ExecutorDeviceType::CPU || !g_enable_watchdog || g_allow_cpu_retry)) {
+      return executeGroupBySpilled(
+          {ra_exe_unit, work_unit.body, max_groups_buffer_entry_guess}, targets_meta, is_agg, co, eo, queue_time_ms);
+    }
     result = {executor_->executeWorkUnit(&error_code,
                                          max_groups_buffer_entry_guess,
                                          is_agg,
@@ -1734,6 +2162,12 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(const RelAlgExecutor::WorkUnit&
   if (!error_code) {
     return result;
   }
+  if (isOutOfSlots(error_code) && !render_info && can_spill_group_by(ra_exe_unit, is_agg) &&
+      (co.device_type_ == ExecutorDeviceType::CPU || !g_enable_watchdog || g_allow_cpu_retry)) {
+    // the estimation was too low, don't grow the buffer and run again until it fits
+    return executeGroupBySpilled(
+        {ra_exe_unit, work_unit.body, max_groups_buffer_entry_guess}, targets_meta, is_agg, co, eo, queue_time_ms);
+  }
   handlePersistentError(error_code);
   return handleRetry(error_code,
                      {ra_exe_unit, work_unit.body, max_groups_buffer_entry_guess},
@@ -1878,7 +2312,9 @@ ExecutionResult RelAlgExecutor::handleRetry(const int32_t error_code_in,
                                    eo.jit_debug,
                                    false,
                                    eo.with_dynamic_watchdog,
-                                   eo.dynamic_watchdog_time_limit};
+                                   eo.dynamic_watchdog_time_limit,
+                                   eo.query_token,
+                                   eo.query_profile};
   ExecutionResult result{std::make_shared<ResultSet>(
                              std::vector<TargetInfo>{}, co.device_type_, QueryMemoryDescriptor{}, nullptr, executor_),
                          {}};
@@ -1936,6 +2372,10 @@ ExecutionResult RelAlgExecutor::handleRetry(const int32_t error_code_in,
       if (!error_code) {
         return result;
       }
+      if (isOutOfSlots(error_code) && can_spill_group_by(ra_exe_unit, is_agg)) {
+        return executeGroupBySpilled(
+            {ra_exe_unit, work_unit.body, max_groups_buffer_entry_guess}, targets_meta, is_agg, co_cpu, eo, queue_time_ms);
+      }
       handlePersistentError(error_code);
       // Even the conservative guess failed; it should only happen when we group
       // by a huge cardinality array. Maybe we should throw an exception instead?
@@ -1950,6 +2390,129 @@ ExecutionResult RelAlgExecutor::handleRetry(const int32_t error_code_in,
   return result;
 }
 
+// Computes a group by whose groups don't fit the --group-by-spill-entries budget in a
+// single scan of its input. The outer table is aggregated a batch of fragments at a time,
+// into buffers sized for the rows of the batch. GroupBySpill hash partitions the groups
+// of every batch on their key and spills the partitions which outgrow their share of the
+// budget under the data directory. Once the input is exhausted, each partition is read
+// back and reduced on its own; partitions have disjoint groups, their results are just
+// appended.
+ExecutionResult RelAlgExecutor::executeGroupBySpilled(const RelAlgExecutor::WorkUnit& work_unit,
+                                                      const std::vector<TargetMetaInfo>& targets_meta,
+                                                      const bool is_agg,
+                                                      const CompilationOptions& co,
+                                                      const ExecutionOptions& eo,
+                                                      const int64_t queue_time_ms) {
+  INJECT_TIMER(executeGroupBySpilled);
+  static const size_t max_partition_count{1024};
+  CompilationOptions co_cpu{ExecutorDeviceType::CPU, co.hoist_literals_, co.opt_level_, co.with_dynamic_watchdog_};
+  // spilling the entries of a batch requires the row-wise layout
+  ExecutionOptions eo_batch{false,
+                            false,
+                            false,
+                            eo.allow_loop_joins,
+                            eo.with_watchdog,
+                            eo.jit_debug,
+                            false,
+                            eo.with_dynamic_watchdog,
+                            eo.dynamic_watchdog_time_limit,
+                            eo.query_token,
+                            eo.query_profile};
+  const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
+  const auto ra_exe_unit = decide_approx_count_distinct_implementation(
+      work_unit.exe_unit, table_infos, executor_, co_cpu.device_type_, target_exprs_owned_);
+  const auto memory_budget_entries = std::max(g_group_by_spill_entries, size_t(1));
+  const auto& outer_fragments = table_infos.front().info.fragments;
+  // the input row count bounds the group count, a partition gets about a budget worth
+  const auto input_row_count = table_infos.front().info.getNumTuplesUpperBound();
+  const auto partition_count = std::min(
+      std::max((input_row_count + memory_budget_entries - 1) / memory_budget_entries, size_t(2)), max_partition_count);
+  GroupBySpill spill(boost::filesystem::path(cat_.get_basePath()) / "mapd_spill" / boost::filesystem::unique_path(),
+                     partition_count,
+                     memory_budget_entries);
+  std::vector<int64_t> target_init_vals;
+  for (size_t batch_start = 0; batch_start < outer_fragments.size();) {
+    auto batch_table_infos = table_infos;
+    auto& batch_outer_info = batch_table_infos.front().info;
+    batch_outer_info.fragments.clear();
+    size_t batch_row_count{0};
+    size_t batch_end{batch_start};
+    // at least one fragment, as many more as the budget allows
+    while (batch_end < outer_fragments.size() &&
+           (batch_end == batch_start ||
+            batch_row_count + outer_fragments[batch_end].getNumTuples() <= memory_budget_entries)) {
+      batch_row_count += outer_fragments[batch_end].getNumTuples();
+      batch_outer_info.fragments.push_back(outer_fragments[batch_end]);
+      ++batch_end;
+    }
+    batch_outer_info.setPhysicalNumTuples(batch_row_count);
+    batch_start = batch_end;
+    // owns the group by buffers of the batch, they're freed once the batch is partitioned
+    auto batch_row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+    int32_t error_code{0};
+    size_t max_groups_buffer_entry_guess{std::max(2 * batch_outer_info.getFragmentNumTuplesUpperBound(), size_t(1))};
+    const auto batch_result = executor_->executeWorkUnit(&error_code,
+                                                         max_groups_buffer_entry_guess,
+                                                         is_agg,
+                                                         batch_table_infos,
+                                                         ra_exe_unit,
+                                                         co_cpu,
+                                                         eo_batch,
+                                                         cat_,
+                                                         batch_row_set_mem_owner,
+                                                         nullptr,
+                                                         true);
+    // a kernel sees at most one fragment worth of rows, only a join can overflow it
+    if (isOutOfSlots(error_code)) {
+      throw std::runtime_error("Query ran out of output slots in the result");
+    }
+    if (error_code) {
+      throw std::runtime_error(getErrorMessageFromCode(error_code));
+    }
+    const auto& batch_rows = boost::get<RowSetPtr>(batch_result);
+    CHECK(batch_rows);
+    if (!batch_rows->getStorage()) {
+      continue;
+    }
+    const auto& batch_query_mem_desc = batch_rows->getQueryMemDesc();
+    if (batch_query_mem_desc.hash_type != GroupByColRangeType::MultiCol || batch_query_mem_desc.output_columnar) {
+      throw std::runtime_error("Query ran out of output slots in the result");
+    }
+    target_init_vals = executor_->plan_state_->init_agg_vals_;
+    spill.add(*batch_rows);
+  }
+  LOG(INFO) << "Group by over " << input_row_count << " rows spilled " << spill.getSpilledBytes() << " bytes in "
+            << partition_count << " partitions";
+  RowSetPtr merged_rows;
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    auto rows = spill.reducePartition(partition_idx, target_init_vals, executor_->row_set_mem_owner_, executor_);
+    if (!rows) {
+      continue;
+    }
+    if (!merged_rows) {
+      merged_rows = rows;
+    } else {
+      merged_rows->append(*rows);
+    }
+  }
+  if (!merged_rows) {
+    std::vector<TargetInfo> targets;
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      targets.push_back(target_info(target_expr));
+    }
+    merged_rows =
+        std::make_shared<ResultSet>(targets, ExecutorDeviceType::CPU, QueryMemoryDescriptor{}, nullptr, executor_);
+  }
+  ExecutionResult result{merged_rows, targets_meta};
+  result.setQueueTime(queue_time_ms);
+  return result;
+}
+
+bool RelAlgExecutor::isOutOfSlots(const int32_t error_code) {
+  // the generated code reports a full group by buffer as the negated row position
+  return error_code < 0 || error_code == Executor::ERR_OUT_OF_SLOTS;
+}
+
 void RelAlgExecutor::handlePersistentError(const int32_t error_code) {
   if (error_code == Executor::ERR_SPECULATIVE_TOP_OOM) {
     throw SpeculativeTopNFailed();
@@ -1973,6 +2536,8 @@ std::string RelAlgExecutor::getErrorMessageFromCode(const int32_t error_code) {
       return "Self joins not supported yet";
     case Executor::ERR_OUT_OF_CPU_MEM:
       return "Not enough host memory to execute the query";
+    case Executor::ERR_OUT_OF_SLOTS:
+      return "Query ran out of output slots in the result";
     case Executor::ERR_OVERFLOW_OR_UNDERFLOW:
       return "Overflow or underflow";
     case Executor::ERR_OUT_OF_TIME:
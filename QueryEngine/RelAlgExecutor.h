@@ -21,6 +21,7 @@
 #include "Execute.h"
 #include "QueryRewrite.h"
 #include "RelAlgExecutionDescriptor.h"
+#include "ResultSetCache.h"
 #include "SpeculativeTopN.h"
 #include "StreamingTopN.h"
 #include "../Shared/scope.h"
@@ -93,6 +94,9 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   TableGenerations computeTableGenerations(const RelAlgNode* ra);
 
+  // Epoch and tuple count of every input table, false if one of them isn't persisted.
+  bool computeTableVersions(std::vector<TableVersion>& table_versions, const RelAlgNode* ra);
+
   Executor* getExecutor() const;
 
  private:
@@ -101,6 +105,8 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                             const ExecutionOptions& eo,
                                             RenderInfo* render_info);
 
+  void executeSubqueries(const CompilationOptions& co, const ExecutionOptions& eo);
+
   void executeRelAlgStep(const size_t step_idx,
                          std::vector<RaExecutionDesc>&,
                          const CompilationOptions&,
@@ -212,6 +218,13 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                 const ExecutionOptions& eo,
                                 const int64_t queue_time_ms);
 
+  ExecutionResult executeGroupBySpilled(const RelAlgExecutor::WorkUnit& work_unit,
+                                        const std::vector<TargetMetaInfo>& targets_meta,
+                                        const bool is_agg,
+                                        const CompilationOptions& co,
+                                        const ExecutionOptions& eo,
+                                        const int64_t queue_time_ms);
+
   ExecutionResult handleRetry(const int32_t error_code_in,
                               const RelAlgExecutor::WorkUnit& work_unit,
                               const std::vector<TargetMetaInfo>& targets_meta,
@@ -220,6 +233,8 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                               const ExecutionOptions& eo,
                               const int64_t queue_time_ms);
 
+  static bool isOutOfSlots(const int32_t error_code);
+
   static void handlePersistentError(const int32_t error_code);
 
   static std::string getErrorMessageFromCode(const int32_t error_code);
@@ -183,6 +183,36 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateScalarRex(const RexSc
   return nullptr;
 }
 
+namespace {
+
+// The second argument of APPROX_PERCENTILE as a DOUBLE constant, 0.5 for APPROX_MEDIAN.
+std::shared_ptr<Analyzer::Constant> translate_percentile_fraction(const std::shared_ptr<Analyzer::Expr>& fraction_expr) {
+  Datum d;
+  d.doubleval = 0.5;
+  if (!fraction_expr) {
+    return makeExpr<Analyzer::Constant>(kDOUBLE, false, d);
+  }
+  // decimal literals may come wrapped in a cast to their inferred type
+  auto fraction_literal = std::dynamic_pointer_cast<Analyzer::Constant>(fraction_expr);
+  const auto cast_expr = std::dynamic_pointer_cast<Analyzer::UOper>(fraction_expr);
+  if (!fraction_literal && cast_expr && cast_expr->get_optype() == kCAST) {
+    fraction_literal = std::dynamic_pointer_cast<Analyzer::Constant>(cast_expr->get_own_operand());
+  }
+  if (fraction_literal && fraction_literal->get_type_info().is_number() && !fraction_literal->get_is_null()) {
+    const auto fraction_double = std::dynamic_pointer_cast<Analyzer::Constant>(
+        fraction_literal->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, false)));
+    CHECK(fraction_double);
+    const auto fraction = fraction_double->get_constval().doubleval;
+    if (fraction >= 0 && fraction <= 1) {
+      d.doubleval = fraction;
+      return makeExpr<Analyzer::Constant>(kDOUBLE, false, d);
+    }
+  }
+  throw std::runtime_error("APPROX_PERCENTILE's second parameter should be a numeric literal between 0 and 1");
+}
+
+}  // namespace
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
     const RexAgg* rex,
     const std::vector<std::shared_ptr<Analyzer::Expr>>& scalar_sources) {
@@ -190,23 +220,29 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, static_cast<ssize_t>(scalar_sources.size()));
     CHECK_LE(rex->size(), 2);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kSMALLINT || err_rate->get_constval().smallintval < 1 ||
-          err_rate->get_constval().smallintval > 100) {
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(scalar_sources[rex->getOperand(1)]);
+      if (!arg1 || arg1->get_type_info().get_type() != kSMALLINT || arg1->get_constval().smallintval < 1 ||
+          arg1->get_constval().smallintval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between 1 and 100");
       }
     }
+    if (agg_kind == kAPPROX_PERCENTILE) {
+      if (!arg_expr->get_type_info().is_number()) {
+        throw std::runtime_error("APPROX_PERCENTILE is only valid on integer, decimal and floating point");
+      }
+      arg1 = translate_percentile_fraction(rex->size() == 2 ? scalar_sources[rex->getOperand(1)] : nullptr);
+    }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(const RexLiteral* rex_literal) {
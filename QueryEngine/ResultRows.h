@@ -28,6 +28,7 @@
 #include "OutputBufferInitialization.h"
 #include "QueryMemoryDescriptor.h"
 #include "ResultSet.h"
+#include "TDigest.h"
 #include "TargetValue.h"
 
 #include "../Analyzer/Analyzer.h"
@@ -195,6 +196,19 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  void addTDigest(TDigest* t_digest) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    t_digests_.push_back(t_digest);
+  }
+
+  // Once the kernels and the reduction are done, so that reading a digest has no side effects.
+  void flushTDigests() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    for (auto t_digest : t_digests_) {
+      t_digest->flush();
+    }
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
@@ -244,6 +258,23 @@ class RowSetMemoryOwner : boost::noncopyable {
     return lit_str_dict_proxy_.get();
   }
 
+  // Copies the string dictionary proxies, transient strings included, into an owner which doesn't
+  // share anything else with this one. Returns the bytes taken by the copied transient strings.
+  size_t copyStringDictsTo(RowSetMemoryOwner& that) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    std::lock_guard<std::mutex> that_lock(that.state_mutex_);
+    CHECK(that.str_dict_proxy_owned_.empty());
+    size_t bytes{0};
+    for (const auto& dict_proxy : str_dict_proxy_owned_) {
+      auto str_dict_proxy = new StringDictionaryProxy(*dict_proxy.second);
+      that.str_dict_proxy_owned_.emplace(dict_proxy.first, str_dict_proxy);
+      bytes += str_dict_proxy->transientBytes();
+    }
+    // literals are immutable once the query is compiled, the proxy can be shared
+    that.lit_str_dict_proxy_ = lit_str_dict_proxy_;
+    return bytes;
+  }
+
   void addColBuffer(const void* col_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     col_buffers_.push_back(const_cast<void*>(col_buffer));
@@ -258,6 +289,9 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
+    for (auto t_digest : t_digests_) {
+      delete t_digest;
+    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -279,6 +313,7 @@ class RowSetMemoryOwner : boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<TDigest*> t_digests_;
   std::vector<int64_t*> group_by_buffers_;
   std::list<std::string> strings_;
   std::list<std::vector<int64_t>> arrays_;
@@ -306,7 +341,7 @@ inline TargetInfo target_info(const PointerType target_expr) {
   if (!agg_expr) {
     return {false,
             kMIN,
-            target_expr ? target_expr->get_type_info() : SQLTypeInfo(kBIGINT, notnull),
+            target_expr ? get_decoded_type_info(target_expr->get_type_info()) : SQLTypeInfo(kBIGINT, notnull),
             SQLTypeInfo(kNULLT, false),
             false,
             false};
@@ -320,7 +355,7 @@ inline TargetInfo target_info(const PointerType target_expr) {
         true, kCOUNT, SQLTypeInfo(g_bigint_count ? kBIGINT : kINT, notnull), SQLTypeInfo(kNULLT, false), false, false};
   }
 
-  const auto& agg_arg_ti = agg_arg->get_type_info();
+  const auto agg_arg_ti = get_decoded_type_info(agg_arg->get_type_info());
   bool is_distinct{false};
   if (agg_expr->get_aggtype() == kCOUNT) {
     is_distinct = agg_expr->get_is_distinct();
@@ -329,7 +364,7 @@ inline TargetInfo target_info(const PointerType target_expr) {
   return {true,
           agg_expr->get_aggtype(),
           agg_type == kCOUNT ? SQLTypeInfo((is_distinct || g_bigint_count) ? kBIGINT : kINT, notnull)
-                             : (agg_type == kAVG ? agg_arg_ti : agg_expr->get_type_info()),
+                             : (agg_type == kAVG ? agg_arg_ti : get_decoded_type_info(agg_expr->get_type_info())),
           agg_arg_ti,
           !agg_arg_ti.get_notnull(),
           is_distinct};
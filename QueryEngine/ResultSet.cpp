@@ -24,6 +24,7 @@
 
 #include "ResultSet.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DynamicWatchdog.h"
 #include "Execute.h"
 #include "InPlaceSort.h"
 #include "OutputBufferInitialization.h"
@@ -32,6 +33,7 @@
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
 #include "SqlTypesLayout.h"
+#include "TDigest.h"
 
 #include <algorithm>
 #include <bitset>
@@ -42,9 +44,14 @@ ResultSetStorage::ResultSetStorage(const std::vector<TargetInfo>& targets,
                                    const QueryMemoryDescriptor& query_mem_desc,
                                    int8_t* buff,
                                    const bool buff_is_provided)
-    : targets_(targets), query_mem_desc_(query_mem_desc), buff_(buff), buff_is_provided_(buff_is_provided) {
+    : targets_(targets),
+      query_mem_desc_(query_mem_desc),
+      buff_(buff),
+      buff_is_provided_(buff_is_provided),
+      row_set_mem_owner_(nullptr) {
   for (const auto& target_info : targets_) {
-    if (target_info.agg_kind == kCOUNT || target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+    if (target_info.agg_kind == kCOUNT || target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_PERCENTILE) {
       target_init_vals_.push_back(0);
       continue;
     }
@@ -90,6 +97,7 @@ ResultSet::ResultSet(const std::vector<TargetInfo>& targets,
       row_set_mem_owner_(row_set_mem_owner),
       queue_time_ms_(0),
       render_time_ms_(0),
+      from_result_cache_(false),
       executor_(executor),
       estimator_buffer_(nullptr),
       host_estimator_buffer_(nullptr),
@@ -122,6 +130,7 @@ ResultSet::ResultSet(const std::vector<TargetInfo>& targets,
       row_set_mem_owner_(row_set_mem_owner),
       queue_time_ms_(0),
       render_time_ms_(0),
+      from_result_cache_(false),
       executor_(executor),
       lazy_fetch_info_(lazy_fetch_info),
       col_buffers_{col_buffers},
@@ -146,6 +155,7 @@ ResultSet::ResultSet(const std::shared_ptr<const Analyzer::NDVEstimator> estimat
       device_id_(device_id),
       query_mem_desc_{},
       crt_row_buff_idx_(0),
+      from_result_cache_(false),
       estimator_(estimator),
       estimator_buffer_(nullptr),
       host_estimator_buffer_(nullptr),
@@ -170,6 +180,7 @@ ResultSet::ResultSet(const std::string& explanation)
       fetched_so_far_(0),
       queue_time_ms_(0),
       render_time_ms_(0),
+      from_result_cache_(false),
       estimator_buffer_(nullptr),
       host_estimator_buffer_(nullptr),
       none_encoded_strings_valid_(false),
@@ -187,6 +198,7 @@ ResultSet::ResultSet(const std::string& image_bytes,
       fetched_so_far_(0),
       queue_time_ms_(queue_time_ms),
       render_time_ms_(render_time_ms),
+      from_result_cache_(false),
       estimator_buffer_(nullptr),
       host_estimator_buffer_(nullptr),
       none_encoded_strings_valid_(false),
@@ -202,6 +214,11 @@ ResultSet::~ResultSet() {
       free(storage_->getUnderlyingBuffer());
     }
   }
+  for (auto& storage : appended_storage_) {
+    if (storage && !storage->buff_is_provided_) {
+      free(storage->getUnderlyingBuffer());
+    }
+  }
   if (host_estimator_buffer_) {
     CHECK(device_type_ == ExecutorDeviceType::CPU || estimator_buffer_);
     free(host_estimator_buffer_);
@@ -217,12 +234,14 @@ const ResultSetStorage* ResultSet::allocateStorage() const {
   OOM_TRACE_PUSH(+": size " + std::to_string(query_mem_desc_.getBufferSizeBytes(device_type_)));
   auto buff = static_cast<int8_t*>(checked_malloc(query_mem_desc_.getBufferSizeBytes(device_type_)));
   storage_.reset(new ResultSetStorage(targets_, query_mem_desc_, buff, false));
+  storage_->row_set_mem_owner_ = row_set_mem_owner_.get();
   return storage_.get();
 }
 
 const ResultSetStorage* ResultSet::allocateStorage(int8_t* buff, const std::vector<int64_t>& target_init_vals) const {
   CHECK(buff);
   storage_.reset(new ResultSetStorage(targets_, query_mem_desc_, buff, true));
+  storage_->row_set_mem_owner_ = row_set_mem_owner_.get();
   storage_->target_init_vals_ = target_init_vals;
   return storage_.get();
 }
@@ -232,10 +251,55 @@ const ResultSetStorage* ResultSet::allocateStorage(const std::vector<int64_t>& t
   OOM_TRACE_PUSH(+": size " + std::to_string(query_mem_desc_.getBufferSizeBytes(device_type_)));
   auto buff = static_cast<int8_t*>(checked_malloc(query_mem_desc_.getBufferSizeBytes(device_type_)));
   storage_.reset(new ResultSetStorage(targets_, query_mem_desc_, buff, false));
+  storage_->row_set_mem_owner_ = row_set_mem_owner_.get();
   storage_->target_init_vals_ = target_init_vals;
   return storage_.get();
 }
 
+bool ResultSet::isSelfContained() const {
+  return storage_ && appended_storage_.empty() && !just_explain_ && !estimator_ && lazy_fetch_info_.empty() &&
+         col_buffers_.empty() && chunks_.empty() && chunk_iters_.empty() && literal_buffers_.empty() &&
+         !none_encoded_strings_valid_;
+}
+
+std::shared_ptr<ResultSet> ResultSet::copy() const {
+  return copy(row_set_mem_owner_);
+}
+
+bool ResultSet::hasOwnerState() const {
+  for (const auto& target_info : targets_) {
+    if (is_distinct_target(target_info) || (target_info.is_agg && target_info.agg_kind == kAPPROX_PERCENTILE)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<ResultSet> ResultSet::copyWithOwnMemory(size_t& owner_bytes) const {
+  CHECK(!hasOwnerState());
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  owner_bytes += row_set_mem_owner_->copyStringDictsTo(*row_set_mem_owner);
+  return copy(row_set_mem_owner);
+}
+
+std::shared_ptr<ResultSet> ResultSet::copy(const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner) const {
+  CHECK(isSelfContained());
+  auto copied = std::make_shared<ResultSet>(targets_, device_type_, query_mem_desc_, row_set_mem_owner, executor_);
+  const auto buffer_size = storage_->query_mem_desc_.getBufferSizeBytes(device_type_);
+  auto buff = static_cast<int8_t*>(checked_malloc(buffer_size));
+  memcpy(buff, storage_->buff_, buffer_size);
+  copied->storage_.reset(new ResultSetStorage(targets_, storage_->query_mem_desc_, buff, false));
+  copied->storage_->row_set_mem_owner_ = row_set_mem_owner.get();
+  copied->storage_->target_init_vals_ = storage_->target_init_vals_;
+  copied->storage_->count_distinct_sets_mapping_ = storage_->count_distinct_sets_mapping_;
+  copied->drop_first_ = drop_first_;
+  copied->keep_first_ = keep_first_;
+  copied->permutation_ = permutation_;
+  copied->geo_return_type_ = geo_return_type_;
+  copied->cached_row_count_ = cached_row_count_.load();
+  return copied;
+}
+
 size_t ResultSet::getCurrentRowBufferIndex() const {
   if (crt_row_buff_idx_ == 0) {
     throw std::runtime_error("current row buffer iteration index is undefined");
@@ -503,6 +567,9 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries, const
   }
 
   permutation_ = initPermutationBuffer(0, 1);
+  if (dynamic_watchdog()) {
+    throw_query_interrupted("sort");
+  }
 
   auto compare = createComparator(order_entries, use_heap);
 
@@ -534,6 +601,7 @@ std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start, const
   const auto total_entries = query_mem_desc_.entry_count + query_mem_desc_.entry_count_small;
   permutation.reserve(total_entries / step);
   for (size_t i = start; i < query_mem_desc_.entry_count + query_mem_desc_.entry_count_small; i += step) {
+    check_query_interrupt(i / step, "sort");
     const auto storage_lookup_result = findStorage(i);
     const auto lhs_storage = storage_lookup_result.storage_ptr;
     const auto off = storage_lookup_result.fixedup_entry_idx;
@@ -551,10 +619,12 @@ const std::vector<uint32_t>& ResultSet::getPermutationBuffer() const {
 
 void ResultSet::parallelTop(const std::list<Analyzer::OrderEntry>& order_entries, const size_t top_n) {
   const size_t step = cpu_threads();
+  const auto query_token = QueryCancellationToken::current();
   std::vector<std::vector<uint32_t>> strided_permutations(step);
   std::vector<std::future<void>> init_futures;
   for (size_t start = 0; start < step; ++start) {
-    init_futures.emplace_back(std::async(std::launch::async, [this, start, step, &strided_permutations] {
+    init_futures.emplace_back(std::async(std::launch::async, [this, start, step, &strided_permutations, query_token] {
+      QueryCancellationToken::ThreadScope query_token_scope(query_token);
       strided_permutations[start] = initPermutationBuffer(start, step);
     }));
   }
@@ -564,6 +634,9 @@ void ResultSet::parallelTop(const std::list<Analyzer::OrderEntry>& order_entries
   for (auto& init_future : init_futures) {
     init_future.get();
   }
+  if (dynamic_watchdog()) {
+    throw_query_interrupted("sort");
+  }
   auto compare = createComparator(order_entries, true);
   std::vector<std::future<void>> top_futures;
   for (auto& strided_permutation : strided_permutations) {
@@ -650,6 +723,24 @@ std::function<bool(const uint32_t, const uint32_t)> ResultSet::createComparator(
           getColumnInternal(lhs_storage->buff_, fixedup_lhs, order_entry.tle_no - 1, lhs_storage_lookup_result);
       const auto rhs_v =
           getColumnInternal(rhs_storage->buff_, fixedup_rhs, order_entry.tle_no - 1, rhs_storage_lookup_result);
+      if (UNLIKELY(agg_info.is_agg && agg_info.agg_kind == kAPPROX_PERCENTILE)) {
+        CHECK(lhs_v.isInt() && rhs_v.isInt());
+        const auto lhs_digest = reinterpret_cast<TDigest*>(lhs_v.i1);
+        const auto rhs_digest = reinterpret_cast<TDigest*>(rhs_v.i1);
+        const double lhs_dval = lhs_digest ? lhs_digest->quantile() : NAN;
+        const double rhs_dval = rhs_digest ? rhs_digest->quantile() : NAN;
+        if (std::isnan(lhs_dval) || std::isnan(rhs_dval)) {
+          if (std::isnan(lhs_dval) && std::isnan(rhs_dval)) {
+            return false;
+          }
+          return std::isnan(lhs_dval) == (use_heap ? !order_entry.nulls_first : order_entry.nulls_first);
+        }
+        if (lhs_dval == rhs_dval) {
+          continue;
+        }
+        const bool use_desc_cmp = use_heap ? !order_entry.is_desc : order_entry.is_desc;
+        return use_desc_cmp ? lhs_dval > rhs_dval : lhs_dval < rhs_dval;
+      }
       if (UNLIKELY(isNull(entry_ti, lhs_v, float_argument_input) && isNull(entry_ti, rhs_v, float_argument_input))) {
         return false;
       }
@@ -115,6 +115,11 @@ class ResultSetStorage {
                               const size_t that_entry_count,
                               const ResultSetStorage& that) const;
 
+  void reduceBaselinePartitioned(int8_t* this_buff,
+                                 const int8_t* that_buff,
+                                 const ResultSetStorage& that,
+                                 const size_t partition_count) const;
+
   void reduceOneEntrySlotsBaseline(int64_t* this_entry_slots,
                                    const int64_t* that_buff,
                                    const size_t that_entry_idx,
@@ -150,6 +155,8 @@ class ResultSetStorage {
                                   const size_t target_logical_idx,
                                   const ResultSetStorage& that) const;
 
+  void reduceOneApproxPercentileSlot(int8_t* this_ptr1, const int8_t* that_ptr1) const;
+
   void fillOneEntryRowWise(const std::vector<int64_t>& entry);
 
   void initializeRowWise() const;
@@ -172,6 +179,9 @@ class ResultSetStorage {
   // re-route the pointers in the result set received over the wire to this
   // machine address-space. Not efficient at all, just a placeholder!
   std::unordered_map<int64_t, int64_t> count_distinct_sets_mapping_;
+  // Owns the approximate percentile digests of the entries created by the reduction, set by
+  // the result set which owns this storage.
+  RowSetMemoryOwner* row_set_mem_owner_;
 
   friend class ResultSet;
   friend class ResultSetManager;
@@ -276,6 +286,24 @@ class ResultSet {
 
   bool isRowAtEmpty(const size_t index) const;
 
+  // True if every target can be read with getColumnValues: a single storage buffer without
+  // permutation, truncation or lazily fetched columns, and one fixed width slot per target.
+  bool canReadColumnsDirectly() const;
+
+  // Appends the values of target target_idx in the non-empty entries of [start_entry, end_entry)
+  // to vals, straight from the storage buffer instead of building a row of TargetValue for each
+  // entry. The values are the ones getRowAtNoTranslations returns: integer, decimal, time and
+  // dictionary encoded targets use the int64_t overload, floating point targets the double one.
+  void getColumnValues(const size_t target_idx,
+                       const size_t start_entry,
+                       const size_t end_entry,
+                       std::vector<int64_t>& vals) const;
+
+  void getColumnValues(const size_t target_idx,
+                       const size_t start_entry,
+                       const size_t end_entry,
+                       std::vector<double>& vals) const;
+
   void sort(const std::list<Analyzer::OrderEntry>& order_entries, const size_t top_n);
 
   void keepFirstN(const size_t n);
@@ -318,6 +346,10 @@ class ResultSet {
 
   int64_t getRenderTime() const;
 
+  void setFromResultCache() { from_result_cache_ = true; }
+
+  bool isFromResultCache() const { return from_result_cache_; }
+
   void moveToBegin() const;
 
   bool isTruncated() const;
@@ -344,6 +376,24 @@ class ResultSet {
 
   const std::vector<uint32_t>& getPermutationBuffer() const;
 
+  // True if the rows live entirely in host buffers owned by this result set, without
+  // references into chunk memory; only such result sets can be copied.
+  bool isSelfContained() const;
+
+  // Deep copy of the row buffer, with its own iteration state. The row set memory owner
+  // (string dictionary proxies, count distinct buffers) is shared with the original.
+  std::shared_ptr<ResultSet> copy() const;
+
+  // True if some target keeps its state in the row set memory owner instead of the row buffer:
+  // count distinct sets and bitmaps, approximate percentile digests.
+  bool hasOwnerState() const;
+
+  // Like copy(), but the copy gets a row set memory owner of its own, with private copies of the
+  // string dictionary proxies, so it doesn't keep the query's owner alive nor grow it while it's
+  // iterated. Not available if hasOwnerState(). The bytes of the copied transient strings are
+  // added to owner_bytes.
+  std::shared_ptr<ResultSet> copyWithOwnMemory(size_t& owner_bytes) const;
+
   std::string serialize() const;
 
   static std::unique_ptr<ResultSet> unserialize(const std::string&, const Executor*);
@@ -379,6 +429,8 @@ class ResultSet {
 
   size_t parallelRowCount() const;
 
+  std::shared_ptr<ResultSet> copy(const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner) const;
+
   size_t advanceCursorToNextEntry() const;
 
   void radixSortOnGpu(const std::list<Analyzer::OrderEntry>& order_entries) const;
@@ -438,6 +490,17 @@ class ResultSet {
                                  const size_t target_logical_idx,
                                  const size_t entry_buff_idx) const;
 
+  struct DirectColumnLayout {
+    const int8_t* col_ptr;    // start of the target column if the output is columnar
+    size_t col_stride;        // distance between entries in the target column
+    size_t rowwise_offset;    // offset of the value in the row otherwise
+    int8_t compact_sz;        // width of the value makeTargetValue would read
+  };
+
+  DirectColumnLayout getDirectColumnLayout(const size_t target_idx) const;
+
+  const int8_t* getDirectValuePtr(const DirectColumnLayout& layout, const size_t entry_idx) const;
+
   struct StorageLookupResult {
     const ResultSetStorage* storage_ptr;
     const size_t fixedup_entry_idx;
@@ -526,6 +589,7 @@ class ResultSet {
   std::vector<uint32_t> permutation_;
   int64_t queue_time_ms_;
   int64_t render_time_ms_;
+  bool from_result_cache_;
   const Executor* executor_;  // TODO(alex): remove
 
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_;
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResultSetCache.h"
+
+#include <glog/logging.h>
+
+size_t g_result_set_cache_bytes{0};
+
+std::unordered_map<std::string, ResultSetCache::CacheEntry> ResultSetCache::result_set_cache_;
+std::list<std::string> ResultSetCache::lru_keys_;
+size_t ResultSetCache::bytes_{0};
+uint64_t ResultSetCache::hits_{0};
+uint64_t ResultSetCache::misses_{0};
+uint64_t ResultSetCache::evictions_{0};
+std::mutex ResultSetCache::result_set_cache_mutex_;
+
+std::shared_ptr<ResultSet> ResultSetCache::get(const std::string& key,
+                                               const std::vector<TableVersion>& table_versions,
+                                               std::vector<TargetMetaInfo>& targets_meta) {
+  std::shared_ptr<ResultSet> cached_rows;
+  {
+    std::lock_guard<std::mutex> guard(result_set_cache_mutex_);
+    auto it = result_set_cache_.find(key);
+    if (it == result_set_cache_.end()) {
+      ++misses_;
+      return nullptr;
+    }
+    if (!(it->second.table_versions == table_versions)) {
+      // one of the inputs has been checkpointed since, the entry can't be hit anymore
+      eraseUnlocked(it);
+      ++evictions_;
+      ++misses_;
+      return nullptr;
+    }
+    ++hits_;
+    lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_pos);
+    cached_rows = it->second.rows;
+    targets_meta = it->second.targets_meta;
+  }
+  // the cached result set is never iterated, copying it outside the lock is safe; the copy gets
+  // its own memory owner since iterating it adds strings and arrays to the owner
+  size_t owner_bytes{0};
+  auto rows = cached_rows->copyWithOwnMemory(owner_bytes);
+  rows->setFromResultCache();
+  return rows;
+}
+
+void ResultSetCache::put(const std::string& key,
+                         const std::vector<TableVersion>& table_versions,
+                         const std::shared_ptr<ResultSet>& rows,
+                         const std::vector<TargetMetaInfo>& targets_meta) {
+  // count distinct sets and bitmaps and approximate percentile digests live in the query's memory
+  // owner, referenced by pointer from the row buffer; such results aren't cached
+  if (!rows || !rows->isSelfContained() || rows->hasOwnerState()) {
+    return;
+  }
+  size_t bytes = key.size() + rows->getBufferSizeBytes(rows->getDeviceType()) +
+                 rows->getPermutationBuffer().size() * sizeof(uint32_t);
+  if (bytes > g_result_set_cache_bytes) {
+    return;
+  }
+  // the caller keeps iterating its own result set, cache an untouched copy which doesn't hold on to
+  // the query's memory owner
+  auto cached_rows = rows->copyWithOwnMemory(bytes);
+  if (bytes > g_result_set_cache_bytes) {
+    return;
+  }
+  cached_rows->moveToBegin();
+  std::lock_guard<std::mutex> guard(result_set_cache_mutex_);
+  auto it = result_set_cache_.find(key);
+  if (it != result_set_cache_.end()) {
+    eraseUnlocked(it);
+  }
+  while (!lru_keys_.empty() && bytes_ + bytes > g_result_set_cache_bytes) {
+    eraseUnlocked(result_set_cache_.find(lru_keys_.back()));
+    ++evictions_;
+  }
+  lru_keys_.push_front(key);
+  result_set_cache_.emplace(key, CacheEntry{table_versions, cached_rows, targets_meta, bytes, lru_keys_.begin()});
+  bytes_ += bytes;
+}
+
+ResultSetCache::Stats ResultSetCache::getStats() {
+  std::lock_guard<std::mutex> guard(result_set_cache_mutex_);
+  return {hits_, misses_, evictions_, result_set_cache_.size(), bytes_};
+}
+
+void ResultSetCache::eraseUnlocked(std::unordered_map<std::string, CacheEntry>::iterator it) {
+  CHECK(it != result_set_cache_.end());
+  CHECK_GE(bytes_, it->second.bytes);
+  bytes_ -= it->second.bytes;
+  lru_keys_.erase(it->second.lru_pos);
+  result_set_cache_.erase(it);
+}
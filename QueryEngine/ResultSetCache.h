@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    ResultSetCache.h
+ * @brief   Memory capped LRU cache of final query results.
+ *
+ * Entries are keyed by the serialized relational algebra of the query and remember the
+ * epoch and tuple count of every table the query reads. A lookup against newer table
+ * versions drops the entry, so checkpoints (loads, updates, deletes) invalidate results
+ * without the writers having to know about the cache.
+ */
+
+#ifndef QUERYENGINE_RESULTSETCACHE_H
+#define QUERYENGINE_RESULTSETCACHE_H
+
+#include "ResultSet.h"
+#include "TargetMetaInfo.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern size_t g_result_set_cache_bytes;  // 0 disables the cache
+
+struct TableVersion {
+  int table_id;
+  int32_t epoch;
+  size_t num_tuples;
+
+  bool operator==(const TableVersion& that) const {
+    return table_id == that.table_id && epoch == that.epoch && num_tuples == that.num_tuples;
+  }
+};
+
+class ResultSetCache {
+ public:
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entry_count;
+    size_t bytes;
+  };
+
+  // Returns a private copy of the cached result, nullptr if there's no entry for the key
+  // and the given table versions.
+  static std::shared_ptr<ResultSet> get(const std::string& key,
+                                        const std::vector<TableVersion>& table_versions,
+                                        std::vector<TargetMetaInfo>& targets_meta);
+
+  static void put(const std::string& key,
+                  const std::vector<TableVersion>& table_versions,
+                  const std::shared_ptr<ResultSet>& rows,
+                  const std::vector<TargetMetaInfo>& targets_meta);
+
+  static Stats getStats();
+
+  static auto yieldCacheInvalidator() -> std::function<void()> {
+    return []() -> void {
+      std::lock_guard<std::mutex> guard(result_set_cache_mutex_);
+      evictions_ += result_set_cache_.size();
+      result_set_cache_.clear();
+      lru_keys_.clear();
+      bytes_ = 0;
+    };
+  }
+
+ private:
+  struct CacheEntry {
+    std::vector<TableVersion> table_versions;
+    std::shared_ptr<ResultSet> rows;
+    std::vector<TargetMetaInfo> targets_meta;
+    size_t bytes;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  static void eraseUnlocked(std::unordered_map<std::string, CacheEntry>::iterator it);
+
+  static std::unordered_map<std::string, CacheEntry> result_set_cache_;
+  static std::list<std::string> lru_keys_;  // most recently used first
+  static size_t bytes_;
+  static uint64_t hits_;
+  static uint64_t misses_;
+  static uint64_t evictions_;
+  static std::mutex result_set_cache_mutex_;
+};
+
+#endif  // QUERYENGINE_RESULTSETCACHE_H
@@ -307,6 +307,151 @@ int64_t int_resize_cast(const int64_t ival, const size_t sz) {
 
 }  // namespace
 
+bool ResultSet::canReadColumnsDirectly() const {
+  if (!storage_ || !appended_storage_.empty() || just_explain_ || !permutation_.empty() || isTruncated() ||
+      query_mem_desc_.entry_count_small) {
+    return false;
+  }
+  for (const auto& col_lazy_fetch : lazy_fetch_info_) {
+    if (col_lazy_fetch.is_lazily_fetched) {
+      return false;
+    }
+  }
+  for (const auto& target_info : targets_) {
+    if (target_info.sql_type.is_geometry() || is_real_str_or_array(target_info) || is_distinct_target(target_info) ||
+        (target_info.is_agg && (target_info.agg_kind == kAVG || target_info.agg_kind == kAPPROX_PERCENTILE))) {
+      return false;
+    }
+    const auto& chosen_type = get_compact_type(target_info);
+    if (!chosen_type.is_fp() && !chosen_type.is_integer() && !chosen_type.is_boolean() && !chosen_type.is_time() &&
+        !chosen_type.is_timeinterval() && !chosen_type.is_decimal() &&
+        !(chosen_type.is_string() && chosen_type.get_compression() == kENCODING_DICT)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Walks the targets the same way getRowAt does to find where the value of target_idx lives.
+ResultSet::DirectColumnLayout ResultSet::getDirectColumnLayout(const size_t target_idx) const {
+  CHECK(storage_);
+  CHECK_LT(target_idx, targets_.size());
+  DirectColumnLayout layout{nullptr, 0, 0, 0};
+  size_t slot_idx = 0;
+  if (query_mem_desc_.output_columnar) {
+    layout.col_ptr = get_cols_ptr(storage_->buff_, query_mem_desc_);
+  } else {
+    layout.rowwise_offset = align_to_int64(get_key_bytes_rowwise(query_mem_desc_));
+  }
+  for (size_t i = 0; i < target_idx; ++i) {
+    const auto& agg_info = targets_[i];
+    if (query_mem_desc_.output_columnar) {
+      layout.col_ptr = advance_to_next_columnar_target_buff(layout.col_ptr, query_mem_desc_, slot_idx);
+      if (agg_info.is_agg && agg_info.agg_kind == kAVG) {
+        layout.col_ptr = advance_to_next_columnar_target_buff(layout.col_ptr, query_mem_desc_, slot_idx + 1);
+      }
+    } else {
+      layout.rowwise_offset =
+          advance_target_ptr(layout.rowwise_offset, agg_info, slot_idx, query_mem_desc_, none_encoded_strings_valid_);
+    }
+    slot_idx = advance_slot(slot_idx, agg_info, none_encoded_strings_valid_);
+  }
+  const auto& target_info = targets_[target_idx];
+  CHECK_LT(slot_idx, query_mem_desc_.agg_col_widths.size());
+  if (query_mem_desc_.output_columnar) {
+    layout.col_stride = query_mem_desc_.agg_col_widths[slot_idx].compact;
+    layout.compact_sz = query_mem_desc_.agg_col_widths[slot_idx].compact;
+  } else if (!query_mem_desc_.target_groupby_indices.empty() &&
+             query_mem_desc_.target_groupby_indices[target_idx] >= 0) {
+    layout.compact_sz = query_mem_desc_.getEffectiveKeyWidth();
+    layout.rowwise_offset = query_mem_desc_.target_groupby_indices[target_idx] * layout.compact_sz;
+  } else {
+    layout.compact_sz = target_info.is_agg
+                            ? std::max(target_info.sql_type.get_size(), target_info.agg_arg_type.get_size())
+                            : target_info.sql_type.get_size();
+  }
+  // same width adjustments as makeTargetValue
+  if (target_info.sql_type.get_type() == kFLOAT) {
+    layout.compact_sz = sizeof(double);
+    if (target_info.is_agg && (target_info.agg_kind == kAVG || target_info.agg_kind == kSUM ||
+                               target_info.agg_kind == kMIN || target_info.agg_kind == kMAX)) {
+      layout.compact_sz = sizeof(float);
+    }
+  }
+  if (target_info.sql_type.is_string() && target_info.sql_type.get_compression() == kENCODING_DICT &&
+      target_info.sql_type.get_comp_param()) {
+    layout.compact_sz = sizeof(int32_t);
+  }
+  return layout;
+}
+
+const int8_t* ResultSet::getDirectValuePtr(const DirectColumnLayout& layout, const size_t entry_idx) const {
+  if (query_mem_desc_.output_columnar) {
+    return layout.col_ptr + layout.col_stride * entry_idx;
+  }
+  return row_ptr_rowwise(storage_->buff_, query_mem_desc_, entry_idx) + layout.rowwise_offset;
+}
+
+void ResultSet::getColumnValues(const size_t target_idx,
+                                const size_t start_entry,
+                                const size_t end_entry,
+                                std::vector<int64_t>& vals) const {
+  const auto layout = getDirectColumnLayout(target_idx);
+  const auto& target_info = targets_[target_idx];
+  const auto& chosen_type = get_compact_type(target_info);
+  CHECK(!chosen_type.is_fp());
+  CHECK_LE(end_entry, query_mem_desc_.entry_count);
+  const bool is_dict_string = chosen_type.is_string();
+  const bool is_decimal = chosen_type.is_decimal();
+  const auto chosen_null_val = inline_int_null_val(chosen_type);
+  const auto null_val = inline_int_null_val(target_info.sql_type);
+  const auto logical_size = chosen_type.get_logical_size();
+  for (size_t entry_idx = start_entry; entry_idx < end_entry; ++entry_idx) {
+    if (storage_->isEmptyEntry(entry_idx)) {
+      continue;
+    }
+    const auto ival = read_int_from_buff(getDirectValuePtr(layout, entry_idx), layout.compact_sz);
+    if (is_dict_string) {
+      vals.push_back(static_cast<int32_t>(ival));
+    } else if (!is_decimal && int_resize_cast(ival, logical_size) == chosen_null_val) {
+      vals.push_back(null_val);
+    } else {
+      vals.push_back(ival);
+    }
+  }
+}
+
+void ResultSet::getColumnValues(const size_t target_idx,
+                                const size_t start_entry,
+                                const size_t end_entry,
+                                std::vector<double>& vals) const {
+  const auto layout = getDirectColumnLayout(target_idx);
+  const auto& chosen_type = get_compact_type(targets_[target_idx]);
+  CHECK(chosen_type.is_fp());
+  CHECK_LE(end_entry, query_mem_desc_.entry_count);
+  const bool is_float = chosen_type.get_type() == kFLOAT;
+  for (size_t entry_idx = start_entry; entry_idx < end_entry; ++entry_idx) {
+    if (storage_->isEmptyEntry(entry_idx)) {
+      continue;
+    }
+    const auto ptr = getDirectValuePtr(layout, entry_idx);
+    switch (layout.compact_sz) {
+      case 8: {
+        const auto dval = *reinterpret_cast<const double*>(ptr);
+        vals.push_back(is_float ? static_cast<float>(dval) : dval);
+        break;
+      }
+      case 4: {
+        CHECK(is_float);
+        vals.push_back(*reinterpret_cast<const float*>(ptr));
+        break;
+      }
+      default:
+        CHECK(false);
+    }
+  }
+}
+
 InternalTargetValue ResultSet::getColumnInternal(const int8_t* buff,
                                                  const size_t entry_idx,
                                                  const size_t target_logical_idx,
@@ -507,6 +652,13 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch, const int8_t* byt
   }
   CHECK(type_info.is_integer() || type_info.is_decimal() || type_info.is_time() || type_info.is_boolean() ||
         type_info.is_string() || type_info.is_array());
+  if (type_info.get_compression() == kENCODING_DIFF) {
+    return diff_fixed_width_int_decode_noinline(
+        byte_stream, type_info.get_comp_param() / 8, inline_int_null_val(get_logical_type_info(type_info)), pos);
+  }
+  if (type_info.get_compression() == kENCODING_RL) {
+    return run_length_int_decode_noinline(byte_stream, pos);
+  }
   size_t type_bitwidth = get_bit_width(type_info);
   if (type_info.get_compression() == kENCODING_FIXED) {
     type_bitwidth = type_info.get_comp_param();
@@ -1066,6 +1218,11 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
   }
 
   auto ival = read_int_from_buff(ptr, actual_compact_sz);
+  if (target_info.is_agg && target_info.agg_kind == kAPPROX_PERCENTILE) {
+    const auto t_digest = reinterpret_cast<TDigest*>(ival);
+    const double quantile = t_digest ? t_digest->quantile() : NAN;
+    return std::isnan(quantile) ? ScalarTargetValue(NULL_DOUBLE) : ScalarTargetValue(quantile);
+  }
   const auto& chosen_type = get_compact_type(target_info);
   if (!lazy_fetch_info_.empty()) {
     CHECK_LT(target_logical_idx, lazy_fetch_info_.size());
@@ -32,11 +32,11 @@
 #include "Shared/thread_count.h"
 
 #include <algorithm>
+#include <atomic>
 #include <future>
+#include <limits>
 #include <numeric>
 
-extern bool g_enable_dynamic_watchdog;
-
 namespace {
 
 bool use_multithreaded_reduction(const size_t entry_count) {
@@ -138,8 +138,13 @@ void ResultSetStorage::reduce(const ResultSetStorage& that) const {
   CHECK(this_buff);
   auto that_buff = that.buff_;
   CHECK(that_buff);
+  // the reduction threads poll the interrupt of the query running on this one
+  const auto query_token = QueryCancellationToken::current();
   if (query_mem_desc_.hash_type == GroupByColRangeType::MultiCol) {
-    if (use_multithreaded_reduction(that.query_mem_desc_.entry_count)) {
+    const auto partition_count = query_mem_desc_.getReductionPartitionCount();
+    if (use_multithreaded_reduction(that.query_mem_desc_.entry_count) && partition_count > 1) {
+      reduceBaselinePartitioned(this_buff, that_buff, that, partition_count);
+    } else if (use_multithreaded_reduction(that.query_mem_desc_.entry_count)) {
       const size_t thread_count = cpu_threads();
       std::vector<std::future<void>> reduction_threads;
       for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -147,7 +152,8 @@ void ResultSetStorage::reduce(const ResultSetStorage& that) const {
         const auto start_index = thread_idx * thread_entry_count;
         const auto end_index = std::min(start_index + thread_entry_count, that.query_mem_desc_.entry_count);
         reduction_threads.emplace_back(
-            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that] {
+            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that, query_token] {
+              QueryCancellationToken::ThreadScope query_token_scope(query_token);
               for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
                 reduceOneEntryBaseline(this_buff, that_buff, entry_idx, that.query_mem_desc_.entry_count, that);
               }
@@ -186,12 +192,14 @@ void ResultSetStorage::reduce(const ResultSetStorage& that) const {
       const auto end_index = std::min(start_index + thread_entry_count, entry_count);
       if (query_mem_desc_.output_columnar) {
         reduction_threads.emplace_back(
-            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that] {
+            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that, query_token] {
+              QueryCancellationToken::ThreadScope query_token_scope(query_token);
               reduceEntriesNoCollisionsColWise(this_buff, that_buff, that, start_index, end_index);
             }));
       } else {
         reduction_threads.emplace_back(
-            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that] {
+            std::async(std::launch::async, [this, this_buff, that_buff, start_index, end_index, &that, query_token] {
+              QueryCancellationToken::ThreadScope query_token_scope(query_token);
               for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
                 reduceOneEntryNoCollisionsRowWise(entry_idx, this_buff, that_buff, that);
               }
@@ -218,11 +226,7 @@ void ResultSetStorage::reduce(const ResultSetStorage& that) const {
 namespace {
 
 ALWAYS_INLINE void check_watchdog(const size_t sample_seed) {
-  if (UNLIKELY(g_enable_dynamic_watchdog && (sample_seed & 0x3F) == 0 && dynamic_watchdog())) {
-    // TODO(alex): distinguish between the deadline and interrupt
-    throw std::runtime_error(
-        "Query execution has exceeded the time limit or was interrupted during result set reduction");
-  }
+  check_query_interrupt(sample_seed, "result set reduction");
 }
 
 }  // namespace
@@ -523,6 +527,99 @@ GroupValueInfo get_group_value_reduction(int64_t* groups_buffer,
 
 }  // namespace
 
+// Radix partitioned reduction of a row-wise baseline hash table. The entries of that_buff
+// are first partitioned by the range of this_buff their hash points to, then every
+// partition is reduced by a single thread. The slots a thread writes to are contiguous and
+// fit in its cache, instead of being spread over the whole output buffer.
+void ResultSetStorage::reduceBaselinePartitioned(int8_t* this_buff,
+                                                 const int8_t* that_buff,
+                                                 const ResultSetStorage& that,
+                                                 const size_t partition_count) const {
+  CHECK(!query_mem_desc_.output_columnar);
+  const auto that_entry_count = that.query_mem_desc_.entry_count;
+  const auto this_entry_count = query_mem_desc_.entry_count;
+  const auto key_count = get_groupby_col_count(query_mem_desc_);
+  const auto key_width = query_mem_desc_.getEffectiveKeyWidth();
+  const auto row_qw_count = get_row_qw_count(query_mem_desc_);
+  const auto that_buff_i64 = reinterpret_cast<const int64_t*>(that_buff);
+  const auto query_token = QueryCancellationToken::current();
+  const size_t thread_count = cpu_threads();
+  const auto thread_entry_count = (that_entry_count + thread_count - 1) / thread_count;
+  static const uint32_t empty_entry{std::numeric_limits<uint32_t>::max()};
+  std::vector<uint32_t> entry_partitions(that_entry_count);
+  std::vector<std::vector<size_t>> partition_sizes(thread_count, std::vector<size_t>(partition_count, 0));
+  std::vector<std::future<void>> partitioning_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto start_index = thread_idx * thread_entry_count;
+    const auto end_index = std::min(start_index + thread_entry_count, that_entry_count);
+    partitioning_threads.emplace_back(std::async(std::launch::async, [&, thread_idx, start_index, end_index] {
+      auto& sizes = partition_sizes[thread_idx];
+      for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+        if (isEmptyEntry(entry_idx, that_buff)) {
+          entry_partitions[entry_idx] = empty_entry;
+          continue;
+        }
+        // same home slot as the one get_group_value_reduction will probe from
+        const auto h = key_hash(&that_buff_i64[row_qw_count * entry_idx], key_count, key_width) % this_entry_count;
+        const auto partition = static_cast<uint32_t>(uint64_t(h) * partition_count / this_entry_count);
+        entry_partitions[entry_idx] = partition;
+        ++sizes[partition];
+      }
+    }));
+  }
+  for (auto& partitioning_thread : partitioning_threads) {
+    partitioning_thread.get();
+  }
+  // entries of the same partition are contiguous, ordered by the thread which found them
+  std::vector<std::vector<size_t>> partition_offsets(thread_count, std::vector<size_t>(partition_count, 0));
+  std::vector<size_t> partition_starts(partition_count + 1, 0);
+  size_t offset{0};
+  for (size_t partition = 0; partition < partition_count; ++partition) {
+    partition_starts[partition] = offset;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      partition_offsets[thread_idx][partition] = offset;
+      offset += partition_sizes[thread_idx][partition];
+    }
+  }
+  partition_starts[partition_count] = offset;
+  std::vector<uint32_t> partitioned_entries(offset);
+  std::vector<std::future<void>> scatter_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto start_index = thread_idx * thread_entry_count;
+    const auto end_index = std::min(start_index + thread_entry_count, that_entry_count);
+    scatter_threads.emplace_back(std::async(std::launch::async, [&, thread_idx, start_index, end_index] {
+      auto& offsets = partition_offsets[thread_idx];
+      for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+        const auto partition = entry_partitions[entry_idx];
+        if (partition != empty_entry) {
+          partitioned_entries[offsets[partition]++] = entry_idx;
+        }
+      }
+    }));
+  }
+  for (auto& scatter_thread : scatter_threads) {
+    scatter_thread.get();
+  }
+  // Linear probing can still spill an entry into the next partition, the insertion in
+  // get_group_value_reduction is atomic. Every key is found in a single entry of that_buff,
+  // so the aggregate slots are only ever updated by one thread.
+  std::atomic<size_t> next_partition{0};
+  std::vector<std::future<void>> reduction_threads;
+  for (size_t thread_idx = 0; thread_idx < std::min(thread_count, partition_count); ++thread_idx) {
+    reduction_threads.emplace_back(std::async(std::launch::async, [&] {
+      QueryCancellationToken::ThreadScope query_token_scope(query_token);
+      for (auto partition = next_partition++; partition < partition_count; partition = next_partition++) {
+        for (auto i = partition_starts[partition]; i < partition_starts[partition + 1]; ++i) {
+          reduceOneEntryBaseline(this_buff, that_buff, partitioned_entries[i], that_entry_count, that);
+        }
+      }
+    }));
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.get();
+  }
+}
+
 // Reduces entry at position that_entry_idx in that_buff into this_buff. This is
 // the baseline layout, so the position in this_buff isn't known to be that_entry_idx.
 void ResultSetStorage::reduceOneEntryBaseline(int8_t* this_buff,
@@ -730,6 +827,9 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end(); ++result_it) {
     result->reduce(*((*result_it)->storage_));
   }
+  if (row_set_mem_owner) {
+    row_set_mem_owner->flushTDigests();
+  }
   return result_rs;
 }
 
@@ -1019,6 +1119,11 @@ void ResultSetStorage::reduceOneSlot(int8_t* this_ptr1,
         AGGREGATE_ONE_NULLABLE_VALUE(max, this_ptr1, that_ptr1, init_val, chosen_bytes, target_info);
         break;
       }
+      case kAPPROX_PERCENTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        reduceOneApproxPercentileSlot(this_ptr1, that_ptr1);
+        break;
+      }
       default:
         CHECK(false);
     }
@@ -1067,6 +1172,25 @@ void ResultSetStorage::reduceOneCountDistinctSlot(int8_t* this_ptr1,
   count_distinct_set_union(*new_set_ptr, *old_set_ptr, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+void ResultSetStorage::reduceOneApproxPercentileSlot(int8_t* this_ptr1, const int8_t* that_ptr1) const {
+  CHECK(this_ptr1 && that_ptr1);
+  auto this_digest_ptr = reinterpret_cast<int64_t*>(this_ptr1);
+  const auto that_digest = reinterpret_cast<TDigest*>(*reinterpret_cast<const int64_t*>(that_ptr1));
+  if (!that_digest) {
+    return;
+  }
+  auto this_digest = reinterpret_cast<TDigest*>(*this_digest_ptr);
+  if (!this_digest) {
+    // Entries created during reduction get a digest of their own, the one from the other
+    // side still belongs to its entry and mustn't be merged into.
+    CHECK(row_set_mem_owner_);
+    this_digest = new TDigest(that_digest->getFraction());
+    row_set_mem_owner_->addTDigest(this_digest);
+    *this_digest_ptr = reinterpret_cast<int64_t>(this_digest);
+  }
+  this_digest->merge(*that_digest);
+}
+
 bool ResultRows::reduceSingleRow(const int8_t* row_ptr,
                                  const int8_t warp_count,
                                  const bool is_columnar,
@@ -22,6 +22,7 @@
 #include "HyperLogLogRank.h"
 #include "MurmurHash.h"
 #include "RuntimeFunctions.h"
+#include "TDigest.h"
 #include "TypePunning.h"
 #include "../Shared/funcannotations.h"
 
@@ -251,6 +252,14 @@ extern "C" ALWAYS_INLINE void agg_count_distinct(int64_t* agg, const int64_t val
   reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
 }
 
+// Null arguments come in as NaN.
+extern "C" NEVER_INLINE void agg_approx_percentile(int64_t* agg, const double val) {
+  if (std::isnan(val)) {
+    return;
+  }
+  reinterpret_cast<TDigest*>(*agg)->add(val);
+}
+
 extern "C" ALWAYS_INLINE void agg_count_distinct_bitmap(int64_t* agg, const int64_t val, const int64_t min_val) {
   const uint64_t bitmap_idx = val - min_val;
   reinterpret_cast<int8_t*>(*agg)[bitmap_idx >> 3] |= (1 << (bitmap_idx & 7));
@@ -296,6 +305,64 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
   return (reinterpret_cast<const int8_t*>(bitset))[bitmap_idx >> 3] & (1 << (bitmap_idx & 7)) ? 1 : 0;
 }
 
+extern "C" ALWAYS_INLINE uint64_t in_values_hash_set_hash(const int64_t key) {
+  // finalizer of MurmurHash3, cheap and good enough for the sequential ids we usually get
+  uint64_t h = key;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// The set is filled at less than half of its capacity, a probe always reaches a group with
+// an empty slot. The slots of a group are compared without early exit so that the compares
+// can be done with a single vector instruction.
+extern "C" ALWAYS_INLINE int8_t int_in_hash_set(const int64_t hash_set,
+                                                const int64_t val,
+                                                const int64_t group_mask,
+                                                const int64_t null_val,
+                                                const int8_t null_bool_val) {
+  if (val == null_val) {
+    return null_bool_val;
+  }
+  const auto slots = reinterpret_cast<const int64_t*>(hash_set);
+  for (uint64_t group = in_values_hash_set_hash(val) & group_mask;; group = (group + 1) & group_mask) {
+    const auto group_slots = slots + group * IN_VALUES_HASH_SET_GROUP_SIZE;
+    bool found{false};
+    bool has_empty{false};
+    for (size_t i = 0; i < IN_VALUES_HASH_SET_GROUP_SIZE; ++i) {
+      found |= group_slots[i] == val;
+      has_empty |= group_slots[i] == null_val;
+    }
+    if (found) {
+      return 1;
+    }
+    if (has_empty) {
+      return 0;
+    }
+  }
+  return 0;
+}
+
+extern "C" ALWAYS_INLINE int8_t double_in_hash_set(const int64_t hash_set,
+                                                   const double val,
+                                                   const int64_t group_mask,
+                                                   const double null_val,
+                                                   const int8_t null_bool_val) {
+  if (val == null_val) {
+    return null_bool_val;
+  }
+  // the set holds bit patterns, 0.0 and -0.0 must hit the same one
+  const double canonical_val = val == 0. ? 0. : val;
+  return int_in_hash_set(hash_set,
+                         *reinterpret_cast<const int64_t*>(may_alias_ptr(&canonical_val)),
+                         group_mask,
+                         *reinterpret_cast<const int64_t*>(may_alias_ptr(&null_val)),
+                         null_bool_val);
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
@@ -853,6 +920,42 @@ extern "C" ALWAYS_INLINE DEVICE int32_t char_length_nullable(const char* str,
   return str_len;
 }
 
+// Slots hold the offset (high half) and the length (low half) of the strings in the
+// payload which follows them, -1 if empty. Groups fill up in order, the first empty slot
+// ends the probe.
+extern "C" ALWAYS_INLINE int8_t string_in_hash_set(const int64_t hash_set,
+                                                   const char* str,
+                                                   const int32_t str_len,
+                                                   const int64_t group_mask,
+                                                   const int8_t null_bool_val) {
+  if (!str) {
+    return null_bool_val;
+  }
+  const auto slots = reinterpret_cast<const int64_t*>(hash_set);
+  const auto payload = reinterpret_cast<const char*>(slots + (group_mask + 1) * IN_VALUES_HASH_SET_GROUP_SIZE);
+  for (uint64_t group = MurmurHash1(str, str_len, 0) & group_mask;; group = (group + 1) & group_mask) {
+    const auto group_slots = slots + group * IN_VALUES_HASH_SET_GROUP_SIZE;
+    for (size_t i = 0; i < IN_VALUES_HASH_SET_GROUP_SIZE; ++i) {
+      const auto slot = group_slots[i];
+      if (slot == -1) {
+        return 0;
+      }
+      if (static_cast<int32_t>(slot & 0xffffffff) != str_len) {
+        continue;
+      }
+      const auto candidate = payload + (slot >> 32);
+      int32_t j = 0;
+      while (j < str_len && candidate[j] == str[j]) {
+        ++j;
+      }
+      if (j == str_len) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
 extern "C" NEVER_INLINE void linear_probabilistic_count(uint8_t* bitmap,
                                                         const uint32_t bitmap_bytes,
                                                         const uint8_t* key_bytes,
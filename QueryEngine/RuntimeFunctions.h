@@ -73,6 +73,13 @@ extern "C" void agg_min_float_skip_val(int32_t* agg, const float val, const floa
 
 extern "C" void agg_count_distinct_bitmap(int64_t* agg, const int64_t val, const int64_t min_val);
 
+extern "C" void agg_approx_percentile(int64_t* agg, const double val);
+
+// IN value hash sets are probed a group of slots at a time, see InValuesHashSet.
+#define IN_VALUES_HASH_SET_GROUP_SIZE 4
+
+extern "C" uint64_t in_values_hash_set_hash(const int64_t key);
+
 #define EMPTY_KEY_64 std::numeric_limits<int64_t>::max()
 #define EMPTY_KEY_32 std::numeric_limits<int32_t>::max()
 #define EMPTY_KEY_16 std::numeric_limits<int16_t>::max()
@@ -173,6 +180,13 @@ extern "C" int64_t fixed_width_unsigned_decode_noinline(const int8_t* byte_strea
                                                         const int32_t byte_width,
                                                         const int64_t pos);
 
+extern "C" int64_t diff_fixed_width_int_decode_noinline(const int8_t* byte_stream,
+                                                        const int32_t byte_width,
+                                                        const int64_t null_val,
+                                                        const int64_t pos);
+
+extern "C" int64_t run_length_int_decode_noinline(const int8_t* byte_stream, const int64_t pos);
+
 extern "C" float fixed_width_float_decode_noinline(const int8_t* byte_stream, const int64_t pos);
 
 extern "C" double fixed_width_double_decode_noinline(const int8_t* byte_stream, const int64_t pos);
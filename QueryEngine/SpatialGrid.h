@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SpatialGrid.h
+ * @brief   Layout of the uniform grid SpatialJoinHashTable builds over the bounding boxes of the
+ *          inner geometries, shared by the build and by the spatial_grid_cell runtime probe.
+ *
+ * The buffer starts with a SpatialGridHeader, followed by the offset and the count of every cell
+ * (int32_t each, cells numbered row-major) and by the inner row ids referenced by the cells. A box
+ * is referenced by every cell it overlaps, so probing a single cell with a point yields a superset
+ * of the rows which can match; the join qualifier itself is still evaluated on every candidate.
+ */
+
+#ifndef QUERYENGINE_SPATIALGRID_H
+#define QUERYENGINE_SPATIALGRID_H
+
+#include "../Shared/funcannotations.h"
+
+#include <cstdint>
+
+struct SpatialGridHeader {
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+  double x_cells_per_unit;
+  double y_cells_per_unit;
+  int64_t x_cells;
+  int64_t y_cells;
+};
+
+// Cell index along one axis, -1 if the value is outside of [min_val, max_val] or NaN.
+DEVICE inline int64_t spatial_grid_axis_cell(const double val,
+                                             const double min_val,
+                                             const double max_val,
+                                             const double cells_per_unit,
+                                             const int64_t cell_count) {
+  if (!(val >= min_val && val <= max_val)) {
+    return -1;
+  }
+  const int64_t cell = (val - min_val) * cells_per_unit;
+  return cell < cell_count ? cell : cell_count - 1;
+}
+
+// Decodes the n-th coordinate of a coords array, compression is 1 for GEOINT32 and 0 for none.
+DEVICE inline double spatial_grid_decode_coord(const int8_t* coords, const int64_t n, const int32_t compression) {
+  if (compression == 1) {
+    const auto compressed = reinterpret_cast<const int32_t*>(coords)[n];
+    return (n % 2 ? 90.0 : 180.0) * (compressed / 2147483647.0);
+  }
+  return reinterpret_cast<const double*>(coords)[n];
+}
+
+#endif  // QUERYENGINE_SPATIALGRID_H
@@ -0,0 +1,522 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpatialJoinHashTable.h"
+#include "Execute.h"
+#include "JoinHashTable.h"
+#include "SpatialGrid.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+
+std::vector<std::pair<SpatialJoinHashTable::HashTableCacheKey, std::shared_ptr<std::vector<int8_t>>>>
+    SpatialJoinHashTable::hash_table_cache_;
+std::mutex SpatialJoinHashTable::hash_table_cache_mutex_;
+
+namespace {
+
+bool get_double_constant(const Analyzer::Expr* expr, double& val) {
+  const auto cast_expr = dynamic_cast<const Analyzer::UOper*>(expr);
+  if (cast_expr && cast_expr->get_optype() == kCAST) {
+    expr = cast_expr->get_operand();
+  }
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null()) {
+    return false;
+  }
+  const auto& ti = constant->get_type_info();
+  const auto datum = constant->get_constval();
+  switch (ti.get_type()) {
+    case kDOUBLE:
+      val = datum.doubleval;
+      return true;
+    case kFLOAT:
+      val = datum.floatval;
+      return true;
+    case kSMALLINT:
+      val = datum.smallintval;
+      return true;
+    case kINT:
+      val = datum.intval;
+      return true;
+    case kBIGINT:
+      val = datum.bigintval;
+      return true;
+    case kDECIMAL:
+    case kNUMERIC:
+      val = datum.bigintval / std::pow(10.0, ti.get_scale());
+      return true;
+    default:
+      return false;
+  }
+}
+
+int32_t get_int_arg(const Analyzer::FunctionOper* func, const size_t i) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(func->getArg(i));
+  if (!constant || constant->get_type_info().get_type() != kINT) {
+    throw HashJoinFail(func->getName() + ": unexpected argument");
+  }
+  return constant->get_constval().intval;
+}
+
+const Analyzer::ColumnVar* get_geo_column_arg(const Analyzer::FunctionOper* func, const size_t i) {
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(func->getArg(i));
+  if (!col_var || col_var->get_table_id() <= 0) {
+    throw HashJoinFail("Spatial join index requires geometry columns of physical tables");
+  }
+  return col_var;
+}
+
+bool is_contains_point(const std::string& name) {
+  return name == "ST_Contains_Polygon_Point" || name == "ST_Contains_MultiPolygon_Point";
+}
+
+// Recognizes ST_Contains(inner_polygon, outer_point) and ST_Distance(point, point) <= d, the
+// latter in either argument order and with the comparison mirrored. Throws HashJoinFail otherwise.
+SpatialJoinHashTable::SpatialPredicate normalize_spatial_predicate(const Analyzer::Expr* qual) {
+  auto func = dynamic_cast<const Analyzer::FunctionOper*>(qual);
+  double distance{0};
+  if (!func) {
+    const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+    if (!bin_oper) {
+      throw HashJoinFail("No spatial join predicate found");
+    }
+    auto lhs = bin_oper->get_left_operand();
+    auto rhs = bin_oper->get_right_operand();
+    auto optype = bin_oper->get_optype();
+    if (optype == kGT || optype == kGE) {
+      std::swap(lhs, rhs);
+      optype = optype == kGT ? kLT : kLE;
+    }
+    func = dynamic_cast<const Analyzer::FunctionOper*>(lhs);
+    if ((optype != kLT && optype != kLE) || !func || func->getName() != "ST_Distance_Point_Point" ||
+        !get_double_constant(rhs, distance) || !(distance >= 0)) {
+      throw HashJoinFail("No spatial join predicate found");
+    }
+    CHECK_EQ(size_t(7), func->getArity());
+    const auto lhs_col = get_geo_column_arg(func, 0);
+    const auto rhs_col = get_geo_column_arg(func, 1);
+    if (get_int_arg(func, 3) != get_int_arg(func, 6) || get_int_arg(func, 5) != get_int_arg(func, 6)) {
+      throw HashJoinFail("Spatial join index doesn't support transformed geometries");
+    }
+    if (lhs_col->get_rte_idx() == rhs_col->get_rte_idx()) {
+      throw HashJoinFail("Spatial join predicate must reference two tables");
+    }
+    const bool lhs_is_inner = lhs_col->get_rte_idx() > rhs_col->get_rte_idx();
+    return {lhs_is_inner ? lhs_col : rhs_col,
+            nullptr,
+            lhs_is_inner ? rhs_col : lhs_col,
+            get_int_arg(func, lhs_is_inner ? 2 : 4),
+            get_int_arg(func, lhs_is_inner ? 4 : 2),
+            distance};
+  }
+  if (!is_contains_point(func->getName())) {
+    throw HashJoinFail("No spatial join predicate found");
+  }
+  CHECK_EQ(size_t(8), func->getArity());
+  const auto poly_col = get_geo_column_arg(func, 0);
+  const auto bounds_col = get_geo_column_arg(func, 1);
+  const auto point_col = get_geo_column_arg(func, 2);
+  if (get_int_arg(func, 4) != get_int_arg(func, 7) || get_int_arg(func, 6) != get_int_arg(func, 7)) {
+    throw HashJoinFail("Spatial join index doesn't support transformed geometries");
+  }
+  if (poly_col->get_rte_idx() <= point_col->get_rte_idx()) {
+    throw HashJoinFail("Spatial join index requires the polygons on the inner side");
+  }
+  return {poly_col, bounds_col, point_col, get_int_arg(func, 3), get_int_arg(func, 5), 0};
+}
+
+// Grid over the given boxes (4 doubles each, NaNs for null rows), laid out as described in SpatialGrid.h.
+std::shared_ptr<std::vector<int8_t>> build_spatial_grid(const std::vector<double>& boxes) {
+  const size_t row_count = boxes.size() / 4;
+  SpatialGridHeader header{1, 1, 0, 0, 0, 0, 1, 1};  // empty extent, every probe misses
+  size_t box_count{0};
+  double total_width{0};
+  double total_height{0};
+  for (size_t i = 0; i < row_count; ++i) {
+    const auto box = &boxes[4 * i];
+    if (std::isnan(box[0])) {
+      continue;
+    }
+    if (!box_count) {
+      header.min_x = box[0];
+      header.min_y = box[1];
+      header.max_x = box[2];
+      header.max_y = box[3];
+    }
+    header.min_x = std::min(header.min_x, box[0]);
+    header.min_y = std::min(header.min_y, box[1]);
+    header.max_x = std::max(header.max_x, box[2]);
+    header.max_y = std::max(header.max_y, box[3]);
+    total_width += box[2] - box[0];
+    total_height += box[3] - box[1];
+    ++box_count;
+  }
+  std::vector<int64_t> cell_ranges;
+  size_t ref_count{0};
+  if (box_count) {
+    // Start with about one cell per box, but no smaller than the average box, and coarsen the grid
+    // while large boxes spanning many cells dominate the size of the index.
+    const auto width = header.max_x - header.min_x;
+    const auto height = header.max_y - header.min_y;
+    const auto cells_per_axis = std::ceil(std::sqrt(static_cast<double>(box_count)));
+    auto cell_width = std::max(width / cells_per_axis, total_width / box_count);
+    auto cell_height = std::max(height / cells_per_axis, total_height / box_count);
+    while (true) {
+      header.x_cells = cell_width > 0 ? std::max(int64_t(1), static_cast<int64_t>(std::ceil(width / cell_width))) : 1;
+      header.y_cells =
+          cell_height > 0 ? std::max(int64_t(1), static_cast<int64_t>(std::ceil(height / cell_height))) : 1;
+      header.x_cells_per_unit = cell_width > 0 ? 1 / cell_width : 0;
+      header.y_cells_per_unit = cell_height > 0 ? 1 / cell_height : 0;
+      cell_ranges.clear();
+      ref_count = 0;
+      for (size_t i = 0; i < row_count; ++i) {
+        const auto box = &boxes[4 * i];
+        if (std::isnan(box[0])) {
+          cell_ranges.insert(cell_ranges.end(), {-1, -1, -1, -1});
+          continue;
+        }
+        const auto x0 = spatial_grid_axis_cell(
+            box[0], header.min_x, header.max_x, header.x_cells_per_unit, header.x_cells);
+        const auto y0 = spatial_grid_axis_cell(
+            box[1], header.min_y, header.max_y, header.y_cells_per_unit, header.y_cells);
+        const auto x1 = spatial_grid_axis_cell(
+            box[2], header.min_x, header.max_x, header.x_cells_per_unit, header.x_cells);
+        const auto y1 = spatial_grid_axis_cell(
+            box[3], header.min_y, header.max_y, header.y_cells_per_unit, header.y_cells);
+        CHECK(x0 >= 0 && y0 >= 0 && x1 >= x0 && y1 >= y0);
+        cell_ranges.insert(cell_ranges.end(), {x0, y0, x1, y1});
+        ref_count += (x1 - x0 + 1) * (y1 - y0 + 1);
+      }
+      const size_t cell_count = header.x_cells * header.y_cells;
+      if (ref_count <= 8 * (box_count + cell_count) || cell_count == 1) {
+        break;
+      }
+      cell_width = cell_width > 0 ? 2 * cell_width : width;
+      cell_height = cell_height > 0 ? 2 * cell_height : height;
+    }
+  }
+  const size_t cell_count = header.x_cells * header.y_cells;
+  if (ref_count > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+      cell_count > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  auto buffer = std::make_shared<std::vector<int8_t>>(
+      sizeof(SpatialGridHeader) + (2 * cell_count + ref_count) * sizeof(int32_t), 0);
+  memcpy(&(*buffer)[0], &header, sizeof(SpatialGridHeader));
+  auto offsets = reinterpret_cast<int32_t*>(&(*buffer)[sizeof(SpatialGridHeader)]);
+  auto counts = offsets + cell_count;
+  auto row_ids = counts + cell_count;
+  for (size_t i = 0; i < cell_ranges.size() / 4; ++i) {
+    const auto range = &cell_ranges[4 * i];
+    if (range[0] < 0) {
+      continue;
+    }
+    for (auto y = range[1]; y <= range[3]; ++y) {
+      for (auto x = range[0]; x <= range[2]; ++x) {
+        ++counts[y * header.x_cells + x];
+      }
+    }
+  }
+  int32_t offset{0};
+  for (size_t cell = 0; cell < cell_count; ++cell) {
+    offsets[cell] = offset;
+    offset += counts[cell];
+    counts[cell] = 0;
+  }
+  for (size_t i = 0; i < cell_ranges.size() / 4; ++i) {
+    const auto range = &cell_ranges[4 * i];
+    if (range[0] < 0) {
+      continue;
+    }
+    for (auto y = range[1]; y <= range[3]; ++y) {
+      for (auto x = range[0]; x <= range[2]; ++x) {
+        const auto cell = y * header.x_cells + x;
+        row_ids[offsets[cell] + counts[cell]++] = static_cast<int32_t>(i);
+      }
+    }
+  }
+  return buffer;
+}
+
+}  // namespace
+
+std::shared_ptr<SpatialJoinHashTable> SpatialJoinHashTable::getInstance(const std::shared_ptr<Analyzer::Expr> qual,
+                                                                        const std::vector<InputTableInfo>& query_infos,
+                                                                        const Data_Namespace::MemoryLevel memory_level,
+                                                                        const int device_count,
+                                                                        Executor* executor) {
+  const auto predicate = normalize_spatial_predicate(qual.get());
+  auto join_hash_table = std::shared_ptr<SpatialJoinHashTable>(
+      new SpatialJoinHashTable(qual, predicate, query_infos, memory_level, executor));
+  join_hash_table->reify(device_count);
+  return join_hash_table;
+}
+
+SpatialJoinHashTable::SpatialJoinHashTable(const std::shared_ptr<Analyzer::Expr> qual,
+                                           const SpatialPredicate& predicate,
+                                           const std::vector<InputTableInfo>& query_infos,
+                                           const Data_Namespace::MemoryLevel memory_level,
+                                           Executor* executor)
+    : qual_(qual),
+      predicate_(predicate),
+      query_infos_(query_infos),
+      memory_level_(memory_level),
+      executor_(executor),
+      cell_count_(0) {}
+
+int64_t SpatialJoinHashTable::getJoinHashBuffer(const ExecutorDeviceType device_type, const int device_id) noexcept {
+  if (device_type == ExecutorDeviceType::CPU && !cpu_hash_table_buff_) {
+    return 0;
+  }
+#ifdef HAVE_CUDA
+  CHECK_LT(static_cast<size_t>(device_id), gpu_hash_table_buff_.size());
+  return device_type == ExecutorDeviceType::CPU
+             ? reinterpret_cast<int64_t>(&(*cpu_hash_table_buff_)[0])
+             : reinterpret_cast<int64_t>(gpu_hash_table_buff_[device_id]->getMemoryPtr());
+#else
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  return reinterpret_cast<int64_t>(&(*cpu_hash_table_buff_)[0]);
+#endif
+}
+
+void SpatialJoinHashTable::reify(const int device_count) {
+  CHECK_LT(0, device_count);
+  const auto& catalog = *executor_->getCatalog();
+  const auto& query_info = get_inner_query_info(getInnerTableId(), query_infos_).info;
+  const auto box_col_id = predicate_.inner_bounds_col ? predicate_.inner_bounds_col->get_column_id()
+                                                      : predicate_.inner_geo_col->get_column_id() + 1;
+  std::vector<ChunkKey> chunk_keys;
+  for (const auto& fragment : query_info.fragments) {
+    chunk_keys.push_back({catalog.get_currentDB().dbId, fragment.physicalTableId, box_col_id, fragment.fragmentId});
+  }
+  const HashTableCacheKey cache_key{query_info.getNumTuples(), chunk_keys, predicate_.distance};
+  initHashTableOnCpuFromCache(cache_key);
+  if (!cpu_hash_table_buff_) {
+    cpu_hash_table_buff_ = build_spatial_grid(fetchInnerBoxes(query_info.fragments));
+    putHashTableOnCpuToCache(cache_key);
+  }
+  const auto header = reinterpret_cast<const SpatialGridHeader*>(&(*cpu_hash_table_buff_)[0]);
+  cell_count_ = header->x_cells * header->y_cells;
+#ifdef HAVE_CUDA
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    auto& data_mgr = executor_->getCatalog()->get_dataMgr();
+    gpu_hash_table_buff_.resize(device_count);
+    for (int device_id = 0; device_id < device_count; ++device_id) {
+      gpu_hash_table_buff_[device_id] =
+          alloc_gpu_abstract_buffer(&data_mgr, cpu_hash_table_buff_->size(), device_id);
+      copy_to_gpu(&data_mgr,
+                  reinterpret_cast<CUdeviceptr>(gpu_hash_table_buff_[device_id]->getMemoryPtr()),
+                  &(*cpu_hash_table_buff_)[0],
+                  cpu_hash_table_buff_->size(),
+                  device_id);
+    }
+  }
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif
+}
+
+std::vector<double> SpatialJoinHashTable::fetchInnerBoxes(
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) const {
+  const auto& catalog = *executor_->getCatalog();
+  const auto inner_table_id = getInnerTableId();
+  const auto box_col_id = predicate_.inner_bounds_col ? predicate_.inner_bounds_col->get_column_id()
+                                                      : predicate_.inner_geo_col->get_column_id() + 1;
+  const auto cd = get_column_descriptor(box_col_id, inner_table_id, catalog);
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> boxes;
+  // Row ids are positions in the inner table with its fragments concatenated, as for the other hash joins.
+  for (const auto& fragment : fragments) {
+    if (fragment.isEmptyPhysicalFragment()) {
+      continue;
+    }
+    auto chunk_meta_it = fragment.getChunkMetadataMap().find(box_col_id);
+    CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+    ChunkKey chunk_key{catalog.get_currentDB().dbId, fragment.physicalTableId, box_col_id, fragment.fragmentId};
+    const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                 &catalog.get_dataMgr(),
+                                                 chunk_key,
+                                                 Data_Namespace::CPU_LEVEL,
+                                                 0,
+                                                 chunk_meta_it->second.numBytes,
+                                                 chunk_meta_it->second.numElements);
+    CHECK(chunk);
+    auto chunk_iter = chunk->begin_iterator(chunk_meta_it->second);
+    for (size_t i = 0; i < fragment.getNumTuples(); ++i) {
+      ArrayDatum ad;
+      bool is_end;
+      ChunkIter_get_nth(&chunk_iter, i, &ad, &is_end);
+      CHECK(!is_end);
+      if (predicate_.inner_bounds_col) {
+        if (ad.is_null || ad.length < 4 * sizeof(double)) {
+          boxes.insert(boxes.end(), {nan, nan, nan, nan});
+          continue;
+        }
+        const auto bounds = reinterpret_cast<const double*>(ad.pointer);
+        boxes.insert(boxes.end(), {bounds[0], bounds[1], bounds[2], bounds[3]});
+        continue;
+      }
+      if (ad.is_null || ad.length < 2 * (predicate_.inner_compression == 1 ? sizeof(int32_t) : sizeof(double))) {
+        boxes.insert(boxes.end(), {nan, nan, nan, nan});
+        continue;
+      }
+      const auto x = spatial_grid_decode_coord(ad.pointer, 0, predicate_.inner_compression);
+      const auto y = spatial_grid_decode_coord(ad.pointer, 1, predicate_.inner_compression);
+      // Pad the distance a little so that rounding in the exact distance computation can't drop matches.
+      const auto d = predicate_.distance + 1e-9 * (std::abs(x) + std::abs(y) + predicate_.distance);
+      boxes.insert(boxes.end(), {x - d, y - d, x + d, y + d});
+    }
+  }
+  return boxes;
+}
+
+#define LL_CONTEXT executor_->cgen_state_->context_
+#define LL_BUILDER executor_->cgen_state_->ir_builder_
+#define LL_INT(v) executor_->ll_int(v)
+
+llvm::Value* SpatialJoinHashTable::codegenSlotIsValid(const CompilationOptions&, const size_t) {
+  CHECK(false);
+  return nullptr;
+}
+
+llvm::Value* SpatialJoinHashTable::codegenSlot(const CompilationOptions&, const size_t) {
+  CHECK(false);
+  return nullptr;
+}
+
+HashJoinMatchingSet SpatialJoinHashTable::codegenMatchingSet(const CompilationOptions& co, const size_t index) {
+  auto hash_ptr = JoinHashTable::codegenHashTableLoad(index, executor_);
+  const auto pi8_type = llvm::Type::getInt8PtrTy(LL_CONTEXT);
+  const auto grid_buff = hash_ptr->getType()->isPointerTy() ? LL_BUILDER.CreatePointerCast(hash_ptr, pi8_type)
+                                                            : LL_BUILDER.CreateIntToPtr(hash_ptr, pi8_type);
+  const auto outer_col = predicate_.outer_point_col;
+  const auto outer_col_lvs = executor_->codegen(outer_col, true, co);
+  CHECK_EQ(size_t(1), outer_col_lvs.size());
+  const auto coords_lv = executor_->cgen_state_->emitExternalCall(
+      "array_buff", pi8_type, {outer_col_lvs.front(), executor_->posArg(outer_col)});
+  const auto coords_size_lv = executor_->cgen_state_->emitExternalCall(
+      "array_size",
+      get_int_type(32, LL_CONTEXT),
+      {outer_col_lvs.front(), executor_->posArg(outer_col), LL_INT(uint32_t(0))});
+  const auto slot_lv = executor_->cgen_state_->emitExternalCall(
+      "spatial_grid_cell",
+      get_int_type(64, LL_CONTEXT),
+      {grid_buff,
+       coords_lv,
+       LL_BUILDER.CreateZExt(coords_size_lv, get_int_type(64, LL_CONTEXT)),
+       LL_INT(predicate_.outer_compression)});
+  const auto slot_valid_lv = LL_BUILDER.CreateICmpSGE(slot_lv, LL_INT(int64_t(0)));
+  const auto safe_slot_lv = LL_BUILDER.CreateSelect(slot_valid_lv, slot_lv, LL_INT(int64_t(0)));
+  const auto offsets_lv = LL_BUILDER.CreatePointerCast(
+      LL_BUILDER.CreateGEP(grid_buff, LL_INT(sizeof(SpatialGridHeader))), llvm::Type::getInt32PtrTy(LL_CONTEXT));
+  const auto offset_lv = LL_BUILDER.CreateLoad(LL_BUILDER.CreateGEP(offsets_lv, safe_slot_lv));
+  const auto count_lv = LL_BUILDER.CreateLoad(
+      LL_BUILDER.CreateGEP(offsets_lv, LL_BUILDER.CreateAdd(safe_slot_lv, LL_INT(static_cast<int64_t>(cell_count_)))));
+  const auto row_ids_lv = LL_BUILDER.CreateGEP(offsets_lv, LL_INT(static_cast<int64_t>(2 * cell_count_)));
+  const auto row_count_lv = LL_BUILDER.CreateSelect(
+      slot_valid_lv, LL_BUILDER.CreateSExt(count_lv, get_int_type(64, LL_CONTEXT)), LL_INT(int64_t(0)));
+  return {LL_BUILDER.CreateGEP(row_ids_lv, offset_lv), row_count_lv, slot_lv};
+}
+
+#undef LL_INT
+#undef LL_BUILDER
+#undef LL_CONTEXT
+
+int SpatialJoinHashTable::getInnerTableId() const noexcept {
+  return predicate_.inner_geo_col->get_table_id();
+}
+
+int SpatialJoinHashTable::getInnerTableRteIdx() const noexcept {
+  return predicate_.inner_geo_col->get_rte_idx();
+}
+
+JoinHashTableInterface::HashType SpatialJoinHashTable::getHashType() const noexcept {
+  return JoinHashTableInterface::HashType::OneToMany;
+}
+
+void SpatialJoinHashTable::initHashTableOnCpuFromCache(const HashTableCacheKey& key) {
+  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
+  for (const auto& kv : hash_table_cache_) {
+    if (kv.first == key) {
+      cpu_hash_table_buff_ = kv.second;
+      break;
+    }
+  }
+}
+
+void SpatialJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& key) {
+  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
+  for (const auto& kv : hash_table_cache_) {
+    if (kv.first == key) {
+      return;
+    }
+  }
+  hash_table_cache_.emplace_back(key, cpu_hash_table_buff_);
+}
+
+bool skip_fragment_by_geo_bounds(const int table_id,
+                                 const Fragmenter_Namespace::FragmentInfo& fragment,
+                                 const std::list<std::shared_ptr<Analyzer::Expr>>& quals) {
+  if (table_id <= 0) {
+    return false;
+  }
+  for (const auto& qual : quals) {
+    const auto func = dynamic_cast<const Analyzer::FunctionOper*>(qual.get());
+    if (!func || !is_contains_point(func->getName())) {
+      continue;
+    }
+    CHECK_EQ(size_t(8), func->getArity());
+    const auto poly_col = dynamic_cast<const Analyzer::ColumnVar*>(func->getArg(0));
+    const auto bounds_col = dynamic_cast<const Analyzer::ColumnVar*>(func->getArg(1));
+    const auto point = dynamic_cast<const Analyzer::Constant*>(func->getArg(2));
+    if (!poly_col || poly_col->get_table_id() != table_id || poly_col->get_rte_idx() > 0 || !bounds_col || !point) {
+      continue;
+    }
+    const auto ic1 = dynamic_cast<const Analyzer::Constant*>(func->getArg(3));
+    const auto isr1 = dynamic_cast<const Analyzer::Constant*>(func->getArg(4));
+    const auto ic2 = dynamic_cast<const Analyzer::Constant*>(func->getArg(5));
+    const auto isr2 = dynamic_cast<const Analyzer::Constant*>(func->getArg(6));
+    const auto osr = dynamic_cast<const Analyzer::Constant*>(func->getArg(7));
+    if (!ic1 || !isr1 || !ic2 || !isr2 || !osr || isr1->get_constval().intval != osr->get_constval().intval ||
+        isr2->get_constval().intval != osr->get_constval().intval) {
+      continue;
+    }
+    std::vector<int8_t> coords;
+    for (const auto& byte : point->get_value_list()) {
+      const auto byte_constant = dynamic_cast<const Analyzer::Constant*>(byte.get());
+      CHECK(byte_constant);
+      coords.push_back(byte_constant->get_constval().tinyintval);
+    }
+    const auto compression = ic2->get_constval().intval;
+    if (coords.size() < 2 * (compression == 1 ? sizeof(int32_t) : sizeof(double))) {
+      continue;
+    }
+    const auto chunk_meta_it = fragment.getChunkMetadataMap().find(bounds_col->get_column_id());
+    if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+      continue;
+    }
+    // The bounds column statistics cover the x and the y bounds alike, a square containing all the boxes.
+    const auto& stats = chunk_meta_it->second.chunkStats;
+    const auto x = spatial_grid_decode_coord(&coords[0], 0, compression);
+    const auto y = spatial_grid_decode_coord(&coords[0], 1, compression);
+    if (x < stats.min.doubleval || x > stats.max.doubleval || y < stats.min.doubleval || y > stats.max.doubleval) {
+      return true;
+    }
+  }
+  return false;
+}
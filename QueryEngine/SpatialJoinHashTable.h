@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef QUERYENGINE_SPATIALJOINHASHTABLE_H
+#define QUERYENGINE_SPATIALJOINHASHTABLE_H
+
+#include "../Analyzer/Analyzer.h"
+#include "../DataMgr/MemoryLevel.h"
+#include "InputMetadata.h"
+#include "JoinHashTableInterface.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <vector>
+
+class Executor;
+
+// Index for joins on a spatial predicate between a point column of the outer table and geometries of
+// the inner table: ST_Contains(inner_polygon, outer_point) and ST_Distance(inner_point, outer_point) <= d.
+// The bounding box of every inner geometry (expanded by d for the distance) is assigned to the cells
+// of a uniform grid it overlaps, see SpatialGrid.h for the layout. Probing returns the rows of the cell
+// which contains the outer point, a superset of the matches; the predicate is evaluated on each of them.
+class SpatialJoinHashTable : public JoinHashTableInterface {
+ public:
+  static std::shared_ptr<SpatialJoinHashTable> getInstance(const std::shared_ptr<Analyzer::Expr> qual,
+                                                           const std::vector<InputTableInfo>& query_infos,
+                                                           const Data_Namespace::MemoryLevel memory_level,
+                                                           const int device_count,
+                                                           Executor* executor);
+
+  int64_t getJoinHashBuffer(const ExecutorDeviceType device_type, const int device_id) noexcept override;
+
+  llvm::Value* codegenSlotIsValid(const CompilationOptions&, const size_t) override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override;
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&, const size_t) override;
+
+  int getInnerTableId() const noexcept override;
+
+  int getInnerTableRteIdx() const noexcept override;
+
+  JoinHashTableInterface::HashType getHashType() const noexcept override;
+
+  static auto yieldCacheInvalidator() -> std::function<void()> {
+    return []() -> void {
+      std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
+      hash_table_cache_.clear();
+    };
+  }
+
+  // Geometry columns and parameters of a supported spatial join predicate.
+  struct SpatialPredicate {
+    const Analyzer::ColumnVar* inner_geo_col;
+    const Analyzer::ColumnVar* inner_bounds_col;  // nullptr when the inner geometries are points
+    const Analyzer::ColumnVar* outer_point_col;
+    int32_t inner_compression;
+    int32_t outer_compression;
+    double distance;
+  };
+
+ private:
+  SpatialJoinHashTable(const std::shared_ptr<Analyzer::Expr> qual,
+                       const SpatialPredicate& predicate,
+                       const std::vector<InputTableInfo>& query_infos,
+                       const Data_Namespace::MemoryLevel memory_level,
+                       Executor* executor);
+
+  void reify(const int device_count);
+
+  std::vector<double> fetchInnerBoxes(const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) const;
+
+  struct HashTableCacheKey {
+    const size_t num_elements;
+    const std::vector<ChunkKey> chunk_keys;
+    const double distance;
+
+    bool operator==(const struct HashTableCacheKey& that) const {
+      return num_elements == that.num_elements && chunk_keys == that.chunk_keys && distance == that.distance;
+    }
+  };
+
+  void initHashTableOnCpuFromCache(const HashTableCacheKey&);
+
+  void putHashTableOnCpuToCache(const HashTableCacheKey&);
+
+  const std::shared_ptr<Analyzer::Expr> qual_;
+  const SpatialPredicate predicate_;
+  const std::vector<InputTableInfo>& query_infos_;
+  const Data_Namespace::MemoryLevel memory_level_;
+  Executor* executor_;
+  size_t cell_count_;
+  std::shared_ptr<std::vector<int8_t>> cpu_hash_table_buff_;
+#ifdef HAVE_CUDA
+  std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_buff_;
+#endif
+
+  static std::vector<std::pair<HashTableCacheKey, std::shared_ptr<std::vector<int8_t>>>> hash_table_cache_;
+  static std::mutex hash_table_cache_mutex_;
+};
+
+// Returns true if the bounds column metadata of the fragment proves that none of its geometries can
+// contain the constant point of an ST_Contains(outer_geo_column, point literal) qualifier.
+bool skip_fragment_by_geo_bounds(const int table_id,
+                                 const Fragmenter_Namespace::FragmentInfo& fragment,
+                                 const std::list<std::shared_ptr<Analyzer::Expr>>& quals);
+
+#endif  // QUERYENGINE_SPATIALJOINHASHTABLE_H
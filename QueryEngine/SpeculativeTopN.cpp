@@ -139,13 +139,19 @@ RowSetPtr SpeculativeTopNMap::asRows(const RelAlgExecutionUnit& ra_exe_unit,
 }
 
 void SpeculativeTopNBlacklist::add(const std::shared_ptr<Analyzer::Expr> expr, const bool desc) {
-  for (const auto e : blacklist_) {
-    CHECK(!(*e.first == *expr) || e.second != desc);
+  std::lock_guard<std::mutex> lock(blacklist_mutex_);
+  // another step can have failed on the same expression in the meantime
+  if (!containsUnlocked(expr, desc)) {
+    blacklist_.emplace_back(expr, desc);
   }
-  blacklist_.emplace_back(expr, desc);
 }
 
 bool SpeculativeTopNBlacklist::contains(const std::shared_ptr<Analyzer::Expr> expr, const bool desc) const {
+  std::lock_guard<std::mutex> lock(blacklist_mutex_);
+  return containsUnlocked(expr, desc);
+}
+
+bool SpeculativeTopNBlacklist::containsUnlocked(const std::shared_ptr<Analyzer::Expr> expr, const bool desc) const {
   for (const auto e : blacklist_) {
     if (*e.first == *expr && e.second == desc) {
       return true;
@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_map>
 #include <vector>
@@ -81,13 +82,17 @@ class SpeculativeTopNFailed : public std::runtime_error {
   SpeculativeTopNFailed() : std::runtime_error("SpeculativeTopNFailed"){};
 };
 
+// Shared by all queries, steps running concurrently can add to it.
 class SpeculativeTopNBlacklist {
  public:
   void add(const std::shared_ptr<Analyzer::Expr> expr, const bool desc);
   bool contains(const std::shared_ptr<Analyzer::Expr> expr, const bool desc) const;
 
  private:
+  bool containsUnlocked(const std::shared_ptr<Analyzer::Expr> expr, const bool desc) const;
+
   std::vector<std::pair<std::shared_ptr<Analyzer::Expr>, bool>> blacklist_;
+  mutable std::mutex blacklist_mutex_;
 };
 
 bool use_speculative_top_n(const RelAlgExecutionUnit&, const QueryMemoryDescriptor&);
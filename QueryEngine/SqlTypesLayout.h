@@ -49,7 +49,9 @@ inline const SQLTypeInfo& get_compact_type(const TargetInfo& target) {
     return target.sql_type;
   }
 
-  return (agg_type != kCOUNT && agg_type != kAPPROX_COUNT_DISTINCT) ? agg_arg : target.sql_type;
+  return (agg_type != kCOUNT && agg_type != kAPPROX_COUNT_DISTINCT && agg_type != kAPPROX_PERCENTILE)
+             ? agg_arg
+             : target.sql_type;
 }
 
 template <typename T>
@@ -113,7 +115,9 @@ inline int64_t inline_int_null_val(const SQLTypeInfo& ti) {
 }
 
 inline int64_t inline_fixed_encoding_null_val(const SQLTypeInfo& ti) {
-  if (ti.get_compression() == kENCODING_NONE) {
+  // Run length and frame of reference encoders take and the decoders return the logical null.
+  if (ti.get_compression() == kENCODING_NONE || ti.get_compression() == kENCODING_RL ||
+      ti.get_compression() == kENCODING_DIFF) {
     return inline_int_null_val(ti);
   }
   if (ti.get_compression() == kENCODING_DICT) {
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TDigest.h
+ * @brief   Merging t-digest, the state behind APPROX_PERCENTILE and APPROX_MEDIAN.
+ *
+ * Values are buffered and periodically merged into at most about `compression` centroids,
+ * which are small near the tails and large around the median. Two digests merge into one
+ * with the same accuracy, which is what group by reduction needs. Also compiled into the
+ * runtime bitcode, keep it C++11.
+ **/
+
+#ifndef QUERYENGINE_TDIGEST_H
+#define QUERYENGINE_TDIGEST_H
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+class TDigest {
+ public:
+  // The fraction is the percentile the slot has been asked for, in [0, 1].
+  explicit TDigest(const double fraction, const size_t compression = 100)
+      : fraction_(fraction),
+        compression_(compression),
+        centroid_weight_(0),
+        min_(std::numeric_limits<double>::max()),
+        max_(std::numeric_limits<double>::lowest()) {}
+
+  void add(const double value) {
+    if (buffer_.empty()) {
+      buffer_.reserve(bufferCapacity());
+    }
+    buffer_.push_back(value);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (buffer_.size() >= bufferCapacity()) {
+      flush();
+    }
+  }
+
+  // Doesn't modify the other digest, it can be read concurrently.
+  void merge(const TDigest& that) {
+    if (&that == this) {
+      return;
+    }
+    if (!that.buffer_.empty()) {
+      TDigest flushed(that);
+      flushed.flush();
+      merge(flushed);
+      return;
+    }
+    if (that.centroids_.empty()) {
+      return;
+    }
+    flush();
+    std::vector<Centroid> all;
+    all.reserve(centroids_.size() + that.centroids_.size());
+    std::merge(centroids_.begin(), centroids_.end(), that.centroids_.begin(), that.centroids_.end(),
+               std::back_inserter(all), centroid_less);
+    compress(all, centroid_weight_ + that.centroid_weight_);
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+  }
+
+  double quantile() const { return quantile(fraction_); }
+
+  // NaN if no value has been added. Side effect free, so concurrent readers of a digest are
+  // fine; a digest which hasn't been flushed is flushed on a copy.
+  double quantile(const double q) const {
+    if (!buffer_.empty()) {
+      TDigest flushed(*this);
+      flushed.flush();
+      return flushed.quantile(q);
+    }
+    if (centroids_.empty()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (q <= 0) {
+      return min_;
+    }
+    if (q >= 1) {
+      return max_;
+    }
+    if (centroids_.size() == 1) {
+      return centroids_.front().mean;
+    }
+    // Centroid i covers the ranks [cumulative, cumulative + weight) and sits in the middle of
+    // them; interpolate between the neighbouring centers, and towards min / max at the ends.
+    const double rank = q * centroid_weight_;
+    const auto& first = centroids_.front();
+    if (rank < first.weight / 2) {
+      return min_ + (first.mean - min_) * rank / (first.weight / 2);
+    }
+    double cumulative = 0;
+    for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+      const auto& crt = centroids_[i];
+      const auto& next = centroids_[i + 1];
+      const double crt_center = cumulative + crt.weight / 2;
+      const double next_center = cumulative + crt.weight + next.weight / 2;
+      if (rank <= next_center) {
+        return crt.mean + (next.mean - crt.mean) * (rank - crt_center) / (next_center - crt_center);
+      }
+      cumulative += crt.weight;
+    }
+    const auto& last = centroids_.back();
+    const double last_center = centroid_weight_ - last.weight / 2;
+    return last.mean + (max_ - last.mean) * std::min((rank - last_center) / (last.weight / 2), 1.);
+  }
+
+  double getFraction() const { return fraction_; }
+
+  size_t centroidCount() const {
+    if (!buffer_.empty()) {
+      TDigest flushed(*this);
+      flushed.flush();
+      return flushed.centroidCount();
+    }
+    return centroids_.size();
+  }
+
+  // Merges the buffered values into the centroids. Done for all the digests of a query once its
+  // reduction is over, after which reading them doesn't need a copy.
+  void flush() {
+    if (buffer_.empty()) {
+      return;
+    }
+    std::sort(buffer_.begin(), buffer_.end());
+    std::vector<Centroid> all;
+    all.reserve(centroids_.size() + buffer_.size());
+    auto centroid_it = centroids_.begin();
+    for (const auto value : buffer_) {
+      while (centroid_it != centroids_.end() && centroid_it->mean < value) {
+        all.push_back(*centroid_it++);
+      }
+      all.push_back({value, 1});
+    }
+    all.insert(all.end(), centroid_it, centroids_.end());
+    compress(all, centroid_weight_ + buffer_.size());
+    buffer_.clear();
+  }
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  static bool centroid_less(const Centroid& lhs, const Centroid& rhs) { return lhs.mean < rhs.mean; }
+
+  size_t bufferCapacity() const { return 5 * compression_; }
+
+  // Scale function k1 of the t-digest paper: a centroid may span at most one unit of k.
+  double scale(const double q) const { return compression_ / (2 * M_PI) * std::asin(2 * std::min(q, 1.) - 1); }
+
+  // Greedily merges neighbours of the sorted centroids as long as the scale function allows.
+  void compress(const std::vector<Centroid>& sorted, const double total_weight) {
+    centroids_.clear();
+    double weight_before = 0;
+    double k_lower = scale(0);
+    Centroid crt = sorted.front();
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      const auto& next = sorted[i];
+      const double q_upper = (weight_before + crt.weight + next.weight) / total_weight;
+      if (scale(q_upper) - k_lower <= 1) {
+        crt.mean += (next.mean - crt.mean) * next.weight / (crt.weight + next.weight);
+        crt.weight += next.weight;
+        continue;
+      }
+      centroids_.push_back(crt);
+      weight_before += crt.weight;
+      k_lower = scale(weight_before / total_weight);
+      crt = next;
+    }
+    centroids_.push_back(crt);
+    centroid_weight_ = total_weight;
+  }
+
+  const double fraction_;
+  const size_t compression_;
+  std::vector<Centroid> centroids_;  // sorted by mean
+  double centroid_weight_;
+  std::vector<double> buffer_;
+  double min_;
+  double max_;
+};
+
+#endif  // QUERYENGINE_TDIGEST_H
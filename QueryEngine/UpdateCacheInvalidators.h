@@ -6,8 +6,11 @@
 // Classes that are involved in needing a cache invalidated when there is an update
 #include "BaselineJoinHashTable.h"
 #include "JoinHashTable.h"
+#include "ResultSetCache.h"
+#include "SpatialJoinHashTable.h"
 
-using UpdateTriggeredCacheInvalidator = CacheInvalidator<BaselineJoinHashTable, JoinHashTable>;
+using UpdateTriggeredCacheInvalidator =
+    CacheInvalidator<BaselineJoinHashTable, JoinHashTable, ResultSetCache, SpatialJoinHashTable>;
 using DeleteTriggeredCacheInvalidator = UpdateTriggeredCacheInvalidator;
 
 #endif
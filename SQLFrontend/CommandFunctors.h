@@ -219,6 +219,8 @@ StandardCommand(Help, {
   std::cout << "\\historylen <number> Set history buffer size (default 100).\n";
   std::cout << "\\timing Print timing information.\n";
   std::cout << "\\notiming Do not print timing information.\n";
+  std::cout << "\\fetch_size <rows> Fetch SELECT results through a server side cursor, <rows> at a time; 0 fetches "
+               "them all at once.\n";
   std::cout << "\\memory_summary Print memory usage summary.\n";
   std::cout << "\\version Print MapD Server version.\n";
   std::cout << "\\copy <file path> <table> Copy data from file to table.\n";
@@ -282,7 +284,7 @@ StandardCommand(ListColumns, {
         const std::string foreign_column = key_with_spec_json["foreign_column"].GetString();
         key_with_spec += foreign_table + "(" + foreign_column + ")";
       } else {
-        CHECK(type == "SHARD KEY");
+        CHECK(type == "SHARD KEY" || type == "SORT KEY");
       }
       keys_with_spec.push_back(key_with_spec);
     }
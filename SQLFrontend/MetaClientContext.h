@@ -53,9 +53,12 @@ struct MetaClientContext {
   TLicenseInfo license_info;
   std::vector<TCompletionHint> completion_hints;
   std::vector<TDashboard> dash_names;
+  int32_t fetch_size;  // rows per fetch_cursor call, 0 runs queries with sql_execute
+  TCursor cursor;
+  TRowSet cursor_rows;
 
   MetaClientContext(TTransport& t, CLIENT_TYPE& c)
-      : transport(t), client(c), session(INVALID_SESSION_ID), execution_mode(TExecuteMode::GPU) {}
+      : transport(t), client(c), session(INVALID_SESSION_ID), execution_mode(TExecuteMode::GPU), fetch_size(0) {}
   MetaClientContext() {}
 };
 
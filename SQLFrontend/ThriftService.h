@@ -34,7 +34,10 @@ enum ThriftService {
   kSET_LICENSE_KEY,
   kGET_LICENSE_CLAIMS,
   kGET_COMPLETION_HINTS,
-  kGET_DASHBOARDS
+  kGET_DASHBOARDS,
+  kOPEN_CURSOR,
+  kFETCH_CURSOR,
+  kCLOSE_CURSOR
 };
 
 #endif
@@ -119,6 +119,15 @@ bool thrift_with_retry(SERVICE_ENUM which_service, CLIENT_CONTEXT& context, char
       case kGET_DASHBOARDS:
         context.client.get_dashboards(context.dash_names, context.session);
         break;
+      case kOPEN_CURSOR:
+        context.client.open_cursor(context.cursor, context.session, arg, true, "");
+        break;
+      case kFETCH_CURSOR:
+        context.client.fetch_cursor(context.cursor_rows, context.session, context.cursor.cursor_id, context.fetch_size);
+        break;
+      case kCLOSE_CURSOR:
+        context.client.close_cursor(context.session, context.cursor.cursor_id);
+        break;
     }
   } catch (TMapDException& e) {
     std::cerr << e.error_msg << std::endl;
@@ -205,13 +205,13 @@ void detect_table(char* file_name, TCopyParams& copy_params, ClientContext& cont
   }
 }
 
-size_t get_row_count(const TQueryResult& query_result) {
-  CHECK(!query_result.row_set.row_desc.empty());
-  if (query_result.row_set.columns.empty()) {
+size_t get_row_count(const TRowSet& row_set) {
+  CHECK(!row_set.row_desc.empty());
+  if (row_set.columns.empty()) {
     return 0;
   }
-  CHECK_EQ(query_result.row_set.columns.size(), query_result.row_set.row_desc.size());
-  return query_result.row_set.columns.front().nulls.size();
+  CHECK_EQ(row_set.columns.size(), row_set.row_desc.size());
+  return row_set.columns.front().nulls.size();
 }
 
 void get_table_epoch(ClientContext& context, const std::string& table_specifier) {
@@ -933,6 +933,77 @@ std::string hide_sensitive_data_from_connect(const std::string& connect_str) {
   return result;
 }
 
+void print_header_row(const TRowDescriptor& row_desc, const std::string& delimiter) {
+  bool not_first = false;
+  for (auto p : row_desc) {
+    if (p.is_physical) {
+      // TODO(d): skip if we decide to suppress displaying physical columns
+    }
+    if (not_first)
+      std::cout << delimiter;
+    else
+      not_first = true;
+    std::cout << p.col_name;
+  }
+  std::cout << std::endl;
+}
+
+void print_rows(const TRowSet& row_set, const std::string& delimiter) {
+  const size_t row_count{get_row_count(row_set)};
+  const auto& col_desc = row_set.row_desc;
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    for (size_t col_idx = 0; col_idx < col_desc.size(); ++col_idx) {
+      if (col_idx) {
+        std::cout << delimiter;
+      }
+      const auto& col_type = col_desc[col_idx].col_type;
+      std::cout << datum_to_string(columnar_val_to_datum(row_set.columns[col_idx], row_idx, col_type), col_type);
+    }
+    std::cout << std::endl;
+  }
+}
+
+bool is_select_query(const std::string& query) {
+  std::istringstream query_stream(query);
+  std::string first_word;
+  query_stream >> first_word;
+  return boost::iequals(first_word, "SELECT") || boost::iequals(first_word, "WITH");
+}
+
+// Runs a SELECT through a server side cursor and prints the rows a page at a time, so that the client
+// never holds more than fetch_size of them.
+void run_query_with_cursor(ClientContext& context,
+                           const std::string& query,
+                           const bool print_header,
+                           const bool print_timing,
+                           const std::string& delimiter) {
+  if (!thrift_with_retry(kOPEN_CURSOR, context, query.c_str())) {
+    return;
+  }
+  if (print_header && context.cursor.row_count) {
+    print_header_row(context.cursor.row_desc, delimiter);
+  }
+  size_t row_count{0};
+  while (thrift_with_retry(kFETCH_CURSOR, context, nullptr)) {
+    const size_t page_row_count{get_row_count(context.cursor_rows)};
+    print_rows(context.cursor_rows, delimiter);
+    row_count += page_row_count;
+    if (page_row_count < static_cast<size_t>(context.fetch_size)) {
+      break;
+    }
+  }
+  (void)thrift_with_retry(kCLOSE_CURSOR, context, nullptr);
+  if (!row_count) {
+    std::cout << "No rows returned." << std::endl;
+  } else if (print_timing) {
+    std::cout << row_count << " rows returned." << std::endl;
+  }
+  if (print_timing) {
+    std::cout << "Execution time: " << context.cursor.execution_time_ms << " ms,"
+              << " Total time: " << context.cursor.total_time_ms << " ms" << std::endl;
+  }
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -942,6 +1013,7 @@ int main(int argc, char** argv) {
   bool print_header = true;
   bool print_connection = true;
   bool print_timing = false;
+  int32_t fetch_size = 0;
   bool http = false;
   TQueryResult _return;
   std::string db_name{"mapd"};
@@ -957,6 +1029,9 @@ int main(int argc, char** argv) {
   desc.add_options()("timing,t",
                      po::bool_switch(&print_timing)->default_value(print_timing)->implicit_value(true),
                      "Print timing information");
+  desc.add_options()("fetch-size",
+                     po::value<int32_t>(&fetch_size)->default_value(fetch_size),
+                     "Fetch SELECT results through a server side cursor, this many rows at a time");
   desc.add_options()(
       "delimiter,d", po::value<std::string>(&delimiter)->default_value(delimiter), "Field delimiter in row output");
   desc.add_options()("db", po::value<std::string>(&db_name)->default_value(db_name), "Database name");
@@ -1025,6 +1100,7 @@ int main(int argc, char** argv) {
   context.server_host = server_host;
   context.port = port;
   context.http = http;
+  context.fetch_size = std::max(fetch_size, 0);
 
   context.session = INVALID_SESSION_ID;
 
@@ -1104,12 +1180,17 @@ int main(int argc, char** argv) {
         current_line.clear();
         prompt.assign("mapdql> ");
         (void)backchannel(TURN_ON, nullptr);
+        if (context.fetch_size > 0 && is_select_query(query)) {
+          run_query_with_cursor(context, query, print_header, print_timing, delimiter);
+          (void)backchannel(TURN_OFF, nullptr);
+          continue;
+        }
         if (thrift_with_retry(kSQL, context, query.c_str())) {
           (void)backchannel(TURN_OFF, nullptr);
           if (context.query_return.row_set.row_desc.empty()) {
             continue;
           }
-          const size_t row_count{get_row_count(context.query_return)};
+          const size_t row_count{get_row_count(context.query_return.row_set)};
           if (!row_count) {
             static const std::string insert{"INSERT"};
             std::string verb(query, 0, insert.size());
@@ -1122,32 +1203,10 @@ int main(int argc, char** argv) {
             }
             continue;
           }
-          bool not_first = false;
           if (print_header) {
-            for (auto p : context.query_return.row_set.row_desc) {
-              if (p.is_physical) {
-                // TODO(d): skip if we decide to suppress displaying physical columns
-              }
-              if (not_first)
-                std::cout << delimiter;
-              else
-                not_first = true;
-              std::cout << p.col_name;
-            }
-            std::cout << std::endl;
-          }
-          for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
-            const auto& col_desc = context.query_return.row_set.row_desc;
-            for (size_t col_idx = 0; col_idx < col_desc.size(); ++col_idx) {
-              if (col_idx) {
-                std::cout << delimiter;
-              }
-              const auto& col_type = col_desc[col_idx].col_type;
-              std::cout << datum_to_string(
-                  columnar_val_to_datum(context.query_return.row_set.columns[col_idx], row_idx, col_type), col_type);
-            }
-            std::cout << std::endl;
+            print_header_row(context.query_return.row_set.row_desc, delimiter);
           }
+          print_rows(context.query_return.row_set, delimiter);
           if (print_timing) {
             std::cout << row_count << " rows returned." << std::endl;
             std::cout << "Execution time: " << context.query_return.execution_time_ms << " ms,"
@@ -1256,6 +1315,8 @@ int main(int argc, char** argv) {
       /* The "/historylen" command will change the history len. */
       int len = atoi(line + 11);
       linenoiseHistorySetMaxLen(len);
+    } else if (!strncmp(line, "\\fetch_size", 11)) {
+      context.fetch_size = std::max(atoi(line + 11), 0);
     } else if (!strncmp(line, "\\multiline", 10)) {
       linenoiseSetMultiLine(1);
     } else if (!strncmp(line, "\\singleline", 11)) {
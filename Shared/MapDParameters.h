@@ -37,6 +37,10 @@ struct MapDParameters {
   std::string ha_brokers;           // name of the HA broker
   std::string ha_shared_data;       // name of shared data directory base
   bool is_decr_start_epoch;         // are we doing a start epoch decrement?
+  size_t num_request_threads = 16;  // max number of requests executing at the same time
+  size_t request_queue_size = 256;  // max number of requests waiting for an execution slot
+  bool nonblocking_server = false;  // serve the binary protocol port with TNonblockingServer
+  size_t cursor_timeout_s = 300;    // seconds an unused cursor stays open, 0 for no limit
 
   MapDParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
 };
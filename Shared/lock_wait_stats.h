@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    lock_wait_stats.h
+ * @brief   Process wide counters of the time spent waiting for the server's coarse locks.
+ *
+ * The sites are the locks every query or load goes through. timed_lock adds two clock reads and
+ * two relaxed atomic updates to an acquisition, cheap next to what these locks protect.
+ */
+
+#ifndef LOCK_WAIT_STATS_H
+#define LOCK_WAIT_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+enum class LockWaitSite {
+  EXECUTE_MUTEX,            // Executor::execute_mutex_
+  SESSIONS_MUTEX,           // MapDHandler::sessions_mutex_
+  EXECUTOR_OUTER_LOCK,      // Lock_Namespace::ExecutorOuterLock
+  TABLE_METADATA_LOCK,      // Lock_Namespace::TableMetadataLock
+  CHECKPOINT_LOCK,          // Lock_Namespace::CheckpointLock
+  UPDATE_DELETE_LOCK,       // Lock_Namespace::UpdateDeleteLock
+  BUFFER_MGR_GLOBAL_MUTEX,  // BufferMgr::globalMutex_, taken by every chunk fetch
+  COUNT
+};
+
+struct LockWaitStats {
+  uint64_t acquisitions;
+  int64_t total_wait_us;
+  int64_t max_wait_us;
+};
+
+namespace lock_wait_detail {
+
+struct Counters {
+  std::atomic<uint64_t> acquisitions;
+  std::atomic<int64_t> total_wait_ns;
+  std::atomic<int64_t> max_wait_ns;
+};
+
+inline Counters& counters(const LockWaitSite site) {
+  static Counters all_counters[static_cast<size_t>(LockWaitSite::COUNT)]{};
+  return all_counters[static_cast<size_t>(site)];
+}
+
+}  // namespace lock_wait_detail
+
+inline const char* lock_wait_site_name(const LockWaitSite site) {
+  switch (site) {
+    case LockWaitSite::EXECUTE_MUTEX:
+      return "execute_mutex";
+    case LockWaitSite::SESSIONS_MUTEX:
+      return "sessions_mutex";
+    case LockWaitSite::EXECUTOR_OUTER_LOCK:
+      return "executor_outer_lock";
+    case LockWaitSite::TABLE_METADATA_LOCK:
+      return "table_metadata_lock";
+    case LockWaitSite::CHECKPOINT_LOCK:
+      return "checkpoint_lock";
+    case LockWaitSite::UPDATE_DELETE_LOCK:
+      return "update_delete_lock";
+    case LockWaitSite::BUFFER_MGR_GLOBAL_MUTEX:
+      return "buffer_mgr_global_mutex";
+    default:
+      return "unknown";
+  }
+}
+
+inline void record_lock_wait(const LockWaitSite site, const int64_t wait_ns) {
+  auto& counters = lock_wait_detail::counters(site);
+  counters.acquisitions.fetch_add(1, std::memory_order_relaxed);
+  counters.total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  auto max_wait_ns = counters.max_wait_ns.load(std::memory_order_relaxed);
+  while (wait_ns > max_wait_ns &&
+         !counters.max_wait_ns.compare_exchange_weak(max_wait_ns, wait_ns, std::memory_order_relaxed)) {
+  }
+}
+
+inline LockWaitStats get_lock_wait_stats(const LockWaitSite site) {
+  const auto& counters = lock_wait_detail::counters(site);
+  return {counters.acquisitions.load(std::memory_order_relaxed),
+          counters.total_wait_ns.load(std::memory_order_relaxed) / 1000,
+          counters.max_wait_ns.load(std::memory_order_relaxed) / 1000};
+}
+
+inline void reset_lock_wait_stats() {
+  for (size_t i = 0; i < static_cast<size_t>(LockWaitSite::COUNT); ++i) {
+    auto& counters = lock_wait_detail::counters(static_cast<LockWaitSite>(i));
+    counters.acquisitions = 0;
+    counters.total_wait_ns = 0;
+    counters.max_wait_ns = 0;
+  }
+}
+
+// Acquires a lock of type LOCK (std / boost lock_guard excluded, it can't be returned) on the
+// mutex and charges the time it took to the site.
+template <typename LOCK, typename MUTEX>
+LOCK timed_lock(MUTEX& mutex, const LockWaitSite site) {
+  const auto start = std::chrono::steady_clock::now();
+  LOCK lock(mutex);
+  record_lock_wait(
+      site, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+  return lock;
+}
+
+#endif  // LOCK_WAIT_STATS_H
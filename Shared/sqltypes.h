@@ -211,7 +211,7 @@ class SQLTypeInfo {
   HOST DEVICE inline int get_comp_param() const { return comp_param; }
   HOST DEVICE inline int get_size() const { return size; }
   inline int get_logical_size() const {
-    if (compression == kENCODING_FIXED) {
+    if (compression == kENCODING_FIXED || compression == kENCODING_RL || compression == kENCODING_DIFF) {
       SQLTypeInfo ti(type, dimension, scale, notnull, kENCODING_NONE, 0, subtype);
       return ti.get_size();
     }
@@ -465,13 +465,12 @@ class SQLTypeInfo {
       case kSMALLINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:  // runs vary in length, only the logical size is meaningful
             return sizeof(int16_t);
           case kENCODING_FIXED:
+          case kENCODING_DIFF:
           case kENCODING_SPARSE:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -479,13 +478,12 @@ class SQLTypeInfo {
       case kINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(int32_t);
           case kENCODING_FIXED:
+          case kENCODING_DIFF:
           case kENCODING_SPARSE:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -495,13 +493,12 @@ class SQLTypeInfo {
       case kDECIMAL:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(int64_t);
           case kENCODING_FIXED:
+          case kENCODING_DIFF:
           case kENCODING_SPARSE:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -543,11 +540,11 @@ class SQLTypeInfo {
       case kDATE:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(time_t);
           case kENCODING_FIXED:
-            return comp_param / 8;
-          case kENCODING_RL:
           case kENCODING_DIFF:
+            return comp_param / 8;
           case kENCODING_SPARSE:
             assert(false);
             break;
@@ -589,7 +586,7 @@ int64_t convert_decimal_value_to_scale(const int64_t decimal_value,
 
 inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
   EncodingType encoding = type_info.get_compression();
-  if (encoding == kENCODING_FIXED) {
+  if (encoding == kENCODING_FIXED || encoding == kENCODING_RL || encoding == kENCODING_DIFF) {
     encoding = kENCODING_NONE;
   }
   return SQLTypeInfo(type_info.get_type(),
@@ -601,6 +598,17 @@ inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
                      type_info.get_subtype());
 }
 
+// Run length and frame of reference chunks are only understood by the column decoders, which
+// produce plain values. Results and temporary tables built from such columns use this type.
+inline SQLTypeInfo get_decoded_type_info(const SQLTypeInfo& type_info) {
+  if (type_info.get_compression() != kENCODING_RL && type_info.get_compression() != kENCODING_DIFF) {
+    return type_info;
+  }
+  auto decoded_ti = get_logical_type_info(type_info);
+  decoded_ti.set_notnull(type_info.get_notnull());
+  return decoded_ti;
+}
+
 template <class T>
 inline int64_t inline_int_null_value() {
   return std::is_signed<T>::value ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
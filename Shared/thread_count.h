@@ -18,6 +18,7 @@
 #define THREAD_COUNT_H
 
 #include <algorithm>
+#include <cstddef>
 #include <unistd.h>
 
 inline int cpu_threads() {
@@ -27,4 +28,14 @@ inline int cpu_threads() {
   return std::max(2 * sysconf(_SC_NPROCESSORS_CONF), 1L);
 }
 
+inline size_t cpu_l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  const auto l2_cache_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (l2_cache_bytes > 0) {
+    return l2_cache_bytes;
+  }
+#endif
+  return 256 * 1024;
+}
+
 #endif  // THREAD_COUNT_H
@@ -29,6 +29,13 @@
 StringDictionaryProxy::StringDictionaryProxy(std::shared_ptr<StringDictionary> sd, const ssize_t generation)
     : string_dict_(sd), generation_(generation) {}
 
+StringDictionaryProxy::StringDictionaryProxy(const StringDictionaryProxy& that) : string_dict_(that.string_dict_) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(that.rw_mutex_);
+  transient_int_to_str_ = that.transient_int_to_str_;
+  transient_str_to_int_ = that.transient_str_to_int_;
+  generation_ = that.generation_;
+}
+
 int32_t truncate_to_generation(const int32_t id, const size_t generation) {
   if (id == StringDictionary::INVALID_STR_ID) {
     return id;
@@ -189,6 +196,16 @@ size_t StringDictionaryProxy::storageEntryCount() const {
   return string_dict_.get()->storageEntryCount();
 }
 
+size_t StringDictionaryProxy::transientBytes() const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  size_t bytes{0};
+  for (const auto& kv : transient_int_to_str_) {
+    // the string is held twice, once per map
+    bytes += 2 * (kv.second.size() + sizeof(int32_t));
+  }
+  return bytes;
+}
+
 void StringDictionaryProxy::updateGeneration(const ssize_t generation) noexcept {
   if (generation == -1) {
     return;
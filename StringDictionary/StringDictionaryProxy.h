@@ -33,6 +33,8 @@
 class StringDictionaryProxy {
  public:
   StringDictionaryProxy(std::shared_ptr<StringDictionary> sd, const ssize_t generation);
+  // shares the dictionary, copies the transient strings
+  StringDictionaryProxy(const StringDictionaryProxy& that);
 
   int32_t getOrAdd(const std::string& str) noexcept;
   StringDictionary* getDictionary() noexcept;
@@ -43,6 +45,7 @@ class StringDictionaryProxy {
   std::string getString(int32_t string_id) const;
   std::pair<char*, size_t> getStringBytes(int32_t string_id) const noexcept;
   size_t storageEntryCount() const;
+  size_t transientBytes() const;
   void updateGeneration(const ssize_t generation) noexcept;
 
   std::vector<int32_t> getLike(const std::string& pattern,
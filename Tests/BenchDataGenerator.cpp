@@ -0,0 +1,347 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchDataGenerator.h"
+#include "../Shared/thread_count.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+
+namespace BenchData {
+
+namespace {
+
+const size_t rows_per_chunk{1000000};
+const size_t sales_per_scale{1000000};
+const size_t customers_per_scale{30000};
+const size_t products_per_scale{20000};
+const size_t stores_per_scale{500};
+const size_t comments_per_scale{50000};
+const size_t city_count{200};
+const size_t channel_count{16};
+const size_t category_count{25};
+const size_t segment_count{5};
+
+// SplitMix64. Unlike the engines and distributions in <random>, the values don't depend on the
+// standard library in use.
+class Random {
+ public:
+  explicit Random(const uint64_t seed) : state_(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // in [0, 1)
+  double uniform() { return (next() >> 11) * (1. / 9007199254740992.); }
+
+  // in [lo, hi]
+  int64_t uniform(const int64_t lo, const int64_t hi) {
+    return lo + static_cast<int64_t>(next() % static_cast<uint64_t>(hi - lo + 1));
+  }
+
+ private:
+  uint64_t state_;
+};
+
+uint64_t derive_seed(const uint64_t seed, const std::string& stream, const uint64_t id) {
+  // FNV-1a, std::hash differs between standard libraries as well
+  uint64_t stream_hash = 0xcbf29ce484222325ULL;
+  for (const auto c : stream) {
+    stream_hash ^= static_cast<unsigned char>(c);
+    stream_hash *= 0x100000001b3ULL;
+  }
+  Random rng(seed ^ stream_hash ^ (id * 0xd1b54a32d192ed03ULL));
+  return rng.next();
+}
+
+// Draws ranks in [0, n) with probabilities proportional to 1 / (rank + 1)^skew.
+class ZipfSampler {
+ public:
+  ZipfSampler(const size_t n, const double skew) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += 1 / std::pow(static_cast<double>(i + 1), skew);
+      cdf_[i] = sum;
+    }
+    for (auto& p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  size_t sample(Random& rng) const {
+    const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), rng.uniform());
+    return std::min(static_cast<size_t>(it - cdf_.begin()), cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+struct Cardinalities {
+  explicit Cardinalities(const double scale_factor)
+      : sales(scaled(sales_per_scale, scale_factor)),
+        customers(scaled(customers_per_scale, scale_factor)),
+        products(scaled(products_per_scale, scale_factor)),
+        stores(scaled(stores_per_scale, scale_factor)),
+        comments(std::max(scaled(comments_per_scale, scale_factor), size_t(1000))) {}
+
+  static size_t scaled(const size_t per_scale, const double scale_factor) {
+    return std::max(static_cast<size_t>(std::llround(per_scale * scale_factor)), size_t(1));
+  }
+
+  const size_t sales;
+  const size_t customers;
+  const size_t products;
+  const size_t stores;
+  const size_t comments;
+};
+
+// 1992-01-01 through 1998-12-31, like the SSB date dimension.
+const int64_t first_day{8035};  // days since the epoch
+const size_t day_count{2557};
+
+struct CivilDate {
+  int year;
+  unsigned month;
+  unsigned day;
+};
+
+// days since 1970-01-01 to year / month / day, from Howard Hinnant's date algorithms
+CivilDate civil_from_days(int64_t z) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int64_t y = static_cast<int64_t>(yoe) + era * 400;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+  const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+  return {static_cast<int>(y + (m <= 2)), m, d};
+}
+
+int date_key(const CivilDate& date) {
+  return date.year * 10000 + date.month * 100 + date.day;
+}
+
+struct Location {
+  double lon;
+  double lat;
+};
+
+Location city_location(const uint64_t seed, const size_t city) {
+  Random rng(derive_seed(seed, "city", city));
+  return {-124 + 54 * rng.uniform(), 26 + 22 * rng.uniform()};
+}
+
+Location jitter(const Location& location, const double radius, Random& rng) {
+  return {location.lon + radius * (rng.uniform() + rng.uniform() - 1),
+          location.lat + radius * (rng.uniform() + rng.uniform() - 1)};
+}
+
+Location store_location(const uint64_t seed, const size_t storekey, const ZipfSampler& cities) {
+  Random rng(derive_seed(seed, "store", storekey));
+  return jitter(city_location(seed, cities.sample(rng)), 0.2, rng);
+}
+
+int64_t product_price_cents(const uint64_t seed, const size_t partkey) {
+  Random rng(derive_seed(seed, "price", partkey));
+  return rng.uniform(100, 100000);
+}
+
+class ChunkWriter {
+ public:
+  explicit ChunkWriter(const std::string& path) : file_(fopen(path.c_str(), "w")), path_(path) {
+    if (!file_) {
+      throw std::runtime_error("Could not create " + path);
+    }
+  }
+
+  ~ChunkWriter() { fclose(file_); }
+
+  template <typename... Args>
+  void row(const char* format, Args... args) {
+    char line[512];
+    const auto len = snprintf(line, sizeof(line), format, args...);
+    if (len < 0 || static_cast<size_t>(len) >= sizeof(line) ||
+        fwrite(line, 1, len, file_) != static_cast<size_t>(len)) {
+      throw std::runtime_error("Could not write " + path_);
+    }
+  }
+
+ private:
+  FILE* file_;
+  const std::string path_;
+};
+
+void write_chunk(const std::string& table,
+                 const Cardinalities& cardinalities,
+                 const uint64_t seed,
+                 const size_t first_row,
+                 const size_t row_count,
+                 const std::string& path) {
+  Random rng(derive_seed(seed, table, first_row / rows_per_chunk));
+  const ZipfSampler cities(city_count, 1.0);
+  ChunkWriter out(path);
+  if (table == "bench_date") {
+    static const char* weekdays[] = {"Thursday", "Friday", "Saturday", "Sunday", "Monday", "Tuesday", "Wednesday"};
+    for (size_t i = first_row; i < first_row + row_count; ++i) {
+      const auto date = civil_from_days(first_day + i);
+      out.row("%d,%04d-%02u-%02u,%d,%u,%s\n",
+              date_key(date),
+              date.year,
+              date.month,
+              date.day,
+              date.year,
+              date.month,
+              weekdays[(first_day + i) % 7]);
+    }
+  } else if (table == "bench_customer") {
+    for (size_t i = first_row; i < first_row + row_count; ++i) {
+      const auto city = cities.sample(rng);
+      const auto nation = city % 25;
+      out.row("%zu,Customer#%09zu,city_%zu,nation_%zu,region_%zu,segment_%lld\n",
+              i + 1,
+              i + 1,
+              city,
+              nation,
+              nation % 5,
+              static_cast<long long>(rng.uniform(0, segment_count - 1)));
+    }
+  } else if (table == "bench_product") {
+    const ZipfSampler categories(category_count, 1.2);
+    for (size_t i = first_row; i < first_row + row_count; ++i) {
+      const auto category = categories.sample(rng);
+      const auto price_cents = product_price_cents(seed, i + 1);
+      out.row("%zu,part_%zu,category_%zu,brand_%lld,%lld.%02lld\n",
+              i + 1,
+              i + 1,
+              category,
+              static_cast<long long>(category * 40 + rng.uniform(0, 39)),
+              static_cast<long long>(price_cents / 100),
+              static_cast<long long>(price_cents % 100));
+    }
+  } else if (table == "bench_store") {
+    for (size_t i = first_row; i < first_row + row_count; ++i) {
+      const auto location = store_location(seed, i + 1, cities);
+      out.row("%zu,store_%zu,POINT(%.6f %.6f)\n", i + 1, i + 1, location.lon, location.lat);
+    }
+  } else if (table == "bench_sales") {
+    const ZipfSampler customers(cardinalities.customers, 0.8);
+    const ZipfSampler channels(channel_count, 1.5);
+    const ZipfSampler comments(cardinalities.comments, 1.1);
+    for (size_t i = first_row; i < first_row + row_count; ++i) {
+      const auto day = rng.uniform(0, day_count - 1);
+      const auto date = civil_from_days(first_day + day);
+      const auto seconds = rng.uniform(0, 86399);
+      const auto partkey = rng.uniform(1, cardinalities.products);
+      const auto storekey = rng.uniform(1, cardinalities.stores);
+      const auto quantity = rng.uniform(1, 50);
+      const auto discount = rng.uniform(0, 10);
+      const auto price_cents = product_price_cents(seed, partkey);
+      const auto location = jitter(store_location(seed, storekey, cities), 0.05, rng);
+      out.row(
+          "%zu,%d,%zu,%lld,%lld,%lld,%lld.%02lld,%lld,%.4f,%04d-%02u-%02u %02lld:%02lld:%02lld,channel_%zu,comment_%zu,"
+          "POINT(%.6f %.6f)\n",
+          i + 1,
+          date_key(date),
+          customers.sample(rng) + 1,
+          static_cast<long long>(partkey),
+          static_cast<long long>(storekey),
+          static_cast<long long>(quantity),
+          static_cast<long long>(price_cents / 100),
+          static_cast<long long>(price_cents % 100),
+          static_cast<long long>(discount),
+          quantity * price_cents * (100 - discount) / 10000.,
+          date.year,
+          date.month,
+          date.day,
+          static_cast<long long>(seconds / 3600),
+          static_cast<long long>(seconds / 60 % 60),
+          static_cast<long long>(seconds % 60),
+          channels.sample(rng),
+          comments.sample(rng),
+          location.lon,
+          location.lat);
+    }
+  } else {
+    throw std::runtime_error("Unknown benchmark table " + table);
+  }
+}
+
+}  // namespace
+
+std::vector<TableSpec> star_schema_tables(const double scale_factor) {
+  const Cardinalities cardinalities(scale_factor);
+  return {{"bench_date",
+           "CREATE TABLE bench_date (d_datekey INT, d_date DATE, d_year SMALLINT, d_month SMALLINT, d_dayofweek TEXT "
+           "ENCODING DICT);",
+           day_count},
+          {"bench_customer",
+           "CREATE TABLE bench_customer (c_custkey INT, c_name TEXT ENCODING DICT, c_city TEXT ENCODING DICT, c_nation "
+           "TEXT ENCODING DICT, c_region TEXT ENCODING DICT, c_segment TEXT ENCODING DICT);",
+           cardinalities.customers},
+          {"bench_product",
+           "CREATE TABLE bench_product (p_partkey INT, p_name TEXT ENCODING DICT, p_category TEXT ENCODING DICT, "
+           "p_brand TEXT ENCODING DICT, p_price DECIMAL(12,2));",
+           cardinalities.products},
+          {"bench_store",
+           "CREATE TABLE bench_store (s_storekey INT, s_name TEXT ENCODING DICT, s_location POINT);",
+           cardinalities.stores},
+          {"bench_sales",
+           "CREATE TABLE bench_sales (lo_orderkey BIGINT, lo_datekey INT, lo_custkey INT, lo_partkey INT, lo_storekey "
+           "INT, lo_quantity SMALLINT, lo_price DECIMAL(12,2), lo_discount SMALLINT, lo_revenue DOUBLE, lo_ts "
+           "TIMESTAMP, lo_channel TEXT ENCODING DICT, lo_comment TEXT ENCODING DICT, lo_location POINT) WITH "
+           "(fragment_size=500000);",
+           cardinalities.sales}};
+}
+
+void write_table_csv(const TableSpec& table, const double scale_factor, const uint64_t seed, const std::string& dir) {
+  const Cardinalities cardinalities(scale_factor);
+  const size_t chunk_count = (table.row_count + rows_per_chunk - 1) / rows_per_chunk;
+  const size_t max_parallel = cpu_threads();
+  std::vector<std::future<void>> chunk_writers;
+  for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+    if (chunk_writers.size() == max_parallel) {
+      for (auto& chunk_writer : chunk_writers) {
+        chunk_writer.get();
+      }
+      chunk_writers.clear();
+    }
+    const auto first_row = chunk * rows_per_chunk;
+    const auto row_count = std::min(rows_per_chunk, table.row_count - first_row);
+    const auto path = dir + "/" + table.name + "_" + std::to_string(chunk) + ".csv";
+    chunk_writers.push_back(std::async(std::launch::async, [&table, &cardinalities, seed, first_row, row_count, path] {
+      write_chunk(table.name, cardinalities, seed, first_row, row_count, path);
+    }));
+  }
+  for (auto& chunk_writer : chunk_writers) {
+    chunk_writer.get();
+  }
+}
+
+std::string table_csv_glob(const TableSpec& table, const std::string& dir) {
+  return dir + "/" + table.name + "_*.csv";
+}
+
+}  // namespace BenchData
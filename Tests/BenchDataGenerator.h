@@ -0,0 +1,54 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    BenchDataGenerator.h
+ * @brief   Deterministic star schema data set for QueryBenchmark.
+ *
+ * A sales fact table with date, customer, product and store dimensions, scaled by a (possibly
+ * fractional) scale factor: 1M fact rows per unit. Foreign keys and dictionary strings follow
+ * Zipf distributions, the fact table carries timestamps and geo points. Every value is derived
+ * from the seed, the table and the row number with our own generator and distributions, so a
+ * given scale factor and seed produce byte for byte the same CSV files on any platform.
+ **/
+
+#ifndef BENCH_DATA_GENERATOR_H
+#define BENCH_DATA_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BenchData {
+
+struct TableSpec {
+  std::string name;
+  std::string create_table;
+  size_t row_count;
+};
+
+std::vector<TableSpec> star_schema_tables(const double scale_factor);
+
+// Writes the table as <dir>/<name>_<chunk>.csv files of at most 1M rows each, the chunks are
+// generated in parallel.
+void write_table_csv(const TableSpec& table, const double scale_factor, const uint64_t seed, const std::string& dir);
+
+// Pattern matching the files written by write_table_csv, for COPY FROM.
+std::string table_csv_glob(const TableSpec& table, const std::string& dir);
+
+}  // namespace BenchData
+
+#endif  // BENCH_DATA_GENERATOR_H
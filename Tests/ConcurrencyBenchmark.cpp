@@ -0,0 +1,474 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ConcurrencyBenchmark.cpp
+ * @brief   Drives an in-process MapDHandler from many sessions at once with a mix of queries and
+ * loads, and reports throughput, latency percentiles, time spent queued for an execution slot
+ * and time spent waiting for the server's coarse locks (see Shared/lock_wait_stats.h).
+ *
+ * Every request goes through a RequestScheduler the way ScheduledMapDProcessor runs them in
+ * mapd_server, so --max-running and --queue-size have the server's meaning.
+ **/
+
+#include "../Catalog/Catalog.h"
+#include "../Shared/MapDParameters.h"
+#include "../Shared/lock_wait_stats.h"
+#include "../Shared/measure.h"
+#include "../ThriftHandler/MapDHandler.h"
+#include "MapDRelease.h"
+
+#include <boost/program_options.hpp>
+#include <glog/logging.h>
+#include <rapidjson/document.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+const std::string bench_table{"bench_concurrency"};
+const size_t account_count{100000};
+const size_t category_count{32};
+
+struct Operation {
+  std::string name;
+  std::string sql;
+};
+
+// The read mix: a scan, a low and a high cardinality group by and a selective filter.
+const std::vector<Operation> read_operations{
+    {"filter_count", "SELECT COUNT(*) FROM " + bench_table + " WHERE amount > 900;"},
+    {"groupby_category", "SELECT category, SUM(amount), COUNT(*) FROM " + bench_table + " GROUP BY category;"},
+    {"topn_account",
+     "SELECT account, COUNT(*) AS n FROM " + bench_table + " GROUP BY account ORDER BY n DESC LIMIT 10;"},
+    {"point_lookup", "SELECT MAX(ts), MIN(id) FROM " + bench_table + " WHERE account = 42;"},
+};
+
+struct Sample {
+  size_t operation;  // index into the report's operations, read operations first, then "load"
+  int64_t queue_us;
+  int64_t latency_us;  // queued plus executing
+  bool failed;
+};
+
+struct OperationReport {
+  std::string name;
+  size_t count;
+  size_t errors;
+  std::vector<int64_t> latency_us;  // sorted, successful requests only
+  std::vector<int64_t> queue_us;    // sorted
+
+  static int64_t percentile(const std::vector<int64_t>& sorted, const double p) {
+    if (sorted.empty()) {
+      return 0;
+    }
+    const auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+  }
+};
+
+std::vector<TStringRow> make_rows(const int64_t first_id, const size_t row_count, std::mt19937_64& rng) {
+  std::uniform_int_distribution<size_t> account(1, account_count);
+  std::uniform_int_distribution<size_t> category(0, category_count - 1);
+  std::uniform_real_distribution<double> amount(0, 1000);
+  const int64_t epoch_1995{788918400};
+  std::vector<TStringRow> rows(row_count);
+  for (size_t i = 0; i < row_count; ++i) {
+    const std::vector<std::string> values{std::to_string(first_id + i),
+                                          std::to_string(epoch_1995 + (first_id + i) % (365 * 86400)),
+                                          std::to_string(account(rng)),
+                                          "category_" + std::to_string(category(rng)),
+                                          std::to_string(amount(rng))};
+    for (const auto& value : values) {
+      TStringValue col;
+      col.str_val = value;
+      col.is_null = false;
+      rows[i].cols.push_back(col);
+    }
+  }
+  return rows;
+}
+
+class Workload {
+ public:
+  Workload(MapDHandler& handler,
+           RequestScheduler& scheduler,
+           const size_t insert_batch_rows,
+           const std::chrono::steady_clock::time_point deadline)
+      : handler_(handler), scheduler_(scheduler), insert_batch_rows_(insert_batch_rows), deadline_(deadline) {}
+
+  // One session issuing reads back to back, picking the next one at random.
+  std::vector<Sample> runReader(const size_t client, const uint64_t seed) {
+    std::mt19937_64 rng(seed + client);
+    std::uniform_int_distribution<size_t> pick(0, read_operations.size() - 1);
+    const auto session = connect();
+    std::vector<Sample> samples;
+    while (std::chrono::steady_clock::now() < deadline_) {
+      const auto operation = pick(rng);
+      samples.push_back(run(operation, RequestScheduler::getPriority("sql_execute"), [&] {
+        TQueryResult result;
+        handler_.sql_execute(result, session, read_operations[operation].sql, true, "", -1, -1);
+      }));
+    }
+    handler_.disconnect(session);
+    return samples;
+  }
+
+  // One session appending batches of new rows back to back, like a streaming importer.
+  std::vector<Sample> runLoader(const size_t client, const int64_t first_id, const uint64_t seed) {
+    std::mt19937_64 rng(seed + 1000003 * (client + 1));
+    const auto session = connect();
+    std::vector<Sample> samples;
+    // interleave the id ranges of the loaders so that every batch gets unique ids
+    int64_t next_id = first_id + client * insert_batch_rows_;
+    const int64_t id_stride = loader_count_ * insert_batch_rows_;
+    while (std::chrono::steady_clock::now() < deadline_) {
+      const auto rows = make_rows(next_id, insert_batch_rows_, rng);
+      next_id += id_stride;
+      samples.push_back(run(read_operations.size(), RequestScheduler::getPriority("load_table"), [&] {
+        handler_.load_table(session, bench_table, rows);
+      }));
+      if (!samples.back().failed) {
+        rows_loaded_ += rows.size();
+      }
+    }
+    handler_.disconnect(session);
+    return samples;
+  }
+
+  void setLoaderCount(const size_t loader_count) { loader_count_ = std::max(loader_count, size_t(1)); }
+  size_t getRowsLoaded() const { return rows_loaded_; }
+
+ private:
+  TSessionId connect() {
+    TSessionId session;
+    handler_.connect(session, MAPD_ROOT_USER, "HyperInteractive", MAPD_SYSTEM_DB);
+    return session;
+  }
+
+  template <typename F>
+  Sample run(const size_t operation, const RequestScheduler::Priority priority, F request) {
+    Sample sample{operation, 0, 0, false};
+    const auto clock_begin = timer_start();
+    try {
+      const auto slot = scheduler_.acquire(priority);
+      sample.queue_us = timer_stop<decltype(clock_begin), std::chrono::microseconds>(clock_begin);
+      request();
+    } catch (const RequestScheduler::QueueFull&) {
+      sample.failed = true;
+    } catch (const TMapDException& e) {
+      LOG(WARNING) << "Request failed: " << e.error_msg;
+      sample.failed = true;
+    }
+    sample.latency_us = timer_stop<decltype(clock_begin), std::chrono::microseconds>(clock_begin);
+    return sample;
+  }
+
+  MapDHandler& handler_;
+  RequestScheduler& scheduler_;
+  const size_t insert_batch_rows_;
+  const std::chrono::steady_clock::time_point deadline_;
+  size_t loader_count_{1};
+  std::atomic<size_t> rows_loaded_{0};
+};
+
+std::vector<OperationReport> summarize(const std::vector<std::vector<Sample>>& samples_per_client) {
+  std::vector<OperationReport> reports;
+  for (const auto& operation : read_operations) {
+    reports.push_back({operation.name, 0, 0, {}, {}});
+  }
+  reports.push_back({"load", 0, 0, {}, {}});
+  for (const auto& samples : samples_per_client) {
+    for (const auto& sample : samples) {
+      auto& report = reports[sample.operation];
+      ++report.count;
+      if (sample.failed) {
+        ++report.errors;
+        continue;
+      }
+      report.latency_us.push_back(sample.latency_us);
+      report.queue_us.push_back(sample.queue_us);
+    }
+  }
+  for (auto& report : reports) {
+    std::sort(report.latency_us.begin(), report.latency_us.end());
+    std::sort(report.queue_us.begin(), report.queue_us.end());
+  }
+  return reports;
+}
+
+void print_report(const std::vector<OperationReport>& reports, const double elapsed_s, const size_t rows_loaded) {
+  std::cout << std::left << std::setw(20) << "operation" << std::right << std::setw(10) << "ops/s" << std::setw(8)
+            << "errors" << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+            << std::setw(14) << "queue p99 ms" << std::endl;
+  for (const auto& report : reports) {
+    std::cout << std::left << std::setw(20) << report.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << report.latency_us.size() / elapsed_s << std::setw(8) << report.errors
+              << std::setprecision(2) << std::setw(10) << OperationReport::percentile(report.latency_us, 0.5) / 1000.
+              << std::setw(10) << OperationReport::percentile(report.latency_us, 0.99) / 1000. << std::setw(10)
+              << OperationReport::percentile(report.latency_us, 1) / 1000. << std::setw(14)
+              << OperationReport::percentile(report.queue_us, 0.99) / 1000. << std::endl;
+  }
+  std::cout << "loaded " << rows_loaded << " rows, " << static_cast<int64_t>(rows_loaded / elapsed_s) << " rows/s"
+            << std::endl;
+  std::cout << std::left << std::setw(26) << "lock" << std::right << std::setw(14) << "acquisitions" << std::setw(14)
+            << "wait ms" << std::setw(12) << "avg us" << std::setw(12) << "max us" << std::endl;
+  for (size_t i = 0; i < static_cast<size_t>(LockWaitSite::COUNT); ++i) {
+    const auto site = static_cast<LockWaitSite>(i);
+    const auto stats = get_lock_wait_stats(site);
+    std::cout << std::left << std::setw(26) << lock_wait_site_name(site) << std::right << std::setw(14)
+              << stats.acquisitions << std::setw(14) << stats.total_wait_us / 1000. << std::setw(12)
+              << (stats.acquisitions ? stats.total_wait_us / static_cast<double>(stats.acquisitions) : 0.)
+              << std::setw(12) << stats.max_wait_us << std::endl;
+  }
+}
+
+void write_report(const std::string& path,
+                  const std::vector<OperationReport>& reports,
+                  const double elapsed_s,
+                  const size_t rows_loaded,
+                  const RequestScheduler::Stats& scheduler_stats,
+                  const size_t readers,
+                  const size_t loaders,
+                  const size_t max_running) {
+  rapidjson::Document report(rapidjson::kObjectType);
+  auto& allocator = report.GetAllocator();
+  report.AddMember("release", rapidjson::Value(MAPD_RELEASE.c_str(), allocator), allocator);
+  report.AddMember("timestamp", static_cast<int64_t>(std::time(nullptr)), allocator);
+  report.AddMember("read_sessions", static_cast<uint64_t>(readers), allocator);
+  report.AddMember("load_sessions", static_cast<uint64_t>(loaders), allocator);
+  report.AddMember("max_running", static_cast<uint64_t>(max_running), allocator);
+  report.AddMember("elapsed_s", elapsed_s, allocator);
+  report.AddMember("rows_loaded", static_cast<uint64_t>(rows_loaded), allocator);
+  report.AddMember("rows_loaded_per_sec", rows_loaded / elapsed_s, allocator);
+  rapidjson::Value operations(rapidjson::kArrayType);
+  for (const auto& operation_report : reports) {
+    rapidjson::Value operation(rapidjson::kObjectType);
+    operation.AddMember("name", rapidjson::Value(operation_report.name.c_str(), allocator), allocator);
+    operation.AddMember("count", static_cast<uint64_t>(operation_report.count), allocator);
+    operation.AddMember("errors", static_cast<uint64_t>(operation_report.errors), allocator);
+    operation.AddMember("ops_per_sec", operation_report.latency_us.size() / elapsed_s, allocator);
+    rapidjson::Value latency(rapidjson::kObjectType);
+    latency.AddMember("p50_ms", OperationReport::percentile(operation_report.latency_us, 0.5) / 1000., allocator);
+    latency.AddMember("p90_ms", OperationReport::percentile(operation_report.latency_us, 0.9) / 1000., allocator);
+    latency.AddMember("p99_ms", OperationReport::percentile(operation_report.latency_us, 0.99) / 1000., allocator);
+    latency.AddMember("max_ms", OperationReport::percentile(operation_report.latency_us, 1) / 1000., allocator);
+    operation.AddMember("latency", latency, allocator);
+    rapidjson::Value queue(rapidjson::kObjectType);
+    queue.AddMember("p50_ms", OperationReport::percentile(operation_report.queue_us, 0.5) / 1000., allocator);
+    queue.AddMember("p99_ms", OperationReport::percentile(operation_report.queue_us, 0.99) / 1000., allocator);
+    queue.AddMember("max_ms", OperationReport::percentile(operation_report.queue_us, 1) / 1000., allocator);
+    operation.AddMember("queue", queue, allocator);
+    operations.PushBack(operation, allocator);
+  }
+  report.AddMember("operations", operations, allocator);
+  rapidjson::Value request_queue(rapidjson::kObjectType);
+  request_queue.AddMember("admitted_requests", scheduler_stats.admitted_requests, allocator);
+  request_queue.AddMember("rejected_requests", scheduler_stats.rejected_requests, allocator);
+  request_queue.AddMember("total_wait_us", scheduler_stats.total_wait_us, allocator);
+  request_queue.AddMember("max_wait_us", scheduler_stats.max_wait_us, allocator);
+  report.AddMember("request_queue", request_queue, allocator);
+  rapidjson::Value lock_waits(rapidjson::kArrayType);
+  for (size_t i = 0; i < static_cast<size_t>(LockWaitSite::COUNT); ++i) {
+    const auto site = static_cast<LockWaitSite>(i);
+    const auto stats = get_lock_wait_stats(site);
+    rapidjson::Value lock_wait(rapidjson::kObjectType);
+    lock_wait.AddMember("lock", rapidjson::StringRef(lock_wait_site_name(site)), allocator);
+    lock_wait.AddMember("acquisitions", stats.acquisitions, allocator);
+    lock_wait.AddMember("total_wait_us", stats.total_wait_us, allocator);
+    lock_wait.AddMember("max_wait_us", stats.max_wait_us, allocator);
+    lock_waits.PushBack(lock_wait, allocator);
+  }
+  report.AddMember("lock_waits", lock_waits, allocator);
+  std::ofstream out(path);
+  rapidjson::OStreamWrapper out_wrapper(out);
+  rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(out_wrapper);
+  report.Accept(writer);
+  out << std::endl;
+}
+
+void execute(MapDHandler& handler, const TSessionId& session, const std::string& sql) {
+  TQueryResult result;
+  handler.sql_execute(result, session, sql, true, "", -1, -1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  namespace po = boost::program_options;
+
+  std::string db_path{BASE_PATH};
+  std::string output{"concurrency_results.json"};
+  size_t readers{8};
+  size_t loaders{1};
+  size_t duration_s{30};
+  size_t initial_rows{1000000};
+  size_t insert_batch_rows{10000};
+  uint64_t seed{1};
+  MapDParameters mapd_parameters;
+
+  po::options_description desc("Options");
+  desc.add_options()("help,h", "Print help messages");
+  desc.add_options()(
+      "path", po::value<std::string>(&db_path)->default_value(db_path), "Directory path to Mapd catalogs");
+  desc.add_options()("read-sessions", po::value<size_t>(&readers)->default_value(readers), "Sessions running queries");
+  desc.add_options()("load-sessions", po::value<size_t>(&loaders)->default_value(loaders), "Sessions loading rows");
+  desc.add_options()("duration", po::value<size_t>(&duration_s)->default_value(duration_s), "Seconds to run for");
+  desc.add_options()("initial-rows",
+                     po::value<size_t>(&initial_rows)->default_value(initial_rows),
+                     "Rows loaded before the clients start");
+  desc.add_options()("batch-rows",
+                     po::value<size_t>(&insert_batch_rows)->default_value(insert_batch_rows),
+                     "Rows per load_table call of the load sessions");
+  desc.add_options()("seed", po::value<uint64_t>(&seed)->default_value(seed), "Seed of the query mix and the rows");
+  desc.add_options()("max-running",
+                     po::value<size_t>(&mapd_parameters.num_request_threads)
+                         ->default_value(mapd_parameters.num_request_threads),
+                     "Max number of requests executing at the same time");
+  desc.add_options()("queue-size",
+                     po::value<size_t>(&mapd_parameters.request_queue_size)
+                         ->default_value(mapd_parameters.request_queue_size),
+                     "Max number of requests waiting for an execution slot");
+  desc.add_options()("calcite-port",
+                     po::value<int>(&mapd_parameters.calcite_port)->default_value(mapd_parameters.calcite_port),
+                     "Calcite port, pick a free one if a server is running on this host");
+  desc.add_options()("output", po::value<std::string>(&output)->default_value(output), "JSON report to write");
+  desc.add_options()("keep-data", "Don't drop the table at the end");
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << "Usage Error: " << e.what() << std::endl;
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+  insert_batch_rows = std::max(insert_batch_rows, size_t(1));
+
+  g_enable_watchdog = false;
+  MapDHandler handler({},
+                      {},
+                      db_path,
+                      "cpu",
+                      true,   // allow_multifrag
+                      false,  // jit_debug
+                      false,  // read_only
+                      false,  // allow_loop_joins
+                      false,  // enable_rendering
+                      0,      // cpu_buffer_mem_bytes, use the default share of system memory
+                      0,      // render_mem_bytes
+                      0,      // num_gpus
+                      0,      // start_gpu
+                      0,      // reserved_gpu_mem
+                      0,      // num_reader_threads
+                      AuthMetadata(),
+                      mapd_parameters,
+                      "",     // db_convert_dir
+                      false,  // legacy_syntax
+                      false);
+  auto scheduler =
+      std::make_shared<RequestScheduler>(mapd_parameters.num_request_threads, mapd_parameters.request_queue_size);
+  handler.setRequestScheduler(scheduler);
+
+  TSessionId admin_session;
+  handler.connect(admin_session, MAPD_ROOT_USER, "HyperInteractive", MAPD_SYSTEM_DB);
+  try {
+    execute(handler, admin_session, "DROP TABLE IF EXISTS " + bench_table + ";");
+    execute(handler,
+            admin_session,
+            "CREATE TABLE " + bench_table +
+                " (id BIGINT, ts TIMESTAMP, account INT, category TEXT ENCODING DICT, amount DOUBLE);");
+    std::mt19937_64 rng(seed);
+    const size_t initial_batch_rows{100000};
+    for (size_t first_row = 0; first_row < initial_rows; first_row += initial_batch_rows) {
+      handler.load_table(admin_session,
+                         bench_table,
+                         make_rows(first_row, std::min(initial_batch_rows, initial_rows - first_row), rng));
+    }
+    // warm up the buffer pool and the code cache, the clients should measure contention only
+    for (const auto& operation : read_operations) {
+      execute(handler, admin_session, operation.sql);
+    }
+  } catch (const TMapDException& e) {
+    LOG(ERROR) << "Could not set up " << bench_table << ": " << e.error_msg;
+    return 1;
+  }
+
+  reset_lock_wait_stats();
+  const auto scheduler_stats_before = scheduler->getStats();
+  const auto clock_begin = timer_start();
+  Workload workload(
+      handler, *scheduler, insert_batch_rows, clock_begin + std::chrono::seconds(std::max(duration_s, size_t(1))));
+  workload.setLoaderCount(loaders);
+  std::vector<std::vector<Sample>> samples_per_client(readers + loaders);
+  std::vector<std::thread> clients;
+  for (size_t i = 0; i < readers; ++i) {
+    clients.emplace_back([&, i] { samples_per_client[i] = workload.runReader(i, seed); });
+  }
+  for (size_t i = 0; i < loaders; ++i) {
+    clients.emplace_back(
+        [&, i] { samples_per_client[readers + i] = workload.runLoader(i, static_cast<int64_t>(initial_rows), seed); });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double elapsed_s = timer_stop<decltype(clock_begin), std::chrono::microseconds>(clock_begin) / 1e6;
+
+  auto scheduler_stats = scheduler->getStats();
+  scheduler_stats.admitted_requests -= scheduler_stats_before.admitted_requests;
+  scheduler_stats.rejected_requests -= scheduler_stats_before.rejected_requests;
+  scheduler_stats.total_wait_us -= scheduler_stats_before.total_wait_us;
+  const auto reports = summarize(samples_per_client);
+  print_report(reports, elapsed_s, workload.getRowsLoaded());
+  write_report(output,
+               reports,
+               elapsed_s,
+               workload.getRowsLoaded(),
+               scheduler_stats,
+               readers,
+               loaders,
+               mapd_parameters.num_request_threads);
+  std::cout << "Wrote " << output << std::endl;
+
+  if (!vm.count("keep-data")) {
+    try {
+      execute(handler, admin_session, "DROP TABLE IF EXISTS " + bench_table + ";");
+    } catch (const TMapDException& e) {
+      LOG(WARNING) << "Could not drop " << bench_table << ": " << e.error_msg;
+    }
+  }
+  handler.disconnect(admin_session);
+  return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CursorFetchTest.cpp
+ * @brief   Tests of open_cursor / fetch_cursor / close_cursor against an in-process MapDHandler,
+ * including a result fetched in pages. With --check-memory, as run by the cursor_memory_test
+ * target on 10M rows, it also checks that the memory of the process stays flat while the pages
+ * are converted.
+ **/
+
+#include "../Catalog/Catalog.h"
+#include "../Shared/MapDParameters.h"
+#include "../ThriftHandler/MapDHandler.h"
+
+#include <boost/program_options.hpp>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+#define CALCITEPORT 39093
+
+namespace {
+
+size_t g_row_count{250000};
+bool g_check_memory{false};
+MapDParameters g_mapd_parameters;  // the handler keeps a reference, tests change the cursor timeout
+std::unique_ptr<MapDHandler> g_handler;
+TSessionId g_session;
+
+void run_ddl_statement(const std::string& sql) {
+  TQueryResult result;
+  g_handler->sql_execute(result, g_session, sql, true, "", -1, -1);
+}
+
+void load_rows(const std::string& table_name, const int64_t first_id, const size_t row_count) {
+  std::vector<TColumn> cols(2);
+  for (size_t i = 0; i < row_count; ++i) {
+    const int64_t id = first_id + i;
+    cols[0].data.int_col.push_back(id);
+    cols[0].nulls.push_back(false);
+    cols[1].data.real_col.push_back(id * 0.5);
+    cols[1].nulls.push_back(false);
+  }
+  g_handler->load_table_binary_columnar(g_session, table_name, cols);
+}
+
+size_t get_resident_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages{0};
+  size_t resident_pages{0};
+  statm >> total_pages >> resident_pages;
+  return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+class CursorFetchEnv : public ::testing::Environment {
+ public:
+  void SetUp() override {
+    g_mapd_parameters.calcite_port = CALCITEPORT;
+    g_handler.reset(new MapDHandler({},
+                                    {},
+                                    BASE_PATH,
+                                    "cpu",
+                                    true,   // allow_multifrag
+                                    false,  // jit_debug
+                                    false,  // read_only
+                                    false,  // allow_loop_joins
+                                    false,  // enable_rendering
+                                    0,      // cpu_buffer_mem_bytes, use the default share of system memory
+                                    0,      // render_mem_bytes
+                                    0,      // num_gpus
+                                    0,      // start_gpu
+                                    0,      // reserved_gpu_mem
+                                    0,      // num_reader_threads
+                                    AuthMetadata(),
+                                    g_mapd_parameters,
+                                    "",     // db_convert_dir
+                                    false,  // legacy_syntax
+                                    false));
+    g_handler->connect(g_session, MAPD_ROOT_USER, "HyperInteractive", MAPD_SYSTEM_DB);
+    run_ddl_statement("DROP TABLE IF EXISTS cursor_big;");
+    run_ddl_statement("CREATE TABLE cursor_big (id BIGINT, val DOUBLE);");
+    const size_t batch_rows{1000000};
+    for (size_t first_row = 0; first_row < g_row_count; first_row += batch_rows) {
+      load_rows("cursor_big", first_row, std::min(batch_rows, g_row_count - first_row));
+    }
+    run_ddl_statement("DROP TABLE IF EXISTS cursor_small;");
+    run_ddl_statement("CREATE TABLE cursor_small (id BIGINT, val DOUBLE);");
+    load_rows("cursor_small", 0, 10);
+  }
+
+  void TearDown() override {
+    run_ddl_statement("DROP TABLE IF EXISTS cursor_big;");
+    run_ddl_statement("DROP TABLE IF EXISTS cursor_small;");
+    g_handler->disconnect(g_session);
+    g_handler.reset();
+  }
+};
+
+}  // namespace
+
+TEST(Cursor, FetchInPages) {
+  TCursor cursor;
+  g_handler->open_cursor(cursor, g_session, "SELECT id, val FROM cursor_big;", true, "");
+  ASSERT_EQ(static_cast<int64_t>(g_row_count), cursor.row_count);
+  ASSERT_EQ(size_t(2), cursor.row_desc.size());
+  const int32_t page_rows{100000};
+  size_t fetched_rows{0};
+  int64_t id_sum{0};
+  size_t first_page_resident_bytes{0};
+  size_t max_resident_bytes{0};
+  while (true) {
+    TRowSet page;
+    g_handler->fetch_cursor(page, g_session, cursor.cursor_id, page_rows);
+    ASSERT_TRUE(page.is_columnar);
+    ASSERT_EQ(size_t(2), page.columns.size());
+    const auto page_row_count = page.columns[0].nulls.size();
+    ASSERT_LE(page_row_count, static_cast<size_t>(page_rows));
+    if (!page_row_count) {
+      break;
+    }
+    for (size_t i = 0; i < page_row_count; ++i) {
+      const auto id = page.columns[0].data.int_col[i];
+      ASSERT_DOUBLE_EQ(id * 0.5, page.columns[1].data.real_col[i]);
+      id_sum += id;
+    }
+    fetched_rows += page_row_count;
+    const auto resident_bytes = get_resident_bytes();
+    if (!first_page_resident_bytes) {
+      first_page_resident_bytes = resident_bytes;
+    }
+    max_resident_bytes = std::max(max_resident_bytes, resident_bytes);
+  }
+  g_handler->close_cursor(g_session, cursor.cursor_id);
+  ASSERT_EQ(g_row_count, fetched_rows);
+  ASSERT_EQ(static_cast<int64_t>(g_row_count * (g_row_count - 1) / 2), id_sum);
+  if (!g_check_memory) {
+    return;
+  }
+  // a whole row set of the result would take more than 16 bytes per row, the pages are converted and
+  // released one at a time
+  const size_t max_growth_bytes{64 << 20};
+  ASSERT_LT(max_resident_bytes - first_page_resident_bytes, max_growth_bytes);
+}
+
+TEST(Cursor, RowFormat) {
+  TCursor cursor;
+  g_handler->open_cursor(cursor, g_session, "SELECT id FROM cursor_small ORDER BY id;", false, "");
+  ASSERT_EQ(int64_t(10), cursor.row_count);
+  std::vector<int64_t> ids;
+  for (size_t i = 0; i < 3; ++i) {
+    TRowSet page;
+    g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 4);
+    ASSERT_FALSE(page.is_columnar);
+    for (const auto& row : page.rows) {
+      ids.push_back(row.cols[0].val.int_val);
+    }
+  }
+  ASSERT_EQ(size_t(10), ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(static_cast<int64_t>(i), ids[i]);
+  }
+  TRowSet page;
+  g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 4);
+  ASSERT_TRUE(page.rows.empty());
+  g_handler->close_cursor(g_session, cursor.cursor_id);
+}
+
+TEST(Cursor, Errors) {
+  TCursor cursor;
+  TRowSet page;
+  EXPECT_THROW(g_handler->open_cursor(cursor, g_session, "DELETE FROM cursor_small WHERE id = 0;", true, ""),
+               TMapDException);
+  EXPECT_THROW(g_handler->open_cursor(cursor, g_session, "EXPLAIN SELECT id FROM cursor_small;", true, ""),
+               TMapDException);
+  g_handler->open_cursor(cursor, g_session, "SELECT id FROM cursor_small;", true, "");
+  EXPECT_THROW(g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 0), TMapDException);
+  TSessionId other_session;
+  g_handler->connect(other_session, MAPD_ROOT_USER, "HyperInteractive", MAPD_SYSTEM_DB);
+  EXPECT_THROW(g_handler->fetch_cursor(page, other_session, cursor.cursor_id, 4), TMapDException);
+  EXPECT_THROW(g_handler->close_cursor(other_session, cursor.cursor_id), TMapDException);
+  g_handler->disconnect(other_session);
+  g_handler->close_cursor(g_session, cursor.cursor_id);
+  EXPECT_THROW(g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 4), TMapDException);
+  EXPECT_THROW(g_handler->close_cursor(g_session, cursor.cursor_id), TMapDException);
+}
+
+TEST(Cursor, TableChanged) {
+  run_ddl_statement("DROP TABLE IF EXISTS cursor_changed;");
+  run_ddl_statement("CREATE TABLE cursor_changed (id BIGINT, val DOUBLE);");
+  load_rows("cursor_changed", 0, 10);
+  TCursor cursor;
+  g_handler->open_cursor(cursor, g_session, "SELECT id, val FROM cursor_changed;", true, "");
+  TRowSet page;
+  g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 4);
+  load_rows("cursor_changed", 10, 10);
+  EXPECT_THROW(g_handler->fetch_cursor(page, g_session, cursor.cursor_id, 4), TMapDException);
+  g_handler->close_cursor(g_session, cursor.cursor_id);
+  run_ddl_statement("DROP TABLE cursor_changed;");
+}
+
+TEST(Cursor, IdleTimeout) {
+  TCursor idle_cursor;
+  g_handler->open_cursor(idle_cursor, g_session, "SELECT id FROM cursor_small;", true, "");
+  const auto saved_timeout_s = g_mapd_parameters.cursor_timeout_s;
+  g_mapd_parameters.cursor_timeout_s = 1;
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+  TCursor active_cursor;
+  g_handler->open_cursor(active_cursor, g_session, "SELECT id FROM cursor_small;", true, "");
+  g_mapd_parameters.cursor_timeout_s = saved_timeout_s;
+  TRowSet page;
+  EXPECT_THROW(g_handler->fetch_cursor(page, g_session, idle_cursor.cursor_id, 4), TMapDException);
+  g_handler->fetch_cursor(page, g_session, active_cursor.cursor_id, 4);
+  EXPECT_EQ(size_t(4), page.columns[0].nulls.size());
+  g_handler->close_cursor(g_session, active_cursor.cursor_id);
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+  namespace po = boost::program_options;
+
+  po::options_description desc("Options");
+  // these two are here to allow passing correctly google testing parameters
+  desc.add_options()("gtest_list_tests", "list all test");
+  desc.add_options()("gtest_filter", "filters tests, use --help for details");
+  desc.add_options()(
+      "rows", po::value<size_t>(&g_row_count)->default_value(g_row_count), "Rows of the result fetched in pages");
+  desc.add_options()("check-memory",
+                     po::value<bool>(&g_check_memory)->default_value(g_check_memory)->implicit_value(true),
+                     "Check that the memory of the process stays flat while the pages are fetched");
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+  po::notify(vm);
+  g_row_count = std::max(g_row_count, size_t(1));
+  // the whole table is projected, the watchdog would reject it
+  g_enable_watchdog = false;
+
+  testing::AddGlobalTestEnvironment(new CursorFetchEnv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    DateTimeBenchmark.cpp
+ * @brief   Compares the CPU latency of DATE_TRUNC / EXTRACT heavy queries with the inline codegen of
+ * the date and time functions (g_enable_inline_datetime) against the calls to the DateTruncate and
+ * ExtractFromTime runtime functions, over a table of timestamps spread from 1900 to 2100. Both paths
+ * must return the same rows, the exit code is non-zero if they don't.
+ **/
+
+#include "../Catalog/Catalog.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/measure.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+const std::string bench_table{"bench_datetime"};
+
+struct BenchQuery {
+  std::string name;
+  std::string sql;
+};
+
+// Time bucketed group bys, plus aggregates and filters on a single field where the date function is
+// most of the work per row.
+const std::vector<BenchQuery> bench_queries{
+    {"groupby_trunc_minute",
+     "SELECT DATE_TRUNC(minute, ts) AS b, COUNT(*) FROM bench_datetime WHERE ts >= '2000-01-01 00:00:00' AND ts < "
+     "'2000-01-08 00:00:00' GROUP BY b;"},
+    {"groupby_trunc_hour", "SELECT DATE_TRUNC(hour, ts) AS b, COUNT(*) FROM bench_datetime GROUP BY b;"},
+    {"groupby_trunc_day", "SELECT DATE_TRUNC(day, ts) AS b, COUNT(*) FROM bench_datetime GROUP BY b;"},
+    {"groupby_trunc_week", "SELECT DATE_TRUNC(week, ts) AS b, COUNT(*) FROM bench_datetime GROUP BY b;"},
+    {"groupby_trunc_month", "SELECT DATE_TRUNC(month, ts) AS b, SUM(val) FROM bench_datetime GROUP BY b;"},
+    {"groupby_trunc_year", "SELECT DATE_TRUNC(year, ts) AS b, SUM(val) FROM bench_datetime GROUP BY b;"},
+    {"groupby_cast_date", "SELECT CAST(ts AS DATE) AS b, COUNT(*) FROM bench_datetime GROUP BY b;"},
+    {"groupby_extract_year_month",
+     "SELECT EXTRACT(YEAR FROM ts) AS y, EXTRACT(MONTH FROM ts) AS m, COUNT(*) FROM bench_datetime GROUP BY y, m;"},
+    {"sum_extract_hour", "SELECT SUM(EXTRACT(HOUR FROM ts)) FROM bench_datetime;"},
+    {"sum_extract_day", "SELECT SUM(EXTRACT(DAY FROM ts)) FROM bench_datetime;"},
+    {"sum_extract_dow", "SELECT SUM(EXTRACT(DOW FROM ts)) FROM bench_datetime;"},
+    {"filter_extract_month", "SELECT COUNT(*) FROM bench_datetime WHERE EXTRACT(MONTH FROM ts) = 2;"},
+    {"filter_extract_year", "SELECT COUNT(*) FROM bench_datetime WHERE EXTRACT(YEAR FROM ts) = 1969;"},
+};
+
+struct PathResult {
+  std::vector<double> ms;  // sorted
+  std::vector<std::vector<int64_t>> rows;
+
+  double median() const {
+    CHECK(!ms.empty());
+    return ms[ms.size() / 2];
+  }
+};
+
+uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// One row per line: a timestamp uniform over 1900-01-01 to 2100-01-01, one in 128 null, and a
+// small integer to aggregate.
+void write_csv(const std::string& path, const size_t row_count, const uint64_t seed) {
+  const int64_t min_ts{-2208988800};
+  const int64_t max_ts{4102444800};
+  std::ofstream out(path);
+  CHECK(out.good()) << "Couldn't open " << path;
+  uint64_t state{seed};
+  char line[64];
+  for (size_t i = 0; i < row_count; ++i) {
+    const auto r = splitmix64(state);
+    const time_t ts = min_ts + static_cast<int64_t>(r % static_cast<uint64_t>(max_ts - min_ts));
+    if (r >> 57 == 0) {
+      snprintf(line, sizeof(line), ",%d\n", static_cast<int>(r >> 48 & 0xff));
+    } else {
+      tm tm_struct;
+      gmtime_r(&ts, &tm_struct);
+      strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", &tm_struct);
+      const auto len = strlen(line);
+      snprintf(line + len, sizeof(line) - len, ",%d\n", static_cast<int>(r >> 48 & 0xff));
+    }
+    out << line;
+  }
+}
+
+void load_data(const std::unique_ptr<Catalog_Namespace::SessionInfo>& session,
+               const size_t row_count,
+               const uint64_t seed,
+               const std::string& db_path) {
+  const auto csv_path = db_path + "/" + bench_table + ".csv";
+  const auto gen_ms = measure<>::execution([&] { write_csv(csv_path, row_count, seed); });
+  QueryRunner::run_ddl_statement("DROP TABLE IF EXISTS " + bench_table + ";", session);
+  QueryRunner::run_ddl_statement("CREATE TABLE " + bench_table + " (ts TIMESTAMP, val INT);", session);
+  const auto load_ms = measure<>::execution([&] {
+    QueryRunner::run_ddl_statement("COPY " + bench_table + " FROM '" + csv_path + "' WITH (header='false');",
+                                   session);
+  });
+  boost::filesystem::remove(csv_path);
+  LOG(INFO) << "Generated " << row_count << " rows in " << gen_ms << " ms, loaded in " << load_ms << " ms";
+}
+
+std::vector<std::vector<int64_t>> get_sorted_rows(ResultSet& rows) {
+  std::vector<std::vector<int64_t>> result;
+  while (true) {
+    const auto crt_row = rows.getNextRow(true, true);
+    if (crt_row.empty()) {
+      break;
+    }
+    std::vector<int64_t> row;
+    for (const auto& target : crt_row) {
+      const auto scalar = boost::get<ScalarTargetValue>(&target);
+      CHECK(scalar);
+      const auto ival = boost::get<int64_t>(scalar);
+      CHECK(ival);
+      row.push_back(*ival);
+    }
+    result.push_back(row);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+PathResult run_path(const BenchQuery& query,
+                    const std::unique_ptr<Catalog_Namespace::SessionInfo>& session,
+                    const bool inline_datetime,
+                    const size_t iterations) {
+  g_enable_inline_datetime = inline_datetime;
+  PathResult result;
+  // the first run compiles the query, the code cache is keyed by the IR so each path has its own entry
+  auto rows = QueryRunner::run_multiple_agg(query.sql, session, ExecutorDeviceType::CPU, true, false);
+  result.rows = get_sorted_rows(*rows);
+  for (size_t i = 0; i < iterations; ++i) {
+    const auto us = measure<std::chrono::microseconds>::execution(
+        [&] { QueryRunner::run_multiple_agg(query.sql, session, ExecutorDeviceType::CPU, true, false); });
+    result.ms.push_back(us / 1000.);
+  }
+  std::sort(result.ms.begin(), result.ms.end());
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  namespace po = boost::program_options;
+
+  std::string db_path{BASE_PATH};
+  std::string query_filter{".*"};
+  size_t row_count{10000000};
+  uint64_t seed{1};
+  size_t iterations{5};
+
+  po::options_description desc("Options");
+  desc.add_options()("help,h", "Print help messages");
+  desc.add_options()(
+      "path", po::value<std::string>(&db_path)->default_value(db_path), "Directory path to Mapd catalogs");
+  desc.add_options()("rows", po::value<size_t>(&row_count)->default_value(row_count), "Rows of the timestamp table");
+  desc.add_options()("seed", po::value<uint64_t>(&seed)->default_value(seed), "Data generator seed");
+  desc.add_options()(
+      "iterations", po::value<size_t>(&iterations)->default_value(iterations), "Timed runs per query and path");
+  desc.add_options()(
+      "query", po::value<std::string>(&query_filter), "Only run the queries whose name matches this regex");
+  desc.add_options()("use-existing-data", "Don't generate and load the data, it's there from an earlier run");
+  desc.add_options()("keep-data", "Don't drop the table at the end");
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << "Usage Error: " << e.what() << std::endl;
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+  iterations = std::max(iterations, size_t(1));
+
+  g_enable_watchdog = false;
+  const auto save_inline_datetime = g_enable_inline_datetime;
+  std::unique_ptr<Catalog_Namespace::SessionInfo> session(QueryRunner::get_session(db_path.c_str()));
+  if (!vm.count("use-existing-data")) {
+    load_data(session, row_count, seed, db_path);
+  }
+
+  const std::regex query_regex(query_filter);
+  size_t mismatches{0};
+  std::cout << std::left << std::setw(28) << "query" << std::right << std::setw(14) << "runtime ms" << std::setw(14)
+            << "inline ms" << std::setw(10) << "speedup" << std::endl;
+  for (const auto& query : bench_queries) {
+    if (!std::regex_match(query.name, query_regex)) {
+      continue;
+    }
+    const auto runtime_result = run_path(query, session, false, iterations);
+    const auto inline_result = run_path(query, session, true, iterations);
+    const bool same_rows = runtime_result.rows == inline_result.rows;
+    if (!same_rows) {
+      LOG(ERROR) << query.name << ": the inline and the runtime paths returned different rows";
+      ++mismatches;
+    }
+    std::cout << std::left << std::setw(28) << query.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << runtime_result.median() << std::setw(14) << inline_result.median() << std::setw(9)
+              << runtime_result.median() / std::max(inline_result.median(), 0.001) << "x"
+              << (same_rows ? "" : "  ROWS DIFFER") << std::endl;
+  }
+  g_enable_inline_datetime = save_inline_datetime;
+
+  if (!vm.count("keep-data") && !vm.count("use-existing-data")) {
+    QueryRunner::run_ddl_statement("DROP TABLE IF EXISTS " + bench_table + ";", session);
+  }
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/DynamicWatchdog.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+TEST(QueryCancellationToken, NoTokenNeverStops) {
+  ASSERT_EQ(nullptr, QueryCancellationToken::current());
+  ASSERT_FALSE(dynamic_watchdog());
+  ASSERT_NO_THROW(check_query_interrupt(0, "test"));
+}
+
+TEST(QueryCancellationToken, Cancel) {
+  QueryCancellationToken token;
+  QueryCancellationToken::ThreadScope token_scope(&token);
+  ASSERT_FALSE(dynamic_watchdog());
+  token.cancel();
+  ASSERT_TRUE(token.isCancelled());
+  ASSERT_TRUE(dynamic_watchdog());
+  // only checked every 64 iterations
+  ASSERT_NO_THROW(check_query_interrupt(1, "test"));
+  ASSERT_THROW(check_query_interrupt(64, "test"), std::runtime_error);
+}
+
+TEST(QueryCancellationToken, Deadline) {
+  QueryCancellationToken token;
+  ASSERT_FALSE(token.hasDeadline());
+  token.startDeadline(20);
+  ASSERT_TRUE(token.hasDeadline());
+  ASSERT_FALSE(token.isCancelled());
+  // a later step of the query doesn't push the deadline back
+  token.startDeadline(60000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(unsigned(0), token.getRemainingMs());
+  ASSERT_TRUE(token.shouldStop());
+  ASSERT_FALSE(token.isCancelled());
+}
+
+TEST(QueryCancellationToken, PerThread) {
+  QueryCancellationToken cancelled_token;
+  cancelled_token.cancel();
+  QueryCancellationToken running_token;
+  {
+    QueryCancellationToken::ThreadScope token_scope(&cancelled_token);
+    ASSERT_TRUE(dynamic_watchdog());
+    // another query running on a different thread isn't affected
+    auto other_query = std::async(std::launch::async, [&running_token] {
+      QueryCancellationToken::ThreadScope token_scope(&running_token);
+      return dynamic_watchdog();
+    });
+    ASSERT_FALSE(other_query.get());
+    {
+      QueryCancellationToken::ThreadScope nested_scope(&running_token);
+      ASSERT_FALSE(dynamic_watchdog());
+    }
+    ASSERT_EQ(&cancelled_token, QueryCancellationToken::current());
+  }
+  ASSERT_EQ(nullptr, QueryCancellationToken::current());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
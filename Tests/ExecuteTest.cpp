@@ -14,20 +14,27 @@
  * limitations under the License.
  */
 
+#include "../Fragmenter/InsertOrderFragmenter.h"
 #include "../Import/Importer.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/RelAlgExecutionDescriptor.h"
+#include "../QueryEngine/ResultSetCache.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "../Shared/ConfigResolve.h"
+#include "../Shared/scope.h"
 #include "../SqliteConnector/SqliteConnector.h"
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <array>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 
 #ifndef BASE_PATH
@@ -427,6 +434,90 @@ TEST(Create, PageSize) {
     }
   }
 }
+
+TEST(Create, PageCompression) {
+  run_ddl_statement("DROP TABLE IF EXISTS test1;");
+  // small pages, so that every chunk spans several of them and appends rewrite partially filled pages
+  run_ddl_statement(
+      "CREATE TABLE test1 (x INT, t TEXT ENCODING NONE) WITH (page_size=128, fragment_size=16, "
+      "page_compression='zlib');");
+  auto& data_mgr = g_session->get_catalog().get_dataMgr();
+  // every query reads the chunks back from the compressed pages on disk instead of the buffer pools
+  const auto evict_test1 = [&data_mgr] {
+    if (data_mgr.gpusPresent()) {
+      data_mgr.clearMemory(Data_Namespace::GPU_LEVEL);
+    }
+    data_mgr.clearMemory(Data_Namespace::CPU_LEVEL);
+  };
+  for (int i = 0; i < 40; ++i) {
+    run_multiple_agg("INSERT INTO test1 VALUES(" + std::to_string(i % 4) + ", 'compressible compressible');",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    evict_test1();
+    ASSERT_EQ(int64_t(40), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test1;", dt)));
+    evict_test1();
+    ASSERT_EQ(int64_t(60), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM test1;", dt)));
+    evict_test1();
+    ASSERT_EQ(int64_t(40),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test1 WHERE t = 'compressible compressible';", dt)));
+  }
+  // the update reads the chunks it rewrites from disk as well
+  evict_test1();
+  run_multiple_agg("UPDATE test1 SET x = x + 1 WHERE x = 3;", ExecutorDeviceType::CPU);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    evict_test1();
+    ASSERT_EQ(int64_t(70), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM test1;", dt)));
+  }
+  run_ddl_statement("DROP TABLE test1;");
+  EXPECT_THROW(run_ddl_statement("CREATE TABLE test1 (x INT) WITH (page_compression='bzip2');"), std::runtime_error);
+}
+TEST(Insert, LogReplay) {
+  const auto save_insert_log = g_enable_insert_log;
+  const auto save_checkpoint_interval = g_insert_log_checkpoint_interval_ms;
+  ScopeGuard reset_insert_log = [save_insert_log, save_checkpoint_interval] {
+    g_enable_insert_log = save_insert_log;
+    g_insert_log_checkpoint_interval_ms = save_checkpoint_interval;
+  };
+  g_enable_insert_log = true;
+  // nothing gets checkpointed behind the test's back
+  g_insert_log_checkpoint_interval_ms = 3600 * 1000;
+  run_ddl_statement("DROP TABLE IF EXISTS insert_log_test;");
+  run_ddl_statement("CREATE TABLE insert_log_test (x INT, t TEXT, s TEXT ENCODING NONE) WITH (fragment_size=4);");
+  auto& cat = g_session->get_catalog();
+  const auto db_id = cat.get_currentDB().dbId;
+  const auto td = cat.getMetadataForTable("insert_log_test");
+  CHECK(td);
+  const auto epoch = cat.getTableEpoch(db_id, td->tableId);
+  for (int i = 0; i < 10; ++i) {
+    run_multiple_agg("INSERT INTO insert_log_test VALUES(" + std::to_string(i) + ", 'dict " + std::to_string(i) +
+                         "', 'none " + std::to_string(i) + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto log_path = cat.get_dataMgr().getInsertLogPath(db_id, td->tableId);
+  ASSERT_GT(boost::filesystem::file_size(log_path), uintmax_t(0));
+  const auto saved_log_path = log_path + ".saved";
+  boost::filesystem::copy_file(log_path, saved_log_path, boost::filesystem::copy_option::overwrite_if_exists);
+  // The server dies before the batches are checkpointed: roll the data files back to before
+  // the inserts and put the log back, the next access to the table replays it.
+  cat.setTableEpoch(db_id, td->tableId, epoch);
+  ASSERT_FALSE(boost::filesystem::exists(log_path));
+  boost::filesystem::rename(saved_log_path, log_path);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(10), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM insert_log_test;", dt)));
+    ASSERT_EQ(int64_t(45), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM insert_log_test;", dt)));
+    ASSERT_EQ(int64_t(7), v<int64_t>(run_simple_agg("SELECT x FROM insert_log_test WHERE t = 'dict 7';", dt)));
+    ASSERT_EQ(int64_t(3), v<int64_t>(run_simple_agg("SELECT x FROM insert_log_test WHERE s = 'none 3';", dt)));
+  }
+  // the replayed batches have been checkpointed and the log emptied
+  ASSERT_EQ(uintmax_t(0), boost::filesystem::file_size(log_path));
+  ASSERT_EQ(epoch + 1, cat.getTableEpoch(db_id, td->tableId));
+  run_ddl_statement("DROP TABLE insert_log_test;");
+}
+
 // Code is commented out while we resolve the leak in parser
 // TEST(Create, PageSize_NegativeCase) {
 //  run_ddl_statement("DROP TABLE IF EXISTS test1;");
@@ -950,6 +1041,50 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxPercentile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the extremes of a digest are exact
+    ASSERT_EQ(static_cast<double>(v<int64_t>(run_simple_agg("SELECT MIN(x) FROM test;", dt))),
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0) FROM test;", dt)));
+    ASSERT_EQ(static_cast<double>(v<int64_t>(run_simple_agg("SELECT MAX(x) FROM test;", dt))),
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 1) FROM test;", dt)));
+    ASSERT_EQ(v<double>(run_simple_agg("SELECT MAX(d) FROM test;", dt)),
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(d, 1.0) FROM test;", dt)));
+    const auto median = v<double>(run_simple_agg("SELECT APPROX_MEDIAN(y) FROM test;", dt));
+    ASSERT_LE(static_cast<double>(v<int64_t>(run_simple_agg("SELECT MIN(y) FROM test;", dt))), median);
+    ASSERT_GE(static_cast<double>(v<int64_t>(run_simple_agg("SELECT MAX(y) FROM test;", dt))), median);
+    ASSERT_EQ(v<double>(run_simple_agg("SELECT APPROX_MEDIAN(y) FROM test;", dt)),
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(y, 0.5) FROM test;", dt)));
+    ASSERT_EQ(NULL_DOUBLE, v<double>(run_simple_agg("SELECT APPROX_MEDIAN(x) FROM test WHERE x < 0;", dt)));
+    {
+      // every group holds a single distinct value
+      const auto rows = run_multiple_agg("SELECT x, APPROX_MEDIAN(x) FROM test GROUP BY x ORDER BY x;", dt);
+      while (true) {
+        const auto crt_row = rows->getNextRow(true, true);
+        if (crt_row.empty()) {
+          break;
+        }
+        ASSERT_EQ(static_cast<double>(v<int64_t>(crt_row[0])), v<double>(crt_row[1]));
+      }
+    }
+    {
+      const auto rows = run_multiple_agg("SELECT y, APPROX_PERCENTILE(x, 0) AS n FROM test GROUP BY y ORDER BY n;", dt);
+      double prev = -std::numeric_limits<double>::max();
+      while (true) {
+        const auto crt_row = rows->getNextRow(true, true);
+        if (crt_row.empty()) {
+          break;
+        }
+        ASSERT_LE(prev, v<double>(crt_row[1]));
+        prev = v<double>(crt_row[1]);
+      }
+    }
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 1.5) FROM test;", dt), std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(str, 0.5) FROM test;", dt), std::runtime_error);
+  }
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2234,6 +2369,72 @@ TEST(Select, Time) {
   }
 }
 
+TEST(Select, TimeInlineCodegen) {
+  const auto save_inline_datetime = g_enable_inline_datetime;
+  ScopeGuard reset_inline_datetime = [save_inline_datetime] { g_enable_inline_datetime = save_inline_datetime; };
+  run_ddl_statement("DROP TABLE IF EXISTS datetime_inline;");
+  run_ddl_statement("CREATE TABLE datetime_inline (id INT, t TIMESTAMP);");
+  // day, minute and month boundaries before and after the epoch, leap days and century years
+  const std::vector<std::string> timestamps{"1969-12-31 23:59:59",
+                                            "1969-12-31 23:59:00",
+                                            "1969-12-31 00:00:00",
+                                            "1970-01-01 00:00:00",
+                                            "1968-02-29 12:30:45",
+                                            "1900-02-28 23:59:59",
+                                            "1900-03-01 00:00:00",
+                                            "1903-05-08 20:15:12",
+                                            "1999-12-31 23:59:59",
+                                            "2000-02-29 06:00:00",
+                                            "2000-03-01 00:00:01",
+                                            "2012-05-08 20:15:12",
+                                            "2038-01-19 03:14:08",
+                                            "2100-03-01 18:00:00",
+                                            "2016-01-03 10:00:00"};
+  for (size_t i = 0; i < timestamps.size(); ++i) {
+    run_multiple_agg(
+        "INSERT INTO datetime_inline VALUES(" + std::to_string(i) + ", '" + timestamps[i] + "');",
+        ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO datetime_inline VALUES(" + std::to_string(timestamps.size()) + ", NULL);",
+                   ExecutorDeviceType::CPU);
+  const std::vector<std::string> exprs{
+      "EXTRACT(YEAR FROM t)",     "EXTRACT(QUARTER FROM t)",    "EXTRACT(MONTH FROM t)",
+      "EXTRACT(DAY FROM t)",      "EXTRACT(HOUR FROM t)",       "EXTRACT(MINUTE FROM t)",
+      "EXTRACT(SECOND FROM t)",   "EXTRACT(DOW FROM t)",        "EXTRACT(ISODOW FROM t)",
+      "EXTRACT(DOY FROM t)",      "EXTRACT(QUARTERDAY FROM t)", "EXTRACT(WEEK FROM t)",
+      "DATE_TRUNC(year, t)",      "DATE_TRUNC(quarter, t)",     "DATE_TRUNC(month, t)",
+      "DATE_TRUNC(week, t)",      "DATE_TRUNC(day, t)",         "DATE_TRUNC(quarterday, t)",
+      "DATE_TRUNC(hour, t)",      "DATE_TRUNC(minute, t)",      "DATE_TRUNC(second, t)",
+      "DATE_TRUNC(decade, t)",    "CAST(t AS DATE)"};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto& expr : exprs) {
+      const std::string query{"SELECT id, " + expr + " FROM datetime_inline ORDER BY id;"};
+      g_enable_inline_datetime = false;
+      const auto runtime_rows = run_multiple_agg(query, dt);
+      g_enable_inline_datetime = true;
+      const auto inline_rows = run_multiple_agg(query, dt);
+      ASSERT_EQ(timestamps.size() + 1, inline_rows->rowCount());
+      ASSERT_EQ(runtime_rows->rowCount(), inline_rows->rowCount());
+      for (size_t i = 0; i < inline_rows->rowCount(); ++i) {
+        const auto runtime_row = runtime_rows->getNextRow(true, true);
+        const auto inline_row = inline_rows->getNextRow(true, true);
+        ASSERT_EQ(v<int64_t>(runtime_row[0]), v<int64_t>(inline_row[0]));
+        ASSERT_EQ(v<int64_t>(runtime_row[1]), v<int64_t>(inline_row[1])) << expr << " of " << v<int64_t>(inline_row[0]);
+      }
+    }
+    g_enable_inline_datetime = true;
+    ASSERT_EQ(-60, v<int64_t>(run_simple_agg("SELECT DATE_TRUNC(minute, t) FROM datetime_inline WHERE id = 1;", dt)));
+    ASSERT_EQ(-86400, v<int64_t>(run_simple_agg("SELECT DATE_TRUNC(day, t) FROM datetime_inline WHERE id = 2;", dt)));
+    ASSERT_EQ(59, v<int64_t>(run_simple_agg("SELECT EXTRACT(SECOND FROM t) FROM datetime_inline WHERE id = 0;", dt)));
+    ASSERT_EQ(951782400,
+              v<int64_t>(run_simple_agg("SELECT DATE_TRUNC(day, t) FROM datetime_inline WHERE id = 9;", dt)));
+    ASSERT_EQ(29, v<int64_t>(run_simple_agg("SELECT EXTRACT(DAY FROM t) FROM datetime_inline WHERE id = 4;", dt)));
+    ASSERT_EQ(1900, v<int64_t>(run_simple_agg("SELECT EXTRACT(YEAR FROM t) FROM datetime_inline WHERE id = 5;", dt)));
+  }
+  run_ddl_statement("DROP TABLE datetime_inline;");
+}
+
 TEST(Select, In) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2249,6 +2450,72 @@ TEST(Select, In) {
   }
 }
 
+TEST(Select, InValuesHashSet) {
+  run_ddl_statement("DROP TABLE IF EXISTS in_set_test;");
+  run_ddl_statement(
+      "CREATE TABLE in_set_test (f FLOAT, d DOUBLE, s TEXT ENCODING NONE, b BIGINT, dc DECIMAL(10,2), dt DATE);");
+  for (const auto& row : {"0.0, 0.0, '', 1, 1.50, '2018-01-01'",
+                          "-0.0, -0.0, 'abcd', 1000000000000, 2.25, '2018-03-04'",
+                          "1.5, 1.5, 'abce', -500000000000000000, 3.00, '2019-12-31'",
+                          "NULL, NULL, NULL, NULL, NULL, NULL",
+                          "2.25, 2.25, 'dcba', 42, 4.12, '1969-07-20'",
+                          "3.0, 1e300, 'x', 7, -1.00, '2000-02-29'"}) {
+    run_multiple_agg("INSERT INTO in_set_test VALUES(" + std::string(row) + ");", ExecutorDeviceType::CPU);
+  }
+  // lists of more than three values go through the bitmap or the hash set, the equivalent
+  // chain of equalities is always evaluated with plain comparisons
+  const auto check_in = [](const std::string& col,
+                           const std::vector<std::string>& values,
+                           const ExecutorDeviceType dt) {
+    std::string in_pred{col + " IN ("};
+    std::string or_pred;
+    for (size_t i = 0; i < values.size(); ++i) {
+      in_pred += (i ? ", " : "") + values[i];
+      or_pred += (i ? " OR " : "") + col + " = " + values[i];
+    }
+    in_pred += ")";
+    for (const auto& wrap : {std::make_pair(std::string("("), std::string(")")),
+                             std::make_pair(std::string("NOT ("), std::string(")")),
+                             std::make_pair(std::string("("), std::string(") IS NULL"))}) {
+      const auto query_prefix = "SELECT COUNT(*) FROM in_set_test WHERE " + wrap.first;
+      ASSERT_EQ(v<int64_t>(run_simple_agg(query_prefix + or_pred + wrap.second + ";", dt)),
+                v<int64_t>(run_simple_agg(query_prefix + in_pred + wrap.second + ";", dt)))
+          << in_pred;
+    }
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // floating point, -0.0 and 0.0 are the same value; a null in the list or a null needle
+    check_in("f", {"-0.0", "1.5", "0.5", "3.0"}, dt);
+    check_in("f", {"1.5", "CAST(NULL AS FLOAT)", "0.5", "7.0"}, dt);
+    check_in("d", {"0.0", "2.25", "1e300", "-4.5"}, dt);
+    check_in("d", {"CAST(NULL AS DOUBLE)", "1.5", "8.0", "9.0"}, dt);
+    ASSERT_EQ(int64_t(2),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM in_set_test WHERE f IN (-0.0, 0.5, 7.0, 8.0);", dt)));
+    // none encoded strings, with the empty string and values of equal length
+    check_in("s", {"''", "'abce'", "'dcba'", "'zzzz'"}, dt);
+    check_in("s", {"'abcf'", "'bbcd'", "'abcd'", "'dcbb'"}, dt);
+    check_in("s", {"'x'", "CAST(NULL AS TEXT)", "'y'", "'z'"}, dt);
+    ASSERT_EQ(
+        int64_t(2),
+        v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM in_set_test WHERE s IN ('abce', 'dcba', 'abcf', 'zz');", dt)));
+    // integers too sparse for the bitmap
+    check_in("b", {"1", "1000000000000", "-500000000000000000", "9000000000000000000"}, dt);
+    check_in("b", {"2", "1000000000001", "-9000000000000000000", "CAST(NULL AS BIGINT)"}, dt);
+    // decimals and dates on the bitmap, then with constants the cast would change
+    check_in("dc", {"1.50", "2.25", "3.00", "9.99"}, dt);
+    check_in("dc", {"1.5", "2.125", "3", "4.12"}, dt);
+    check_in("dt", {"'2018-01-01'", "'2019-12-31'", "'1969-07-20'", "'2001-01-01'"}, dt);
+    check_in("dt",
+             {"TIMESTAMP '2018-01-01 00:00:00'",
+              "TIMESTAMP '2019-12-31 00:00:00'",
+              "TIMESTAMP '2000-02-29 12:00:00'",
+              "TIMESTAMP '2001-01-01 00:00:00'"},
+             dt);
+  }
+  run_ddl_statement("DROP TABLE in_set_test;");
+}
+
 TEST(Select, DivByZero) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -3346,6 +3613,35 @@ TEST(Select, Subqueries) {
   }
 }
 
+TEST(Select, ConcurrentSteps) {
+  const auto save_max_concurrent_steps = g_max_concurrent_steps;
+  ScopeGuard reset_max_concurrent_steps = [save_max_concurrent_steps] {
+    g_max_concurrent_steps = save_max_concurrent_steps;
+  };
+  // the same results whether independent steps and subqueries run one after the other or together
+  for (const size_t max_concurrent_steps : {size_t(1), size_t(2), size_t(4)}) {
+    g_max_concurrent_steps = max_concurrent_steps;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT a.str as key0,a.fixed_str as key1,COUNT(*) AS color FROM test a JOIN (select str,count(*) "
+        "from test group by str order by COUNT(*) desc limit 40) b on a.str=b.str JOIN (select "
+        "fixed_str,count(*) from test group by fixed_str order by count(*) desc limit 40) c on "
+        "c.fixed_str=a.fixed_str GROUP BY key0, key1 ORDER BY key0,key1;",
+        dt);
+      c("SELECT min_x, max_y FROM (SELECT MIN(x) AS min_x FROM test), (SELECT MAX(y) AS max_y FROM test_inner);", dt);
+      c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner) AND y IN (SELECT y FROM test WHERE x > 7);",
+        dt);
+      c("SELECT str, COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner GROUP BY x) AND y > (SELECT MIN(y) FROM "
+        "test) AND z NOT IN (SELECT z FROM test WHERE x = 8) GROUP BY str ORDER BY str;",
+        dt);
+      // the inner subquery has to finish before the one using it starts
+      c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test WHERE x > (SELECT COUNT(*) FROM test WHERE x > 7) "
+        "+ 2 GROUP BY x) AND y IN (SELECT y FROM test GROUP BY y);",
+        dt);
+    }
+  }
+}
+
 TEST(Select, Joins_Arrays) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -4010,6 +4306,181 @@ TEST(Select, WatchdogTest) {
   }
 }
 
+TEST(Select, ResultSetCache) {
+  const auto save_cache_bytes = g_result_set_cache_bytes;
+  ScopeGuard reset_cache_bytes = [save_cache_bytes] { g_result_set_cache_bytes = save_cache_bytes; };
+  g_result_set_cache_bytes = 1 << 20;
+  run_ddl_statement("DROP TABLE IF EXISTS result_cache_test;");
+  run_ddl_statement("CREATE TABLE result_cache_test (x int, str text encoding dict);");
+  run_multiple_agg("INSERT INTO result_cache_test VALUES(1, 'a');", ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO result_cache_test VALUES(2, 'b');", ExecutorDeviceType::CPU);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const std::string query{"SELECT str, SUM(x) AS n FROM result_cache_test GROUP BY str ORDER BY n DESC;"};
+    const auto hits_before = ResultSetCache::getStats().hits;
+    const auto first = run_multiple_agg(query, dt);
+    ASSERT_FALSE(first->isFromResultCache());
+    const auto second = run_multiple_agg(query, dt);
+    ASSERT_TRUE(second->isFromResultCache());
+    ASSERT_EQ(hits_before + 1, ResultSetCache::getStats().hits);
+    ASSERT_EQ(size_t(2), second->rowCount());
+    const auto crt_row = second->getNextRow(true, true);
+    ASSERT_EQ("b", boost::get<std::string>(v<NullableString>(crt_row[0])));
+    ASSERT_EQ(int64_t(2), v<int64_t>(crt_row[1]));
+    // the cached copy mustn't keep the memory of the query which filled the cache
+    ASSERT_NE(first->getRowSetMemOwner(), second->getRowSetMemOwner());
+    // count distinct and percentile state lives outside of the row buffer, these aren't cached
+    for (const auto& owner_state_query :
+         {"SELECT str, COUNT(DISTINCT x) FROM result_cache_test GROUP BY str;",
+          "SELECT APPROX_PERCENTILE(x, 0.5) FROM result_cache_test;"}) {
+      const auto entries_before = ResultSetCache::getStats().entry_count;
+      run_multiple_agg(owner_state_query, dt);
+      ASSERT_FALSE(run_multiple_agg(owner_state_query, dt)->isFromResultCache());
+      ASSERT_EQ(entries_before, ResultSetCache::getStats().entry_count);
+    }
+  }
+  // a new row must invalidate the cached aggregate
+  const std::string sum_query{"SELECT SUM(x) FROM result_cache_test;"};
+  ASSERT_EQ(int64_t(3), v<int64_t>(run_simple_agg(sum_query, ExecutorDeviceType::CPU)));
+  ASSERT_TRUE(run_multiple_agg(sum_query, ExecutorDeviceType::CPU)->isFromResultCache());
+  run_multiple_agg("INSERT INTO result_cache_test VALUES(3, 'a');", ExecutorDeviceType::CPU);
+  const auto rows = run_multiple_agg(sum_query, ExecutorDeviceType::CPU);
+  ASSERT_FALSE(rows->isFromResultCache());
+  ASSERT_EQ(int64_t(6), v<int64_t>(rows->getRowAt(0, 0, true)));
+  run_ddl_statement("DROP TABLE result_cache_test;");
+}
+
+TEST(Select, GroupBySpilled) {
+  const auto save_spill_entries = g_group_by_spill_entries;
+  ScopeGuard reset_spill_entries = [save_spill_entries] { g_group_by_spill_entries = save_spill_entries; };
+  // more groups than the default guess of the group by buffer, on few enough rows to skip the
+  // cardinality estimation: the first attempt runs out of slots
+  const size_t row_count{18000};
+  const size_t group_count{17000};
+  const int64_t key_stride{1000003};
+  run_ddl_statement("DROP TABLE IF EXISTS group_by_spill_test;");
+  run_ddl_statement("CREATE TABLE group_by_spill_test (k BIGINT, v INT) WITH (fragment_size=4000);");
+  const std::string csv_path{std::string(BASE_PATH) + "/group_by_spill_test.csv"};
+  {
+    std::ofstream csv(csv_path);
+    for (size_t i = 0; i < row_count; ++i) {
+      csv << static_cast<int64_t>(i % group_count) * key_stride << "," << i % 7 << "\n";
+    }
+  }
+  run_ddl_statement("COPY group_by_spill_test FROM '" + csv_path + "' WITH (header='false');");
+  std::remove(csv_path.c_str());
+  const auto spill_path = boost::filesystem::path(BASE_PATH) / "mapd_spill";
+  // with 1024 entries, every fragment is a batch of its own and the partitions spill; the
+  // groups of the first fragment show up again in the last one and are reduced across batches
+  for (const size_t spill_entries : {size_t(1) << 22, size_t(1024)}) {
+    g_group_by_spill_entries = spill_entries;
+    const auto rows =
+        run_multiple_agg("SELECT k, COUNT(*), SUM(v) FROM group_by_spill_test GROUP BY k;", ExecutorDeviceType::CPU);
+    ASSERT_EQ(group_count, rows->rowCount());
+    std::vector<bool> seen(group_count, false);
+    while (true) {
+      const auto crt_row = rows->getNextRow(true, true);
+      if (crt_row.empty()) {
+        break;
+      }
+      const auto k = v<int64_t>(crt_row[0]);
+      ASSERT_EQ(int64_t(0), k % key_stride);
+      const auto group = static_cast<size_t>(k / key_stride);
+      ASSERT_LT(group, group_count);
+      ASSERT_FALSE(seen[group]);
+      seen[group] = true;
+      const bool has_two_rows = group + group_count < row_count;
+      ASSERT_EQ(int64_t(has_two_rows ? 2 : 1), v<int64_t>(crt_row[1]));
+      const int64_t expected_sum = group % 7 + (has_two_rows ? (group + group_count) % 7 : 0);
+      ASSERT_EQ(expected_sum, v<int64_t>(crt_row[2]));
+    }
+    // the spill files of the query are gone with it
+    ASSERT_TRUE(boost::filesystem::is_directory(spill_path));
+    ASSERT_TRUE(boost::filesystem::is_empty(spill_path));
+  }
+  run_ddl_statement("DROP TABLE group_by_spill_test;");
+}
+
+TEST(Select, RunLengthAndDiffEncoding) {
+  run_ddl_statement("DROP TABLE IF EXISTS rl_diff_test;");
+  run_ddl_statement(
+      "CREATE TABLE rl_diff_test (x INT, rl_x INT ENCODING RL, diff_x INT ENCODING DIFF(16), rl_ts TIMESTAMP "
+      "ENCODING RL, diff_ts TIMESTAMP ENCODING DIFF(32), diff_b BIGINT ENCODING DIFF(8)) WITH (fragment_size=4);");
+  g_sqlite_comparator.query("DROP TABLE IF EXISTS rl_diff_test;");
+  g_sqlite_comparator.query("CREATE TABLE rl_diff_test (x INT, rl_x INT, diff_x INT);");
+  // one row per insert, so runs are extended across appends and span fragments
+  for (int i = 0; i < 10; ++i) {
+    const auto rl_x = std::to_string(i / 3);
+    const auto diff_x = i == 5 ? std::string("NULL") : std::to_string(1000 + i);
+    const auto rl_ts = "'2018-01-0" + std::to_string(1 + i / 4) + " 00:00:00'";
+    const auto diff_ts = "'2018-01-01 00:00:0" + std::to_string(i) + "'";
+    // 250 is out of DIFF(8) range from the base of its chunk, the chunk gets a new base
+    const auto diff_b = i == 9 ? std::string("250") : std::to_string(10 + i);
+    run_multiple_agg("INSERT INTO rl_diff_test VALUES(" + std::to_string(i) + ", " + rl_x + ", " + diff_x + ", " +
+                         rl_ts + ", " + diff_ts + ", " + diff_b + ");",
+                     ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query("INSERT INTO rl_diff_test VALUES(" + std::to_string(i) + ", " + rl_x + ", " + diff_x +
+                              ");");
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM rl_diff_test WHERE rl_x = 1;", dt);
+    c("SELECT SUM(rl_x), MIN(rl_x), MAX(rl_x) FROM rl_diff_test;", dt);
+    c("SELECT SUM(diff_x), MIN(diff_x), MAX(diff_x), COUNT(diff_x) FROM rl_diff_test;", dt);
+    c("SELECT COUNT(*) FROM rl_diff_test WHERE diff_x IS NULL;", dt);
+    c("SELECT x, rl_x, diff_x FROM rl_diff_test ORDER BY x;", dt);
+    c("SELECT x FROM rl_diff_test WHERE diff_x > 1005 ORDER BY x;", dt);
+    c("SELECT rl_x, COUNT(*) FROM rl_diff_test GROUP BY rl_x ORDER BY rl_x;", dt);
+    ASSERT_EQ(int64_t(4),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM rl_diff_test WHERE rl_ts = '2018-01-02 00:00:00';", dt)));
+    ASSERT_EQ(int64_t(4),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM rl_diff_test WHERE diff_ts > '2018-01-01 00:00:05';", dt)));
+    ASSERT_EQ(int64_t(10), v<int64_t>(run_simple_agg("SELECT COUNT(diff_b) FROM rl_diff_test;", dt)));
+    ASSERT_EQ(int64_t(250), v<int64_t>(run_simple_agg("SELECT MAX(diff_b) FROM rl_diff_test;", dt)));
+    ASSERT_EQ(int64_t(10), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM rl_diff_test WHERE diff_b >= 10;", dt)));
+  }
+  // 100000 can't share a DIFF(8) chunk with 18 and 250, the insert fails without appending the row
+  EXPECT_THROW(run_multiple_agg("INSERT INTO rl_diff_test VALUES(10, 3, 1010, '2018-01-03 00:00:00', "
+                                "'2018-01-01 00:00:10', 100000);",
+                                ExecutorDeviceType::CPU),
+               std::runtime_error);
+  run_multiple_agg("INSERT INTO rl_diff_test VALUES(10, 3, 1010, '2018-01-03 00:00:00', '2018-01-01 00:00:10', 200);",
+                   ExecutorDeviceType::CPU);
+  g_sqlite_comparator.query("INSERT INTO rl_diff_test VALUES(10, 3, 1010);");
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, rl_x, diff_x FROM rl_diff_test ORDER BY x;", dt);
+    ASSERT_EQ(int64_t(11), v<int64_t>(run_simple_agg("SELECT COUNT(diff_b) FROM rl_diff_test;", dt)));
+    ASSERT_EQ(int64_t(200), v<int64_t>(run_simple_agg("SELECT diff_b FROM rl_diff_test WHERE x = 10;", dt)));
+  }
+  run_ddl_statement("DROP TABLE rl_diff_test;");
+  // re-bases of a chunk which is cached at the CPU and GPU levels already
+  run_ddl_statement("DROP TABLE IF EXISTS diff_rebase_test;");
+  run_ddl_statement("CREATE TABLE diff_rebase_test (x INT, b BIGINT ENCODING DIFF(8));");
+  // the value inserted and the sum after it
+  const std::vector<std::pair<std::string, int64_t>> rebase_inserts{
+      {"100", 100}, {"300", 400}, {"NULL", 400}, {"50", 450}};
+  for (size_t i = 0; i < rebase_inserts.size(); ++i) {
+    run_multiple_agg("INSERT INTO diff_rebase_test VALUES(" + std::to_string(i) + ", " + rebase_inserts[i].first + ");",
+                     ExecutorDeviceType::CPU);
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      ASSERT_EQ(rebase_inserts[i].second, v<int64_t>(run_simple_agg("SELECT SUM(b) FROM diff_rebase_test;", dt)));
+    }
+  }
+  EXPECT_THROW(run_multiple_agg("INSERT INTO diff_rebase_test VALUES(4, 400);", ExecutorDeviceType::CPU),
+               std::runtime_error);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(4), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM diff_rebase_test;", dt)));
+    ASSERT_EQ(int64_t(50), v<int64_t>(run_simple_agg("SELECT MIN(b) FROM diff_rebase_test;", dt)));
+    ASSERT_EQ(int64_t(300), v<int64_t>(run_simple_agg("SELECT MAX(b) FROM diff_rebase_test;", dt)));
+    ASSERT_EQ(int64_t(100), v<int64_t>(run_simple_agg("SELECT b FROM diff_rebase_test WHERE x = 0;", dt)));
+    ASSERT_EQ(int64_t(1), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM diff_rebase_test WHERE b IS NULL;", dt)));
+  }
+  run_ddl_statement("DROP TABLE diff_rebase_test;");
+}
+
 TEST(Truncate, Count) {
   run_ddl_statement("create table trunc_test (i1 integer, t1 text);");
   run_multiple_agg("insert into trunc_test values(1, '1');", ExecutorDeviceType::CPU);
@@ -4022,6 +4493,132 @@ TEST(Truncate, Count) {
   run_ddl_statement("drop table trunc_test;");
 }
 
+TEST(Partition, RangePartitionedTable) {
+  run_ddl_statement("DROP TABLE IF EXISTS range_part_test;");
+  run_ddl_statement(
+      "CREATE TABLE range_part_test (x INTEGER, d DATE) WITH (fragment_size=2) PARTITION BY RANGE (x) "
+      "(PARTITION p0 VALUES LESS THAN (10), PARTITION p1 VALUES LESS THAN (20), PARTITION pmax VALUES LESS THAN "
+      "MAXVALUE);");
+  for (int i = 0; i < 30; ++i) {
+    run_multiple_agg("INSERT INTO range_part_test VALUES(" + std::to_string(i) + ", '2018-01-01');",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO range_part_test VALUES(NULL, '2018-01-01');", ExecutorDeviceType::CPU);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(31), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test;", dt)));
+    ASSERT_EQ(int64_t(5), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x < 5;", dt)));
+    ASSERT_EQ(int64_t(10),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x >= 10 AND x < 20;", dt)));
+    ASSERT_EQ(int64_t(1), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x = 20;", dt)));
+    ASSERT_EQ(int64_t(435), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM range_part_test;", dt)));
+  }
+  // the row would stay in p0, where WHERE x = 25 no longer looks
+  EXPECT_THROW(run_multiple_agg("UPDATE range_part_test SET x = 25 WHERE x = 5;", ExecutorDeviceType::CPU),
+               std::runtime_error);
+  EXPECT_THROW(
+      run_multiple_agg("UPDATE range_part_test SET d = '2018-01-02', x = x + 1 WHERE x = 5;", ExecutorDeviceType::CPU),
+      std::runtime_error);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(1), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x = 5;", dt)));
+    ASSERT_EQ(int64_t(1), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x = 25;", dt)));
+    ASSERT_EQ(int64_t(435), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM range_part_test;", dt)));
+  }
+  run_ddl_statement("ALTER TABLE range_part_test DROP PARTITION p0;");
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(20), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test;", dt)));
+    ASSERT_EQ(int64_t(0), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x < 10;", dt)));
+  }
+  // the lowest remaining partition takes the values below its bound from now on
+  run_multiple_agg("INSERT INTO range_part_test VALUES(3, '2018-01-01');", ExecutorDeviceType::CPU);
+  ASSERT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM range_part_test WHERE x < 10;", ExecutorDeviceType::CPU)));
+  EXPECT_THROW(run_ddl_statement("ALTER TABLE range_part_test DROP PARTITION p0;"), std::runtime_error);
+  run_ddl_statement("DROP TABLE range_part_test;");
+
+  EXPECT_THROW(run_ddl_statement("CREATE TABLE range_part_test (x INTEGER) PARTITION BY RANGE (x) (PARTITION p0 "
+                                 "VALUES LESS THAN (10), PARTITION p1 VALUES LESS THAN (5));"),
+               std::runtime_error);
+  run_ddl_statement(
+      "CREATE TABLE range_part_test (x INTEGER) PARTITION BY RANGE (x) (PARTITION p0 VALUES LESS THAN (10));");
+  EXPECT_THROW(run_multiple_agg("INSERT INTO range_part_test VALUES(10);", ExecutorDeviceType::CPU),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("ALTER TABLE range_part_test DROP PARTITION p0;"), std::runtime_error);
+  run_ddl_statement("DROP TABLE range_part_test;");
+}
+
+TEST(SortKey, LoadInSortKeyOrder) {
+  run_ddl_statement("DROP TABLE IF EXISTS sort_key_test;");
+  run_ddl_statement("CREATE TABLE sort_key_test (x INTEGER, y DOUBLE, SORT KEY (x, y)) WITH (fragment_size=8);");
+  auto& cat = g_session->get_catalog();
+  const auto td = cat.getMetadataForTable("sort_key_test");
+  CHECK(td);
+  const auto x_cd = cat.getMetadataForColumn(td->tableId, "x");
+  CHECK(x_cd);
+  Importer_NS::Loader loader(cat, td);
+  std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
+  for (const auto cd : loader.get_column_descs()) {
+    import_buffers.emplace_back(new Importer_NS::TypedImportBuffer(cd, nullptr));
+  }
+  // batches of an import thread, each one spans the whole range of x in descending order
+  const auto load_batch = [&loader, &import_buffers](const std::vector<std::pair<int, double>>& rows) {
+    for (const auto& row : rows) {
+      import_buffers[0]->addInt(row.first);
+      import_buffers[1]->addDouble(row.second);
+    }
+    ASSERT_TRUE(loader.loadNoCheckpoint(import_buffers, rows.size()));
+    for (auto& import_buffer : import_buffers) {
+      import_buffer->clear();
+    }
+  };
+  const auto check_x_range = [td, x_cd](const size_t fragment_idx, const int min_x, const int max_x) {
+    const auto query_info = td->fragmenter->getFragmentsForQuery();
+    ASSERT_LT(fragment_idx, query_info.fragments.size());
+    const auto& fragment = query_info.fragments[fragment_idx];
+    const auto chunk_meta_it = fragment.getChunkMetadataMapPhysical().find(x_cd->columnId);
+    ASSERT_TRUE(chunk_meta_it != fragment.getChunkMetadataMapPhysical().end());
+    ASSERT_EQ(min_x, chunk_meta_it->second.chunkStats.min.intval);
+    ASSERT_EQ(max_x, chunk_meta_it->second.chunkStats.max.intval);
+  };
+  // held back until a fragment's worth of rows is there
+  load_batch({{9, 0}, {6, 0}, {3, 0}, {0, NAN}});
+  ASSERT_EQ(int64_t(0), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sort_key_test;", ExecutorDeviceType::CPU)));
+  load_batch({{10, 1}, {7, 1}, {4, 1}, {0, 1}});
+  ASSERT_EQ(size_t(1), td->fragmenter->getFragmentsForQuery().fragments.size());
+  check_x_range(0, 0, 10);
+  load_batch({{11, 2}, {8, 2}, {5, 2}, {2, 2}});
+  ASSERT_TRUE(loader.loadPendingRows(false));
+  loader.checkpoint();
+  check_x_range(1, 2, 11);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(12), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sort_key_test;", dt)));
+    ASSERT_EQ(int64_t(65), v<int64_t>(run_simple_agg("SELECT SUM(x) FROM sort_key_test;", dt)));
+    // both batches of the first fragment are sorted together, NaN after the numbers
+    ASSERT_EQ(int64_t(0), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 0;", dt)));
+    ASSERT_EQ(double(1), v<double>(run_simple_agg("SELECT y FROM sort_key_test WHERE rowid = 0;", dt)));
+    ASSERT_EQ(int64_t(0), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 1;", dt)));
+    ASSERT_EQ(int64_t(3), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 2;", dt)));
+    ASSERT_EQ(int64_t(10), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 7;", dt)));
+    ASSERT_EQ(int64_t(2), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 8;", dt)));
+    ASSERT_EQ(int64_t(11), v<int64_t>(run_simple_agg("SELECT x FROM sort_key_test WHERE rowid = 11;", dt)));
+  }
+  // a rolled back import drops the rows it held back
+  load_batch({{12, 3}});
+  loader.setTableEpoch(loader.getTableEpoch());
+  ASSERT_TRUE(loader.loadPendingRows(false));
+  ASSERT_EQ(int64_t(12), v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sort_key_test;", ExecutorDeviceType::CPU)));
+  run_ddl_statement("DROP TABLE sort_key_test;");
+
+  EXPECT_THROW(run_ddl_statement("CREATE TABLE sort_key_test (x INTEGER, SORT KEY (z));"), std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("CREATE TABLE sort_key_test (x INTEGER, s TEXT, SORT KEY (s));"),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("CREATE TABLE sort_key_test (x INTEGER, SORT KEY (x), SORT KEY (x));"),
+               std::runtime_error);
+}
+
 // Can uncomment once Michael fixes a thing in Catalog.cpp
 // TEST(Update, NoneEncodedText) {
 //  if (!std::is_same<CalciteUpdatePathSelector, PreprocessorTrue>::value)
@@ -6161,6 +6758,128 @@ TEST(Select, GeoSpatial) {
   }
 }
 
+TEST(Select, GeoSpatialJoin) {
+  const auto save_threshold = g_trivial_loop_join_threshold;
+  const auto save_spatial_join_index = g_enable_spatial_join_index;
+  ScopeGuard reset_join_settings = [save_threshold, save_spatial_join_index] {
+    g_trivial_loop_join_threshold = save_threshold;
+    g_enable_spatial_join_index = save_spatial_join_index;
+  };
+  // Loop joins are disallowed below, the joins only succeed through the spatial index.
+  g_trivial_loop_join_threshold = 0;
+  g_enable_spatial_join_index = true;
+  run_ddl_statement("DROP TABLE IF EXISTS geo_join_pts;");
+  run_ddl_statement("DROP TABLE IF EXISTS geo_join_polys;");
+  run_ddl_statement("DROP TABLE IF EXISTS geo_join_polys_frag;");
+  run_ddl_statement("DROP TABLE IF EXISTS geo_join_sites;");
+  run_ddl_statement("CREATE TABLE geo_join_pts (id INT, p POINT) WITH (fragment_size=4);");
+  run_ddl_statement("CREATE TABLE geo_join_polys (id INT, poly POLYGON);");
+  run_ddl_statement("CREATE TABLE geo_join_polys_frag (id INT, poly POLYGON) WITH (fragment_size=5);");
+  run_ddl_statement("CREATE TABLE geo_join_sites (id INT, s POINT);");
+  // 5x5 grid of 8x8 squares with a gap of 2 between them, plus one large square overlapping many of them.
+  std::vector<std::array<double, 4>> squares;
+  for (int j = 0; j < 5; ++j) {
+    for (int i = 0; i < 5; ++i) {
+      squares.push_back({10. * i, 10. * j, 10. * i + 8, 10. * j + 8});
+    }
+  }
+  squares.push_back({5., 5., 35., 35.});
+  for (size_t k = 0; k < squares.size(); ++k) {
+    const auto& sq = squares[k];
+    const auto x0 = std::to_string(sq[0]), y0 = std::to_string(sq[1]);
+    const auto x1 = std::to_string(sq[2]), y1 = std::to_string(sq[3]);
+    const std::string poly{"'POLYGON((" + x0 + " " + y0 + ", " + x1 + " " + y0 + ", " + x1 + " " + y1 + ", " + x0 +
+                           " " + y1 + ", " + x0 + " " + y0 + "))'"};
+    for (const std::string table : {"geo_join_polys", "geo_join_polys_frag"}) {
+      run_multiple_agg("INSERT INTO " + table + " VALUES(" + std::to_string(k) + ", " + poly + ");",
+                       ExecutorDeviceType::CPU);
+    }
+  }
+  std::vector<std::pair<double, double>> sites;
+  for (int j = 0; j < 5; ++j) {
+    for (int i = 0; i < 5; ++i) {
+      sites.emplace_back(10. * i + 4, 10. * j + 4);
+      run_multiple_agg("INSERT INTO geo_join_sites VALUES(" + std::to_string(5 * j + i) + ", 'POINT(" +
+                           std::to_string(sites.back().first) + " " + std::to_string(sites.back().second) + ")');",
+                       ExecutorDeviceType::CPU);
+    }
+  }
+  std::vector<std::pair<double, double>> points;
+  for (int k = 0; k < 100; ++k) {
+    points.emplace_back((k * 7) % 60 - 5 + 0.5, (k * 13) % 60 - 5 + 0.5);
+    run_multiple_agg("INSERT INTO geo_join_pts VALUES(" + std::to_string(k) + ", 'POINT(" +
+                         std::to_string(points.back().first) + " " + std::to_string(points.back().second) + ")');",
+                     ExecutorDeviceType::CPU);
+  }
+  int64_t expected_contains{0};
+  int64_t expected_contains_id_sum{0};
+  for (const auto& pt : points) {
+    for (size_t k = 0; k < squares.size(); ++k) {
+      const auto& sq = squares[k];
+      if (pt.first > sq[0] && pt.first < sq[2] && pt.second > sq[1] && pt.second < sq[3]) {
+        ++expected_contains;
+        expected_contains_id_sum += k;
+      }
+    }
+  }
+  int64_t expected_within{0};
+  for (const auto& pt : points) {
+    for (const auto& site : sites) {
+      if (std::hypot(pt.first - site.first, pt.second - site.second) < 3.0) {
+        ++expected_within;
+      }
+    }
+  }
+  ASSERT_GT(expected_contains, 0);
+  ASSERT_GT(expected_within, 0);
+  const std::string contains_query{
+      "SELECT COUNT(*), SUM(geo_join_polys.id) FROM geo_join_pts, geo_join_polys "
+      "WHERE ST_Contains(geo_join_polys.poly, geo_join_pts.p);"};
+  const std::string within_query{
+      "SELECT COUNT(*) FROM geo_join_pts, geo_join_sites WHERE ST_Distance(geo_join_pts.p, geo_join_sites.s) < 3.0;"};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const auto contains_rows = run_multiple_agg(contains_query, dt, false);
+    const auto contains_row = contains_rows->getNextRow(true, true);
+    ASSERT_EQ(expected_contains, v<int64_t>(contains_row[0]));
+    ASSERT_EQ(expected_contains_id_sum, v<int64_t>(contains_row[1]));
+    ASSERT_EQ(expected_within, v<int64_t>(run_multiple_agg(within_query, dt, false)->getRowAt(0, 0, true)));
+    // Filter on top of the join and the mirrored distance comparison.
+    int64_t expected_filtered{0};
+    for (const auto& pt : points) {
+      for (const auto& site : sites) {
+        if (site.first < 25 && std::hypot(pt.first - site.first, pt.second - site.second) <= 3.0) {
+          ++expected_filtered;
+        }
+      }
+    }
+    const std::string filtered_query{
+        "SELECT COUNT(*) FROM geo_join_pts, geo_join_sites WHERE 3.0 >= ST_Distance(geo_join_sites.s, geo_join_pts.p) "
+        "AND geo_join_sites.id % 5 < 3;"};
+    ASSERT_EQ(expected_filtered, v<int64_t>(run_multiple_agg(filtered_query, dt, false)->getRowAt(0, 0, true)));
+    // Constant point filters prune the fragments of geo_join_polys_frag by their bounds, results must not change.
+    for (const auto& pt : std::vector<std::pair<double, double>>{{12.5, 12.5}, {44.5, 3.5}, {9, 9}, {100, 100}}) {
+      int64_t expected{0};
+      for (const auto& sq : squares) {
+        if (pt.first > sq[0] && pt.first < sq[2] && pt.second > sq[1] && pt.second < sq[3]) {
+          ++expected;
+        }
+      }
+      ASSERT_EQ(expected,
+                v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM geo_join_polys_frag WHERE ST_Contains(poly, 'POINT(" +
+                                              std::to_string(pt.first) + " " + std::to_string(pt.second) + ")');",
+                                          dt)));
+    }
+    g_enable_spatial_join_index = false;
+    EXPECT_THROW(run_multiple_agg(contains_query, dt, false), std::runtime_error);
+    g_enable_spatial_join_index = true;
+  }
+  run_ddl_statement("DROP TABLE geo_join_pts;");
+  run_ddl_statement("DROP TABLE geo_join_polys;");
+  run_ddl_statement("DROP TABLE geo_join_polys_frag;");
+  run_ddl_statement("DROP TABLE geo_join_sites;");
+}
+
 TEST(Rounding, ROUND) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -15,16 +15,20 @@
  */
 
 #include "../Import/Importer.h"
+#include "../Import/CsvTokenizer.h"
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
 #include <boost/algorithm/string.hpp>
 #include "boost/filesystem.hpp"
+
+#include <fstream>
 #include "../Catalog/Catalog.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ResultSet.h"
 #include "../QueryRunner/QueryRunner.h"
+#include "../Shared/measure.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -237,6 +241,59 @@ TEST(Detect, Numeric) {
   d(kTEXT, "1.22.22");
 }
 
+std::vector<std::string> tokenize_row(const std::string& line, const Importer_NS::CopyParams& copy_params) {
+  Importer_NS::CsvTokenizer tokenizer(copy_params, nullptr);
+  std::vector<boost::string_ref> fields;
+  bool try_single_thread{false};
+  tokenizer.get_row(line.data(), line.data() + line.size(), line.data() + line.size(), fields, try_single_thread);
+  EXPECT_FALSE(try_single_thread);
+  std::vector<std::string> result;
+  for (const auto& field : fields) {
+    result.push_back(field.to_string());
+  }
+  return result;
+}
+
+TEST(CsvTokenizer, Fields) {
+  Importer_NS::CopyParams copy_params;
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "", "c"}), tokenize_row("a, b ,,c\n", copy_params));
+  EXPECT_EQ(std::vector<std::string>({"a,b", "c"}), tokenize_row("\"a,b\",c\n", copy_params));
+  EXPECT_EQ(std::vector<std::string>({"say \"hi\"", "x"}), tokenize_row("\"say \"\"hi\"\"\",x\r\n", copy_params));
+  EXPECT_EQ(std::vector<std::string>({"0123456789abcdefghij", "1"}),
+            tokenize_row("0123456789abcdefghij,1\n", copy_params));
+  copy_params.delimiter = '|';
+  EXPECT_EQ(std::vector<std::string>({"a,b", "c"}), tokenize_row("a,b|c", copy_params));
+}
+
+TEST(CsvTokenizer, Throughput) {
+  const Importer_NS::CopyParams copy_params;
+  for (const auto& filename : {"trip_data_1.csv", "trip_data_b.txt"}) {
+    std::ifstream file(std::string("../../Tests/Import/datafiles/") + filename);
+    ASSERT_TRUE(file.good());
+    const std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    // repeat the small sample files to get a measurable amount of work
+    std::string data;
+    while (data.size() < (64 << 20)) {
+      data += contents;
+    }
+    Importer_NS::CsvTokenizer tokenizer(copy_params, nullptr);
+    std::vector<boost::string_ref> row;
+    size_t field_count{0};
+    const auto us = measure<std::chrono::microseconds>::execution([&]() {
+      const char* buf_end = data.data() + data.size();
+      bool try_single_thread{false};
+      for (const char* p = data.data(); p < buf_end; p++) {
+        row.clear();
+        p = tokenizer.get_row(p, buf_end, buf_end, row, try_single_thread);
+        field_count += row.size();
+      }
+    });
+    EXPECT_GT(field_count, size_t(0));
+    LOG(INFO) << filename << ": tokenized " << data.size() << " bytes (" << field_count << " fields) at "
+              << static_cast<double>(data.size()) / std::max(us, int64_t(1)) / 1000 << " GB/s";
+  }
+}
+
 // don't use R"()" format; somehow it causes many blank lines
 // to be output on console. how come?
 const char* create_table_trips =
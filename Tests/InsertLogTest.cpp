@@ -0,0 +1,177 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../Fragmenter/InsertLog.h"
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using Fragmenter_Namespace::InsertLog;
+
+namespace {
+
+class InsertLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    path_ = (dir_ / "insert_logs" / "table_1_1.log").string();
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(dir_); }
+
+  std::vector<std::pair<int, std::string>> replay() {
+    std::vector<std::pair<int, std::string>> records;
+    InsertLog log(path_);
+    log.replay([&records](const int epoch, const std::string& payload) { records.emplace_back(epoch, payload); });
+    return records;
+  }
+
+  boost::filesystem::path dir_;
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(InsertLogTest, AppendReplay) {
+  {
+    InsertLog log(path_);
+    log.append(1, "first");
+    log.append(1, std::string(100000, 'x'));
+    log.sync(log.append(2, ""));
+  }
+  const auto records = replay();
+  ASSERT_EQ(size_t(3), records.size());
+  ASSERT_EQ(std::make_pair(1, std::string("first")), records[0]);
+  ASSERT_EQ(std::make_pair(1, std::string(100000, 'x')), records[1]);
+  ASSERT_EQ(std::make_pair(2, std::string()), records[2]);
+}
+
+TEST_F(InsertLogTest, TornTail) {
+  {
+    InsertLog log(path_);
+    log.sync(log.append(1, "kept"));
+  }
+  const auto intact_size = boost::filesystem::file_size(path_);
+  {
+    std::ofstream log_file(path_, std::ios::binary | std::ios::app);
+    log_file << "INS";
+  }
+  ASSERT_EQ(size_t(1), replay().size());
+  ASSERT_EQ(intact_size, boost::filesystem::file_size(path_));
+  {
+    InsertLog log(path_);
+    log.sync(log.append(2, "after the crash"));
+  }
+  const auto records = replay();
+  ASSERT_EQ(size_t(2), records.size());
+  ASSERT_EQ("after the crash", records[1].second);
+}
+
+TEST_F(InsertLogTest, Checksum) {
+  {
+    InsertLog log(path_);
+    log.append(1, "good");
+    log.sync(log.append(1, "bad"));
+  }
+  {
+    std::fstream log_file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    log_file.seekp(-1, std::ios::end);
+    log_file << 'B';
+  }
+  const auto records = replay();
+  ASSERT_EQ(size_t(1), records.size());
+  ASSERT_EQ("good", records[0].second);
+}
+
+TEST_F(InsertLogTest, Reset) {
+  InsertLog log(path_);
+  const auto lsn = log.append(1, "checkpointed");
+  log.reset();
+  ASSERT_EQ(size_t(0), log.sizeBytes());
+  // everything appended before the reset counts as durable
+  log.sync(lsn);
+  ASSERT_EQ(size_t(0), log.syncCount());
+  log.sync(log.append(2, "new"));
+  const auto records = replay();
+  ASSERT_EQ(size_t(1), records.size());
+  ASSERT_EQ(2, records[0].first);
+}
+
+TEST_F(InsertLogTest, Rollback) {
+  InsertLog log(path_);
+  log.append(1, "kept");
+  const auto size_bytes = log.sizeBytes();
+  log.append(1, "failed");
+  log.rollback(size_bytes);
+  ASSERT_EQ(size_bytes, log.sizeBytes());
+  log.sync(log.append(1, "next"));
+  const auto records = replay();
+  ASSERT_EQ(size_t(2), records.size());
+  ASSERT_EQ("kept", records[0].second);
+  ASSERT_EQ("next", records[1].second);
+}
+
+TEST_F(InsertLogTest, GroupCommit) {
+  InsertLog log(path_);
+  const size_t thread_count{8};
+  const size_t rounds{50};
+  // Every round, all the writers append before any of them syncs: the first sync of the
+  // round covers the batches of all of them, the others find their batch durable already.
+  std::mutex barrier_mutex;
+  std::condition_variable barrier_cv;
+  size_t arrived{0};
+  size_t generation{0};
+  const auto barrier = [&] {
+    std::unique_lock<std::mutex> lock(barrier_mutex);
+    const auto crt_generation = generation;
+    if (++arrived == thread_count) {
+      arrived = 0;
+      ++generation;
+      barrier_cv.notify_all();
+      return;
+    }
+    barrier_cv.wait(lock, [&] { return generation != crt_generation; });
+  };
+  std::vector<std::future<void>> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.push_back(std::async(std::launch::async, [&log, &barrier, i] {
+      for (size_t j = 0; j < rounds; ++j) {
+        const auto lsn = log.append(1, std::to_string(i * rounds + j));
+        barrier();
+        log.sync(lsn);
+        barrier();
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.get();
+  }
+  ASSERT_EQ(rounds, log.syncCount());
+  ASSERT_LT(log.syncCount(), thread_count * rounds);
+  ASSERT_EQ(thread_count * rounds, replay().size());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -57,6 +57,9 @@ class CoreMockClient {
   MockMethod(get_license_claims)
   MockMethod(get_completion_hints)
   MockMethod(get_dashboards)
+  MockMethod(open_cursor)
+  MockMethod(fetch_cursor)
+  MockMethod(close_cursor)
 };
 // clang-format on
 
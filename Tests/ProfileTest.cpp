@@ -1322,8 +1322,28 @@ TEST(Reduction, Baseline) {
   std::vector<int64_t> gpu_reduced_result(input_size / sizeof(int64_t), 0);
   memcpy(&gpu_reduced_result[0], results[0]->getStorage()->getUnderlyingBuffer(), input_size);
 #endif
+  {
+    // the baseline inputs are moved into a new buffer, they can be reduced again below
+    ResultSetManager unpartitioned_rs_manager;
+    const auto enable_partitioned_reduction = g_enable_partitioned_reduction;
+    g_enable_partitioned_reduction = false;
+    ResultSet* unpartitioned_result = nullptr;
+    std::cout << "CPU reduction without radix partitioning: ";
+    const auto unpartitionedTime =
+        measure<>::execution([&]() { unpartitioned_result = unpartitioned_rs_manager.reduce(storage_set); });
+    g_enable_partitioned_reduction = enable_partitioned_reduction;
+    CHECK(unpartitioned_result != nullptr);
+    std::cout << "Current reduction took " << unpartitionedTime << " ms and got reduced "
+              << unpartitioned_result->rowCount() << " rows\n";
+    ASSERT_TRUE(emulator.compare(unpartitioned_result->getStorage()->getUnderlyingBuffer(),
+                                 key_count,
+                                 val_count,
+                                 unpartitioned_result->getQueryMemDesc().entry_count,
+                                 is_columnar,
+                                 ref_reduced_result));
+  }
   ResultSet* reduced_result = nullptr;
-  std::cout << "CPU reduction: ";
+  std::cout << "CPU reduction with radix partitioning: ";
   auto elapsedTime = measure<>::execution([&]() {
     // Do calculation on host
     reduced_result = rs_manager.reduce(storage_set);
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    QueryBenchmark.cpp
+ * @brief   Runs a fixed query set over the BenchDataGenerator star schema on CPU and writes
+ * cold / warm latency percentiles, rows/s and peak memory of every query as JSON. Pass the
+ * JSON of an earlier run as --baseline to get a regression report against it.
+ **/
+
+#include "BenchDataGenerator.h"
+
+#include "../Catalog/Catalog.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/measure.h"
+#include "MapDRelease.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <glog/logging.h>
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#ifdef __APPLE__
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+struct BenchQuery {
+  std::string name;
+  std::string sql;
+  std::string input_table;  // whose rows count towards rows/s
+};
+
+// Scans, filters, group bys, joins, top-N and count distinct over the star schema. Keep the
+// names stable, reports are matched by name across runs.
+const std::vector<BenchQuery> bench_queries{
+    {"scan_count", "SELECT COUNT(*) FROM bench_sales;", "bench_sales"},
+    {"scan_sum", "SELECT SUM(lo_revenue), AVG(lo_quantity), MAX(lo_price) FROM bench_sales;", "bench_sales"},
+    {"filter_range",
+     "SELECT COUNT(*) FROM bench_sales WHERE lo_quantity BETWEEN 10 AND 20 AND lo_discount < 3;",
+     "bench_sales"},
+    {"filter_dict_string", "SELECT COUNT(*) FROM bench_sales WHERE lo_channel = 'channel_3';", "bench_sales"},
+    {"filter_timestamp",
+     "SELECT COUNT(*) FROM bench_sales WHERE lo_ts >= '1995-01-01 00:00:00' AND lo_ts < '1996-01-01 00:00:00';",
+     "bench_sales"},
+    {"filter_geo_distance",
+     "SELECT COUNT(*) FROM bench_sales WHERE ST_Distance(lo_location, 'POINT(-100 37)') < 2.0;",
+     "bench_sales"},
+    {"groupby_low_cardinality",
+     "SELECT lo_channel, SUM(lo_revenue), COUNT(*) FROM bench_sales GROUP BY lo_channel;",
+     "bench_sales"},
+    {"groupby_high_cardinality",
+     "SELECT lo_custkey, SUM(lo_quantity) FROM bench_sales GROUP BY lo_custkey;",
+     "bench_sales"},
+    {"groupby_multi_key",
+     "SELECT EXTRACT(YEAR FROM lo_ts) AS y, lo_channel, COUNT(*) FROM bench_sales GROUP BY y, lo_channel;",
+     "bench_sales"},
+    {"join_date_filter",
+     "SELECT d_month, SUM(lo_revenue) FROM bench_sales, bench_date WHERE lo_datekey = d_datekey AND d_year = 1995 "
+     "GROUP BY d_month;",
+     "bench_sales"},
+    {"join_star",
+     "SELECT c_region, p_category, SUM(lo_revenue) FROM bench_sales, bench_customer, bench_product WHERE lo_custkey "
+     "= c_custkey AND lo_partkey = p_partkey GROUP BY c_region, p_category;",
+     "bench_sales"},
+    {"topn_projection",
+     "SELECT lo_orderkey, lo_revenue FROM bench_sales WHERE lo_discount = 0 ORDER BY lo_revenue DESC LIMIT 100;",
+     "bench_sales"},
+    {"topn_groupby",
+     "SELECT lo_comment, COUNT(*) AS n FROM bench_sales GROUP BY lo_comment ORDER BY n DESC LIMIT 10;",
+     "bench_sales"},
+    {"count_distinct", "SELECT COUNT(DISTINCT lo_custkey) FROM bench_sales;", "bench_sales"},
+    {"count_distinct_groupby",
+     "SELECT lo_channel, COUNT(DISTINCT lo_partkey) FROM bench_sales GROUP BY lo_channel;",
+     "bench_sales"},
+    {"approx_count_distinct", "SELECT APPROX_COUNT_DISTINCT(lo_comment) FROM bench_sales;", "bench_sales"},
+};
+
+struct QueryResult {
+  std::string name;
+  size_t result_rows;
+  double cold_ms;
+  std::vector<double> warm_ms;  // sorted
+  double rows_per_sec;
+  int64_t peak_rss_kb;
+
+  double percentile(const double p) const {
+    CHECK(!warm_ms.empty());
+    const auto rank = static_cast<size_t>(std::ceil(p * warm_ms.size()));
+    return warm_ms[std::min(std::max(rank, size_t(1)), warm_ms.size()) - 1];
+  }
+};
+
+#ifndef __APPLE__
+int64_t read_proc_status_kb(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stoll(line.substr(field.size() + 1));
+    }
+  }
+  return -1;
+}
+#endif
+
+// Restarts the peak resident set size at the current one, so that the peak read afterwards
+// belongs to the queries run in between. ru_maxrss can't be reset, the peak of an earlier
+// query would hide the ones of all the queries after it. Not possible on macOS, the peak
+// reported there is the one of the process so far.
+void reset_peak_rss() {
+#ifndef __APPLE__
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.close();
+  if (!clear_refs) {
+    LOG(WARNING) << "Could not reset the peak RSS, it's the one of the whole process so far";
+  }
+#endif
+}
+
+int64_t peak_rss_kb() {
+#ifdef __APPLE__
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024;
+#else
+  return read_proc_status_kb("VmHWM");
+#endif
+}
+
+double run_timed(const std::string& sql,
+                 const std::unique_ptr<Catalog_Namespace::SessionInfo>& session,
+                 size_t& result_rows) {
+  std::shared_ptr<ResultSet> rows;
+  const auto us = measure<std::chrono::microseconds>::execution(
+      [&] { rows = QueryRunner::run_multiple_agg(sql, session, ExecutorDeviceType::CPU, true, false); });
+  result_rows = rows ? rows->rowCount() : 0;
+  return us / 1000.;
+}
+
+void load_data(const std::unique_ptr<Catalog_Namespace::SessionInfo>& session,
+               const std::vector<BenchData::TableSpec>& tables,
+               const double scale_factor,
+               const uint64_t seed,
+               const std::string& data_dir) {
+  boost::filesystem::create_directories(data_dir);
+  for (const auto& table : tables) {
+    const auto gen_ms =
+        measure<>::execution([&] { BenchData::write_table_csv(table, scale_factor, seed, data_dir); });
+    QueryRunner::run_ddl_statement("DROP TABLE IF EXISTS " + table.name + ";", session);
+    QueryRunner::run_ddl_statement(table.create_table, session);
+    const auto load_ms = measure<>::execution([&] {
+      QueryRunner::run_ddl_statement(
+          "COPY " + table.name + " FROM '" + BenchData::table_csv_glob(table, data_dir) + "' WITH (header='false');",
+          session);
+    });
+    LOG(INFO) << "Generated " << table.row_count << " rows of " << table.name << " in " << gen_ms << " ms, loaded in "
+              << load_ms << " ms";
+  }
+}
+
+QueryResult run_benchmark_query(const BenchQuery& query,
+                                const std::unique_ptr<Catalog_Namespace::SessionInfo>& session,
+                                const size_t input_rows,
+                                const size_t iterations) {
+  QueryResult result;
+  result.name = query.name;
+  // cold: no buffered chunks and no cached code
+  Executor::nukeCacheOfExecutors();
+  session->get_catalog().get_dataMgr().clearMemory(Data_Namespace::CPU_LEVEL);
+  reset_peak_rss();
+  result.cold_ms = run_timed(query.sql, session, result.result_rows);
+  for (size_t i = 0; i < iterations; ++i) {
+    size_t result_rows{0};
+    result.warm_ms.push_back(run_timed(query.sql, session, result_rows));
+  }
+  std::sort(result.warm_ms.begin(), result.warm_ms.end());
+  const auto p50_ms = result.percentile(0.5);
+  result.rows_per_sec = p50_ms > 0 ? input_rows / (p50_ms / 1000.) : 0;
+  result.peak_rss_kb = peak_rss_kb();
+  return result;
+}
+
+void write_report(const std::string& path,
+                  const std::vector<QueryResult>& results,
+                  const double scale_factor,
+                  const uint64_t seed,
+                  const size_t iterations) {
+  rapidjson::Document report(rapidjson::kObjectType);
+  auto& allocator = report.GetAllocator();
+  report.AddMember("release", rapidjson::Value(MAPD_RELEASE.c_str(), allocator), allocator);
+  report.AddMember("timestamp", static_cast<int64_t>(std::time(nullptr)), allocator);
+  report.AddMember("device", rapidjson::StringRef("CPU"), allocator);
+  report.AddMember("scale_factor", scale_factor, allocator);
+  report.AddMember("seed", seed, allocator);
+  report.AddMember("iterations", static_cast<uint64_t>(iterations), allocator);
+  rapidjson::Value queries(rapidjson::kArrayType);
+  for (const auto& result : results) {
+    rapidjson::Value query(rapidjson::kObjectType);
+    query.AddMember("name", rapidjson::Value(result.name.c_str(), allocator), allocator);
+    query.AddMember("result_rows", static_cast<uint64_t>(result.result_rows), allocator);
+    query.AddMember("cold_ms", result.cold_ms, allocator);
+    rapidjson::Value warm(rapidjson::kObjectType);
+    warm.AddMember("min_ms", result.warm_ms.front(), allocator);
+    warm.AddMember("p50_ms", result.percentile(0.5), allocator);
+    warm.AddMember("p90_ms", result.percentile(0.9), allocator);
+    warm.AddMember("p99_ms", result.percentile(0.99), allocator);
+    warm.AddMember("max_ms", result.warm_ms.back(), allocator);
+    query.AddMember("warm", warm, allocator);
+    query.AddMember("rows_per_sec", result.rows_per_sec, allocator);
+    query.AddMember("peak_rss_kb", result.peak_rss_kb, allocator);
+    queries.PushBack(query, allocator);
+  }
+  report.AddMember("queries", queries, allocator);
+  std::ofstream out(path);
+  rapidjson::OStreamWrapper out_wrapper(out);
+  rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(out_wrapper);
+  report.Accept(writer);
+  out << std::endl;
+}
+
+// Compares the warm p50 of every query with the baseline run, returns the number of queries
+// which got slower by more than the threshold.
+size_t report_regressions(const std::string& baseline_path,
+                          const std::vector<QueryResult>& results,
+                          const double scale_factor,
+                          const double threshold) {
+  std::ifstream in(baseline_path);
+  if (!in) {
+    LOG(ERROR) << "Could not open baseline " << baseline_path;
+    return 0;
+  }
+  rapidjson::IStreamWrapper in_wrapper(in);
+  rapidjson::Document baseline;
+  baseline.ParseStream(in_wrapper);
+  if (baseline.HasParseError() || !baseline.IsObject() || !baseline.HasMember("queries")) {
+    LOG(ERROR) << "Could not parse baseline " << baseline_path;
+    return 0;
+  }
+  if (baseline["scale_factor"].GetDouble() != scale_factor) {
+    LOG(WARNING) << "Baseline ran at scale factor " << baseline["scale_factor"].GetDouble() << ", this run at "
+                 << scale_factor;
+  }
+  std::map<std::string, double> baseline_p50_ms;
+  for (const auto& query : baseline["queries"].GetArray()) {
+    baseline_p50_ms[query["name"].GetString()] = query["warm"]["p50_ms"].GetDouble();
+  }
+  size_t regressions = 0;
+  std::cout << std::left << std::setw(28) << "query" << std::right << std::setw(14) << "baseline ms" << std::setw(14)
+            << "current ms" << std::setw(10) << "change" << std::endl;
+  for (const auto& result : results) {
+    const auto it = baseline_p50_ms.find(result.name);
+    if (it == baseline_p50_ms.end()) {
+      continue;
+    }
+    const auto p50_ms = result.percentile(0.5);
+    const auto change = it->second > 0 ? p50_ms / it->second - 1 : 0;
+    const bool regressed = change > threshold;
+    regressions += regressed;
+    std::cout << std::left << std::setw(28) << result.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << it->second << std::setw(14) << p50_ms << std::setw(9) << std::showpos
+              << change * 100 << std::noshowpos << "%" << (regressed ? "  REGRESSION" : "") << std::endl;
+  }
+  return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  namespace po = boost::program_options;
+
+  std::string db_path{BASE_PATH};
+  std::string data_dir;
+  std::string output{"bench_results.json"};
+  std::string baseline;
+  std::string query_filter{".*"};
+  double scale_factor{1};
+  uint64_t seed{1};
+  size_t iterations{10};
+  double regression_threshold{0.1};
+
+  po::options_description desc("Options");
+  desc.add_options()("help,h", "Print help messages");
+  desc.add_options()(
+      "path", po::value<std::string>(&db_path)->default_value(db_path), "Directory path to Mapd catalogs");
+  desc.add_options()(
+      "scale", po::value<double>(&scale_factor)->default_value(scale_factor), "Scale factor, 1M fact rows each");
+  desc.add_options()("seed", po::value<uint64_t>(&seed)->default_value(seed), "Data generator seed");
+  desc.add_options()("data-dir",
+                     po::value<std::string>(&data_dir),
+                     "Directory for the generated CSV files (default <path>/bench_data)");
+  desc.add_options()("iterations", po::value<size_t>(&iterations)->default_value(iterations), "Warm runs per query");
+  desc.add_options()(
+      "query", po::value<std::string>(&query_filter), "Only run the queries whose name matches this regex");
+  desc.add_options()("output", po::value<std::string>(&output)->default_value(output), "JSON report to write");
+  desc.add_options()("baseline", po::value<std::string>(&baseline), "JSON report of an earlier run to compare with");
+  desc.add_options()("regression-threshold",
+                     po::value<double>(&regression_threshold)->default_value(regression_threshold),
+                     "Relative slowdown of the warm p50 reported as a regression");
+  desc.add_options()("use-existing-data", "Don't generate and load the data, it's there from an earlier run");
+  desc.add_options()("keep-data", "Don't drop the tables at the end");
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+    po::notify(vm);
+  } catch (const po::error& e) {
+    std::cerr << "Usage Error: " << e.what() << std::endl;
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+  if (data_dir.empty()) {
+    data_dir = db_path + "/bench_data";
+  }
+  iterations = std::max(iterations, size_t(1));
+
+  g_enable_watchdog = false;
+  std::unique_ptr<Catalog_Namespace::SessionInfo> session(QueryRunner::get_session(db_path.c_str()));
+  const auto tables = BenchData::star_schema_tables(scale_factor);
+  if (!vm.count("use-existing-data")) {
+    load_data(session, tables, scale_factor, seed, data_dir);
+  }
+
+  std::map<std::string, size_t> table_rows;
+  for (const auto& table : tables) {
+    table_rows[table.name] = table.row_count;
+  }
+  const std::regex query_regex(query_filter);
+  std::vector<QueryResult> results;
+  for (const auto& query : bench_queries) {
+    if (!std::regex_match(query.name, query_regex)) {
+      continue;
+    }
+    results.push_back(run_benchmark_query(query, session, table_rows[query.input_table], iterations));
+    const auto& result = results.back();
+    LOG(INFO) << query.name << ": cold " << result.cold_ms << " ms, warm p50 " << result.percentile(0.5) << " ms, "
+              << static_cast<int64_t>(result.rows_per_sec) << " rows/s";
+  }
+  write_report(output, results, scale_factor, seed, iterations);
+  std::cout << "Wrote " << results.size() << " query results to " << output << std::endl;
+
+  size_t regressions = 0;
+  if (!baseline.empty()) {
+    regressions = report_regressions(baseline, results, scale_factor, regression_threshold);
+  }
+
+  if (!vm.count("keep-data") && !vm.count("use-existing-data")) {
+    for (const auto& table : tables) {
+      QueryRunner::run_ddl_statement("DROP TABLE IF EXISTS " + table.name + ";", session);
+    }
+    boost::filesystem::remove_all(data_dir);
+  }
+  return regressions ? 1 : 0;
+}
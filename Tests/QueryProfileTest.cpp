@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/QueryProfile.h"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <future>
+#include <thread>
+#include <vector>
+
+TEST(QueryProfile, ConcurrentKernels) {
+  QueryProfile profile;
+  auto step = profile.startStep(3, "Aggregate");
+  const size_t thread_count{8};
+  const size_t kernels_per_thread{1000};
+  std::vector<std::future<void>> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.push_back(std::async(std::launch::async, [step, i] {
+      for (size_t j = 0; j < kernels_per_thread; ++j) {
+        step->addKernel(std::unique_ptr<KernelProfile>(
+            new KernelProfile{false, 0, {i * kernels_per_thread + j}, i, 100, 1, 2, nullptr}));
+        step->addChunkFetch(Data_Namespace::CPU_LEVEL, 1, 100, 1);
+        step->addSkippedFragments(1);
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.get();
+  }
+  size_t kernel_count{0};
+  for (auto kernel = step->getKernels(); kernel; kernel = kernel->next) {
+    ++kernel_count;
+  }
+  ASSERT_EQ(thread_count * kernels_per_thread, kernel_count);
+  ASSERT_EQ(thread_count * kernels_per_thread, step->getFetchChunks(Data_Namespace::CPU_LEVEL));
+  ASSERT_EQ(thread_count * kernels_per_thread * 100, step->getFetchBytes(Data_Namespace::CPU_LEVEL));
+  ASSERT_EQ(size_t(0), step->getFetchBytes(Data_Namespace::GPU_LEVEL));
+  ASSERT_EQ(thread_count * kernels_per_thread, step->getSkippedFragments());
+}
+
+TEST(QueryProfile, ConcurrentSteps) {
+  QueryProfile profile;
+  auto main_step = profile.startStep(1, "Project");
+  const size_t thread_count{8};
+  std::vector<std::future<bool>> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.push_back(std::async(std::launch::async, [&profile, i] {
+      auto step = profile.startStep(i + 2, "Aggregate");
+      step->addCompilation(1);
+      return profile.currentStep() == step;
+    }));
+  }
+  for (auto& thread : threads) {
+    ASSERT_TRUE(thread.get());
+  }
+  ASSERT_EQ(main_step, profile.currentStep());
+  ASSERT_EQ(thread_count + 1, profile.getSteps().size());
+  int64_t compile_us{0};
+  for (const auto& step : profile.getSteps()) {
+    compile_us += step->getCompileUs();
+  }
+  ASSERT_EQ(static_cast<int64_t>(thread_count), compile_us);
+}
+
+TEST(QueryProfile, Json) {
+  QueryProfile profile;
+  auto step = profile.startStep(1, "Compound");
+  step->addCompilation(50);
+  step->addCodeCacheLookup(true);
+  step->addCodeCacheLookup(false);
+  step->addKernel(std::unique_ptr<KernelProfile>(new KernelProfile{false, 0, {0}, 42, 64, 3, 10, nullptr}));
+  step->addKernel(std::unique_ptr<KernelProfile>(new KernelProfile{false, 0, {1}, 42, 64, 3, 20, nullptr}));
+  step->addKernel(std::unique_ptr<KernelProfile>(new KernelProfile{false, 0, {2}, 7, 64, 3, 5, nullptr}));
+  step->addChunkFetch(Data_Namespace::DISK_LEVEL, 2, 128, 9);
+  step->addChunkFetch(Data_Namespace::CPU_LEVEL, 1, 64, 1);
+  step->addReduction(8);
+  // work units without a step of their own land in the last one started on this thread
+  ASSERT_EQ(step, profile.currentStep());
+  profile.addResultConversion(4);
+
+  rapidjson::Document document;
+  document.Parse(profile.toJson().c_str());
+  ASSERT_FALSE(document.HasParseError());
+  ASSERT_EQ(4, document["result_conversion_us"].GetInt64());
+  const auto& steps = document["steps"];
+  ASSERT_EQ(rapidjson::SizeType(1), steps.Size());
+  ASSERT_EQ(1u, steps[0]["node_id"].GetUint());
+  ASSERT_EQ(50, steps[0]["compile_us"].GetInt64());
+  ASSERT_EQ(1u, steps[0]["code_cache_hits"].GetUint64());
+  ASSERT_EQ(1u, steps[0]["code_cache_misses"].GetUint64());
+  ASSERT_EQ(8, steps[0]["reduction_us"].GetInt64());
+  ASSERT_FALSE(document["result_cache_hit"].GetBool());
+  const auto& chunk_fetch = steps[0]["chunk_fetch"];
+  ASSERT_EQ(2u, chunk_fetch["disk"]["chunks"].GetUint64());
+  ASSERT_EQ(128u, chunk_fetch["disk"]["bytes"].GetUint64());
+  ASSERT_EQ(1u, chunk_fetch["cpu"]["chunks"].GetUint64());
+  ASSERT_EQ(0u, chunk_fetch["gpu"]["chunks"].GetUint64());
+  const auto& kernels = steps[0]["kernels"];
+  ASSERT_EQ(rapidjson::SizeType(3), kernels.Size());
+  ASSERT_EQ(0u, kernels[0]["fragments"][0].GetUint64());
+  ASSERT_EQ(0u, kernels[0]["thread"].GetUint64());
+  ASSERT_EQ(1u, kernels[2]["thread"].GetUint64());
+  const auto& threads = steps[0]["threads"];
+  ASSERT_EQ(rapidjson::SizeType(2), threads.Size());
+  ASSERT_EQ(2u, threads[0]["kernels"].GetUint64());
+  ASSERT_EQ(30, threads[0]["kernel_us"].GetInt64());
+  ASSERT_EQ(5, threads[1]["kernel_us"].GetInt64());
+  ASSERT_NE(std::string::npos, profile.toString().find("Step 1 (Compound)"));
+  ASSERT_NE(std::string::npos, profile.toString().find("chunks from disk: 2, 128 bytes"));
+}
+
+TEST(QueryProfile, ResultCacheHit) {
+  QueryProfile profile;
+  profile.setResultCacheHit();
+  rapidjson::Document document;
+  document.Parse(profile.toJson().c_str());
+  ASSERT_FALSE(document.HasParseError());
+  ASSERT_TRUE(document["result_cache_hit"].GetBool());
+  ASSERT_EQ(rapidjson::SizeType(0), document["steps"].Size());
+  ASSERT_EQ(size_t(0), profile.toString().find("Result set cache hit"));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../ThriftHandler/RequestScheduler.h"
+
+#include <gtest/gtest.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <vector>
+
+using apache::thrift::protocol::TBinaryProtocol;
+using apache::thrift::transport::TMemoryBuffer;
+
+namespace {
+
+void wait_for_queued(const RequestScheduler& scheduler, const size_t queued) {
+  while (scheduler.getStats().queued_requests < queued) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void wait_for_running(const RequestScheduler& scheduler, const size_t running) {
+  while (scheduler.getStats().running_requests < running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// Queries block until they're interrupted, or for 30 seconds at most.
+class BlockingQueryHandler : public MapDNull {
+ public:
+  BlockingQueryHandler() : interrupted_(false) {}
+
+  void sql_execute(TQueryResult&,
+                   const TSessionId&,
+                   const std::string&,
+                   const bool,
+                   const std::string&,
+                   const int32_t,
+                   const int32_t) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    interrupted_cv_.wait_for(lock, std::chrono::seconds(30), [this] { return interrupted_; });
+  }
+
+  void interrupt(const TSessionId&) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      interrupted_ = true;
+    }
+    interrupted_cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable interrupted_cv_;
+  bool interrupted_;
+};
+
+// Runs one call through the processor the way a server connection does: send_call writes the
+// request with a client, recv_reply reads the answer back with another one.
+template <typename SEND, typename RECV>
+void process_call(apache::thrift::TProcessor& processor, SEND send_call, RECV recv_reply) {
+  auto request = mapd::make_shared<TMemoryBuffer>();
+  auto reply = mapd::make_shared<TMemoryBuffer>();
+  mapd::shared_ptr<apache::thrift::protocol::TProtocol> request_protocol(new TBinaryProtocol(request));
+  mapd::shared_ptr<apache::thrift::protocol::TProtocol> reply_protocol(new TBinaryProtocol(reply));
+  MapDClient sender(request_protocol);
+  send_call(sender);
+  processor.process(request_protocol, reply_protocol, nullptr);
+  MapDClient receiver(reply_protocol);
+  recv_reply(receiver);
+}
+
+}  // namespace
+
+TEST(RequestScheduler, Priority) {
+  ASSERT_EQ(RequestScheduler::Priority::LOW, RequestScheduler::getPriority("sql_execute"));
+  ASSERT_EQ(RequestScheduler::Priority::LOW, RequestScheduler::getPriority("load_table_binary"));
+  ASSERT_EQ(RequestScheduler::Priority::HIGH, RequestScheduler::getPriority("get_tables"));
+  ASSERT_EQ(RequestScheduler::Priority::HIGH, RequestScheduler::getPriority("interrupt"));
+  ASSERT_TRUE(RequestScheduler::isControlCall("interrupt"));
+  ASSERT_TRUE(RequestScheduler::isControlCall("disconnect"));
+  ASSERT_FALSE(RequestScheduler::isControlCall("get_tables"));
+  ASSERT_FALSE(RequestScheduler::isControlCall("sql_execute"));
+}
+
+TEST(RequestScheduler, RejectWhenQueueFull) {
+  RequestScheduler scheduler(1, 1);
+  auto running = scheduler.acquire(RequestScheduler::Priority::LOW);
+  auto queued = std::async(std::launch::async, [&scheduler] { scheduler.acquire(RequestScheduler::Priority::LOW); });
+  wait_for_queued(scheduler, 1);
+  ASSERT_THROW(scheduler.acquire(RequestScheduler::Priority::HIGH), RequestScheduler::QueueFull);
+  {
+    auto released = std::move(running);
+  }
+  queued.get();
+  const auto stats = scheduler.getStats();
+  ASSERT_EQ(size_t(0), stats.running_requests);
+  ASSERT_EQ(size_t(0), stats.queued_requests);
+  ASSERT_EQ(uint64_t(2), stats.admitted_requests);
+  ASSERT_EQ(uint64_t(1), stats.rejected_requests);
+}
+
+TEST(RequestScheduler, HighPriorityFirst) {
+  RequestScheduler scheduler(1, 8);
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto run = [&scheduler, &order_mutex, &order](const RequestScheduler::Priority priority, const int id) {
+    auto slot = scheduler.acquire(priority);
+    std::lock_guard<std::mutex> lock(order_mutex);
+    order.push_back(id);
+  };
+  std::vector<std::future<void>> requests;
+  {
+    auto running = scheduler.acquire(RequestScheduler::Priority::LOW);
+    requests.push_back(std::async(std::launch::async, run, RequestScheduler::Priority::LOW, 0));
+    wait_for_queued(scheduler, 1);
+    requests.push_back(std::async(std::launch::async, run, RequestScheduler::Priority::LOW, 1));
+    wait_for_queued(scheduler, 2);
+    requests.push_back(std::async(std::launch::async, run, RequestScheduler::Priority::HIGH, 2));
+    wait_for_queued(scheduler, 3);
+  }
+  for (auto& request : requests) {
+    request.get();
+  }
+  ASSERT_EQ((std::vector<int>{2, 0, 1}), order);
+}
+
+TEST(RequestScheduler, InterruptWhileSlotsBusy) {
+  auto scheduler = std::make_shared<RequestScheduler>(2, 4);
+  mapd::shared_ptr<BlockingQueryHandler> handler(new BlockingQueryHandler());
+  ScheduledMapDProcessor processor(handler, scheduler);
+  auto run_query = [&processor] {
+    process_call(processor,
+                 [](MapDClient& client) { client.send_sql_execute("session", "SELECT 1;", true, "", -1, -1); },
+                 [](MapDClient& client) {
+                   TQueryResult result;
+                   client.recv_sql_execute(result);
+                 });
+  };
+  std::vector<std::future<void>> queries;
+  for (size_t i = 0; i < 2; ++i) {
+    queries.push_back(std::async(std::launch::async, run_query));
+  }
+  wait_for_running(*scheduler, 2);
+  // both slots are held by queries which only finish once interrupted
+  auto interrupt = std::async(std::launch::async, [&processor] {
+    process_call(processor,
+                 [](MapDClient& client) { client.send_interrupt("session"); },
+                 [](MapDClient& client) { client.recv_interrupt(); });
+  });
+  ASSERT_EQ(std::future_status::ready, interrupt.wait_for(std::chrono::seconds(10)));
+  interrupt.get();
+  for (auto& query : queries) {
+    ASSERT_EQ(std::future_status::ready, query.wait_for(std::chrono::seconds(10)));
+    query.get();
+  }
+  const auto stats = scheduler->getStats();
+  ASSERT_EQ(size_t(0), stats.running_requests);
+  ASSERT_EQ(uint64_t(2), stats.admitted_requests);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1425,6 +1425,55 @@ std::vector<TargetInfo> generate_test_target_infos() {
   return target_infos;
 }
 
+void test_direct_column_read(const std::vector<TargetInfo>& target_infos,
+                             const QueryMemoryDescriptor& query_mem_desc) {
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  ResultSet result_set(target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = result_set.allocateStorage();
+  EvenNumberGenerator generator;
+  fill_storage_buffer(storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+  ASSERT_TRUE(result_set.canReadColumnsDirectly());
+  const auto entry_count = result_set.entryCount();
+  for (size_t i = 0; i < target_infos.size(); ++i) {
+    std::vector<int64_t> int_vals;
+    std::vector<double> fp_vals;
+    const bool is_fp = target_infos[i].sql_type.is_fp();
+    // split the range to also cover reads starting in the middle of the buffer
+    for (size_t start_entry = 0; start_entry < entry_count; start_entry += 7) {
+      const auto end_entry = std::min(start_entry + 7, entry_count);
+      if (is_fp) {
+        result_set.getColumnValues(i, start_entry, end_entry, fp_vals);
+      } else {
+        result_set.getColumnValues(i, start_entry, end_entry, int_vals);
+      }
+    }
+    size_t val_idx{0};
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      const auto row = result_set.getRowAtNoTranslations(entry_idx);
+      if (row.empty()) {
+        continue;
+      }
+      if (is_fp) {
+        ASSERT_LT(val_idx, fp_vals.size());
+        ASSERT_EQ(v<double>(row[i]), fp_vals[val_idx]);
+      } else {
+        ASSERT_LT(val_idx, int_vals.size());
+        ASSERT_EQ(v<int64_t>(row[i]), int_vals[val_idx]);
+      }
+      ++val_idx;
+    }
+    ASSERT_EQ(val_idx, is_fp ? fp_vals.size() : int_vals.size());
+  }
+}
+
+// generate_test_target_infos without the AVG target, which takes two slots
+std::vector<TargetInfo> generate_direct_read_target_infos() {
+  auto target_infos = generate_test_target_infos();
+  CHECK_EQ(kAVG, target_infos[1].agg_kind);
+  target_infos.erase(target_infos.begin() + 1);
+  return target_infos;
+}
+
 std::vector<TargetInfo> generate_random_groups_target_infos() {
   std::vector<TargetInfo> target_infos;
   SQLTypeInfo int_ti(kINT, true);
@@ -1916,6 +1965,47 @@ TEST(Iterate, BaselineHashColumnar) {
   test_iterate(target_infos, query_mem_desc);
 }
 
+TEST(DirectColumnRead, PerfectHashOneCol) {
+  const auto target_infos = generate_direct_read_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  test_direct_column_read(target_infos, query_mem_desc);
+}
+
+TEST(DirectColumnRead, PerfectHashOneCol32) {
+  const auto target_infos = generate_direct_read_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 4, 0, 99);
+  test_direct_column_read(target_infos, query_mem_desc);
+}
+
+TEST(DirectColumnRead, PerfectHashOneColColumnar) {
+  const auto target_infos = generate_direct_read_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  query_mem_desc.output_columnar = true;
+  test_direct_column_read(target_infos, query_mem_desc);
+}
+
+TEST(DirectColumnRead, BaselineHash) {
+  const auto target_infos = generate_direct_read_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  test_direct_column_read(target_infos, query_mem_desc);
+}
+
+TEST(DirectColumnRead, BaselineHashColumnar) {
+  const auto target_infos = generate_direct_read_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.output_columnar = true;
+  test_direct_column_read(target_infos, query_mem_desc);
+}
+
+TEST(DirectColumnRead, Unsupported) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  ResultSet result_set(target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  result_set.allocateStorage();
+  ASSERT_FALSE(result_set.canReadColumnsDirectly());
+}
+
 TEST(Reduce, PerfectHashOneCol) {
   const auto target_infos = generate_test_target_infos();
   const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
@@ -167,6 +167,35 @@ TEST(StorageRename, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table new_table;"););
 }
 
+TEST(StorageSmall, FragmentSnapshots) {
+  ASSERT_NO_THROW(run_ddl_statement("drop table if exists snapshots;"););
+  ASSERT_NO_THROW(run_ddl_statement("create table snapshots (a int, b double) with (fragment_size=1000);"););
+  populate_table_random("snapshots", 2500, gsession->get_catalog());
+  const auto td = gsession->get_catalog().getMetadataForTable("snapshots");
+  CHECK(td);
+  const auto snapshot = td->fragmenter->getFragmentsSnapshot();
+  // readers share the snapshot until the table changes
+  EXPECT_EQ(snapshot, td->fragmenter->getFragmentsSnapshot());
+  ASSERT_EQ(size_t(2500), snapshot->getPhysicalNumTuples());
+  ASSERT_EQ(size_t(3), snapshot->fragments.size());
+  const auto& last_fragment = snapshot->fragments.back();
+  const auto last_chunk_meta_it = last_fragment.getChunkMetadataMapPhysical().find(1);
+  ASSERT_TRUE(last_chunk_meta_it != last_fragment.getChunkMetadataMapPhysical().end());
+  EXPECT_EQ(size_t(500), last_chunk_meta_it->second.numElements);
+
+  populate_table_random("snapshots", 1000, gsession->get_catalog());
+  const auto new_snapshot = td->fragmenter->getFragmentsSnapshot();
+  EXPECT_NE(snapshot, new_snapshot);
+  EXPECT_EQ(size_t(3500), new_snapshot->getPhysicalNumTuples());
+  EXPECT_EQ(size_t(4), new_snapshot->fragments.size());
+  // the pinned snapshot keeps the metadata it was taken with
+  EXPECT_EQ(size_t(2500), snapshot->getPhysicalNumTuples());
+  EXPECT_EQ(size_t(500), last_chunk_meta_it->second.numElements);
+  const auto& filled_fragment = new_snapshot->fragments[2];
+  EXPECT_EQ(size_t(1000), filled_fragment.getChunkMetadataMapPhysical().find(1)->second.numElements);
+  ASSERT_NO_THROW(run_ddl_statement("drop table snapshots;"););
+}
+
 TEST(StorageSmallParallel, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table if exists alltypes;"););
   ASSERT_NO_THROW(run_ddl_statement("create table alltypes (a smallint, b int, c bigint, d numeric(7,3), e double, f float, "
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../Import/RowToColumnLoader.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Loads into a counter instead of a server. Rows are one BIGINT column, "bad" doesn't convert.
+class StubConnection : public ColumnarLoaderConnection {
+ public:
+  StubConnection(std::atomic<size_t>& rows_loaded, std::atomic<size_t>& batches_loaded)
+      : rows_loaded_(rows_loaded), batches_loaded_(batches_loaded) {}
+
+  bool convert_string_to_column(const std::vector<TStringValue>& row,
+                                const Importer_NS::CopyParams& copy_params,
+                                std::vector<TColumn>& columns) const override {
+    CHECK_EQ(size_t(1), row.size());
+    CHECK_EQ(size_t(1), columns.size());
+    if (row.front().str_val == "bad") {
+      return false;
+    }
+    columns.front().data.int_col.push_back(std::stoll(row.front().str_val));
+    columns.front().nulls.push_back(false);
+    return true;
+  }
+
+  void load_columns(const std::vector<TColumn>& columns, const Importer_NS::CopyParams& copy_params) override {
+    // keep batches in flight long enough for the queues to fill up
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    rows_loaded_ += columns.front().data.int_col.size();
+    ++batches_loaded_;
+  }
+
+  void load_arrow_stream(const std::string& arrow_stream, const Importer_NS::CopyParams& copy_params) override {
+    ++batches_loaded_;
+  }
+
+  TRowDescriptor get_row_descriptor() const override { return TRowDescriptor(1); }
+
+  std::string print_row_with_delim(std::vector<TStringValue> row,
+                                   const Importer_NS::CopyParams& copy_params) const override {
+    return row.front().str_val;
+  }
+
+ private:
+  std::atomic<size_t>& rows_loaded_;
+  std::atomic<size_t>& batches_loaded_;
+};
+
+std::vector<std::vector<TStringValue>> make_rows(const std::vector<std::string>& values) {
+  std::vector<std::vector<TStringValue>> rows;
+  for (const auto& value : values) {
+    TStringValue str_value;
+    str_value.str_val = value;
+    str_value.is_null = false;
+    rows.push_back({str_value});
+  }
+  return rows;
+}
+
+std::unique_ptr<StreamingColumnarLoader> make_loader(std::atomic<size_t>& rows_loaded,
+                                                     std::atomic<size_t>& batches_loaded,
+                                                     const size_t parse_threads,
+                                                     const size_t connection_count) {
+  std::vector<std::unique_ptr<ColumnarLoaderConnection>> connections;
+  for (size_t i = 0; i < connection_count; ++i) {
+    connections.emplace_back(new StubConnection(rows_loaded, batches_loaded));
+  }
+  return std::unique_ptr<StreamingColumnarLoader>(
+      new StreamingColumnarLoader(std::move(connections), Importer_NS::CopyParams(), parse_threads));
+}
+
+}  // namespace
+
+TEST(BoundedQueue, CloseDrains) {
+  BoundedQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  queue.close();
+  int item{0};
+  for (int expected = 1; expected <= 3; ++expected) {
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQ(expected, item);
+  }
+  ASSERT_FALSE(queue.pop(item));
+  ASSERT_FALSE(queue.pop(item));
+}
+
+TEST(BoundedQueue, CloseWakesPop) {
+  BoundedQueue<int> queue(1);
+  auto popper = std::async(std::launch::async, [&queue] {
+    int item{0};
+    return queue.pop(item);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  ASSERT_FALSE(popper.get());
+}
+
+TEST(BoundedQueue, PushBlocksWhileFull) {
+  BoundedQueue<int> queue(1);
+  queue.push(1);
+  std::atomic<bool> pushed{false};
+  auto pusher = std::async(std::launch::async, [&queue, &pushed] {
+    queue.push(2);
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_FALSE(pushed);
+  int item{0};
+  ASSERT_TRUE(queue.pop(item));
+  ASSERT_EQ(1, item);
+  pusher.get();
+  ASSERT_TRUE(pushed);
+  ASSERT_TRUE(queue.pop(item));
+  ASSERT_EQ(2, item);
+}
+
+TEST(StreamingColumnarLoader, FlushWaitsForAllBatches) {
+  std::atomic<size_t> rows_loaded{0};
+  std::atomic<size_t> batches_loaded{0};
+  auto loader = make_loader(rows_loaded, batches_loaded, 2, 2);
+  // nothing pending, returns right away
+  loader->flush();
+  const size_t batch_count{50};
+  for (size_t i = 0; i < batch_count; ++i) {
+    loader->add_rows(make_rows({"1", "bad", "2", "3"}));
+  }
+  loader->add_arrow_stream("arrow", 7);
+  loader->flush();
+  ASSERT_EQ(batch_count + 1, batches_loaded);
+  ASSERT_EQ(batch_count * 3, rows_loaded);
+  ASSERT_EQ(batch_count * 3 + 7, loader->get_rows_loaded());
+  ASSERT_EQ(batch_count, loader->get_rows_skipped());
+}
+
+TEST(StreamingColumnarLoader, BatchWithoutValidRows) {
+  std::atomic<size_t> rows_loaded{0};
+  std::atomic<size_t> batches_loaded{0};
+  auto loader = make_loader(rows_loaded, batches_loaded, 1, 1);
+  // never reaches a connection, the parse stage has to finish it or flush() hangs
+  loader->add_rows(make_rows({"bad", "bad"}));
+  loader->flush();
+  ASSERT_EQ(size_t(0), batches_loaded);
+  ASSERT_EQ(size_t(0), loader->get_rows_loaded());
+  ASSERT_EQ(size_t(2), loader->get_rows_skipped());
+  loader->add_rows(make_rows({"bad", "4"}));
+  loader->add_rows(make_rows({"bad"}));
+  loader->flush();
+  ASSERT_EQ(size_t(1), batches_loaded);
+  ASSERT_EQ(size_t(1), loader->get_rows_loaded());
+  ASSERT_EQ(size_t(4), loader->get_rows_skipped());
+}
+
+TEST(StreamingColumnarLoader, EmptyBatch) {
+  std::atomic<size_t> rows_loaded{0};
+  std::atomic<size_t> batches_loaded{0};
+  auto loader = make_loader(rows_loaded, batches_loaded, 1, 1);
+  loader->add_rows({});
+  loader->flush();
+  ASSERT_EQ(size_t(0), batches_loaded);
+  ASSERT_EQ(size_t(0), loader->get_rows_skipped());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/TDigest.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <vector>
+
+namespace {
+
+double exact_quantile(std::vector<double> values, const double q) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+// Rank error of an estimate, which is what a t-digest bounds.
+double rank_error(const std::vector<double>& sorted_values, const double estimate, const double q) {
+  const auto rank = std::lower_bound(sorted_values.begin(), sorted_values.end(), estimate) - sorted_values.begin();
+  return std::abs(static_cast<double>(rank) / sorted_values.size() - q);
+}
+
+}  // namespace
+
+TEST(TDigest, Empty) {
+  TDigest digest(0.5);
+  ASSERT_TRUE(std::isnan(digest.quantile()));
+  TDigest other(0.5);
+  digest.merge(other);
+  ASSERT_TRUE(std::isnan(digest.quantile()));
+}
+
+TEST(TDigest, Small) {
+  TDigest digest(0.5);
+  digest.add(42);
+  ASSERT_EQ(42, digest.quantile());
+  digest.add(7);
+  digest.add(100);
+  ASSERT_EQ(7, digest.quantile(0));
+  ASSERT_EQ(100, digest.quantile(1));
+  ASSERT_EQ(42, digest.quantile());
+}
+
+TEST(TDigest, Accuracy) {
+  std::mt19937 gen(17);
+  std::lognormal_distribution<double> dist(0, 1);
+  std::vector<double> values;
+  TDigest digest(0.5);
+  for (size_t i = 0; i < 200000; ++i) {
+    values.push_back(dist(gen));
+    digest.add(values.back());
+  }
+  ASSERT_LE(digest.centroidCount(), size_t(110));
+  auto sorted_values = values;
+  std::sort(sorted_values.begin(), sorted_values.end());
+  for (const auto q : {0.001, 0.01, 0.25, 0.5, 0.75, 0.95, 0.99, 0.999}) {
+    ASSERT_LT(rank_error(sorted_values, digest.quantile(q), q), 0.005) << q;
+  }
+  ASSERT_NEAR(exact_quantile(values, 0.5), digest.quantile(), 0.02);
+}
+
+TEST(TDigest, Merge) {
+  std::mt19937 gen(23);
+  std::uniform_real_distribution<double> dist(-1000, 1000);
+  std::vector<double> values;
+  std::vector<TDigest> partials(16, TDigest(0.95));
+  for (size_t i = 0; i < 160000; ++i) {
+    values.push_back(dist(gen));
+    partials[i % partials.size()].add(values.back());
+  }
+  TDigest merged(0.95);
+  for (auto& partial : partials) {
+    merged.merge(partial);
+  }
+  auto sorted_values = values;
+  std::sort(sorted_values.begin(), sorted_values.end());
+  for (const auto q : {0.01, 0.5, 0.95, 0.99}) {
+    ASSERT_LT(rank_error(sorted_values, merged.quantile(q), q), 0.005) << q;
+  }
+  ASSERT_EQ(sorted_values.front(), merged.quantile(0));
+  ASSERT_EQ(sorted_values.back(), merged.quantile(1));
+}
+
+TEST(TDigest, ConstReads) {
+  TDigest digest(0.5);
+  for (int i = 0; i < 1000; ++i) {
+    digest.add(i);
+  }
+  // some values are still buffered; neither reading nor merging from it may change it
+  const TDigest& const_digest = digest;
+  const auto median = const_digest.quantile();
+  const auto centroid_count = const_digest.centroidCount();
+  TDigest merged(0.5);
+  merged.merge(const_digest);
+  ASSERT_EQ(median, merged.quantile());
+  std::vector<std::future<double>> readers;
+  for (int i = 0; i < 8; ++i) {
+    readers.push_back(std::async(std::launch::async, [&const_digest] { return const_digest.quantile(); }));
+  }
+  for (auto& reader : readers) {
+    ASSERT_EQ(median, reader.get());
+  }
+  digest.flush();
+  ASSERT_EQ(median, digest.quantile());
+  ASSERT_EQ(centroid_count, digest.centroidCount());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -61,6 +61,7 @@
 #include "Shared/StringTransform.h"
 #include "Shared/geosupport.h"
 #include "Shared/import_helpers.h"
+#include "Shared/lock_wait_stats.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/measure.h"
 #include "Shared/scope.h"
@@ -144,7 +145,8 @@ MapDHandler::MapDHandler(const std::vector<LeafHostInfo>& db_leaves,
       legacy_syntax_(legacy_syntax),
       super_user_rights_(false),
       access_priv_check_(access_priv_check),
-      _was_geo_copy_from(false) {
+      _was_geo_copy_from(false),
+      next_cursor_id_(0) {
   LOG(INFO) << "MapD Server " << MAPD_RELEASE;
   if (executor_device == "gpu") {
 #ifdef HAVE_CUDA
@@ -258,7 +260,8 @@ std::string generate_random_string(const size_t len) {
 
 // internal connection for connections with no password
 void MapDHandler::internal_connect(TSessionId& session, const std::string& user, const std::string& dbname) {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
+  const auto write_lock =
+      timed_lock<mapd_unique_lock<mapd_shared_mutex>>(sessions_mutex_, LockWaitSite::SESSIONS_MUTEX);
   Catalog_Namespace::UserMetadata user_meta;
   if (!SysCatalog::instance().getMetadataForUser(user, user_meta)) {
     THROW_MAPD_EXCEPTION(std::string("User ") + user + " does not exist.");
@@ -270,7 +273,8 @@ void MapDHandler::connect(TSessionId& session,
                           const std::string& user,
                           const std::string& passwd,
                           const std::string& dbname) {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
+  const auto write_lock =
+      timed_lock<mapd_unique_lock<mapd_shared_mutex>>(sessions_mutex_, LockWaitSite::SESSIONS_MUTEX);
   Catalog_Namespace::UserMetadata user_meta;
   if (!SysCatalog::instance().getMetadataForUser(user, user_meta)) {
     THROW_MAPD_EXCEPTION(std::string("User ") + user + " does not exist.");
@@ -327,7 +331,8 @@ void MapDHandler::connectImpl(TSessionId& session,
 }
 
 void MapDHandler::disconnect(const TSessionId& session) {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
+  const auto write_lock =
+      timed_lock<mapd_unique_lock<mapd_shared_mutex>>(sessions_mutex_, LockWaitSite::SESSIONS_MUTEX);
   if (leaf_aggregator_.leafCount() > 0) {
     leaf_aggregator_.disconnect(session);
   }
@@ -339,31 +344,63 @@ void MapDHandler::disconnect(const TSessionId& session) {
   LOG(INFO) << "User " << session_it->second->get_currentUser().userName << " disconnected from database " << dbname
             << std::endl;
   sessions_.erase(session_it);
+  close_session_cursors(session);
 }
 
 void MapDHandler::interrupt(const TSessionId& session) {
-  if (g_enable_dynamic_watchdog) {
-    mapd_lock_guard<mapd_shared_mutex> read_lock(sessions_mutex_);
-    if (leaf_aggregator_.leafCount() > 0) {
-      leaf_aggregator_.interrupt(session);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+  if (leaf_aggregator_.leafCount() > 0) {
+    leaf_aggregator_.interrupt(session);
+  }
+  auto session_it = get_session_it(session);
+  const auto dbname = session_it->second->get_catalog().get_currentDB().dbName;
+  auto session_info_ptr = session_it->second.get();
+  auto& cat = session_info_ptr->get_catalog();
+  auto executor = Executor::getExecutor(
+      cat.get_currentDB().dbId, jit_debug_ ? "/tmp" : "", jit_debug_ ? "mapdquery" : "", mapd_parameters_, nullptr);
+  CHECK(executor);
+
+  std::vector<std::shared_ptr<QueryCancellationToken>> query_tokens;
+  {
+    std::lock_guard<std::mutex> lock(running_queries_mutex_);
+    const auto session_queries = running_queries_.equal_range(session);
+    for (auto query_it = session_queries.first; query_it != session_queries.second; ++query_it) {
+      query_tokens.push_back(query_it->second);
     }
-    auto session_it = get_session_it(session);
-    const auto dbname = session_it->second->get_catalog().get_currentDB().dbName;
-    auto session_info_ptr = session_it->second.get();
-    auto& cat = session_info_ptr->get_catalog();
-    auto executor = Executor::getExecutor(
-        cat.get_currentDB().dbId, jit_debug_ ? "/tmp" : "", jit_debug_ ? "mapdquery" : "", mapd_parameters_, nullptr);
-    CHECK(executor);
+  }
+
+  VLOG(1) << "Received interrupt: "
+          << "Session " << session << ", Executor " << executor << ", leafCount " << leaf_aggregator_.leafCount()
+          << ", User " << session_it->second->get_currentUser().userName << ", Database " << dbname << ", "
+          << query_tokens.size() << " running queries" << std::endl;
 
-    VLOG(1) << "Received interrupt: "
-            << "Session " << session << ", Executor " << executor << ", leafCount " << leaf_aggregator_.leafCount()
-            << ", User " << session_it->second->get_currentUser().userName << ", Database " << dbname << std::endl;
+  // only the queries of this session are cancelled, not whatever the executor is running
+  for (const auto& query_token : query_tokens) {
+    query_token->cancel();
+    executor->interrupt(query_token.get());
+  }
 
-    executor->interrupt();
+  LOG(INFO) << "User " << session_it->second->get_currentUser().userName << " interrupted session with database "
+            << dbname << std::endl;
+}
 
-    LOG(INFO) << "User " << session_it->second->get_currentUser().userName << " interrupted session with database "
-              << dbname << std::endl;
+std::shared_ptr<QueryCancellationToken> MapDHandler::registerQuery(const TSessionId& session) const {
+  auto query_token = std::make_shared<QueryCancellationToken>();
+  std::lock_guard<std::mutex> lock(running_queries_mutex_);
+  running_queries_.emplace(session, query_token);
+  return query_token;
+}
+
+void MapDHandler::unregisterQuery(const TSessionId& session, const QueryCancellationToken* query_token) const {
+  std::lock_guard<std::mutex> lock(running_queries_mutex_);
+  const auto session_queries = running_queries_.equal_range(session);
+  for (auto query_it = session_queries.first; query_it != session_queries.second; ++query_it) {
+    if (query_it->second.get() == query_token) {
+      running_queries_.erase(query_it);
+      return;
+    }
   }
+  CHECK(false);
 }
 
 void MapDHandler::get_server_status(TServerStatus& _return, const TSessionId& session) {
@@ -375,6 +412,8 @@ void MapDHandler::get_server_status(TServerStatus& _return, const TSessionId& se
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = "aggregator";
+  get_request_queue_stats(_return.request_queue);
+  get_result_cache_stats(_return.result_cache);
 }
 
 void MapDHandler::get_status(std::vector<TServerStatus>& _return, const TSessionId& session) {
@@ -387,6 +426,8 @@ void MapDHandler::get_status(std::vector<TServerStatus>& _return, const TSession
   ret.start_time = start_time_;
   ret.edition = MAPD_EDITION;
   ret.host_name = "aggregator";
+  get_request_queue_stats(ret.request_queue);
+  get_result_cache_stats(ret.result_cache);
   _return.push_back(ret);
   if (leaf_aggregator_.leafCount() > 0) {
     std::vector<TServerStatus> leaf_status = leaf_aggregator_.getLeafStatus(session);
@@ -394,6 +435,34 @@ void MapDHandler::get_status(std::vector<TServerStatus>& _return, const TSession
   }
 }
 
+void MapDHandler::setRequestScheduler(std::shared_ptr<RequestScheduler> request_scheduler) {
+  request_scheduler_ = request_scheduler;
+}
+
+void MapDHandler::get_request_queue_stats(TRequestQueueStats& _return) const {
+  if (!request_scheduler_) {
+    return;
+  }
+  const auto stats = request_scheduler_->getStats();
+  _return.running_requests = stats.running_requests;
+  _return.queued_requests = stats.queued_requests;
+  _return.admitted_requests = stats.admitted_requests;
+  _return.rejected_requests = stats.rejected_requests;
+  _return.avg_wait_us = stats.admitted_requests ? stats.total_wait_us / stats.admitted_requests : 0;
+  _return.max_wait_us = stats.max_wait_us;
+}
+
+void MapDHandler::get_result_cache_stats(TResultCacheStats& _return) const {
+  const auto stats = ResultSetCache::getStats();
+  _return.hits = stats.hits;
+  _return.misses = stats.misses;
+  _return.evictions = stats.evictions;
+  _return.entry_count = stats.entry_count;
+  _return.bytes = stats.bytes;
+  const auto lookups = stats.hits + stats.misses;
+  _return.hit_rate = lookups ? static_cast<double>(stats.hits) / lookups : 0.;
+}
+
 void MapDHandler::get_hardware_info(TClusterHardwareInfo& _return, const TSessionId& session) {
   THardwareInfo ret;
   CudaMgr_Namespace::CudaMgr* cuda_mgr = data_mgr_->cudaMgr_;
@@ -718,13 +787,12 @@ void MapDHandler::sql_execute_df(TDataFrame& _return,
             measure<>::execution([&]() { query_ra = parse_to_ra(query_str, session_info, &tableNames); });
 
         // COPY_TO/SELECT: get read ExecutorOuterLock >> read UpdateDeleteLock locks
-        mapd_shared_lock<mapd_shared_mutex> executeReadLock(
-            *LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true));
+        const auto executeReadLock = getExecutorOuterLock<mapd_shared_lock>();
         std::vector<std::shared_ptr<VLock>> upddelLocks;
         getTableLocks<mapd_shared_mutex>(
             session_info.get_catalog(), tableNames, upddelLocks, LockType::UpdateDeleteLock);
 
-        if (pw.is_select_calcite_explain) {
+        if (pw.is_select_calcite_explain || pw.is_select_analyze_explain) {
           throw std::runtime_error("explain is not unsupported by current thrift API");
         }
         execute_rel_alg_df(_return,
@@ -782,6 +850,174 @@ void MapDHandler::deallocate_df(const TSessionId& session,
                           data_mgr_.get());
 }
 
+namespace {
+
+// Epoch and tuple count of the tables read by a cursor's query. Changes to the tables move their
+// chunks around, the result can only be converted as long as they haven't changed.
+std::vector<TableVersion> get_cursor_table_versions(const Catalog& cat,
+                                                    const std::map<std::string, bool>& table_names) {
+  std::vector<TableVersion> table_versions;
+  for (const auto& table_name : table_names) {
+    const auto td = cat.getMetadataForTable(table_name.first);
+    if (!td) {
+      throw std::runtime_error("Table " + table_name.first + " does not exist.");
+    }
+    if (td->isView) {
+      continue;
+    }
+    size_t num_tuples{0};
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      CHECK(physical_td->fragmenter);
+      num_tuples += physical_td->fragmenter->getFragmentsSnapshot()->getPhysicalNumTuples();
+    }
+    const auto epoch = td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL
+                           ? cat.getTableEpoch(cat.get_currentDB().dbId, td->tableId)
+                           : -1;
+    table_versions.push_back({td->tableId, epoch, num_tuples});
+  }
+  return table_versions;
+}
+
+}  // namespace
+
+void MapDHandler::open_cursor(TCursor& _return,
+                              const TSessionId& session,
+                              const std::string& query_str,
+                              const bool column_format,
+                              const std::string& nonce) {
+  const auto session_info = get_session(session);
+  LOG(INFO) << "open_cursor :" << session << ":query_str:" << hide_sensitive_data(query_str);
+  if (leaf_aggregator_.leafCount() > 0) {
+    THROW_MAPD_EXCEPTION("Cursors are not supported in distributed mode.");
+  }
+  ParserWrapper pw{query_str};
+  if (!is_calcite_path_permissable(pw) || pw.is_update_dml || pw.is_select_explain || pw.is_select_calcite_explain ||
+      pw.is_select_analyze_explain) {
+    THROW_MAPD_EXCEPTION("Only SELECT statements can be run with a cursor.");
+  }
+  close_idle_cursors();
+  auto cursor = std::make_shared<Cursor>();
+  cursor->session = session;
+  cursor->column_format = column_format;
+  TQueryResult query_result;
+  query_result.execution_time_ms = 0;
+  _return.total_time_ms = measure<>::execution([&]() {
+    try {
+      const auto query_ra = parse_to_ra(query_str, session_info, &cursor->table_names);
+      // SELECT: read ExecutorOuterLock >> read UpdateDeleteLocks, as in sql_execute
+      const auto executeReadLock = getExecutorOuterLock<mapd_shared_lock>();
+      std::vector<std::shared_ptr<VLock>> upddelLocks;
+      getTableLocks<mapd_shared_mutex>(
+          session_info.get_catalog(), cursor->table_names, upddelLocks, LockType::UpdateDeleteLock);
+      cursor->table_versions = get_cursor_table_versions(session_info.get_catalog(), cursor->table_names);
+      execute_rel_alg(query_result,
+                      query_ra,
+                      column_format,
+                      session_info,
+                      session_info.get_executor_device_type(),
+                      -1,
+                      -1,
+                      false,
+                      false,
+                      false,
+                      cursor.get());
+    } catch (const TMapDException&) {
+      throw;
+    } catch (std::exception& e) {
+      THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+    }
+  });
+  CHECK(cursor->rows);
+  _return.row_desc = query_result.row_set.row_desc;
+  _return.row_count = cursor->rows->rowCount();
+  _return.execution_time_ms = query_result.execution_time_ms;
+  _return.nonce = nonce;
+  cursor->last_used = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+    _return.cursor_id = next_cursor_id_++;
+    cursors_.emplace(_return.cursor_id, cursor);
+  }
+  LOG(INFO) << "open_cursor-COMPLETED cursor " << _return.cursor_id << ", " << _return.row_count
+            << " rows, Total: " << _return.total_time_ms << " (ms), Execution: " << _return.execution_time_ms
+            << " (ms)";
+}
+
+void MapDHandler::fetch_cursor(TRowSet& _return,
+                               const TSessionId& session,
+                               const TCursorId cursor_id,
+                               const int32_t max_rows) {
+  const auto session_info = get_session(session);
+  if (max_rows <= 0) {
+    THROW_MAPD_EXCEPTION("The number of rows to fetch must be positive.");
+  }
+  close_idle_cursors();
+  const auto cursor = get_cursor(session, cursor_id);
+  std::lock_guard<std::mutex> fetch_lock(cursor->fetch_mutex);
+  // the conversion reads the chunks of the tables, lock them like the conversion of sql_execute
+  const auto executeReadLock = getExecutorOuterLock<mapd_shared_lock>();
+  std::vector<std::shared_ptr<VLock>> upddelLocks;
+  TQueryResult page;
+  try {
+    getTableLocks<mapd_shared_mutex>(
+        session_info.get_catalog(), cursor->table_names, upddelLocks, LockType::UpdateDeleteLock);
+    if (!(get_cursor_table_versions(session_info.get_catalog(), cursor->table_names) == cursor->table_versions)) {
+      throw std::runtime_error("The tables read by the cursor have changed since it was opened.");
+    }
+    convert_rows(page, cursor->targets, *cursor->rows, cursor->column_format, max_rows, -1);
+  } catch (const TMapDException&) {
+    throw;
+  } catch (std::exception& e) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  swap(_return, page.row_set);
+}
+
+void MapDHandler::close_cursor(const TSessionId& session, const TCursorId cursor_id) {
+  get_session(session);
+  get_cursor(session, cursor_id);
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  cursors_.erase(cursor_id);
+}
+
+std::shared_ptr<MapDHandler::Cursor> MapDHandler::get_cursor(const TSessionId& session, const TCursorId cursor_id) {
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  const auto cursor_it = cursors_.find(cursor_id);
+  if (cursor_it == cursors_.end() || cursor_it->second->session != session) {
+    THROW_MAPD_EXCEPTION("Cursor not valid, it may have been closed after " +
+                         std::to_string(mapd_parameters_.cursor_timeout_s) + " seconds without fetches.");
+  }
+  cursor_it->second->last_used = std::chrono::steady_clock::now();
+  return cursor_it->second;
+}
+
+void MapDHandler::close_idle_cursors() {
+  if (!mapd_parameters_.cursor_timeout_s) {
+    return;
+  }
+  const auto oldest_used = std::chrono::steady_clock::now() - std::chrono::seconds(mapd_parameters_.cursor_timeout_s);
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  for (auto cursor_it = cursors_.begin(); cursor_it != cursors_.end();) {
+    if (cursor_it->second->last_used < oldest_used) {
+      LOG(INFO) << "Closing idle cursor " << cursor_it->first << " of session " << cursor_it->second->session;
+      cursor_it = cursors_.erase(cursor_it);
+    } else {
+      ++cursor_it;
+    }
+  }
+}
+
+void MapDHandler::close_session_cursors(const TSessionId& session) {
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  for (auto cursor_it = cursors_.begin(); cursor_it != cursors_.end();) {
+    if (cursor_it->second->session == session) {
+      cursor_it = cursors_.erase(cursor_it);
+    } else {
+      ++cursor_it;
+    }
+  }
+}
+
 std::string MapDHandler::apply_copy_to_shim(const std::string& query_str) {
   auto result = query_str;
   {
@@ -798,7 +1034,7 @@ void MapDHandler::sql_validate(TTableDescriptor& _return, const TSessionId& sess
   std::unique_ptr<const Planner::RootPlan> root_plan;
   const auto session_info = get_session(session);
   ParserWrapper pw{query_str};
-  if (pw.is_select_explain || pw.is_other_explain || pw.is_ddl || pw.is_update_dml) {
+  if (pw.is_select_explain || pw.is_select_analyze_explain || pw.is_other_explain || pw.is_ddl || pw.is_update_dml) {
     THROW_MAPD_EXCEPTION("Can only validate SELECT statements.");
   }
   MapDHandler::validate_rel_alg(_return, query_str, session_info);
@@ -967,7 +1203,7 @@ void MapDHandler::validate_rel_alg(TTableDescriptor& _return,
   try {
     const auto query_ra = parse_to_ra(query_str, session_info);
     TQueryResult result;
-    MapDHandler::execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true);
+    MapDHandler::execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true, false);
     const auto& row_desc = fixup_row_descriptor(result.row_set.row_desc, session_info.get_catalog());
     for (const auto& col_desc : row_desc) {
       const auto it_ok = _return.insert(std::make_pair(col_desc.col_name, col_desc));
@@ -1241,7 +1477,7 @@ void MapDHandler::get_table_details_impl(TTableDetails& _return,
     try {
       const auto query_ra = parse_to_ra(td->viewSQL, session_info);
       TQueryResult result;
-      execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true);
+      execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true, false);
       _return.row_desc = fixup_row_descriptor(result.row_set.row_desc, cat);
     } catch (std::exception& e) {
       TColumnType tColumnType;
@@ -1403,7 +1639,7 @@ void MapDHandler::get_tables_meta(std::vector<TTableMeta>& _return, const TSessi
       try {
         const auto query_ra = parse_to_ra(td->viewSQL, session_info);
         TQueryResult result;
-        execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true);
+        execute_rel_alg(result, query_ra, true, session_info, ExecutorDeviceType::CPU, -1, -1, false, true, false);
         num_cols = result.row_set.row_desc.size();
         for (const auto col : result.row_set.row_desc) {
           if (col.is_physical) {
@@ -1553,6 +1789,17 @@ void MapDHandler::get_frontend_views(std::vector<TFrontendView>& view_names, con
   }
 }
 
+void MapDHandler::set_statement_timeout(const TSessionId& session, const int32_t timeout_ms) {
+  if (timeout_ms < 0) {
+    THROW_MAPD_EXCEPTION("Statement timeout can't be negative");
+  }
+  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
+  auto session_it = get_session_it(session);
+  session_it->second->set_statement_timeout(timeout_ms);
+  LOG(INFO) << "User " << session_it->second->get_currentUser().userName << " sets statement timeout to "
+            << timeout_ms << " ms.";
+}
+
 void MapDHandler::set_execution_mode(const TSessionId& session, const TExecuteMode::type mode) {
   mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
   auto session_it = get_session_it(session);
@@ -3023,7 +3270,7 @@ SessionMap::iterator MapDHandler::get_session_it(const TSessionId& session) {
 }
 
 Catalog_Namespace::SessionInfo MapDHandler::get_session(const TSessionId& session) {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+  const auto read_lock = timed_lock<mapd_shared_lock<mapd_shared_mutex>>(sessions_mutex_, LockWaitSite::SESSIONS_MUTEX);
   return *get_session_it(session)->second;
 }
 
@@ -3085,10 +3332,21 @@ void MapDHandler::execute_rel_alg(TQueryResult& _return,
                                   const int32_t first_n,
                                   const int32_t at_most_n,
                                   const bool just_explain,
-                                  const bool just_validate) const {
+                                  const bool just_validate,
+                                  const bool explain_analyze,
+                                  Cursor* cursor) const {
   INJECT_TIMER(execute_rel_alg);
   const auto& cat = session_info.get_catalog();
-  CompilationOptions co = {executor_device_type, true, ExecutorOptLevel::Default, g_enable_dynamic_watchdog};
+  const auto statement_timeout_ms = session_info.get_statement_timeout();
+  const bool with_dynamic_watchdog = g_enable_dynamic_watchdog || statement_timeout_ms;
+  const auto query_token = registerQuery(session_info.get_session_id());
+  ScopeGuard unregister_query = [this, &session_info, &query_token] {
+    unregisterQuery(session_info.get_session_id(), query_token.get());
+  };
+  const auto query_profile = (explain_analyze || g_enable_query_profile) && !just_explain && !just_validate
+                                 ? std::make_shared<QueryProfile>()
+                                 : nullptr;
+  CompilationOptions co = {executor_device_type, true, ExecutorOptLevel::Default, with_dynamic_watchdog};
   ExecutionOptions eo = {false,
                          allow_multifrag_,
                          just_explain,
@@ -3096,8 +3354,10 @@ void MapDHandler::execute_rel_alg(TQueryResult& _return,
                          g_enable_watchdog,
                          jit_debug_,
                          just_validate,
-                         g_enable_dynamic_watchdog,
-                         g_dynamic_watchdog_time_limit};
+                         with_dynamic_watchdog,
+                         statement_timeout_ms ? statement_timeout_ms : g_dynamic_watchdog_time_limit,
+                         query_token,
+                         query_profile};
   auto executor = Executor::getExecutor(
       cat.get_currentDB().dbId, jit_debug_ ? "/tmp" : "", jit_debug_ ? "mapdquery" : "", mapd_parameters_, nullptr);
   RelAlgExecutor ra_executor(executor.get(), cat);
@@ -3109,11 +3369,35 @@ void MapDHandler::execute_rel_alg(TQueryResult& _return,
       measure<>::execution([&]() { result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr); });
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  _return.result_cache_hit = result.getRows()->isFromResultCache();
   if (just_explain) {
     convert_explain(_return, *result.getRows(), column_format);
+    return;
+  }
+  if (cursor) {
+    // fetch_cursor converts the rows, a page at a time
+    _return.row_set.row_desc = convert_target_metainfo(result.getTargetsMeta());
+    cursor->rows = result.getRows();
+    cursor->targets = result.getTargetsMeta();
+    return;
+  }
+  if (explain_analyze) {
+    // the rows are converted and dropped, the conversion is part of what's being profiled
+    TQueryResult discarded_rows;
+    query_profile->addResultConversion(measure<std::chrono::microseconds>::execution([&]() {
+      convert_rows(discarded_rows, result.getTargetsMeta(), *result.getRows(), column_format, first_n, at_most_n);
+    }));
+    convert_explain(_return, ResultSet(query_profile->toString()), column_format);
   } else {
-    convert_rows(_return, result.getTargetsMeta(), *result.getRows(), column_format, first_n, at_most_n);
+    const auto conversion_us = measure<std::chrono::microseconds>::execution([&]() {
+      convert_rows(_return, result.getTargetsMeta(), *result.getRows(), column_format, first_n, at_most_n);
+    });
+    if (!query_profile) {
+      return;
+    }
+    query_profile->addResultConversion(conversion_us);
   }
+  _return.__set_execution_profile(query_profile->toJson());
 }
 
 void MapDHandler::execute_rel_alg_df(TDataFrame& _return,
@@ -3124,7 +3408,13 @@ void MapDHandler::execute_rel_alg_df(TDataFrame& _return,
                                      const int32_t first_n) const {
   const auto& cat = session_info.get_catalog();
   CHECK(device_type == ExecutorDeviceType::CPU || session_info.get_executor_device_type() == ExecutorDeviceType::GPU);
-  CompilationOptions co = {device_type, true, ExecutorOptLevel::Default, g_enable_dynamic_watchdog};
+  const auto statement_timeout_ms = session_info.get_statement_timeout();
+  const bool with_dynamic_watchdog = g_enable_dynamic_watchdog || statement_timeout_ms;
+  const auto query_token = registerQuery(session_info.get_session_id());
+  ScopeGuard unregister_query = [this, &session_info, &query_token] {
+    unregisterQuery(session_info.get_session_id(), query_token.get());
+  };
+  CompilationOptions co = {device_type, true, ExecutorOptLevel::Default, with_dynamic_watchdog};
   ExecutionOptions eo = {false,
                          allow_multifrag_,
                          false,
@@ -3132,8 +3422,9 @@ void MapDHandler::execute_rel_alg_df(TDataFrame& _return,
                          g_enable_watchdog,
                          jit_debug_,
                          false,
-                         g_enable_dynamic_watchdog,
-                         g_dynamic_watchdog_time_limit};
+                         with_dynamic_watchdog,
+                         statement_timeout_ms ? statement_timeout_ms : g_dynamic_watchdog_time_limit,
+                         query_token};
   auto executor = Executor::getExecutor(
       cat.get_currentDB().dbId, jit_debug_ ? "/tmp" : "", jit_debug_ ? "mapdquery" : "", mapd_parameters_, nullptr);
   RelAlgExecutor ra_executor(executor.get(), cat);
@@ -3419,8 +3710,7 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
           chkptlLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(
               session_info.get_catalog(), table.first, LockType::CheckpointLock);
       // COPY_TO/SELECT: read ExecutorOuterLock >> read UpdateDeleteLock locks
-      executeReadLock =
-          mapd_shared_lock<mapd_shared_mutex>(*LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true));
+      executeReadLock = getExecutorOuterLock<mapd_shared_lock>();
       getTableLocks<mapd_shared_mutex>(session_info.get_catalog(), tableNames, upddelLocks, LockType::UpdateDeleteLock);
       execute_rel_alg(_return,
                       query_ra,
@@ -3430,7 +3720,8 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
                       first_n,
                       at_most_n,
                       pw.is_select_explain,
-                      false);
+                      false,
+                      pw.is_select_analyze_explain);
       return;
     }
     LOG(INFO) << "passing query to legacy processor";
@@ -3539,8 +3830,7 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
           // INSERT_VALUES: CheckpointLock >> write ExecutorOuterLock [ >> write UpdateDeleteLocks ]
           chkptlLock = getTableLock<mapd_shared_mutex, mapd_unique_lock>(
               session_info.get_catalog(), *stmtp->get_table(), LockType::CheckpointLock);
-          executeWriteLock =
-              mapd_unique_lock<mapd_shared_mutex>(*LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true));
+          executeWriteLock = getExecutorOuterLock<mapd_unique_lock>();
           // [ write UpdateDeleteLocks ] lock is deferred in InsertOrderFragmenter::deleteFragments
         }
 
@@ -3576,7 +3866,9 @@ Planner::RootPlan* MapDHandler::parse_to_plan(const std::string& query_str,
   ParserWrapper pw{query_str};
   // if this is a calcite select or explain select run in calcite
   if (!pw.is_ddl && !pw.is_update_dml && !pw.is_other_explain) {
-    const std::string actual_query{pw.is_select_explain || pw.is_select_calcite_explain ? pw.actual_query : query_str};
+    const std::string actual_query{
+      pw.is_select_explain || pw.is_select_calcite_explain || pw.is_select_analyze_explain ? pw.actual_query
+                                                                                          : query_str};
     const auto query_ra = calcite_
                               ->process(session_info,
                                         legacy_syntax_ ? pg_shim(actual_query) : actual_query,
@@ -3598,7 +3890,9 @@ std::string MapDHandler::parse_to_ra(const std::string& query_str,
                                      std::map<std::string, bool>* tableNames) {
   INJECT_TIMER(parse_to_ra);
   ParserWrapper pw{query_str};
-  const std::string actual_query{pw.is_select_explain || pw.is_select_calcite_explain ? pw.actual_query : query_str};
+  const std::string actual_query{
+      pw.is_select_explain || pw.is_select_calcite_explain || pw.is_select_analyze_explain ? pw.actual_query
+                                                                                          : query_str};
   if (is_calcite_path_permissable(pw)) {
     auto result = calcite_->process(session_info,
                                     legacy_syntax_ ? pg_shim(actual_query) : actual_query,
@@ -25,6 +25,7 @@
 #define MAPDHANDLER_H
 
 #include "LeafAggregator.h"
+#include "RequestScheduler.h"
 #ifdef HAVE_PROFILER
 #include <gperftools/heap-profiler.h>
 #endif  // HAVE_PROFILER
@@ -53,6 +54,7 @@
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/JsonAccessors.h"
+#include "QueryEngine/ResultSetCache.h"
 #include "QueryEngine/TableGenerations.h"
 #include "Shared/MapDParameters.h"
 #include "Shared/StringTransform.h"
@@ -78,6 +80,7 @@
 #include <boost/program_options.hpp>
 #include <boost/regex.hpp>
 #include <boost/tokenizer.hpp>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <map>
@@ -186,8 +189,22 @@ class MapDHandler : public MapDIf {
                      const TDeviceType::type device_type,
                      const int32_t device_id);
   void interrupt(const TSessionId& session);
+  // Runs a SELECT and keeps its result on the server, the rows are then fetched a page at a time
+  // with fetch_cursor. The cursor is closed by close_cursor, by disconnect or once it's been idle
+  // for longer than MapDParameters::cursor_timeout_s.
+  void open_cursor(TCursor& _return,
+                   const TSessionId& session,
+                   const std::string& query,
+                   const bool column_format,
+                   const std::string& nonce);
+  // Converts the next max_rows rows of the cursor, an empty row set once the result is exhausted.
+  void fetch_cursor(TRowSet& _return, const TSessionId& session, const TCursorId cursor_id, const int32_t max_rows);
+  void close_cursor(const TSessionId& session, const TCursorId cursor_id);
   void sql_validate(TTableDescriptor& _return, const TSessionId& session, const std::string& query);
   void set_execution_mode(const TSessionId& session, const TExecuteMode::type mode);
+  // Time limit for each of the queries of the session, in milliseconds. 0 goes back to the
+  // server wide dynamic watchdog limit.
+  void set_statement_timeout(const TSessionId& session, const int32_t timeout_ms);
   void render_vega(TRenderResult& _return,
                    const TSessionId& session,
                    const int64_t widget_id,
@@ -339,6 +356,8 @@ class MapDHandler : public MapDIf {
 
   TSessionId getInvalidSessionId() const;
 
+  void setRequestScheduler(std::shared_ptr<RequestScheduler> request_scheduler);
+
   void internal_connect(TSessionId& session, const std::string& user, const std::string& dbname);
   void connectImpl(TSessionId& session,
                    const std::string& user,
@@ -370,9 +389,23 @@ class MapDHandler : public MapDIf {
   std::unique_ptr<MapDLeafHandler> leaf_handler_;
   std::shared_ptr<Calcite> calcite_;
   const bool legacy_syntax_;
+  std::shared_ptr<RequestScheduler> request_scheduler_;
   Catalog_Namespace::SessionInfo get_session(const TSessionId& session);
 
  private:
+  // Result of a query run by open_cursor.
+  struct Cursor {
+    TSessionId session;
+    std::shared_ptr<ResultSet> rows;
+    std::vector<TargetMetaInfo> targets;
+    bool column_format;
+    std::map<std::string, bool> table_names;
+    // versions of the tables when the query ran, the lazily fetched columns of rows point into their chunks
+    std::vector<TableVersion> table_versions;
+    std::chrono::steady_clock::time_point last_used;
+    std::mutex fetch_mutex;  // fetches advance the row iterator of rows
+  };
+
   void check_table_load_privileges(const TSessionId& session, const std::string& table_name);
   void check_table_load_privileges(const Catalog_Namespace::SessionInfo& session_info, const std::string& table_name);
   void get_tables_impl(std::vector<std::string>& table_names,
@@ -415,7 +448,9 @@ class MapDHandler : public MapDIf {
                        const int32_t first_n,
                        const int32_t at_most_n,
                        const bool just_explain,
-                       const bool just_validate) const;
+                       const bool just_validate,
+                       const bool explain_analyze,
+                       Cursor* cursor = nullptr) const;
   void execute_rel_alg_df(TDataFrame& _return,
                           const std::string& query_ra,
                           const Catalog_Namespace::SessionInfo& session_info,
@@ -441,6 +476,10 @@ class MapDHandler : public MapDIf {
   void convert_explain(TQueryResult& _return, const ResultSet& results, const bool column_format) const;
   void convert_result(TQueryResult& _return, const ResultSet& results, const bool column_format) const;
 
+  std::shared_ptr<Cursor> get_cursor(const TSessionId& session, const TCursorId cursor_id);
+  void close_idle_cursors();
+  void close_session_cursors(const TSessionId& session);
+
   template <class R>
   void convert_rows(TQueryResult& _return,
                     const std::vector<TargetMetaInfo>& targets,
@@ -497,6 +536,13 @@ class MapDHandler : public MapDIf {
       const std::vector<std::string>& table_names,
       const TSessionId& session);
 
+  // interrupt() cancels the queries of a session through the tokens registered here.
+  std::shared_ptr<QueryCancellationToken> registerQuery(const TSessionId& session) const;
+  void unregisterQuery(const TSessionId& session, const QueryCancellationToken* query_token) const;
+
+  void get_request_queue_stats(TRequestQueueStats& _return) const;
+  void get_result_cache_stats(TResultCacheStats& _return) const;
+
   bool super_user_rights_;  // default is "false"; setting to "true" ignores passwd checks in "connect(..)" method
   const bool access_priv_check_;
 
@@ -509,6 +555,15 @@ class MapDHandler : public MapDIf {
   mutable std::mutex handle_to_dev_ptr_mutex_;
   mutable std::unordered_map<std::string, int8_t*> ipc_handle_to_dev_ptr_;
 
+  // Queries in flight, by session
+  mutable std::mutex running_queries_mutex_;
+  mutable std::unordered_multimap<TSessionId, std::shared_ptr<QueryCancellationToken>> running_queries_;
+
+  // Results kept for open_cursor, by cursor id
+  std::mutex cursors_mutex_;
+  TCursorId next_cursor_id_;
+  std::unordered_map<TCursorId, std::shared_ptr<Cursor>> cursors_;
+
   friend void run_warmup_queries(mapd::shared_ptr<MapDHandler> handler,
                                  std::string base_path,
                                  std::string query_file_path);
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RequestScheduler.h"
+
+#include <glog/logging.h>
+#include <thrift/TApplicationException.h>
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+RequestScheduler::RequestScheduler(const size_t max_running, const size_t max_queued)
+    : max_running_(max_running)
+    , max_queued_(max_queued)
+    , next_ticket_(0)
+    , running_(0)
+    , admitted_(0)
+    , rejected_(0)
+    , total_wait_us_(0)
+    , max_wait_us_(0) {
+  CHECK_GT(max_running_, size_t(0));
+}
+
+RequestScheduler::Slot RequestScheduler::acquire(const Priority priority) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& high_queue = queues_[static_cast<int>(Priority::HIGH)];
+  auto& queue = queues_[static_cast<int>(priority)];
+  if (running_ < max_running_ && high_queue.empty() && queues_[static_cast<int>(Priority::LOW)].empty()) {
+    ++running_;
+    ++admitted_;
+    return Slot(this);
+  }
+  if (high_queue.size() + queues_[static_cast<int>(Priority::LOW)].size() >= max_queued_) {
+    ++rejected_;
+    throw QueueFull();
+  }
+  const auto ticket = next_ticket_++;
+  queue.push_back(ticket);
+  const auto enqueued = std::chrono::steady_clock::now();
+  slot_available_.wait(lock, [this, priority, ticket] { return running_ < max_running_ && isNext(priority, ticket); });
+  queue.pop_front();
+  ++running_;
+  ++admitted_;
+  const int64_t wait_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - enqueued).count();
+  total_wait_us_ += wait_us;
+  max_wait_us_ = std::max(max_wait_us_, wait_us);
+  // the next request in line might fit as well if several slots were freed at once
+  slot_available_.notify_all();
+  return Slot(this);
+}
+
+bool RequestScheduler::isNext(const Priority priority, const uint64_t ticket) const {
+  const auto& queue = queues_[static_cast<int>(priority)];
+  CHECK(!queue.empty());
+  return queue.front() == ticket && (priority == Priority::HIGH || queues_[static_cast<int>(Priority::HIGH)].empty());
+}
+
+void RequestScheduler::release() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_GT(running_, size_t(0));
+    --running_;
+  }
+  slot_available_.notify_all();
+}
+
+RequestScheduler::Stats RequestScheduler::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {running_,
+          queues_[static_cast<int>(Priority::HIGH)].size() + queues_[static_cast<int>(Priority::LOW)].size(),
+          admitted_,
+          rejected_,
+          total_wait_us_,
+          max_wait_us_};
+}
+
+RequestScheduler::Priority RequestScheduler::getPriority(const std::string& method_name) {
+  // calls which can keep an execution slot busy for a long time; everything else
+  // (metadata, dashboards, privileges) jumps ahead of them in the queue
+  static const std::unordered_set<std::string> long_running_methods{"sql_execute",
+                                                                    "sql_execute_df",
+                                                                    "sql_execute_gdf",
+                                                                    "open_cursor",
+                                                                    "fetch_cursor",
+                                                                    "sql_validate",
+                                                                    "render_vega",
+                                                                    "get_result_row_for_pixel",
+                                                                    "load_table_binary",
+                                                                    "load_table_binary_columnar",
+                                                                    "load_table_binary_arrow",
+                                                                    "load_table",
+                                                                    "import_table",
+                                                                    "import_geo_table",
+                                                                    "detect_column_types",
+                                                                    "execute_first_step",
+                                                                    "start_query",
+                                                                    "broadcast_serialized_rows",
+                                                                    "start_render_query",
+                                                                    "execute_next_render_step",
+                                                                    "insert_data",
+                                                                    "checkpoint"};
+  return long_running_methods.count(method_name) ? Priority::LOW : Priority::HIGH;
+}
+
+bool RequestScheduler::isControlCall(const std::string& method_name) {
+  static const std::unordered_set<std::string> control_methods{"connect",
+                                                               "disconnect",
+                                                               "interrupt",
+                                                               "set_execution_mode",
+                                                               "set_statement_timeout",
+                                                               "close_cursor",
+                                                               "deallocate_df",
+                                                               "get_server_status",
+                                                               "get_status",
+                                                               "get_version",
+                                                               "get_hardware_info",
+                                                               "import_table_status"};
+  return control_methods.count(method_name);
+}
+
+bool ScheduledMapDProcessor::dispatchCall(::apache::thrift::protocol::TProtocol* iprot,
+                                          ::apache::thrift::protocol::TProtocol* oprot,
+                                          const std::string& fname,
+                                          int32_t seqid,
+                                          void* callContext) {
+  if (RequestScheduler::isControlCall(fname)) {
+    return MapDProcessor::dispatchCall(iprot, oprot, fname, seqid, callContext);
+  }
+  try {
+    auto slot = scheduler_->acquire(RequestScheduler::getPriority(fname));
+    return MapDProcessor::dispatchCall(iprot, oprot, fname, seqid, callContext);
+  } catch (const RequestScheduler::QueueFull& e) {
+    LOG(WARNING) << "Rejected " << fname << ": " << e.what();
+    // drain the arguments and answer the same way the generated code answers unknown methods
+    iprot->skip(::apache::thrift::protocol::T_STRUCT);
+    iprot->readMessageEnd();
+    iprot->getTransport()->readEnd();
+    ::apache::thrift::TApplicationException x(::apache::thrift::TApplicationException::INTERNAL_ERROR, e.what());
+    oprot->writeMessageBegin(fname, ::apache::thrift::protocol::T_EXCEPTION, seqid);
+    x.write(oprot);
+    oprot->writeMessageEnd();
+    oprot->getTransport()->writeEnd();
+    oprot->getTransport()->flush();
+    return true;
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2018 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef THRIFTHANDLER_REQUESTSCHEDULER_H
+#define THRIFTHANDLER_REQUESTSCHEDULER_H
+
+#include "Shared/mapd_shared_ptr.h"
+#include "gen-cpp/MapD.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// Bounds the number of requests executing at the same time and keeps a bounded queue for
+// the rest. Short metadata calls are admitted ahead of queued queries and loads, in FIFO
+// order within each priority. Control calls (see isControlCall) don't go through it at all.
+class RequestScheduler {
+ public:
+  enum class Priority { HIGH, LOW };
+
+  struct Stats {
+    size_t running_requests;
+    size_t queued_requests;
+    uint64_t admitted_requests;
+    uint64_t rejected_requests;  // turned away because the queue was full
+    int64_t total_wait_us;       // time spent queued, summed over all admitted requests
+    int64_t max_wait_us;
+  };
+
+  class QueueFull : public std::runtime_error {
+   public:
+    QueueFull() : std::runtime_error("Server is busy, request queue is full. Please try again later.") {}
+  };
+
+  // Execution slot, held for the duration of a request.
+  class Slot {
+   public:
+    Slot(Slot&& other) : scheduler_(other.scheduler_) { other.scheduler_ = nullptr; }
+    ~Slot() {
+      if (scheduler_) {
+        scheduler_->release();
+      }
+    }
+
+   private:
+    explicit Slot(RequestScheduler* scheduler) : scheduler_(scheduler) {}
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+    RequestScheduler* scheduler_;
+
+    friend class RequestScheduler;
+  };
+
+  RequestScheduler(const size_t max_running, const size_t max_queued);
+
+  // Blocks until the request can run. Throws QueueFull if max_queued requests are waiting already.
+  Slot acquire(const Priority priority);
+
+  Stats getStats() const;
+
+  static Priority getPriority(const std::string& method_name);
+
+  // Calls which only touch session or server state and must get through while every slot is busy,
+  // interrupt in particular: they run without a slot.
+  static bool isControlCall(const std::string& method_name);
+
+ private:
+  void release();
+  bool isNext(const Priority priority, const uint64_t ticket) const;
+
+  const size_t max_running_;
+  const size_t max_queued_;
+  mutable std::mutex mutex_;
+  std::condition_variable slot_available_;
+  std::deque<uint64_t> queues_[2];  // tickets of waiting requests, indexed by Priority
+  uint64_t next_ticket_;
+  size_t running_;
+  uint64_t admitted_;
+  uint64_t rejected_;
+  int64_t total_wait_us_;
+  int64_t max_wait_us_;
+};
+
+// Runs every call but the control calls through a RequestScheduler before dispatching it to the handler. The
+// MapDIf interface and the wire protocol are unchanged; a call rejected because the queue
+// is full gets a TApplicationException.
+class ScheduledMapDProcessor : public MapDProcessor {
+ public:
+  ScheduledMapDProcessor(mapd::shared_ptr<MapDIf> iface, std::shared_ptr<RequestScheduler> scheduler)
+      : MapDProcessor(iface), scheduler_(scheduler) {}
+
+ protected:
+  bool dispatchCall(::apache::thrift::protocol::TProtocol* iprot,
+                    ::apache::thrift::protocol::TProtocol* oprot,
+                    const std::string& fname,
+                    int32_t seqid,
+                    void* callContext) override;
+
+ private:
+  std::shared_ptr<RequestScheduler> scheduler_;
+};
+
+#endif  // THRIFTHANDLER_REQUESTSCHEDULER_H
@@ -21,7 +21,83 @@
 
 #include "ChunkIter.h"
 
-DEVICE static void decompress(const SQLTypeInfo& ti, int8_t* compressed, VarlenDatum* result, Datum* datum) {
+// Run length and frame of reference chunks aren't plain arrays, second_buf points to the start
+// of the chunk for them; see Chunk::begin_iterator. The layouts are described in
+// DataMgr/RunLengthEncoder.h and DataMgr/DiffEncoder.h.
+DEVICE static int64_t decode_encoded_int(const ChunkIter* it, const int8_t* compressed, bool* is_null) {
+  const auto& ti = it->type_info;
+  *is_null = false;
+  if (ti.get_compression() == kENCODING_RL) {
+    const auto runs = reinterpret_cast<const int64_t*>(it->second_buf);
+    const int64_t pos = (compressed - it->second_buf) / it->skip_size;
+    int64_t lo = 0;
+    int64_t hi = runs[0] - 1;
+    while (lo < hi) {
+      const auto mid = lo + (hi - lo) / 2;
+      if (runs[1 + 2 * mid] <= pos) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return runs[2 + 2 * lo];
+  }
+  assert(ti.get_compression() == kENCODING_DIFF);
+  int64_t offset{0};
+  switch (ti.get_comp_param()) {
+    case 8:
+      offset = *(const int8_t*)compressed;
+      break;
+    case 16:
+      offset = *(const int16_t*)compressed;
+      break;
+    case 32:
+      offset = *(const int32_t*)compressed;
+      break;
+    default:
+      assert(false);
+  }
+  if (offset == -(int64_t(1) << (ti.get_comp_param() - 1))) {
+    *is_null = true;
+    return 0;
+  }
+  return *reinterpret_cast<const int64_t*>(it->second_buf) + offset;
+}
+
+DEVICE static void decompress(const ChunkIter* it, int8_t* compressed, VarlenDatum* result, Datum* datum) {
+  const auto& ti = it->type_info;
+  if (ti.get_compression() == kENCODING_RL || ti.get_compression() == kENCODING_DIFF) {
+    bool is_null{false};
+    const auto val = decode_encoded_int(it, compressed, &is_null);
+    switch (ti.get_type()) {
+      case kSMALLINT:
+        datum->smallintval = is_null ? NULL_SMALLINT : static_cast<int16_t>(val);
+        result->length = sizeof(int16_t);
+        result->pointer = (int8_t*)&datum->smallintval;
+        break;
+      case kINT:
+        datum->intval = is_null ? NULL_INT : static_cast<int32_t>(val);
+        result->length = sizeof(int32_t);
+        result->pointer = (int8_t*)&datum->intval;
+        break;
+      case kBIGINT:
+        datum->bigintval = is_null ? NULL_BIGINT : val;
+        result->length = sizeof(int64_t);
+        result->pointer = (int8_t*)&datum->bigintval;
+        break;
+      case kTIME:
+      case kTIMESTAMP:
+      case kDATE:
+        datum->timeval = is_null ? NULL_BIGINT : static_cast<time_t>(val);
+        result->length = sizeof(time_t);
+        result->pointer = (int8_t*)&datum->timeval;
+        break;
+      default:
+        assert(false);
+    }
+    result->is_null = ti.is_null(*datum);
+    return;
+  }
   switch (ti.get_type()) {
     case kSMALLINT:
       result->length = sizeof(int16_t);
@@ -137,8 +213,10 @@ DEVICE void ChunkIter_get_next(ChunkIter* it, bool uncompress, VarlenDatum* resu
 
   if (it->skip_size > 0) {
     // for fixed-size
-    if (uncompress && it->type_info.get_compression() != kENCODING_NONE) {
-      decompress(it->type_info, it->current_pos, result, &it->datum);
+    // run length chunks have no per row bytes to hand out, always decode them
+    if ((uncompress && it->type_info.get_compression() != kENCODING_NONE) ||
+        it->type_info.get_compression() == kENCODING_RL) {
+      decompress(it, it->current_pos, result, &it->datum);
     } else {
       result->length = it->skip_size;
       result->pointer = it->current_pos;
@@ -169,8 +247,9 @@ DEVICE void ChunkIter_get_nth(ChunkIter* it, int n, bool uncompress, VarlenDatum
   if (it->skip_size > 0) {
     // for fixed-size
     int8_t* current_pos = it->start_pos + n * it->skip_size;
-    if (uncompress && it->type_info.get_compression() != kENCODING_NONE) {
-      decompress(it->type_info, current_pos, result, &it->datum);
+    if ((uncompress && it->type_info.get_compression() != kENCODING_NONE) ||
+        it->type_info.get_compression() == kENCODING_RL) {
+      decompress(it, current_pos, result, &it->datum);
     } else {
       result->length = it->skip_size;
       result->pointer = current_pos;
@@ -55,6 +55,38 @@ find_library(Thrift_LIBRARY
 
 get_filename_component(Thrift_LIBRARY_DIR ${Thrift_LIBRARY} DIRECTORY)
 
+# Optional: non-blocking server support, needs libthriftnb and libevent
+find_library(Thrift_NB_LIBRARY
+  NAMES thriftnb
+  HINTS
+  ${Thrift_LIBRARY_DIR}
+  ENV LD_LIBRARY_PATH
+  ENV DYLD_LIBRARY_PATH
+  PATHS
+  /usr/lib
+  /usr/local/lib
+  /usr/local/homebrew/lib
+  /opt/local/lib)
+
+find_library(Thrift_EVENT_LIBRARY
+  NAMES event
+  HINTS
+  ${Thrift_LIBRARY_DIR}
+  ENV LD_LIBRARY_PATH
+  ENV DYLD_LIBRARY_PATH
+  PATHS
+  /usr/lib
+  /usr/local/lib
+  /usr/local/homebrew/lib
+  /opt/local/lib)
+
+if(Thrift_NB_LIBRARY AND Thrift_EVENT_LIBRARY)
+  set(Thrift_NB_FOUND TRUE)
+  set(Thrift_NB_LIBRARIES ${Thrift_NB_LIBRARY} ${Thrift_EVENT_LIBRARY})
+else()
+  set(Thrift_NB_FOUND FALSE)
+endif()
+
 find_program(Thrift_EXECUTABLE
   NAMES thrift
   HINTS
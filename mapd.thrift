@@ -119,6 +119,7 @@ typedef list<TColumnType> TRowDescriptor
 typedef map<string, TColumnType> TTableDescriptor
 typedef string TSessionId
 typedef i64 TQueryId
+typedef i64 TCursorId
 
 enum TMergeType {
   UNION,
@@ -146,6 +147,17 @@ struct TQueryResult {
   2: i64 execution_time_ms
   3: i64 total_time_ms
   4: string nonce
+  5: bool result_cache_hit
+  6: optional string execution_profile
+}
+
+struct TCursor {
+  1: TCursorId cursor_id
+  2: TRowDescriptor row_desc
+  3: i64 row_count
+  4: i64 execution_time_ms
+  5: i64 total_time_ms
+  6: string nonce
 }
 
 struct TDataFrame {
@@ -218,6 +230,24 @@ struct TDashboard {
   8: bool is_dash_shared
 }
 
+struct TRequestQueueStats {
+  1: i64 running_requests
+  2: i64 queued_requests
+  3: i64 admitted_requests
+  4: i64 rejected_requests
+  5: i64 avg_wait_us
+  6: i64 max_wait_us
+}
+
+struct TResultCacheStats {
+  1: i64 hits
+  2: i64 misses
+  3: i64 evictions
+  4: i64 entry_count
+  5: i64 bytes
+  6: double hit_rate
+}
+
 struct TServerStatus {
   1: bool read_only
   2: string version
@@ -226,6 +256,8 @@ struct TServerStatus {
   5: string edition
   6: string host_name
   7: bool poly_rendering_enabled
+  8: TRequestQueueStats request_queue
+  9: TResultCacheStats result_cache
 }
 
 struct TPixel {
@@ -499,9 +531,13 @@ service MapD {
   TDataFrame sql_execute_gdf(1: TSessionId session, 2: string query 3: i32 device_id = 0, 4: i32 first_n = -1) throws (1: TMapDException e)
   void deallocate_df(1: TSessionId session, 2: TDataFrame df, 3: TDeviceType device_type, 4: i32 device_id = 0) throws (1: TMapDException e)
   void interrupt(1: TSessionId session) throws (1: TMapDException e)
+  TCursor open_cursor(1: TSessionId session, 2: string query, 3: bool column_format, 4: string nonce) throws (1: TMapDException e)
+  TRowSet fetch_cursor(1: TSessionId session, 2: TCursorId cursor_id, 3: i32 max_rows) throws (1: TMapDException e)
+  void close_cursor(1: TSessionId session, 2: TCursorId cursor_id) throws (1: TMapDException e)
   TTableDescriptor sql_validate(1: TSessionId session, 2: string query) throws (1: TMapDException e)
   list<completion_hints.TCompletionHint> get_completion_hints(1: TSessionId session, 2:string sql, 3:i32 cursor) throws (1: TMapDException e)
   void set_execution_mode(1: TSessionId session, 2: TExecuteMode mode) throws (1: TMapDException e)
+  void set_statement_timeout(1: TSessionId session, 2: i32 timeout_ms) throws (1: TMapDException e)
   TRenderResult render_vega(1: TSessionId session, 2: i64 widget_id, 3: string vega_json, 4: i32 compression_level, 5: string nonce) throws (1: TMapDException e)
   TPixelTableRowResult get_result_row_for_pixel(1: TSessionId session, 2: i64 widget_id, 3: TPixel pixel, 4: map<string, list<string>> table_col_names, 5: bool column_format, 6: i32 pixelRadius, 7: string nonce) throws (1: TMapDException e)
   # Immerse